@@ -1,11 +1,96 @@
-#version 420
+#version 450
 
-layout(binding = 0) uniform sampler2D samplerAlbedo;
+layout (binding = 0) uniform UBO_vp {
+	mat4 data;
+	mat4 inverse_data;
+} vp;
 
-layout(location = 0) in vec2 inUV;
-layout(location = 0) out vec4 outColor;
+layout (binding = 1) uniform m_Pos{
+	vec4 lightPos;
+	vec4 cameraPos;
+} pos;
+
+// Written by the g-buffer subpass, read at this pixel only.
+layout (input_attachment_index = 0, binding = 2) uniform subpassInput inAlbedo;
+layout (input_attachment_index = 1, binding = 3) uniform subpassInput inNormal;
+layout (input_attachment_index = 2, binding = 4) uniform subpassInput inMaterial;
+layout (input_attachment_index = 3, binding = 5) uniform subpassInput inDepth;
+
+// Matches Engine::Descriptors::LightData, after the light count padded to one.
+struct Light
+{
+	vec4 position;	// w: radius.
+	vec4 color;		// w: intensity.
+};
+
+layout (std430, binding = 6) readonly buffer Lights {
+	uint lightCount;
+	uint padding[7];
+	Light lights[];
+};
+
+layout (location = 0) in vec2 inUV;
+layout (location = 0) out vec4 outColor;
+
+const float inv_pi = 0.318309886;
+const float Ka = 0.4;
+const float Ks = 0.4;	// Of the intensity.
+const uint MATERIAL_UNLIT = 1;
+
+vec3 decodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
 
 void main()
 {
-    outColor = texture(samplerAlbedo, inUV, 0.0);
+	vec4 diffuse_color = subpassLoad(inAlbedo);
+	vec4 material = subpassLoad(inMaterial);
+
+	// Nothing drawn here, the clear color is the background.
+	if (uint(material.b * 255.0 + 0.5) == MATERIAL_UNLIT) {
+		outColor = diffuse_color;
+		return;
+	}
+
+	vec3 N = decodeOctahedral(subpassLoad(inNormal).xy);
+
+	// The full-screen triangle's UV spans the view, as NDC once scaled.
+	vec4 world_pos = vp.inverse_data * vec4(inUV * 2.0 - 1.0, subpassLoad(inDepth).r, 1.0);
+	vec3 frag_world_pos = world_pos.xyz / world_pos.w;
+
+	// Blinn-Phong exponent of the same highlight size, metals tint it with their albedo.
+	float roughness = max(material.r, 0.05);
+	float shininess = 2.0 / pow(roughness, 4.0) - 2.0;
+	float metalness = material.g;
+
+	vec3 V = normalize(pos.cameraPos.xyz - frag_world_pos);
+	vec3 radiance = diffuse_color.rgb * Ka;
+
+	// Every light, see tiled_lighting_cs.glsl for many of them.
+	for(uint i = 0; i < lightCount; i++)
+	{
+		vec3 light_dir = lights[i].position.xyz - frag_world_pos;
+		float distance = length(light_dir);
+
+		vec3 L = light_dir / distance;
+		vec3 H = normalize(L + V);
+
+		float window = clamp(1.0 - pow(distance / lights[i].position.w, 4.0), 0.0, 1.0);
+		float attenuation = lights[i].color.w * window * window / (distance * distance);
+
+		float n_dot_l = max(dot(N, L), 0.0);
+		float n_dot_h = max(dot(N, H), 0.0);
+
+		float diffuse  = inv_pi * n_dot_l * attenuation;
+		float specular = Ks * inv_pi * pow(n_dot_h, shininess) * attenuation;
+
+		radiance += diffuse_color.rgb * diffuse * (1.0 - metalness) +
+					mix(lights[i].color.rgb, lights[i].color.rgb * diffuse_color.rgb, metalness) * specular;
+	}
+
+	outColor = vec4(radiance, diffuse_color.a);
 }
\ No newline at end of file
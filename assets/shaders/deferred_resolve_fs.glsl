@@ -0,0 +1,12 @@
+#version 450
+
+// Shaded by the tiled lighting pass.
+layout (binding = 0) uniform sampler2D samplerColor;
+
+layout (location = 0) in vec2 inUV;
+layout (location = 0) out vec4 outColor;
+
+void main()
+{
+    outColor = texture(samplerColor, inUV, 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#version 450
+
+// One workgroup per meshlet: the first invocation culls it, all of them copy its indices when visible.
+layout (local_size_x = 64) in;
+
+// Matches Engine::Meshlet.
+struct Meshlet
+{
+    vec3 center;
+    float radius;
+    vec3 coneAxis;
+    float coneCutoff;
+    vec3 coneApex;
+    uint indexOffset;
+    uint indexCount;
+    uint vertexCount;
+    uint padding[2];
+};
+
+layout (binding = 0) uniform UBO_m {
+    mat4 data;
+} m;
+
+layout (binding = 1) uniform UBO_vp {
+    mat4 data;
+} vp;
+
+layout (std430, binding = 2) readonly buffer Meshlets {
+    Meshlet meshlets[];
+};
+
+// Object index buffer, two indices per word when 16 bits.
+layout (std430, binding = 3) readonly buffer Indices {
+    uint indices[];
+};
+
+layout (std430, binding = 4) writeonly buffer VisibleIndices {
+    uint visibleIndices[];
+};
+
+// VkDrawIndexedIndirectCommand, indexCount is reset to 0 before the dispatch.
+layout (std430, binding = 5) buffer DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+} draw;
+
+layout (push_constant) uniform Params {
+    uint meshletCount;
+    uint index16Bit;
+} params;
+
+shared bool visible;
+shared uint visibleOffset;
+
+// Tests run in object space, with the planes and the eye of the model-view-projection matrix.
+bool isVisible(Meshlet meshlet)
+{
+    mat4 mvp = vp.data * m.data;
+    mat4 rows = transpose(mvp);
+
+    // Gribb-Hartmann planes: left, right, bottom, top, near, far.
+    vec4 planes[6] = vec4[](rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1],
+                            rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]);
+
+    for (int i = 0; i < 6; ++i)
+        if (dot(planes[i].xyz, meshlet.center) + planes[i].w < -meshlet.radius * length(planes[i].xyz))
+            return false;
+
+    if (meshlet.coneCutoff >= 1.0)
+        return true;
+
+    // The eye is the point projected to x = y = w = 0.
+    mat3 xyw = mat3(mvp[0].xyw, mvp[1].xyw, mvp[2].xyw);
+    vec3 eye = inverse(xyw) * -mvp[3].xyw;
+
+    return dot(normalize(meshlet.coneApex - eye), meshlet.coneAxis) < meshlet.coneCutoff;
+}
+
+void main()
+{
+    uint meshletIndex = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    // Uniform over the workgroup, so barrier() below stays in uniform control flow.
+    if (meshletIndex >= params.meshletCount)
+        return;
+
+    Meshlet meshlet = meshlets[meshletIndex];
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        visible = isVisible(meshlet);
+        if (visible)
+            visibleOffset = atomicAdd(draw.indexCount, meshlet.indexCount);
+    }
+
+    barrier();
+
+    if (!visible)
+        return;
+
+    for (uint i = gl_LocalInvocationIndex; i < meshlet.indexCount; i += gl_WorkGroupSize.x)
+    {
+        uint index = meshlet.indexOffset + i;
+        if (params.index16Bit != 0)
+            index = (indices[index >> 1] >> ((index & 1) * 16)) & 0xFFFF;
+        else
+            index = indices[index];
+
+        visibleIndices[visibleOffset + i] = index;
+    }
+}
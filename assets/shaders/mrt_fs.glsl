@@ -8,12 +8,28 @@ layout (binding = 2) uniform m_Pos{
 layout (binding = 3) uniform sampler2D samplerAlbedo;
 
 layout (location = 0) in vec2 inUV;
-layout (location = 1) in vec3 inNormal;
-layout (location = 2) in vec3 inFragWorldPos;
+layout (location = 2) in vec3 inNormal;
 
 layout (location = 0) out vec4 outAlbedo;
+layout (location = 1) out vec2 outNormal;
+layout (location = 2) out vec4 outMaterial;
+
+// Objects have no material yet, roughness 0.8 gives phong's exponent of 3.
+const float roughness = 0.8;
+const float metalness = 0.0;
+const uint MATERIAL_LIT = 0;
+
+// Unit vector folded on the octahedron, then its lower half over the upper one.
+vec2 encodeOctahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 folded = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return n.z >= 0.0 ? n.xy : folded;
+}
 
 void main()
 {
-    outAlbedo = texture(samplerAlbedo, inUV);
+    outAlbedo   = texture(samplerAlbedo, inUV);
+    outNormal   = encodeOctahedral(normalize(inNormal));
+    outMaterial = vec4(roughness, metalness, float(MATERIAL_LIT) / 255.0, 0.0);
 }
\ No newline at end of file
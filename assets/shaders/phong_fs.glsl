@@ -1,4 +1,4 @@
-#version 420
+#version 450
 
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
@@ -9,61 +9,101 @@ layout (binding = 2) uniform m_Pos{
 } pos;
 
 layout (binding = 3) uniform sampler2D samplerColor;
+layout (binding = 4) uniform sampler2D samplerNormal;
+
+// Engine::GraphicsPipeline::ShaderVariant, one pipeline per combination.
+layout (constant_id = 0) const uint MAX_LIGHTS = 32;	// Per froxel, LightClusters::MAX_CLUSTER_LIGHTS.
+layout (constant_id = 1) const bool HAS_TEXTURE = true;
+layout (constant_id = 2) const bool ALPHA_TEST = false;
+layout (constant_id = 3) const bool NORMAL_MAPPING = true;
+layout (constant_id = 4) const float Ka = 0.2;
+layout (constant_id = 5) const float Ks = 0.4;	// Of the intensity.
+layout (constant_id = 6) const float ALPHA_CUTOFF = 0.5;
+
+// Matches Engine::Descriptors::LightData, after the light count padded to one.
+struct Light
+{
+	vec4 position;	// w: radius.
+	vec4 color;		// w: intensity.
+};
+
+layout (std430, binding = 5) readonly buffer Lights {
+	uint lightCount;
+	uint padding[7];
+	Light lights[];
+};
+
+// Engine::Descriptors::LightClusters::CLUSTER_X, CLUSTER_Y and CLUSTER_Z, asserted there.
+const uvec3 CLUSTERS = uvec3(16, 9, 24);
+
+// Built every frame by Engine::Descriptors::LightClusters, of CLUSTER_X * CLUSTER_Y * CLUSTER_Z froxels.
+layout (std430, binding = 6) readonly buffer Clusters {
+	vec4 viewDepth;		// Dot with the world position: distance along the view direction.
+	vec4 clusterScale;	// Froxels per pixel in x and y, log depth scale and bias to slices.
+	uvec2 clusterRanges[CLUSTERS.x * CLUSTERS.y * CLUSTERS.z];	// Offset and count in lightIndices.
+	uint lightIndices[];
+};
 
 layout (location = 0) in vec2 inUV;
 layout (location = 1) in vec3 inFragWorldPos;
 layout (location = 2) in vec3 inNormal;
+layout (location = 3) in vec4 inTangent;	// w: bitangent sign.
 
 layout (location = 0) out vec4 outFragColor;
 
-struct LightData
-{
-	vec3 pos;
-	vec3 color;
-};
-
-const LightData[2] lights = LightData[2](
-	LightData(vec3(-3,  5, -3), vec3(1, 0, 0)),
-	LightData(vec3(3, 3, 3), vec3(0, 1, 0)));
-
 const float inv_pi = 0.318309886;
 
 void main()
 {
-	int LIGHT_COUNT = 2;
+	vec4 diffuse_color = HAS_TEXTURE ? texture(samplerColor, inUV, 0.0) : vec4(1.0);
+	if (ALPHA_TEST && diffuse_color.a < ALPHA_CUTOFF)
+		discard;
+
+	vec3 radiance = diffuse_color.rgb * Ka;
 
-	vec4 diffuse_color = texture(samplerColor, inUV, 0.0);
-	vec3 radiance = vec3(0, 0, 0);
+	float depth = dot(viewDepth, vec4(inFragWorldPos, 1.0));
+	float slice = log(max(depth, 1e-6)) * clusterScale.z + clusterScale.w;
 
-	float Ka = 0.2;
-	float Kd = 100.0;
-	float Ks = 40.0;
+	uvec3 froxel = min(uvec3(uvec2(gl_FragCoord.xy * clusterScale.xy), uint(max(slice, 0.0))), CLUSTERS - 1);
+	uvec2 range = clusterRanges[(froxel.z * CLUSTERS.y + froxel.y) * CLUSTERS.x + froxel.x];
 
-	for(int i = 0; i < lights.length(); i++)
+	vec3 N = normalize(inNormal);
+	// Interpolated tangent made orthogonal to N again. Meshes without tangents keep the vertex normal.
+	vec3 T = inTangent.xyz - N * dot(N, inTangent.xyz);
+	if (NORMAL_MAPPING && dot(T, T) > 1e-8) {
+		T = normalize(T);
+		vec3 B = cross(N, T) * inTangent.w;
+		N = normalize(mat3(T, B, N) * (texture(samplerNormal, inUV).xyz * 2.0 - 1.0));
+	}
+	vec3 V = normalize(pos.cameraPos.xyz - inFragWorldPos);
+
+	// Only the lights reaching this froxel, a constant bound lets the compiler unroll or drop the loop.
+	uint light_count = min(range.y, MAX_LIGHTS);
+	for(uint i = 0; i < MAX_LIGHTS; i++)
 	{
-		vec3 light_dir = lights[i].pos - inFragWorldPos;
-		vec3 light_color = lights[i].color;
+		if (i >= light_count)
+			break;
+
+		Light light = lights[lightIndices[range.x + i]];
+
+		vec3 light_dir = light.position.xyz - inFragWorldPos;
 		float distance = length(light_dir);
 
 		vec3 L = light_dir / distance;
-		vec3 N = normalize(inNormal);
-		vec3 V = normalize(pos.cameraPos.xyz - inFragWorldPos);
-		vec3 R = normalize(reflect(-L, N));
 		vec3 H = normalize(L + V);
 
-		distance *= distance;
+		float window = clamp(1.0 - pow(distance / light.position.w, 4.0), 0.0, 1.0);
+		float attenuation = light.color.w * window * window / (distance * distance);
 
 		float n_dot_l = max(dot(N, L), 0.0);
-		float r_dot_v = max(dot(R, V), 0.0);
 		float n_dot_h = max(dot(N, H), 0.0);
 
-		float diffuse  = Kd * inv_pi * n_dot_l / distance;
-		float specular = Ks * inv_pi * pow(n_dot_h, 3.0) / distance;
+		float diffuse  = inv_pi * n_dot_l * attenuation;
+		float specular = Ks * inv_pi * pow(n_dot_h, 3.0) * attenuation;
 
-		radiance += diffuse_color.rgb * Ka +
-					diffuse_color.rgb * diffuse +
-					light_color.rgb   * specular;
+		radiance += diffuse_color.rgb * diffuse +
+					light.color.rgb   * specular;
 	}
 
 	outFragColor = vec4(radiance, diffuse_color.a);
-}
\ No newline at end of file
+}
@@ -0,0 +1,65 @@
+#version 420
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (binding = 0) uniform UBO_m {
+    mat4 data;
+} m;
+
+layout (binding = 1) uniform UBO_vp {
+    mat4 data;
+} vp;
+
+// Mesh bounds used to quantize positions (see Vertex::QuantizationParams).
+layout (push_constant) uniform Quantization {
+    vec4 boundsMin;
+    vec4 boundsExtent;
+} quantization;
+
+layout (location = 0) in vec4 inPos;    // UNORM16, w holds the packed tangent
+layout (location = 1) in vec2 inUV;     // Half float
+layout (location = 2) in vec2 inNormal; // SNORM16 octahedral
+
+layout (location = 0) out vec2 outUV;
+layout (location = 1) out vec3 outFragWorldPos;
+layout (location = 2) out vec3 outNormal;
+layout (location = 3) out vec4 outTangent;
+
+const float TWO_PI = 6.28318530718;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
+// Vertex::VertexQuantizer::decodeTangent: angle around the normal in the high 15 bits, bitangent sign in the low bit.
+vec4 decodeTangent(vec3 normal, uint encoded)
+{
+    float s = normal.z >= 0.0 ? 1.0 : -1.0;
+    float a = -1.0 / (s + normal.z);
+    float b = normal.x * normal.y * a;
+    vec3 b1 = vec3(1.0 + s * normal.x * normal.x * a, s * b, -s * normal.x);
+    vec3 b2 = vec3(b, s + normal.y * normal.y * a, -normal.y);
+
+    float angle = (float(encoded >> 1u) / 32767.0 - 0.5) * TWO_PI;
+    return vec4(b1 * cos(angle) + b2 * sin(angle), (encoded & 1u) != 0u ? -1.0 : 1.0);
+}
+
+void main()
+{
+    vec3 pos        = quantization.boundsMin.xyz + inPos.xyz * quantization.boundsExtent.xyz;
+    vec3 normal     = octDecode(inNormal);
+    vec4 tangent    = decodeTangent(normal, uint(round(inPos.w * 65535.0)));
+
+    outUV           = inUV;
+    outFragWorldPos = (m.data * vec4(pos, 1.0)).xyz;
+    gl_Position     = vp.data * vec4(outFragWorldPos, 1.0);
+
+    vec4 tNormal    = vec4(inverse(transpose(m.data)) * vec4(normal, 1.0));
+    outNormal       = tNormal.xyz / tNormal.w;
+    outTangent      = vec4(mat3(m.data) * tangent.xyz, tangent.w);
+}
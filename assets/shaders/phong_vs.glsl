@@ -14,10 +14,12 @@ layout (binding = 1) uniform UBO_vp {
 layout (location = 0) in vec3 inPos;
 layout (location = 1) in vec2 inUV;
 layout (location = 2) in vec3 inNormal;
+layout (location = 3) in vec4 inTangent;  // w: bitangent sign.
 
 layout (location = 0) out vec2 outUV;
 layout (location = 1) out vec3 outFragWorldPos;
 layout (location = 2) out vec3 outNormal;
+layout (location = 3) out vec4 outTangent;
 
 void main()
 {
@@ -27,4 +29,5 @@ void main()
 
     vec4 tNormal    = vec4(inverse(transpose(m.data)) * vec4(inNormal, 1.0));
     outNormal       = tNormal.xyz / tNormal.w;
+    outTangent      = vec4(mat3(m.data) * inTangent.xyz, inTangent.w);
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#version 450
+
+// One workgroup per 16x16 tile: depth range, lights reaching it, then one invocation shades each pixel.
+layout (local_size_x = 16, local_size_y = 16) in;
+
+layout (binding = 0) uniform UBO_vp {
+    mat4 data;
+    mat4 inverse_data;
+} vp;
+
+layout (binding = 1) uniform m_Pos{
+    vec4 lightPos;
+    vec4 cameraPos;
+} pos;
+
+// Matches Engine::Descriptors::LightData, after the light count padded to one.
+struct Light
+{
+    vec4 position;  // w: radius.
+    vec4 color;     // w: intensity.
+};
+
+layout (std430, binding = 2) readonly buffer Lights {
+    uint lightCount;
+    uint padding[7];
+    Light lights[];
+};
+
+layout (binding = 3) uniform sampler2D samplerAlbedo;
+layout (binding = 4) uniform sampler2D samplerNormal;
+layout (binding = 5) uniform sampler2D samplerMaterial;
+layout (binding = 6) uniform sampler2D samplerDepth;
+
+layout (binding = 7, rgba16f) uniform writeonly image2D outColor;
+
+// Past it, lights of a crowded tile are dropped.
+const uint MAX_TILE_LIGHTS = 256;
+
+const float inv_pi = 0.318309886;
+const float Ka = 0.4;
+const float Ks = 0.4;   // Of the intensity.
+const uint MATERIAL_UNLIT = 1;
+
+shared uint tileMinDepth;
+shared uint tileMaxDepth;
+shared uint tileLightCount;
+shared uint tileLights[MAX_TILE_LIGHTS];
+
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+vec3 unproject(vec2 ndc, float depth)
+{
+    vec4 world_pos = vp.inverse_data * vec4(ndc, depth, 1.0);
+    return world_pos.xyz / world_pos.w;
+}
+
+void main()
+{
+    ivec2 size = textureSize(samplerDepth, 0);
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    bool inside = all(lessThan(pixel, size));
+
+    if (gl_LocalInvocationIndex == 0) {
+        tileMinDepth = 0xffffffffu;
+        tileMaxDepth = 0u;
+        tileLightCount = 0u;
+    }
+    barrier();
+
+    vec4 material = inside ? texelFetch(samplerMaterial, pixel, 0) : vec4(0.0);
+    bool lit = inside && uint(material.b * 255.0 + 0.5) != MATERIAL_UNLIT;
+    float depth = inside ? texelFetch(samplerDepth, pixel, 0).r : 1.0;
+
+    // Depths are positive, their bits order like them.
+    if (lit) {
+        atomicMin(tileMinDepth, floatBitsToUint(depth));
+        atomicMax(tileMaxDepth, floatBitsToUint(depth));
+    }
+    barrier();
+
+    // World space bounds of the tile between its depths, lights are spheres tested against them.
+    if (tileMinDepth <= tileMaxDepth)
+    {
+        vec2 ndc_min = vec2(gl_WorkGroupID.xy * gl_WorkGroupSize.xy) / vec2(size) * 2.0 - 1.0;
+        vec2 ndc_max = vec2((gl_WorkGroupID.xy + 1) * gl_WorkGroupSize.xy) / vec2(size) * 2.0 - 1.0;
+        float depth_min = uintBitsToFloat(tileMinDepth);
+        float depth_max = uintBitsToFloat(tileMaxDepth);
+
+        vec3 box_min = vec3(1e30);
+        vec3 box_max = vec3(-1e30);
+        for (int i = 0; i < 8; i++)
+        {
+            vec3 corner = unproject(vec2((i & 1) != 0 ? ndc_max.x : ndc_min.x, (i & 2) != 0 ? ndc_max.y : ndc_min.y),
+                                    (i & 4) != 0 ? depth_max : depth_min);
+            box_min = min(box_min, corner);
+            box_max = max(box_max, corner);
+        }
+
+        uint group_size = gl_WorkGroupSize.x * gl_WorkGroupSize.y;
+        for (uint i = gl_LocalInvocationIndex; i < lightCount; i += group_size)
+        {
+            vec3 closest = clamp(lights[i].position.xyz, box_min, box_max);
+            vec3 offset = closest - lights[i].position.xyz;
+
+            if (dot(offset, offset) <= lights[i].position.w * lights[i].position.w) {
+                uint index = atomicAdd(tileLightCount, 1u);
+                if (index < MAX_TILE_LIGHTS)
+                    tileLights[index] = i;
+            }
+        }
+    }
+    barrier();
+
+    if (!inside)
+        return;
+
+    vec4 diffuse_color = texelFetch(samplerAlbedo, pixel, 0);
+
+    // Nothing drawn here, the clear color is the background.
+    if (!lit) {
+        imageStore(outColor, pixel, diffuse_color);
+        return;
+    }
+
+    vec3 N = decodeOctahedral(texelFetch(samplerNormal, pixel, 0).xy);
+    vec3 frag_world_pos = unproject((vec2(pixel) + 0.5) / vec2(size) * 2.0 - 1.0, depth);
+    vec3 V = normalize(pos.cameraPos.xyz - frag_world_pos);
+
+    // Blinn-Phong exponent of the same highlight size, metals tint it with their albedo.
+    float roughness = max(material.r, 0.05);
+    float shininess = 2.0 / pow(roughness, 4.0) - 2.0;
+    float metalness = material.g;
+
+    vec3 radiance = diffuse_color.rgb * Ka;
+
+    uint count = min(tileLightCount, MAX_TILE_LIGHTS);
+    for (uint i = 0; i < count; i++)
+    {
+        Light light = lights[tileLights[i]];
+
+        vec3 light_dir = light.position.xyz - frag_world_pos;
+        float distance = length(light_dir);
+
+        vec3 L = light_dir / distance;
+        vec3 H = normalize(L + V);
+
+        // Fades to nothing at the radius, so culled lights are never missed.
+        float window = clamp(1.0 - pow(distance / light.position.w, 4.0), 0.0, 1.0);
+        float attenuation = light.color.w * window * window / (distance * distance);
+
+        float n_dot_l = max(dot(N, L), 0.0);
+        float n_dot_h = max(dot(N, H), 0.0);
+
+        float diffuse  = inv_pi * n_dot_l * attenuation;
+        float specular = Ks * inv_pi * pow(n_dot_h, shininess) * attenuation;
+
+        radiance += diffuse_color.rgb * diffuse * (1.0 - metalness) +
+                    mix(light.color.rgb, light.color.rgb * diffuse_color.rgb, metalness) * specular;
+    }
+
+    imageStore(outColor, pixel, vec4(radiance, diffuse_color.a));
+}
\ No newline at end of file
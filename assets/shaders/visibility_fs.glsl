@@ -0,0 +1,12 @@
+#version 450
+
+layout (location = 0) flat in uint inObject;
+layout (location = 0) out uint outId;
+
+// Engine::GraphicsPipeline::Visibility::TRIANGLE_BITS
+const uint TRIANGLE_BITS = 22;
+
+void main()
+{
+    outId = (inObject << TRIANGLE_BITS) | uint(gl_PrimitiveID);
+}
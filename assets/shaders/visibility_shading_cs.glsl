@@ -0,0 +1,192 @@
+#version 450
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+// One invocation per pixel: fetch its triangle, interpolate its attributes, shade it once.
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0) uniform UBO_vp {
+    mat4 data;
+    mat4 inverse_data;
+} vp;
+
+layout (binding = 1) uniform m_Pos{
+    vec4 lightPos;
+    vec4 cameraPos;
+} pos;
+
+// Matches Engine::Descriptors::LightData, after the light count padded to one.
+struct Light
+{
+    vec4 position;  // w: radius.
+    vec4 color;     // w: intensity.
+};
+
+layout (std430, binding = 2) readonly buffer Lights {
+    uint lightCount;
+    uint padding[7];
+    Light lights[];
+};
+
+// Engine::Descriptors::LightClusters::CLUSTER_X, CLUSTER_Y and CLUSTER_Z, asserted there.
+const uvec3 CLUSTERS = uvec3(16, 9, 24);
+
+// Built every frame by Engine::Descriptors::LightClusters, of CLUSTER_X * CLUSTER_Y * CLUSTER_Z froxels.
+layout (std430, binding = 3) readonly buffer Clusters {
+    vec4 viewDepth;
+    vec4 clusterScale;
+    uvec2 clusterRanges[CLUSTERS.x * CLUSTERS.y * CLUSTERS.z];
+    uint lightIndices[];
+};
+
+// Matches Engine::GraphicsPipeline::Visibility::ObjectData.
+struct Object
+{
+    uint firstIndex;
+    uint vertexOffset;
+    uint texture;
+    uint padding;
+};
+
+layout (std430, binding = 4) readonly buffer Objects {
+    Object objects[];
+};
+
+layout (std430, binding = 5) readonly buffer Indices {
+    uint indices[];
+};
+
+// Engine::VertexData, 16 floats: position, UV, normal, color and tangent.
+layout (std430, binding = 6) readonly buffer Vertices {
+    float vertices[];
+};
+
+layout (binding = 7) uniform usampler2D samplerVisibility;
+layout (binding = 8, rgba16f) uniform writeonly image2D outColor;
+layout (binding = 9) uniform sampler2D textures[256];
+
+// Engine::GraphicsPipeline::Visibility::TRIANGLE_BITS
+const uint TRIANGLE_BITS = 22;
+const uint VERTEX_FLOATS = 16;
+const vec4 BACKGROUND = vec4(0.4, 0.4, 0.4, 1.0);
+
+const float inv_pi = 0.318309886;
+const float Ka = 0.2;
+const float Ks = 0.4;   // Of the intensity.
+
+vec3 getPosition(uint vertex)
+{
+    uint base = vertex * VERTEX_FLOATS;
+    return vec3(vertices[base], vertices[base + 1], vertices[base + 2]);
+}
+
+vec2 getUV(uint vertex)
+{
+    uint base = vertex * VERTEX_FLOATS;
+    return vec2(vertices[base + 3], vertices[base + 4]);
+}
+
+vec3 getNormal(uint vertex)
+{
+    uint base = vertex * VERTEX_FLOATS;
+    return vec3(vertices[base + 5], vertices[base + 6], vertices[base + 7]);
+}
+
+float cross2(vec2 a, vec2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+// Perspective correct barycentrics of the triangle at 'ndc'.
+vec3 getBarycentrics(vec4 clip[3], vec2 ndc)
+{
+    vec3 inv_w = 1.0 / vec3(clip[0].w, clip[1].w, clip[2].w);
+    vec2 p0 = clip[0].xy * inv_w.x;
+    vec2 p1 = clip[1].xy * inv_w.y;
+    vec2 p2 = clip[2].xy * inv_w.z;
+
+    vec3 screen = vec3(cross2(p1 - ndc, p2 - ndc), cross2(p2 - ndc, p0 - ndc), cross2(p0 - ndc, p1 - ndc)) / cross2(p1 - p0, p2 - p0);
+    vec3 perspective = screen * inv_w;
+
+    return perspective / (perspective.x + perspective.y + perspective.z);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(outColor);
+    if (any(greaterThanEqual(pixel, size)))
+        return;
+
+    uint id = texelFetch(samplerVisibility, pixel, 0).r;
+    if (id == 0) {
+        imageStore(outColor, pixel, BACKGROUND);
+        return;
+    }
+
+    Object object = objects[(id >> TRIANGLE_BITS) - 1];
+    uint triangle = id & ((1u << TRIANGLE_BITS) - 1u);
+
+    uint triangle_vertices[3];
+    vec4 clip[3];
+    for (uint i = 0; i < 3; i++)
+    {
+        triangle_vertices[i] = object.vertexOffset + indices[object.firstIndex + triangle * 3 + i];
+        clip[i] = vp.data * vec4(getPosition(triangle_vertices[i]), 1.0);
+    }
+
+    // At the pixel and its neighbours, for texture derivatives.
+    vec2 ndc_step = 2.0 / vec2(size);
+    vec2 ndc = (vec2(pixel) + 0.5) * ndc_step - 1.0;
+    vec3 b = getBarycentrics(clip, ndc);
+    vec3 b_dx = getBarycentrics(clip, ndc + vec2(ndc_step.x, 0.0));
+    vec3 b_dy = getBarycentrics(clip, ndc + vec2(0.0, ndc_step.y));
+
+    vec2 uv0 = getUV(triangle_vertices[0]);
+    vec2 uv1 = getUV(triangle_vertices[1]);
+    vec2 uv2 = getUV(triangle_vertices[2]);
+    vec2 uv = b.x * uv0 + b.y * uv1 + b.z * uv2;
+    vec2 uv_dx = b_dx.x * uv0 + b_dx.y * uv1 + b_dx.z * uv2 - uv;
+    vec2 uv_dy = b_dy.x * uv0 + b_dy.y * uv1 + b_dy.z * uv2 - uv;
+
+    vec3 frag_world_pos = b.x * getPosition(triangle_vertices[0]) + b.y * getPosition(triangle_vertices[1]) +
+                          b.z * getPosition(triangle_vertices[2]);
+    vec3 N = normalize(b.x * getNormal(triangle_vertices[0]) + b.y * getNormal(triangle_vertices[1]) +
+                       b.z * getNormal(triangle_vertices[2]));
+    vec3 V = normalize(pos.cameraPos.xyz - frag_world_pos);
+
+    vec4 diffuse_color = textureGrad(textures[nonuniformEXT(object.texture)], uv, uv_dx, uv_dy);
+    vec3 radiance = diffuse_color.rgb * Ka;
+
+    float depth = dot(viewDepth, vec4(frag_world_pos, 1.0));
+    float slice = log(max(depth, 1e-6)) * clusterScale.z + clusterScale.w;
+
+    uvec3 froxel = min(uvec3(uvec2((vec2(pixel) + 0.5) * clusterScale.xy), uint(max(slice, 0.0))), CLUSTERS - 1);
+    uvec2 range = clusterRanges[(froxel.z * CLUSTERS.y + froxel.y) * CLUSTERS.x + froxel.x];
+
+    // Same model as phong_fs.glsl.
+    for (uint i = range.x; i < range.x + range.y; i++)
+    {
+        Light light = lights[lightIndices[i]];
+
+        vec3 light_dir = light.position.xyz - frag_world_pos;
+        float distance = length(light_dir);
+
+        vec3 L = light_dir / distance;
+        vec3 H = normalize(L + V);
+
+        float window = clamp(1.0 - pow(distance / light.position.w, 4.0), 0.0, 1.0);
+        float attenuation = light.color.w * window * window / (distance * distance);
+
+        float n_dot_l = max(dot(N, L), 0.0);
+        float n_dot_h = max(dot(N, H), 0.0);
+
+        float diffuse  = inv_pi * n_dot_l * attenuation;
+        float specular = Ks * inv_pi * pow(n_dot_h, 3.0) * attenuation;
+
+        radiance += diffuse_color.rgb * diffuse +
+                    light.color.rgb   * specular;
+    }
+
+    imageStore(outColor, pixel, vec4(radiance, 1.0));
+}
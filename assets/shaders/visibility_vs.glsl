@@ -0,0 +1,22 @@
+#version 450
+
+layout (binding = 0) uniform UBO_vp {
+    mat4 data;
+    mat4 inverse_data;
+} vp;
+
+layout (location = 0) in vec3 inPos;
+
+// The first instance of the draw is the object index, 0 is the background.
+layout (location = 0) flat out uint outObject;
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main()
+{
+    outObject   = gl_InstanceIndex + 1;
+    gl_Position = vp.data * vec4(inPos, 1.0);
+}
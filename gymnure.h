@@ -42,14 +42,56 @@ public:
 #endif
     }
 
-    uint32_t initPhongProgram()
+    /**
+     * 'meshlet_culling' culls meshlets against the camera on the GPU, worth it for large meshes such as terrains.
+     * 'variant' is the material of the program's objects (light count, alpha test...), each combination gets its own
+     * specialized pipeline. The second texture of an object is its normal map.
+     * */
+    uint32_t initPhongProgram(bool quantized_vertices = false, bool meshlet_culling = false,
+                              const Engine::GraphicsPipeline::ShaderVariant& variant = {})
     {
-        return Engine::Application::createPhongProgram();
+        return Engine::Application::createPhongProgram(quantized_vertices, meshlet_culling, variant);
     }
 
-    uint32_t initDeferredProgram()
+    /**
+     * 'tiled_lighting' shades the g-buffer in a compute pass, each tile with the lights reaching it only. Otherwise
+     * a subpass shades every pixel with every light, cheaper with few lights on tilers.
+     * */
+    uint32_t initDeferredProgram(bool tiled_lighting = true)
     {
-        return Engine::Application::createDeferredProgram();
+        return Engine::Application::createDeferredProgram(tiled_lighting ? Engine::GraphicsPipeline::Deferred::Lighting::TILED
+                                                                         : Engine::GraphicsPipeline::Deferred::Lighting::SUBPASS);
+    }
+
+    /**
+     * Objects write only their triangle ID per pixel, then each pixel is shaded once in a compute pass, whatever the
+     * overdraw. Needs descriptor indexing, see ApplicationData::visibility_buffer.
+     * */
+    uint32_t initVisibilityProgram()
+    {
+        return Engine::Application::createVisibilityProgram();
+    }
+
+    /**
+     * Objects whose pipeline variant is still compiling are drawn with the base variant of their program, or not at
+     * all, instead of waiting for it. Set it before creating programs to build their pipelines in the background.
+     * */
+    void setAsyncPipelines(bool async_pipelines)
+    {
+        Engine::ApplicationData::data->async_pipelines = async_pipelines;
+    }
+
+    /**
+     * Index of the light, to move it with setLight(). Lights deferred and phong programs.
+     * */
+    uint32_t addLight(const Engine::Descriptors::LightData& light)
+    {
+        return Engine::Application::getLights()->add(light);
+    }
+
+    void setLight(uint32_t index, const Engine::Descriptors::LightData& light)
+    {
+        Engine::Application::getLights()->set(index, light);
     }
 
     void addObjData(uint32_t program_id, GymnureObjData&& gymnure_data)
@@ -62,6 +104,60 @@ public:
         Engine::Application::addObjData(program_id, std::move(gymnure_data), GymnureObjDataType::FBX);
     }
 
+    void addPlyData(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        Engine::Application::addObjData(program_id, std::move(gymnure_data), GymnureObjDataType::PLY);
+    }
+
+    void addStlData(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        Engine::Application::addObjData(program_id, std::move(gymnure_data), GymnureObjDataType::STL);
+    }
+
+    void addGltfData(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        Engine::Application::addObjData(program_id, std::move(gymnure_data), GymnureObjDataType::GLTF);
+    }
+
+    /**
+     * Model cooked for streaming by gymnure_cook (any format, meshes over Cooker::STREAMING_MIN_TRIANGLES), drawn
+     * from a fixed size GPU pool paged as the camera moves. Needs a quantized program.
+     * */
+    void addStreamedData(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        Engine::Application::addObjData(program_id, std::move(gymnure_data), GymnureObjDataType::STREAMED);
+    }
+
+    std::shared_future<void> addObjDataAsync(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        return Engine::Application::addObjDataAsync(program_id, std::move(gymnure_data), GymnureObjDataType::OBJ);
+    }
+
+    std::shared_future<void> addFbxDataAsync(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        return Engine::Application::addObjDataAsync(program_id, std::move(gymnure_data), GymnureObjDataType::FBX);
+    }
+
+    std::shared_future<void> addPlyDataAsync(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        return Engine::Application::addObjDataAsync(program_id, std::move(gymnure_data), GymnureObjDataType::PLY);
+    }
+
+    std::shared_future<void> addStlDataAsync(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        return Engine::Application::addObjDataAsync(program_id, std::move(gymnure_data), GymnureObjDataType::STL);
+    }
+
+    std::shared_future<void> addGltfDataAsync(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        return Engine::Application::addObjDataAsync(program_id, std::move(gymnure_data), GymnureObjDataType::GLTF);
+    }
+
+    std::shared_future<void> addStreamedDataAsync(uint32_t program_id, GymnureObjData&& gymnure_data)
+    {
+        return Engine::Application::addObjDataAsync(program_id, std::move(gymnure_data), GymnureObjDataType::STREAMED);
+    }
+
     void prepare()
     {
         Engine::Application::prepare();
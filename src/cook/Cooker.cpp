@@ -0,0 +1,460 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <Util/Archive.h>
+#include <Util/BlockCompressor.h>
+#include <Util/CookedAsset.h>
+#include <Util/Hash.h>
+#include <Util/Ktx2.h>
+#include <Util/MappedFile.h>
+#include <Util/MeshFile.h>
+#include <Util/MeshOptimizer.h>
+#include <Util/ModelDataLoader.h>
+#include <Util/StreamedMeshFile.h>
+#include <Util/TangentSpace.h>
+#include <Util/ThreadPool.h>
+#include "Cooker.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+namespace Engine::Cook
+{
+    namespace
+    {
+        const char* const MESH_EXTENSIONS[]    = { ".obj", ".fbx", ".ply", ".stl" };
+        const char* const TEXTURE_EXTENSIONS[] = { ".jpg", ".jpeg", ".png", ".tga", ".bmp" };
+
+        // Folders under the assets folder that are not sources.
+        const char* const SKIPPED_FOLDERS[]    = { "cooked", "shaders" };
+
+        template <size_t N>
+        bool contains(const char* const (&list)[N], const std::string& value)
+        {
+            return std::find(std::begin(list), std::end(list), value) != std::end(list);
+        }
+
+        std::string getCookedPath(const CookJob& job)
+        {
+            return Util::CookedAsset::getPath(job.asset_path, job.type == COOK_MESH ? ".gmesh" : ".ktx2");
+        }
+
+        std::string getTempPath(const std::string& path)
+        {
+            return path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        }
+    }
+
+    Cooker::Cooker(const CookOptions& options) : options_(options) {}
+
+    std::string Cooker::getManifestPath()
+    {
+        return std::string(COOKED_FOLDER_PATH_STR) + "/manifest.txt";
+    }
+
+    void Cooker::loadManifest()
+    {
+        // One "<hash> <asset path>" line per cooked source.
+        std::ifstream file(getManifestPath());
+        std::string line;
+        while (std::getline(file, line))
+        {
+            auto separator = line.find(' ');
+            if (separator == std::string::npos)
+                continue;
+
+            manifest_[line.substr(separator + 1)] = std::stoull(line.substr(0, separator), nullptr, 16);
+        }
+    }
+
+    void Cooker::saveManifest()
+    {
+        std::vector<std::pair<std::string, uint64_t>> entries(manifest_.begin(), manifest_.end());
+        std::sort(entries.begin(), entries.end());
+
+        std::ostringstream stream;
+        for (const auto& [path, hash] : entries)
+            stream << std::hex << std::setw(16) << std::setfill('0') << hash << ' ' << path << '\n';
+
+        auto temp_path = getTempPath(getManifestPath());
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            file << stream.str();
+        }
+        if (!commit(temp_path, getManifestPath()))
+            log("Cannot write manifest: " + getManifestPath());
+    }
+
+    std::vector<CookJob> Cooker::collectJobs()
+    {
+        namespace fs = std::filesystem;
+
+        std::vector<CookJob> jobs = {};
+        fs::path assets_folder = ASSETS_FOLDER_PATH_STR;
+
+        std::error_code error;
+        for (auto it = fs::recursive_directory_iterator(assets_folder, error); it != fs::recursive_directory_iterator(); it.increment(error))
+        {
+            if (error)
+                break;
+
+            if (it->is_directory()) {
+                if (it.depth() == 0 && contains(SKIPPED_FOLDERS, it->path().filename().string()))
+                    it.disable_recursion_pending();
+                continue;
+            }
+
+            std::string extension = it->path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+
+            CookJob job = {};
+            job.asset_path = fs::relative(it->path(), assets_folder).generic_string();
+
+            if (contains(MESH_EXTENSIONS, extension))
+                job.type = COOK_MESH;
+            else if (contains(TEXTURE_EXTENSIONS, extension))
+                job.type = COOK_TEXTURE;
+            else
+                continue;
+
+            job.dependencies = findDependencies(job);
+            jobs.push_back(std::move(job));
+        }
+
+        // Biggest sources first, so the pool does not end up waiting on a single late mesh.
+        std::vector<uintmax_t> sizes(jobs.size());
+        for (size_t i = 0; i < jobs.size(); ++i)
+            sizes[i] = fs::file_size(assets_folder / jobs[i].asset_path, error);
+
+        std::vector<size_t> order(jobs.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+        std::vector<CookJob> sorted_jobs = {};
+        sorted_jobs.reserve(jobs.size());
+        for (size_t i : order)
+            sorted_jobs.push_back(std::move(jobs[i]));
+
+        return sorted_jobs;
+    }
+
+    std::vector<std::string> Cooker::findDependencies(const CookJob& job)
+    {
+        std::vector<std::string> dependencies = {};
+
+        std::string extension = std::filesystem::path(job.asset_path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (job.type != COOK_MESH || extension != ".obj")
+            return dependencies;
+
+        // Material libraries, resolved next to the obj like ModelDataLoader::LoadModelData does.
+        Util::MappedFile file(std::string(ASSETS_FOLDER_PATH_STR) + "/" + job.asset_path);
+        if (!file.isOpen())
+            return dependencies;
+
+        std::string folder = std::filesystem::path(job.asset_path).parent_path().generic_string();
+        std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+
+        size_t line_start = 0;
+        while (line_start < text.size())
+        {
+            size_t line_end = text.find('\n', line_start);
+            if (line_end == std::string_view::npos)
+                line_end = text.size();
+
+            std::string_view line = text.substr(line_start, line_end - line_start);
+            if (line.substr(0, 7) == "mtllib ")
+            {
+                std::string name(line.substr(7));
+                while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back())))
+                    name.pop_back();
+
+                dependencies.push_back(folder.empty() ? name : folder + "/" + name);
+            }
+
+            line_start = line_end + 1;
+        }
+
+        return dependencies;
+    }
+
+    uint64_t Cooker::hashJob(const CookJob& job)
+    {
+        uint64_t hash = Util::Hash::mix(Util::Hash::FNV_OFFSET, VERSION);
+        hash = Util::Hash::mix(hash, job.type == COOK_MESH ? Util::MeshFile::VERSION : 0);
+        hash = Util::Hash::mix(hash, job.type == COOK_MESH ? Util::StreamedMeshFile::VERSION : 0);
+
+        std::vector<std::string> sources = {job.asset_path};
+        sources.insert(sources.end(), job.dependencies.begin(), job.dependencies.end());
+
+        for (const auto& source : sources)
+        {
+            // Missing dependencies still count, by name, so adding them later triggers a cook.
+            hash = Util::Hash::fnv1a(source.data(), source.size(), hash);
+
+            Util::MappedFile file(std::string(ASSETS_FOLDER_PATH_STR) + "/" + source);
+            if (file.isOpen())
+                hash = Util::Hash::fnv1a(file.data(), file.size(), hash);
+        }
+
+        return hash;
+    }
+
+    void Cooker::optimizeMesh(Mesh& mesh)
+    {
+        auto& vertices = *mesh.vertexData;
+        auto& indices  = *mesh.indexData;
+
+        mesh.bounds = Util::MeshOptimizer::computeBounds(vertices);
+        Util::MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+
+        mesh.lods.clear();
+        float diagonal = glm::length(mesh.bounds.max - mesh.bounds.min);
+        size_t previous_count = indices.size();
+
+        for (uint32_t grid_size : LOD_GRID_SIZES)
+        {
+            auto lod = Util::MeshOptimizer::simplifyClustered(vertices, indices, mesh.bounds, grid_size);
+            if (lod.empty() || static_cast<float>(lod.size()) > static_cast<float>(previous_count) * LOD_MIN_REDUCTION)
+                continue;
+
+            Util::MeshOptimizer::optimizeVertexCache(lod, vertices.size());
+            previous_count = lod.size();
+
+            // Clustering moves a vertex at most one cell diagonal away.
+            mesh.lods.push_back(MeshLod{std::make_shared<std::vector<uint32_t>>(std::move(lod)), diagonal / static_cast<float>(grid_size)});
+        }
+
+        std::vector<std::vector<uint32_t>*> index_lists = {&indices};
+        for (auto& lod : mesh.lods)
+            index_lists.push_back(lod.indexData.get());
+
+        Util::MeshOptimizer::optimizeVertexFetch(vertices, index_lists);
+    }
+
+    bool Cooker::cookMesh(const CookJob& job)
+    {
+        auto model = Util::ModelDataLoader::LoadModelData(job.asset_path);
+        if (model == nullptr || model->meshes == nullptr)
+            return false;
+
+        auto& meshes = *model->meshes;
+        Util::ThreadPool::getInstance()->parallelFor(meshes.size(), [&meshes](size_t i)
+        {
+            auto& mesh = meshes[i];
+            if (mesh->vertexData == nullptr)
+                mesh->vertexData = std::make_shared<std::vector<VertexData>>();
+
+            if (mesh->indexData == nullptr) {
+                mesh->indexData = std::make_shared<std::vector<uint32_t>>(mesh->vertexData->size());
+                for (uint32_t v = 0; v < mesh->indexData->size(); ++v)
+                    (*mesh->indexData)[v] = v;
+            }
+
+            optimizeMesh(*mesh);
+        });
+
+        auto cooked_path = getCookedPath(job);
+        auto temp_path = getTempPath(cooked_path);
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(cooked_path).parent_path(), error);
+
+        if (!Util::MeshFile::write(temp_path, *model) || !commit(temp_path, cooked_path))
+            return false;
+
+        size_t triangle_count = 0;
+        for (const auto& mesh : meshes)
+            triangle_count += mesh->indexData->size() / 3;
+
+        // A model that shrank under the threshold must not keep streaming its old geometry.
+        auto streamed_path = Util::CookedAsset::getPath(job.asset_path, ".gstream");
+        if (triangle_count < STREAMING_MIN_TRIANGLES) {
+            std::filesystem::remove(streamed_path, error);
+            return true;
+        }
+
+        temp_path = getTempPath(streamed_path);
+        return Util::StreamedMeshFile::write(temp_path, *model) && commit(temp_path, streamed_path);
+    }
+
+    bool Cooker::cookTexture(const CookJob& job)
+    {
+        int width, height, channels;
+        auto source_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + job.asset_path;
+        stbi_uc* pixels = stbi_load(source_path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (pixels == nullptr)
+            return false;
+
+        auto image = Util::BlockCompressor::encodeMipChain(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+        stbi_image_free(pixels);
+
+        auto cooked_path = getCookedPath(job);
+        auto temp_path = getTempPath(cooked_path);
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(cooked_path).parent_path(), error);
+
+        return Util::Ktx2::write(temp_path, image) && commit(temp_path, cooked_path);
+    }
+
+    bool Cooker::pack(const std::vector<CookJob>& jobs)
+    {
+        std::vector<Util::ArchiveSource> sources = {};
+        for (const auto& job : jobs)
+        {
+            if (manifest_.find(job.asset_path) == manifest_.end())
+                continue;
+
+            auto name = Util::CookedAsset::getArchiveName(job.asset_path, job.type == COOK_MESH ? ".gmesh" : ".ktx2");
+            sources.push_back(Util::ArchiveSource{name, getCookedPath(job)});
+        }
+
+        auto archive_path = std::string(COOKED_FOLDER_PATH_STR) + "/assets.gpak";
+        auto temp_path = getTempPath(archive_path);
+        if (!Util::Archive::write(temp_path, sources, options_.compress) || !commit(temp_path, archive_path))
+            return false;
+
+        log("Packed " + std::to_string(sources.size()) + " files into " + archive_path);
+        return true;
+    }
+
+    bool Cooker::commit(const std::string& temp_path, const std::string& path)
+    {
+        // The engine may read cooked files while we cook, never let it see a partial one.
+        std::error_code error;
+        std::filesystem::rename(temp_path, path, error);
+        if (error)
+            std::filesystem::remove(temp_path, error);
+
+        return !error;
+    }
+
+    void Cooker::log(const std::string& message)
+    {
+        static std::mutex log_mutex;
+        std::lock_guard<std::mutex> lock(log_mutex);
+        std::cout << message << std::endl;
+    }
+
+    uint32_t Cooker::run()
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::error_code error;
+        std::filesystem::create_directories(COOKED_FOLDER_PATH_STR, error);
+
+        if (!options_.force)
+            loadManifest();
+
+        auto jobs = collectJobs();
+
+        std::atomic<uint32_t> cooked = 0;
+        std::atomic<uint32_t> failed = 0;
+
+        Util::ThreadPool::getInstance()->parallelFor(jobs.size(), [this, &jobs, &cooked, &failed](size_t i)
+        {
+            auto& job = jobs[i];
+            job.hash = hashJob(job);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto entry = manifest_.find(job.asset_path);
+                if (entry != manifest_.end() && entry->second == job.hash && std::filesystem::exists(getCookedPath(job)))
+                    return;
+            }
+
+            bool success = job.type == COOK_MESH ? cookMesh(job) : cookTexture(job);
+            log((success ? "Cooked " : "Failed to cook ") + job.asset_path);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (success) {
+                manifest_[job.asset_path] = job.hash;
+                ++cooked;
+            } else {
+                manifest_.erase(job.asset_path);
+                ++failed;
+            }
+        });
+
+        // Forget sources that are gone.
+        std::unordered_map<std::string, uint64_t> manifest = {};
+        for (const auto& job : jobs) {
+            auto entry = manifest_.find(job.asset_path);
+            if (entry != manifest_.end())
+                manifest.insert(*entry);
+        }
+        manifest_ = std::move(manifest);
+        saveManifest();
+
+        if (options_.pack && !pack(jobs)) {
+            log("Cannot write asset archive");
+            ++failed;
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        log(std::to_string(cooked.load()) + " cooked, " + std::to_string(jobs.size() - cooked - failed) + " up to date, " +
+            std::to_string(failed.load()) + " failed in " + std::to_string(std::chrono::duration<double>(end - start).count()) + "s");
+
+        return failed;
+    }
+
+    void Cooker::benchmarkTangentSpace(size_t triangle_count)
+    {
+        auto side = static_cast<uint32_t>(std::max(1.0, std::sqrt(static_cast<double>(triangle_count) / 2.0)));
+
+        Mesh source = {};
+        source.vertexData = std::make_shared<std::vector<VertexData>>();
+        source.indexData  = std::make_shared<std::vector<uint32_t>>();
+        source.vertexData->reserve(static_cast<size_t>(side + 1) * (side + 1));
+        source.indexData->reserve(static_cast<size_t>(side) * side * 6);
+
+        // Wavy grid, u mirrored around the middle column.
+        for (uint32_t y = 0; y <= side; ++y)
+            for (uint32_t x = 0; x <= side; ++x) {
+                float fx = static_cast<float>(x) / side, fy = static_cast<float>(y) / side;
+                glm::vec3 pos = glm::vec3(fx, 0.05f * std::sin(fx * 40.0f) * std::cos(fy * 40.0f), fy);
+                source.vertexData->push_back({ pos, glm::vec2(std::abs(fx - 0.5f), fy), glm::vec3(0.0f), glm::vec4(1.0f) });
+            }
+
+        for (uint32_t y = 0; y < side; ++y)
+            for (uint32_t x = 0; x < side; ++x) {
+                uint32_t i = y * (side + 1) + x;
+                source.indexData->insert(source.indexData->end(), { i, i + side + 1, i + 1, i + 1, i + side + 1, i + side + 2 });
+            }
+
+        log("TangentSpace on " + std::to_string(source.indexData->size() / 3) + " triangles, " + std::to_string(source.vertexData->size()) +
+            " vertices, " + std::to_string(Util::ThreadPool::getInstance()->getThreadCount() + 1) + " threads (best of 5):");
+
+        double normals_ms = 1e30, tangents_ms = 1e30;
+        size_t vertex_count = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            Mesh mesh = {};
+            mesh.vertexData = std::make_shared<std::vector<VertexData>>(*source.vertexData);
+            mesh.indexData  = std::make_shared<std::vector<uint32_t>>(*source.indexData);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            Util::TangentSpace::generateNormals(mesh);
+            auto middle = std::chrono::high_resolution_clock::now();
+            Util::TangentSpace::generateTangents(mesh);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            normals_ms  = std::min(normals_ms, std::chrono::duration<double, std::milli>(middle - start).count());
+            tangents_ms = std::min(tangents_ms, std::chrono::duration<double, std::milli>(end - middle).count());
+            vertex_count = mesh.vertexData->size();
+        }
+
+        double million_triangles = static_cast<double>(source.indexData->size() / 3) / 1e6;
+        log("  normals:  " + std::to_string(normals_ms) + "ms (" + std::to_string(million_triangles / normals_ms * 1e3) + " Mtri/s)");
+        log("  tangents: " + std::to_string(tangents_ms) + "ms (" + std::to_string(million_triangles / tangents_ms * 1e3) + " Mtri/s), " +
+            std::to_string(vertex_count - source.vertexData->size()) + " vertices split");
+    }
+}
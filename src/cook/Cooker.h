@@ -0,0 +1,92 @@
+#ifndef GYMNURE_COOKER_H
+#define GYMNURE_COOKER_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <Util/ModelData.hpp>
+
+namespace Engine::Cook
+{
+    enum CookJobType
+    {
+        COOK_MESH,
+        COOK_TEXTURE,
+    };
+
+    struct CookJob
+    {
+        CookJobType                 type         = COOK_MESH;
+        std::string                 asset_path   = {};  // Relative to the assets folder.
+        std::vector<std::string>    dependencies = {};  // Other sources read by the job (obj material libraries).
+        uint64_t                    hash         = 0;
+    };
+
+    struct CookOptions
+    {
+        bool force      = false;    // Ignore the manifest, cook everything again.
+        bool pack       = false;    // Also pack every cooked file into the asset archive (assets.gpak).
+        bool compress   = false;    // LZ4 archive entries that shrink enough. Compressed entries are copied on load.
+    };
+
+    /**
+     * Turns the sources of ASSETS_FOLDER_PATH_STR into engine ready files under COOKED_FOLDER_PATH_STR:
+     * meshes into .gmesh (optimized, quantized, with LODs) and images into BC compressed .ktx2. Models of at least
+     * STREAMING_MIN_TRIANGLES also get a .gstream (see Util::StreamedMeshFile), read in place so never packed.
+     *
+     * A manifest keeps the content hash of every cooked source, unchanged sources are skipped.
+     * */
+    class Cooker
+    {
+
+    private:
+
+        // Bump when the output of a job changes for the same input.
+        static constexpr uint64_t VERSION = 2;
+
+        // LOD grids, from finest to coarsest. A LOD is kept only when it drops enough triangles.
+        static constexpr uint32_t LOD_GRID_SIZES[] = { 256, 64, 16 };
+        static constexpr float    LOD_MIN_REDUCTION = 0.75f;
+
+        static constexpr size_t   STREAMING_MIN_TRIANGLES = 1 << 20;
+
+        CookOptions                                 options_;
+
+        std::unordered_map<std::string, uint64_t>   manifest_   = {};
+        std::mutex                                  mutex_      = {};
+
+        static std::string getManifestPath();
+        void loadManifest();
+        void saveManifest();
+
+        static std::vector<CookJob> collectJobs();
+        static std::vector<std::string> findDependencies(const CookJob& job);
+        static uint64_t hashJob(const CookJob& job);
+
+        static bool cookMesh(const CookJob& job);
+        static bool cookTexture(const CookJob& job);
+
+        static void optimizeMesh(Mesh& mesh);
+        bool pack(const std::vector<CookJob>& jobs);
+
+        static bool commit(const std::string& temp_path, const std::string& path);
+        static void log(const std::string& message);
+
+    public:
+
+        explicit Cooker(const CookOptions& options);
+
+        /**
+         * Cook every stale source. Returns the number of failed jobs.
+         * */
+        uint32_t run();
+
+        /**
+         * Time TangentSpace on a generated grid of about 'triangle_count' triangles, with a UV mirror seam.
+         * */
+        static void benchmarkTangentSpace(size_t triangle_count);
+    };
+}
+
+#endif //GYMNURE_COOKER_H
@@ -0,0 +1,35 @@
+#include <string>
+#include <iostream>
+#include "Cooker.h"
+
+/**
+ * gymnure_cook [--force] [--pack] [--compress]
+ * Cooks the assets folder the engine was built with, see Engine::Cook::CookOptions for the flags.
+ *
+ * gymnure_cook --benchmark-tangents [triangle_count]
+ * Times normal and tangent generation instead (4 million triangles by default).
+ * */
+int main(int argc, char** argv)
+{
+    Engine::Cook::CookOptions options = {};
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--force") {
+            options.force = true;
+        } else if (arg == "--pack") {
+            options.pack = true;
+        } else if (arg == "--compress") {
+            options.compress = true;
+        } else if (arg == "--benchmark-tangents") {
+            Engine::Cook::Cooker::benchmarkTangentSpace(i + 1 < argc ? std::stoull(argv[i + 1]) : 4'000'000);
+            return 0;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--force] [--pack] [--compress] | --benchmark-tangents [triangle_count]" << std::endl;
+            return 2;
+        }
+    }
+
+    Engine::Cook::Cooker cooker(options);
+    return cooker.run() == 0 ? 0 : 1;
+}
@@ -3,14 +3,24 @@
 #include <Util/Debug.hpp>
 #include <RenderPass/Queue.h>
 #include <Util/Layers.h>
+#include <Util/ThreadPool.h>
+#include <Util/PipelineCache.h>
+#include <GraphicsPipeline/ShaderModuleCache.h>
+#include <Descriptors/TextureStreamer.h>
 
 namespace Engine
 {
     std::shared_ptr<Descriptors::Camera>                    Application::main_camera = nullptr;
+    std::shared_ptr<Descriptors::Lights>                    Application::lights_ = nullptr;
+    std::shared_ptr<Descriptors::LightClusters>             Application::light_clusters_ = nullptr;
 
+    std::unique_ptr<GraphicsPipeline::RenderGraph>          Application::render_graph_ = nullptr;
     std::unique_ptr<GraphicsPipeline::Forward>              Application::forward_pipeline_ = nullptr;
     std::unique_ptr<GraphicsPipeline::Deferred>             Application::deferred_pipeline_ = nullptr;
+    std::unique_ptr<GraphicsPipeline::Visibility>           Application::visibility_pipeline_ = nullptr;
     std::vector<ProgramPipeline>                            Application::programs_ = {};
+    std::vector<Application::PendingLoad>                   Application::pending_loads_ = {};
+    bool                                                    Application::prepared_ = false;
 
     void Application::create(const std::vector<const char *>& instance_extension_names)
     {
@@ -42,17 +52,35 @@ namespace Engine
         return main_camera;
     }
 
+    std::shared_ptr<Descriptors::Lights> Application::getLights()
+    {
+        return lights_;
+    }
+
     void Application::destroy()
     {
         auto app_data = ApplicationData::data;
 
+        // Workers do not touch the device, just let them finish.
+        for (auto& pending_load : pending_loads_)
+            pending_load.load_data.wait();
+        pending_loads_.clear();
+
         app_data->device.waitIdle();
         forward_pipeline_.reset();
         deferred_pipeline_.reset();
+        visibility_pipeline_.reset();
+        light_clusters_.reset();
+        render_graph_.reset();
         RenderPass::SwapChain::reset();
+        if(!Util::PipelineCache::save(app_data->pipeline_cache))
+            Debug::logInfo("Could not write the pipeline cache to " + Util::PipelineCache::getDefaultPath() + ".");
+        app_data->device.destroyPipelineCache(app_data->pipeline_cache);
+        GraphicsPipeline::ShaderModuleCache::clear();
         if(app_data->surface)
             app_data->instance.destroySurfaceKHR(app_data->surface, nullptr);
         main_camera.reset();
+        lights_.reset();
         app_data->device.destroyCommandPool(app_data->graphic_command_pool, nullptr);
         app_data->device.destroy();
         Debug::destroy();
@@ -61,21 +89,74 @@ namespace Engine
 
     void Application::draw()
     {
+        if(!pending_loads_.empty())
+            uploadFinishedLoads();
+
+        // Streamed geometry uploads and texture level requests, before the frames drawing them.
         if(forward_pipeline_ != nullptr)
-            forward_pipeline_->render();
+            forward_pipeline_->update(*main_camera);
 
         if(deferred_pipeline_ != nullptr)
-            deferred_pipeline_->render();
+            deferred_pipeline_->update(*main_camera);
+
+        if(visibility_pipeline_ != nullptr)
+            visibility_pipeline_->update(*main_camera);
+
+        // New texture levels are new images: objects using them switch to their spare descriptor sets and command
+        // buffers are recorded again as they become free. Only once the previous swap reached every buffer, so the
+        // spare sets and replaced images are no longer bound by a pending one.
+        auto texture_streamer = Descriptors::TextureStreamer::getInstance();
+        bool loads_ready = texture_streamer->update();
+        if(prepared_ && render_graph_->isRecordCurrent()) {
+            texture_streamer->releaseRetired();
+
+            if(loads_ready) {
+                texture_streamer->applyLoads();
+
+                bool rebound = forward_pipeline_ != nullptr && forward_pipeline_->updateTextures();
+                rebound = (deferred_pipeline_ != nullptr && deferred_pipeline_->updateTextures()) || rebound;
+                rebound = (visibility_pipeline_ != nullptr && visibility_pipeline_->updateTextures()) || rebound;
+                if(rebound)
+                    render_graph_->invalidateRecords();
+            }
+        }
+
+        // Pipelines built in the background only change what is bound, record again as buffers become free.
+        if(ApplicationData::data->async_pipelines && prepared_) {
+            bool new_pipelines = forward_pipeline_ != nullptr && forward_pipeline_->updatePipelines();
+            new_pipelines = (deferred_pipeline_ != nullptr && deferred_pipeline_->updatePipelines()) || new_pipelines;
+            if(new_pipelines)
+                render_graph_->invalidateRecords();
+        }
+
+        // Lights are read from storage buffers, moving them needs no recording. Each frame reads its own copy,
+        // written once the GPU is done with it. Froxels are assigned once for every pipeline reading them.
+        bool clustered = forward_pipeline_ != nullptr || visibility_pipeline_ != nullptr;
+        render_graph_->execute([clustered](uint32_t frame) {
+            if(clustered)
+                light_clusters_->update(*main_camera, frame);
+
+            lights_->update(frame);
+        });
     }
 
     void Application::prepare()
     {
-        // Prepare pipelines
-        if(forward_pipeline_ != nullptr)
-            forward_pipeline_->prepare(main_camera);
+        render_graph_->reset();
 
+        // Deferred lighting first, forward objects and the interface are drawn over it.
         if(deferred_pipeline_ != nullptr)
-            deferred_pipeline_->prepare(main_camera);
+            deferred_pipeline_->prepare(main_camera, lights_, *render_graph_);
+
+        if(visibility_pipeline_ != nullptr)
+            visibility_pipeline_->prepare(main_camera, *render_graph_);
+
+        if(forward_pipeline_ != nullptr)
+            forward_pipeline_->prepare(main_camera, *render_graph_);
+
+        render_graph_->compile();
+
+        prepared_ = true;
     }
 
     void Application::setupSurface(const uint32_t& width, const uint32_t& height)
@@ -148,24 +229,58 @@ namespace Engine
         std::vector<const char *> device_extension_names;
         device_extension_names.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
+        // Visibility buffer shading picks the texture of each pixel in an array, when available.
+        vk::PhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features = {};
+        for (const vk::ExtensionProperties& extension : app_data->gpu.enumerateDeviceExtensionProperties())
+        {
+            if (std::string(extension.extensionName) != VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)
+                continue;
+
+            vk::PhysicalDeviceDescriptorIndexingFeaturesEXT supported_indexing = {};
+            vk::PhysicalDeviceFeatures2 supported_features2 = {};
+            supported_features2.pNext = &supported_indexing;
+            app_data->gpu.getFeatures2(&supported_features2);
+
+            indexing_features.shaderSampledImageArrayNonUniformIndexing = supported_indexing.shaderSampledImageArrayNonUniformIndexing;
+            if (indexing_features.shaderSampledImageArrayNonUniformIndexing == VK_TRUE)
+                device_extension_names.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        }
+        app_data->descriptor_indexing = indexing_features.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+
         vk::DeviceCreateInfo device_info = {};
-        device_info.pNext 					= nullptr;
+        device_info.pNext 					= app_data->descriptor_indexing ? &indexing_features : nullptr;
         device_info.queueCreateInfoCount 	= 1;
         device_info.pQueueCreateInfos 		= &queue_info;
         device_info.enabledExtensionCount 	= (uint32_t)device_extension_names.size();
         device_info.ppEnabledExtensionNames = device_info.enabledExtensionCount ? device_extension_names.data() : nullptr;
         device_info.enabledLayerCount 		= 0;
         device_info.ppEnabledLayerNames 	= nullptr;
-        device_info.pEnabledFeatures 		= nullptr;
+        // BC textures are used when available, RGBA8 otherwise.
+        vk::PhysicalDeviceFeatures supported_features = app_data->gpu.getFeatures();
+        vk::PhysicalDeviceFeatures enabled_features = {};
+        enabled_features.textureCompressionBC = supported_features.textureCompressionBC;
+        app_data->texture_compression_bc = enabled_features.textureCompressionBC == VK_TRUE;
+        // Streamed geometry draws all its slots with one indirect draw when available.
+        enabled_features.multiDrawIndirect = supported_features.multiDrawIndirect;
+        app_data->multi_draw_indirect = enabled_features.multiDrawIndirect == VK_TRUE;
+        // Fragment shaders read gl_PrimitiveID to write the visibility buffer.
+        enabled_features.geometryShader = supported_features.geometryShader;
+        app_data->visibility_buffer = app_data->descriptor_indexing && enabled_features.geometryShader == VK_TRUE;
+
+        device_info.pEnabledFeatures 		= &enabled_features;
 
         app_data->device = app_data->gpu.createDevice(device_info);
 
         vk::CommandPoolCreateInfo cmd_pool_info = {};
         cmd_pool_info.pNext 			= nullptr;
+        cmd_pool_info.flags             = vk::CommandPoolCreateFlagBits::eResetCommandBuffer; // Re-recorded when async loads finish.
         cmd_pool_info.queueFamilyIndex  = queueGraphicFamilyIndex;
 
         app_data->graphic_command_pool = app_data->device.createCommandPool(cmd_pool_info);
 
+        // Warm starts skip compiling the pipelines of the previous run.
+        app_data->pipeline_cache = Util::PipelineCache::load();
+
         app_data->view_width  = width;
         app_data->view_height = height;
 
@@ -173,6 +288,14 @@ namespace Engine
         main_camera = std::make_shared<Descriptors::Camera>(app_data->view_width, app_data->view_height);
 
         Engine::RenderPass::Queue::LoadQueues();
+
+        render_graph_ = std::make_unique<GraphicsPipeline::RenderGraph>();
+
+        // The scene lights, red and green. A copy per frame in flight, written once its frame is done.
+        lights_ = std::make_shared<Descriptors::Lights>(render_graph_->getFrameCount());
+        lights_->add({glm::vec4(-3.f, 5.f, -3.f, 50.f), glm::vec4(1.f, 0.f, 0.f, 100.f)});
+        lights_->add({glm::vec4(3.f, 3.f, 3.f, 50.f), glm::vec4(0.f, 1.f, 0.f, 100.f)});
+        light_clusters_ = std::make_shared<Descriptors::LightClusters>(lights_, render_graph_->getFrameCount());
     }
 
     void Application::addObjData(uint32_t program_id, GymnureObjData&& data, const GymnureObjDataType& type)
@@ -184,26 +307,96 @@ namespace Engine
             forward_pipeline_->addObjData(program_id, std::move(data), type);
         else if(programs_[program_id] == DEFERRED)
             deferred_pipeline_->addObjData(program_id, std::move(data), type);
+        else if(programs_[program_id] == VISIBILITY)
+            visibility_pipeline_->addObjData(std::move(data), type);
+        else Debug::logErrorAndDie("invalid program type!");
+    }
+
+    std::shared_future<void> Application::addObjDataAsync(uint32_t program_id, GymnureObjData&& data, const GymnureObjDataType& type)
+    {
+        if(programs_.size() <= program_id) { Debug::logErrorAndDie("invalid program_id!"); }
+
+        bool build_meshlets = programs_[program_id] == FORWARD && forward_pipeline_->usesMeshletCulling(program_id);
+
+        PendingLoad pending_load = {};
+        pending_load.program_id = program_id;
+        pending_load.load_data = Util::ThreadPool::getInstance()->submit([data = std::move(data), type, build_meshlets]() mutable {
+            return Programs::Program::loadObjData(std::move(data), type, build_meshlets);
+        });
+
+        std::shared_future<void> uploaded = pending_load.uploaded.get_future().share();
+        pending_loads_.push_back(std::move(pending_load));
+
+        return uploaded;
+    }
+
+    void Application::uploadObjData(uint32_t program_id, std::vector<Programs::ObjectLoadData>&& load_data)
+    {
+        if(programs_[program_id] == FORWARD)
+            forward_pipeline_->uploadObjData(program_id, std::move(load_data));
+        else if(programs_[program_id] == DEFERRED)
+            deferred_pipeline_->uploadObjData(program_id, std::move(load_data));
+        else if(programs_[program_id] == VISIBILITY)
+            visibility_pipeline_->uploadObjData(std::move(load_data));
         else Debug::logErrorAndDie("invalid program type!");
     }
 
+    void Application::uploadFinishedLoads()
+    {
+        bool uploaded = false;
+
+        for (auto it = pending_loads_.begin(); it != pending_loads_.end();)
+        {
+            if(it->load_data.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            try {
+                uploadObjData(it->program_id, it->load_data.get());
+                it->uploaded.set_value();
+                uploaded = true;
+            } catch (...) {
+                // Loader errors are handed to whoever waits on the load.
+                it->uploaded.set_exception(std::current_exception());
+            }
+
+            it = pending_loads_.erase(it);
+        }
+
+        // Command buffers and descriptor sets are recorded once, record them again with the new objects.
+        if(uploaded && prepared_) {
+            ApplicationData::data->device.waitIdle();
+            prepare();
+        }
+    }
+
     void Application::addUiData(uint32_t program_id, const std::vector<ImDrawVert>& vertexData, const std::vector<ImDrawIdx>& indexBuffer)
     {
         forward_pipeline_->addUiData(program_id, vertexData, indexBuffer);
     }
 
-    uint32_t Application::createPhongProgram()
+    uint32_t Application::createPhongProgram(bool quantized_vertices, bool meshlet_culling, const GraphicsPipeline::ShaderVariant& variant)
     {
         if(forward_pipeline_ == nullptr)
-            forward_pipeline_ = std::make_unique<GraphicsPipeline::Forward>();
+            forward_pipeline_ = std::make_unique<GraphicsPipeline::Forward>(*render_graph_, light_clusters_);
 
+        // Diffuse and normal map, then the lights and their froxels as storage buffers, see Descriptors::LightClusters.
         Descriptors::LayoutData ld = {};
-        ld.fragment_texture_count = 1;
+        ld.fragment_texture_count = 2;
         ld.fragment_uniform_count = 1;
+        ld.fragment_storage_buffer_count = 2;
 
-        uint32_t vi_mask = Programs::VertexInputType::POSITION | Programs::VertexInputType::UV | Programs::VertexInputType::NORMAL;
+        Programs::ProgramParams params = {};
+        params.vertex_input         = quantized_vertices ? Vertex::PackedMeshLayout::describe() : Vertex::MeshLayout::describe();
+        params.layout_data          = ld;
+        params.shaders_name         = "phong";
+        params.quantized_vertices   = quantized_vertices;
+        params.meshlet_culling      = meshlet_culling;
+        params.shader_variants      = true;
+        params.variant              = variant;
 
-        uint32_t program_id = forward_pipeline_->createProgram(Programs::ProgramParams{vi_mask, ld, "phong"});
+        uint32_t program_id = forward_pipeline_->createProgram(std::move(params));
 
         if(program_id != programs_.size()) { Debug::logErrorAndDie("invalid program_id!"); }
         programs_.push_back(FORWARD);
@@ -214,15 +407,13 @@ namespace Engine
     uint32_t Application::createInterfaceProgram()
     {
         if(forward_pipeline_ == nullptr)
-            forward_pipeline_ = std::make_unique<GraphicsPipeline::Forward>();
+            forward_pipeline_ = std::make_unique<GraphicsPipeline::Forward>(*render_graph_, light_clusters_);
 
         Descriptors::LayoutData ld = {};
         ld.fragment_texture_count = 1;
         ld.vertex_uniform_count = 1;
 
-        uint32_t vi_mask = Programs::VertexInputType::POSITION | Programs::VertexInputType::UV | Programs::VertexInputType::COLOR;
-
-        uint32_t program_id = forward_pipeline_->createProgram(Programs::ProgramParams{vi_mask, ld, "interface"});
+        uint32_t program_id = forward_pipeline_->createProgram(Programs::ProgramParams{Vertex::UiLayout::describe(), ld, "interface"});
 
         if(program_id != programs_.size()) { Debug::logErrorAndDie("invalid program_id!"); }
         programs_.push_back(FORWARD);
@@ -231,31 +422,35 @@ namespace Engine
     }
 
 
-    uint32_t Application::createDeferredProgram()
+    uint32_t Application::createDeferredProgram(GraphicsPipeline::Deferred::Lighting lighting)
     {
         if(deferred_pipeline_ == nullptr)
-            deferred_pipeline_ = std::make_unique<GraphicsPipeline::Deferred>();
+            deferred_pipeline_ = std::make_unique<GraphicsPipeline::Deferred>(*render_graph_, lighting);
 
-        uint32_t vi_mask = Programs::VertexInputType::POSITION | Programs::VertexInputType::UV | Programs::VertexInputType::NORMAL;
         Descriptors::LayoutData ld = {};
 
         ld.has_model_matrix             = true;
         ld.has_view_projection_matrix   = true;
         ld.fragment_texture_count       = 1;
         ld.fragment_uniform_count       = 1;
-        Programs::ProgramParams mrt = Programs::ProgramParams{vi_mask, ld, "mrt"};
-
-        ld.has_model_matrix             = false;
-        ld.has_view_projection_matrix   = false;
-        ld.fragment_texture_count       = 1;
-        ld.fragment_uniform_count       = 0;
-        Programs::ProgramParams present = Programs::ProgramParams{Programs::VertexInputType::NONE, ld, "deferred"};
 
-        uint32_t program_id = deferred_pipeline_->createProgram(std::move(mrt), std::move(present));
+        uint32_t program_id = deferred_pipeline_->createProgram(Programs::ProgramParams{Vertex::UnmappedMeshLayout::describe(), ld, "mrt"});
 
         if(program_id != programs_.size()) { Debug::logErrorAndDie("invalid program_id!"); }
         programs_.push_back(DEFERRED);
 
         return program_id;
     }
+
+    uint32_t Application::createVisibilityProgram()
+    {
+        if(visibility_pipeline_ == nullptr)
+            visibility_pipeline_ = std::make_unique<GraphicsPipeline::Visibility>(*render_graph_, light_clusters_);
+
+        // Nothing per program, objects of every visibility program are drawn and shaded together.
+        auto program_id = static_cast<uint32_t>(programs_.size());
+        programs_.push_back(VISIBILITY);
+
+        return program_id;
+    }
 }
@@ -1,8 +1,10 @@
 #ifndef GYMNURE_APPLICATION_HPP
 #define GYMNURE_APPLICATION_HPP
 
+#include <future>
 #include <GraphicsPipeline/Forward.hpp>
 #include <GraphicsPipeline/Deferred.hpp>
+#include <GraphicsPipeline/Visibility.hpp>
 
 #define APP_NAME "Gymnure"
 
@@ -11,18 +13,35 @@ namespace Engine
     enum ProgramPipeline
     {
         FORWARD,
-        DEFERRED
+        DEFERRED,
+        VISIBILITY
     };
 
     class Application
     {
     private:
 
+        struct PendingLoad
+        {
+            uint32_t                                                    program_id  = 0;
+            std::future<std::vector<Programs::ObjectLoadData>>          load_data   = {};
+            std::promise<void>                                          uploaded    = {};
+        };
+
         static std::shared_ptr<Descriptors::Camera>                     main_camera;
+        static std::shared_ptr<Descriptors::Lights>                     lights_;
+        static std::shared_ptr<Descriptors::LightClusters>              light_clusters_;    // Shared by forward and visibility shading.
 
+        static std::unique_ptr<GraphicsPipeline::RenderGraph>           render_graph_;
         static std::unique_ptr<GraphicsPipeline::Forward>               forward_pipeline_;
         static std::unique_ptr<GraphicsPipeline::Deferred>              deferred_pipeline_;
+        static std::unique_ptr<GraphicsPipeline::Visibility>            visibility_pipeline_;
         static std::vector<ProgramPipeline>                             programs_;
+        static std::vector<PendingLoad>                                 pending_loads_;
+        static bool                                                     prepared_;
+
+        static void uploadObjData(uint32_t program_id, std::vector<Programs::ObjectLoadData>&& load_data);
+        static void uploadFinishedLoads();
 
     public:
 
@@ -34,11 +53,29 @@ namespace Engine
         static void destroy();
 
         static std::shared_ptr<Descriptors::Camera> getMainCamera();
-        static uint32_t createPhongProgram();
-        static uint32_t createDeferredProgram();
+        static std::shared_ptr<Descriptors::Lights> getLights();
+        /**
+         * 'variant' holds the material keys of every object, texture and normal mapping are dropped for objects
+         * without such textures.
+         * */
+        static uint32_t createPhongProgram(bool quantized_vertices = false, bool meshlet_culling = false,
+                                           const GraphicsPipeline::ShaderVariant& variant = {});
+        /**
+         * Every deferred program shares the lighting of the first one created.
+         * */
+        static uint32_t createDeferredProgram(GraphicsPipeline::Deferred::Lighting lighting = GraphicsPipeline::Deferred::Lighting::TILED);
+        /**
+         * Every visibility program shares the same merged geometry, needs ApplicationData::visibility_buffer.
+         * */
+        static uint32_t createVisibilityProgram();
         static uint32_t createInterfaceProgram();
 
         static void addObjData(uint32_t, GymnureObjData&&, const GymnureObjDataType& type);
+        /**
+         * Parse and decode on worker threads, upload on the render thread during draw().
+         * The returned future is ready once the object is part of the scene.
+         * */
+        static std::shared_future<void> addObjDataAsync(uint32_t, GymnureObjData&&, const GymnureObjDataType& type);
         static void addUiData(uint32_t program_id, const std::vector<ImDrawVert>& vertexData, const std::vector<ImDrawIdx>& indexBuffer);
     };
 
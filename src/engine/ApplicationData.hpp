@@ -19,6 +19,12 @@ namespace Engine
         vk::Device 								device;
         vk::PhysicalDevice                      gpu;
         vk::CommandPool                         graphic_command_pool;
+        vk::PipelineCache                       pipeline_cache;         // Shared by every pipeline, see Util::PipelineCache.
+        bool                                    texture_compression_bc = false;
+        bool                                    multi_draw_indirect = false;
+        bool                                    descriptor_indexing = false;
+        bool                                    visibility_buffer = false;
+        bool                                    async_pipelines = false;    // Draw without variants still compiling.
 
         vk::Queue                               transfer_queue;
         uint32_t							 	queue_family_count;
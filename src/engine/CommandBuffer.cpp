@@ -1,4 +1,3 @@
-#include <RenderPass/FrameBuffer.h>
 #include "CommandBuffer.h"
 
 namespace Engine
@@ -22,64 +21,102 @@ namespace Engine
         app_data->device.freeCommandBuffers(app_data->graphic_command_pool, {command_buffer_});
     }
 
-    void CommandBuffer::bindGraphicCommandBuffer(
-        std::vector<vk::ClearValue> clear_values,
-        const std::shared_ptr<RenderPass::RenderPass>& render_pass,
-        const std::shared_ptr<RenderPass::FrameBuffer>& frame_buffer,
-        const std::vector<std::shared_ptr<Programs::Program>>& programs)
+    void CommandBuffer::begin() const
     {
-        uint32_t width = ApplicationData::data->view_width;
-        uint32_t height = ApplicationData::data->view_height;
-
-        size_t dynamicAlignment = Memory::Memory::getDynamicAlignment<glm::mat4>();
-
         vk::CommandBufferBeginInfo cmd_buf_info = {};
         cmd_buf_info.pNext 				= nullptr;
         cmd_buf_info.flags 				= vk::CommandBufferUsageFlagBits::eSimultaneousUse;
         cmd_buf_info.pInheritanceInfo 	= nullptr;
 
-        vk::RenderPassBeginInfo rp_begin = {};
-        rp_begin.pNext 				= nullptr;
-        rp_begin.renderPass 		= render_pass->getRenderPass();
-        rp_begin.renderArea.offset 	= vk::Offset2D{0, 0};
-        rp_begin.renderArea.extent  = vk::Extent2D{width, height};
-        rp_begin.clearValueCount 	= static_cast<uint32_t>(clear_values.size());
-        rp_begin.pClearValues 		= clear_values.data();
-
         command_buffer_.begin(cmd_buf_info);
+    }
 
-        rp_begin.setFramebuffer(frame_buffer->getFrameBufferKHR());
-        command_buffer_.beginRenderPass(rp_begin, vk::SubpassContents::eInline);
+    void CommandBuffer::end() const
+    {
+        command_buffer_.end();
+    }
+
+    void CommandBuffer::recordCulling(vk::CommandBuffer command_buffer, const std::vector<std::shared_ptr<Programs::Program>>& programs)
+    {
+        // Culling writes the indices drawn later, it can not run inside the render pass.
+        for(auto& program_obj : programs)
+        {
+            auto program_data = program_obj->getProgramsData();
+            if(program_data->meshlet_culling == nullptr)
+                continue;
+
+            std::vector<std::shared_ptr<GraphicsPipeline::MeshletDrawData>> draw_data = {};
+            for(auto &data : program_data->objects_data)
+                if(data->meshlet_draw != nullptr)
+                    draw_data.push_back(data->meshlet_draw);
+
+            program_data->meshlet_culling->recordCulling(command_buffer, draw_data);
+        }
+    }
+
+    void CommandBuffer::recordDraws(vk::CommandBuffer command_buffer, const std::vector<std::shared_ptr<Programs::Program>>& programs, uint32_t frame)
+    {
+        uint32_t width = ApplicationData::data->view_width;
+        uint32_t height = ApplicationData::data->view_height;
+
+        size_t dynamicAlignment = Memory::Memory::getDynamicAlignment<glm::mat4>();
 
         for(auto& program_obj : programs)
         {
             auto program_data = program_obj->getProgramsData();
             vk::PipelineLayout pl = program_data->descriptor_layout->getPipelineLayout();
+            bool has_vertex_dequantization = program_data->descriptor_layout->getLayoutData()->has_vertex_dequantization;
+            const std::vector<Vertex::VertexStream>& vertex_streams = program_data->vertex_input.streams;
+            std::vector<uint32_t> frame_offsets = program_obj->getFrameOffsets(frame);
 
             uint32_t j = 0;
             for(auto &data : program_data->objects_data)
             {
                 uint32_t dynamicOffset = (j++) * static_cast<uint32_t>(dynamicAlignment);
 
-                Util::Util::initViewport(command_buffer_, width, height);
-                Util::Util::initScissor(command_buffer_, width, height);
+                // Its pipeline is still compiling, see Program::updatePipelines().
+                if(!data->pipeline)
+                    continue;
+
+                Util::Util::initViewport(command_buffer, width, height);
+                Util::Util::initScissor(command_buffer, width, height);
 
-                command_buffer_.bindPipeline(vk::PipelineBindPoint::eGraphics, program_data->graphic_pipeline->getPipeline());
-                command_buffer_.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pl, 0, {data->descriptor_set}, {dynamicOffset});
-                command_buffer_.bindVertexBuffers(0, {data->vertex_buffer->getVertexBuffer()}, {0});
+                command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, data->pipeline);
+                // In binding order: the model matrix, then the storage buffers of the frame.
+                std::vector<uint32_t> dynamic_offsets = {dynamicOffset};
+                dynamic_offsets.insert(dynamic_offsets.end(), frame_offsets.begin(), frame_offsets.end());
+                command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pl, 0, {data->descriptor_set}, dynamic_offsets);
+
+                if(data->streamed_geometry != nullptr) {
+                    command_buffer.pushConstants(pl, vk::ShaderStageFlagBits::eVertex, 0, sizeof(Vertex::QuantizationParams), &data->quantization);
+                    data->streamed_geometry->recordDraw(command_buffer);
+                    continue;
+                }
+
+                // One vertex buffer per program binding.
+                if(!vertex_streams.empty()) {
+                    std::vector<vk::Buffer> vertex_buffers = {};
+                    for(auto stream : vertex_streams)
+                        vertex_buffers.push_back(data->vertex_buffer->getStreamBuffer(stream));
+                    std::vector<vk::DeviceSize> offsets(vertex_buffers.size(), 0);
+
+                    command_buffer.bindVertexBuffers(0, vertex_buffers, offsets);
+                }
+
+                if(has_vertex_dequantization)
+                    command_buffer.pushConstants(pl, vk::ShaderStageFlagBits::eVertex, 0, sizeof(Vertex::QuantizationParams), &data->quantization);
 
                 auto index_count = data->vertex_buffer->getIndexCount();
-                if(index_count > 0) {
-                    command_buffer_.bindIndexBuffer(data->vertex_buffer->getIndexBuffer(), 0, vk::IndexType::eUint32);
-                    command_buffer_.drawIndexed(index_count, 1, 0, 0, 0);
+                if(data->meshlet_draw != nullptr) {
+                    GraphicsPipeline::MeshletCulling::recordDraw(command_buffer, *data->meshlet_draw);
+                } else if(index_count > 0) {
+                    command_buffer.bindIndexBuffer(data->vertex_buffer->getIndexBuffer(), 0, data->vertex_buffer->getIndexType());
+                    command_buffer.drawIndexed(index_count, 1, 0, 0, 0);
                 } else {
-                    command_buffer_.draw(data->vertex_buffer->getVertexCount(), 1, 0, 0);
+                    command_buffer.draw(data->vertex_buffer->getVertexCount(), 1, 0, 0);
                 }
             }
         }
-
-        command_buffer_.endRenderPass();
-        command_buffer_.end();
     }
 
     vk::CommandBuffer CommandBuffer::getCommandBuffer() const
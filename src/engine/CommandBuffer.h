@@ -9,7 +9,6 @@
 #include "Descriptors/Layout.h"
 #include "SyncPrimitives/SyncPrimitives.h"
 #include "Vertex/VertexBuffer.h"
-#include <RenderPass/RenderPass.h>
 
 namespace Engine
 {
@@ -25,11 +24,18 @@ namespace Engine
         CommandBuffer();
         ~CommandBuffer();
 
-        void bindGraphicCommandBuffer(
-            std::vector<vk::ClearValue> clear_values,
-            const std::shared_ptr<RenderPass::RenderPass>& render_pass,
-            const std::shared_ptr<RenderPass::FrameBuffer>& frame_buffer,
-            const std::vector<std::shared_ptr<Programs::Program>>& programs);
+        void begin() const;
+        void end() const;
+
+        /**
+         * Meshlet culling of every program, must be recorded outside of a render pass.
+         * */
+        static void recordCulling(vk::CommandBuffer command_buffer, const std::vector<std::shared_ptr<Programs::Program>>& programs);
+
+        /**
+         * Every object of every program, inside a render pass compatible with the programs one.
+         * */
+        static void recordDraws(vk::CommandBuffer command_buffer, const std::vector<std::shared_ptr<Programs::Program>>& programs, uint32_t frame);
 
         vk::CommandBuffer getCommandBuffer() const;
 
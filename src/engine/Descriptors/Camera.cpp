@@ -13,9 +13,10 @@ namespace Engine
 
             buffer_data.usage      = vk::BufferUsageFlagBits::eUniformBuffer;
             buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-            buffer_data.count      = 1;
+            buffer_data.count      = 2;
             vp_buffer_  = std::make_unique<Memory::Buffer<glm::mat4>>(buffer_data);
-            vp_buffer_->updateBuffer({projection * view});
+            glm::mat4 view_projection = projection * view;
+            vp_buffer_->updateBuffer({view_projection, glm::inverse(view_projection)});
 
             vp_buffer_info_.offset = 0;
             vp_buffer_info_.range  = VK_WHOLE_SIZE;
@@ -81,10 +82,47 @@ namespace Engine
 
         void Camera::updateMVP()
         {
-            vp_buffer_->updateBuffer({projection * view});
+            glm::mat4 view_projection = projection * view;
+            vp_buffer_->updateBuffer({view_projection, glm::inverse(view_projection)});
             pos_buffer_->updateBuffer({glm::vec4(0, 10, 0, 1.f), pos});
         }
 
+        std::array<glm::vec4, 6> Camera::getFrustumPlanes() const
+        {
+            glm::mat4 rows = glm::transpose(projection * view);
+
+            return {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1],
+                    rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]};
+        }
+
+        glm::vec3 Camera::getEyePosition() const
+        {
+            return glm::vec3(glm::inverse(view)[3]);
+        }
+
+        glm::vec2 Camera::getDepthRange() const
+        {
+            // glm::perspective, right handed with [-1, 1] depth.
+            float a = projection[2][2];
+            float b = projection[3][2];
+
+            return glm::vec2(b / (a - 1.f), b / (a + 1.f));
+        }
+
+        float Camera::getPixelsPerUnit() const
+        {
+            return std::abs(projection[1][1]) * static_cast<float>(ApplicationData::data->view_height) * 0.5f;
+        }
+
+        bool Camera::isSphereVisible(const std::array<glm::vec4, 6>& planes, const glm::vec3& center, float radius)
+        {
+            for (const glm::vec4& plane : planes)
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -radius * glm::length(glm::vec3(plane)))
+                    return false;
+
+            return true;
+        }
+
         std::vector<vk::WriteDescriptorSet> Camera::getWrites(vk::DescriptorSet desc_set, uint32_t vp_bind, uint32_t cam_pos_bind)
         {
             std::vector<vk::WriteDescriptorSet> writes = {};
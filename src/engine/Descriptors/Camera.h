@@ -14,6 +14,7 @@ namespace Engine::Descriptors
 
     private:
 
+        // View-projection, then its inverse to rebuild positions from depth.
         vk::DescriptorBufferInfo vp_buffer_info_ {};
         std::unique_ptr<Memory::Buffer<glm::mat4>> vp_buffer_;
 
@@ -40,6 +41,24 @@ namespace Engine::Descriptors
         void rotateArcballCamera(float delta_phi, float delta_theta);
         void updateMVP();
 
+        /**
+         * Gribb-Hartmann planes of the view-projection matrix (left, right, bottom, top, near, far), not normalized.
+         * */
+        [[nodiscard]] std::array<glm::vec4, 6> getFrustumPlanes() const;
+        [[nodiscard]] glm::vec3 getEyePosition() const;
+
+        /**
+         * Near and far distances of the perspective projection.
+         * */
+        [[nodiscard]] glm::vec2 getDepthRange() const;
+
+        /**
+         * Screen pixels covered by one world unit seen face on, one unit away from the eye.
+         * */
+        [[nodiscard]] float getPixelsPerUnit() const;
+
+        static bool isSphereVisible(const std::array<glm::vec4, 6>& planes, const glm::vec3& center, float radius);
+
         std::vector<vk::WriteDescriptorSet> getWrites(vk::DescriptorSet desc_set, uint32_t vp_bind, uint32_t cam_pos_bind);
     };
 }
@@ -24,11 +24,11 @@ namespace Engine
             }
 
             if(ds_data.has_view_projection_matrix) {
-                // View-Projection Matrix
+                // View-Projection Matrix, fragments rebuilding positions from depth read its inverse.
                 l_bind.binding 			    = binding_count++;
                 l_bind.descriptorType 	    = vk::DescriptorType::eUniformBuffer;
                 l_bind.descriptorCount 	    = 1;
-                l_bind.stageFlags 		    = vk::ShaderStageFlagBits::eVertex;
+                l_bind.stageFlags 		    = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
                 l_bind.pImmutableSamplers   = nullptr;
                 layout_bindings_.push_back(l_bind);
             }
@@ -77,6 +77,28 @@ namespace Engine
                 layout_bindings_.push_back(l_bind);
             }
 
+            for (uint32_t i = 0; i < ds_data.fragment_input_attachment_count; ++i)
+            {
+                l_bind.binding 			    = binding_count++;
+                l_bind.descriptorType 	    = vk::DescriptorType::eInputAttachment;
+                l_bind.descriptorCount 	    = 1;
+                l_bind.stageFlags 		    = vk::ShaderStageFlagBits::eFragment;
+                l_bind.pImmutableSamplers   = nullptr;
+
+                layout_bindings_.push_back(l_bind);
+            }
+
+            for (uint32_t i = 0; i < ds_data.fragment_storage_buffer_count; ++i)
+            {
+                l_bind.binding 			    = binding_count++;
+                l_bind.descriptorType 	    = vk::DescriptorType::eStorageBufferDynamic;
+                l_bind.descriptorCount 	    = 1;
+                l_bind.stageFlags 		    = vk::ShaderStageFlagBits::eFragment;
+                l_bind.pImmutableSamplers   = nullptr;
+
+                layout_bindings_.push_back(l_bind);
+            }
+
             // Set Descriptor Layouts
             vk::DescriptorSetLayoutCreateInfo descriptor_layout_ = {};
             descriptor_layout_.pNext 						 = nullptr;
@@ -85,11 +107,20 @@ namespace Engine
 
             desc_layout_ = app_data->device.createDescriptorSetLayout(descriptor_layout_);
 
+            std::vector<vk::PushConstantRange> push_constant_ranges = {};
+            if(ds_data.has_vertex_dequantization) {
+                vk::PushConstantRange push_constant_range = {};
+                push_constant_range.stageFlags  = vk::ShaderStageFlagBits::eVertex;
+                push_constant_range.offset      = 0;
+                push_constant_range.size        = sizeof(Vertex::QuantizationParams);
+                push_constant_ranges.push_back(push_constant_range);
+            }
+
             // Set Pipeline Layout
             vk::PipelineLayoutCreateInfo pPipelineLayoutCreateInfo = {};
             pPipelineLayoutCreateInfo.pNext                  = nullptr;
-            pPipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-            pPipelineLayoutCreateInfo.pPushConstantRanges    = nullptr;
+            pPipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+            pPipelineLayoutCreateInfo.pPushConstantRanges    = push_constant_ranges.empty() ? nullptr : push_constant_ranges.data();
             pPipelineLayoutCreateInfo.setLayoutCount         = 1;
             pPipelineLayoutCreateInfo.pSetLayouts            = &desc_layout_;
 
@@ -114,6 +145,10 @@ namespace Engine
         {
             // Create Descriptor Set
             {
+                // Objects were added since last call, sets are allocated again from a new pool.
+                if(desc_pool_)
+                    ApplicationData::data->device.destroyDescriptorPool(desc_pool_);
+
                 std::vector<vk::DescriptorPoolSize> poolSizes = {};
 
                 vk::DescriptorPoolSize poolSize = {};
@@ -125,8 +160,8 @@ namespace Engine
                 }
 
                 uint32_t uniform_count = ds_data_->vertex_uniform_count + ds_data_->fragment_uniform_count;
-                if(uniform_count > 0){
-                    uint32_t vp_mat_count = ds_data_->has_view_projection_matrix ? 1 : 0;
+                uint32_t vp_mat_count = ds_data_->has_view_projection_matrix ? 1 : 0;
+                if(vp_mat_count + uniform_count > 0){
                     poolSize.type = vk::DescriptorType::eUniformBuffer;
                     poolSize.descriptorCount = objects_count * (vp_mat_count + uniform_count); // VP matrix + uniform_count.
                     poolSizes.push_back(poolSize);
@@ -139,6 +174,18 @@ namespace Engine
                     poolSizes.push_back(poolSize);
                 }
 
+                if(ds_data_->fragment_input_attachment_count > 0) {
+                    poolSize.type = vk::DescriptorType::eInputAttachment;
+                    poolSize.descriptorCount = objects_count * ds_data_->fragment_input_attachment_count;
+                    poolSizes.push_back(poolSize);
+                }
+
+                if(ds_data_->fragment_storage_buffer_count > 0) {
+                    poolSize.type = vk::DescriptorType::eStorageBufferDynamic;
+                    poolSize.descriptorCount = objects_count * ds_data_->fragment_storage_buffer_count;
+                    poolSizes.push_back(poolSize);
+                }
+
                 vk::DescriptorPoolCreateInfo descriptor_pool_info = {};
                 descriptor_pool_info.maxSets 		= objects_count;
                 descriptor_pool_info.poolSizeCount 	= static_cast<uint32_t>(poolSizes.size());
@@ -11,6 +11,7 @@
 #include "Descriptors/Camera.h"
 #include "Descriptors/Texture.hpp"
 #include "Memory/BufferImage.h"
+#include "Vertex/VertexQuantizer.h"
 
 namespace Engine
 {
@@ -26,6 +27,15 @@ namespace Engine
 
             uint32_t fragment_texture_count = 0;
             uint32_t fragment_uniform_count = 0;
+
+            // Read from earlier subpasses, after the textures (see RenderGraph::Pass::readAttachment).
+            uint32_t fragment_input_attachment_count = 0;
+
+            // Read only, e.g. Descriptors::Lights, after the input attachments. Dynamic: one region per frame in flight.
+            uint32_t fragment_storage_buffer_count = 0;
+
+            // Quantized vertices bounds, as vertex push constant (see Vertex::QuantizationParams).
+            bool has_vertex_dequantization  = false;
         };
 
         class Layout
@@ -0,0 +1,178 @@
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include "LightClusters.h"
+
+namespace Engine::Descriptors
+{
+    // phong_fs.glsl and visibility_shading_cs.glsl repeat the grid in CLUSTERS, which also sizes their froxel ranges.
+    static_assert(LightClusters::CLUSTER_X == 16 && LightClusters::CLUSTER_Y == 9 && LightClusters::CLUSTER_Z == 24,
+                  "Update CLUSTERS in the shaders reading the light clusters!");
+
+    LightClusters::LightClusters(std::shared_ptr<Lights> lights, uint32_t frame_count) : lights_(std::move(lights))
+    {
+        const size_t frame_size = (sizeof(GridData) / sizeof(uint32_t) + CLUSTER_COUNT * 2 + MAX_LIGHT_INDICES) * sizeof(uint32_t);
+        frame_stride_ = static_cast<uint32_t>(Memory::Memory::getStorageAlignment(frame_size) / sizeof(uint32_t));
+
+        struct BufferData buffer_data = {};
+        buffer_data.usage      = vk::BufferUsageFlagBits::eStorageBuffer;
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        buffer_data.count      = static_cast<size_t>(frame_stride_) * frame_count;
+        buffer_ = std::make_unique<Memory::Buffer<uint32_t>>(buffer_data);
+
+        buffer_info_.offset = 0;
+        buffer_info_.range  = frame_size;
+        buffer_info_.buffer = buffer_->getBuffer();
+    }
+
+    void LightClusters::updateBounds(const Camera& camera)
+    {
+        glm::vec2 depth_range = camera.getDepthRange();
+        float ratio = depth_range.y / depth_range.x;
+
+        // A point of NDC 'ndc' at 'depth' from the eye, in view space.
+        auto unproject = [&camera](glm::vec2 ndc, float depth) {
+            return glm::vec3(ndc.x * depth / camera.projection[0][0], ndc.y * depth / camera.projection[1][1], -depth);
+        };
+
+        for (uint32_t z = 0; z < CLUSTER_Z; ++z)
+        {
+            float slice_near = depth_range.x * std::pow(ratio, static_cast<float>(z) / CLUSTER_Z);
+            float slice_far = depth_range.x * std::pow(ratio, static_cast<float>(z + 1) / CLUSTER_Z);
+
+            for (uint32_t y = 0; y < CLUSTER_Y; ++y)
+            {
+                for (uint32_t x = 0; x < CLUSTER_X; ++x)
+                {
+                    glm::vec2 ndc_min = glm::vec2(x, y) / glm::vec2(CLUSTER_X, CLUSTER_Y) * 2.f - 1.f;
+                    glm::vec2 ndc_max = glm::vec2(x + 1, y + 1) / glm::vec2(CLUSTER_X, CLUSTER_Y) * 2.f - 1.f;
+
+                    Aabb& aabb = bounds_[(z * CLUSTER_Y + y) * CLUSTER_X + x];
+                    aabb.min = glm::vec3(std::numeric_limits<float>::max());
+                    aabb.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+                    for (float depth : {slice_near, slice_far})
+                    {
+                        for (glm::vec2 ndc : {ndc_min, ndc_max, glm::vec2(ndc_min.x, ndc_max.y), glm::vec2(ndc_max.x, ndc_min.y)})
+                        {
+                            glm::vec3 corner = unproject(ndc, depth);
+                            aabb.min = glm::min(aabb.min, corner);
+                            aabb.max = glm::max(aabb.max, corner);
+                        }
+                    }
+                }
+            }
+        }
+
+        bounds_projection_ = camera.projection;
+    }
+
+    void LightClusters::update(const Camera& camera, uint32_t frame)
+    {
+        if (camera.projection != bounds_projection_)
+            updateBounds(camera);
+
+        for (std::vector<uint32_t>& cluster : cluster_lights_)
+            cluster.clear();
+
+        glm::vec2 depth_range = camera.getDepthRange();
+        float slice_scale = CLUSTER_Z / std::log(depth_range.y / depth_range.x);
+        float slice_bias = -slice_scale * std::log(depth_range.x);
+
+        auto getSlice = [&](float depth) {
+            auto slice = static_cast<int32_t>(std::floor(std::log(std::max(depth, depth_range.x)) * slice_scale + slice_bias));
+            return static_cast<uint32_t>(std::clamp(slice, 0, static_cast<int32_t>(CLUSTER_Z) - 1));
+        };
+
+        const std::vector<LightData>& lights = lights_->getLights();
+        for (uint32_t i = 0; i < lights.size(); ++i)
+        {
+            glm::vec3 center = glm::vec3(camera.view * glm::vec4(glm::vec3(lights[i].position), 1.f));
+            float radius = lights[i].position.w;
+            float depth = -center.z;
+
+            if (depth + radius < depth_range.x || depth - radius > depth_range.y)
+                continue;
+
+            uint32_t last_slice = getSlice(depth + radius);
+            for (uint32_t z = getSlice(depth - radius); z <= last_slice; ++z)
+            {
+                for (uint32_t cluster = z * CLUSTER_X * CLUSTER_Y; cluster < (z + 1) * CLUSTER_X * CLUSTER_Y; ++cluster)
+                {
+                    glm::vec3 closest = glm::clamp(center, bounds_[cluster].min, bounds_[cluster].max);
+                    glm::vec3 offset = closest - center;
+
+                    if (glm::dot(offset, offset) <= radius * radius)
+                        cluster_lights_[cluster].push_back(i);
+                }
+            }
+        }
+
+        // Over the cap, keep the lights nearest to the froxel center.
+        for (uint32_t cluster = 0; cluster < CLUSTER_COUNT; ++cluster)
+        {
+            std::vector<uint32_t>& cluster_lights = cluster_lights_[cluster];
+            if (cluster_lights.size() <= MAX_CLUSTER_LIGHTS)
+                continue;
+
+            glm::vec3 cluster_center = (bounds_[cluster].min + bounds_[cluster].max) * 0.5f;
+            auto distance = [&](uint32_t light) {
+                glm::vec3 offset = glm::vec3(camera.view * glm::vec4(glm::vec3(lights[light].position), 1.f)) - cluster_center;
+                return glm::dot(offset, offset);
+            };
+
+            std::nth_element(cluster_lights.begin(), cluster_lights.begin() + MAX_CLUSTER_LIGHTS, cluster_lights.end(),
+                             [&](uint32_t a, uint32_t b) { return distance(a) < distance(b); });
+            cluster_lights.resize(MAX_CLUSTER_LIGHTS);
+        }
+
+        GridData grid = {};
+        glm::mat4 view_rows = glm::transpose(camera.view);
+        grid.view_depth = -view_rows[2];
+        grid.scale = glm::vec4(static_cast<float>(CLUSTER_X) / static_cast<float>(ApplicationData::data->view_width),
+                               static_cast<float>(CLUSTER_Y) / static_cast<float>(ApplicationData::data->view_height),
+                               slice_scale, slice_bias);
+
+        const size_t grid_words = sizeof(GridData) / sizeof(uint32_t);
+        data_.resize(grid_words + CLUSTER_COUNT * 2);
+        std::memcpy(data_.data(), &grid, sizeof(grid));
+
+        uint32_t offset = 0;
+        for (uint32_t cluster = 0; cluster < CLUSTER_COUNT; ++cluster)
+        {
+            auto count = static_cast<uint32_t>(cluster_lights_[cluster].size());
+
+            data_[grid_words + cluster * 2]     = offset;
+            data_[grid_words + cluster * 2 + 1] = count;
+            data_.insert(data_.end(), cluster_lights_[cluster].begin(), cluster_lights_[cluster].begin() + count);
+            offset += count;
+        }
+
+        // Frames still in flight read their own lists.
+        auto* data = static_cast<uint32_t*>(buffer_->map()) + static_cast<size_t>(frame) * frame_stride_;
+        std::memcpy(data, data_.data(), data_.size() * sizeof(uint32_t));
+        buffer_->unmap();
+    }
+
+    std::vector<vk::WriteDescriptorSet> LightClusters::getWrites(vk::DescriptorSet desc_set, uint32_t lights_bind, uint32_t clusters_bind)
+    {
+        std::vector<vk::WriteDescriptorSet> writes = {lights_->getWrite(desc_set, lights_bind)};
+
+        vk::WriteDescriptorSet write = {};
+        write.pNext 			= nullptr;
+        write.dstSet 			= desc_set;
+        write.descriptorCount 	= 1;
+        write.descriptorType 	= vk::DescriptorType::eStorageBufferDynamic;
+        write.pBufferInfo 		= &buffer_info_;
+        write.dstBinding 		= clusters_bind;
+        writes.push_back(write);
+
+        return writes;
+    }
+
+    std::vector<uint32_t> LightClusters::getOffsets(uint32_t frame) const
+    {
+        return {lights_->getOffset(frame), frame * frame_stride_ * static_cast<uint32_t>(sizeof(uint32_t))};
+    }
+}
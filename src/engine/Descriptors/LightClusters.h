@@ -0,0 +1,80 @@
+#ifndef GYMNURE_LIGHTCLUSTERS_H
+#define GYMNURE_LIGHTCLUSTERS_H
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "Camera.h"
+#include "Lights.h"
+
+namespace Engine::Descriptors
+{
+    /**
+     * Lights of each froxel of the view, for forward shading with many lights (see phong_fs.glsl).
+     *
+     * The view is split in CLUSTER_X * CLUSTER_Y screen tiles and CLUSTER_Z depth slices, exponentially spaced so
+     * froxels stay roughly cubic. Every frame each light sphere is tested against the view space bounds of the
+     * froxels it may reach, and the lists are uploaded to a storage buffer: the grid parameters, an offset and count
+     * per froxel, then the light indices. A fragment only iterates the lights of its froxel. Like the lights, the
+     * buffer holds the lists of each frame in flight, bound at the dynamic offset of the frame.
+     * A froxel keeps its MAX_CLUSTER_LIGHTS nearest lights, so every shader sees the same lists.
+     * */
+    class LightClusters
+    {
+    public:
+
+        static constexpr uint32_t CLUSTER_X             = 16;
+        static constexpr uint32_t CLUSTER_Y             = 9;
+        static constexpr uint32_t CLUSTER_Z             = 24;
+        static constexpr uint32_t CLUSTER_COUNT         = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+        static constexpr uint32_t MAX_CLUSTER_LIGHTS    = 32;   // Per froxel, the default ShaderVariant::max_lights.
+        static constexpr uint32_t MAX_LIGHT_INDICES     = CLUSTER_COUNT * MAX_CLUSTER_LIGHTS;
+
+    private:
+
+        /**
+         * As the shaders read it, before the froxel ranges.
+         * */
+        struct GridData
+        {
+            glm::vec4   view_depth  = {};   // Dot with a world position (w = 1): distance along the view direction.
+            glm::vec4   scale       = {};   // Froxels per pixel in x and y, log depth scale and bias to slices.
+        };
+
+        struct Aabb
+        {
+            glm::vec3   min         = {};
+            glm::vec3   max         = {};
+        };
+
+        std::shared_ptr<Lights>                         lights_             = nullptr;
+        std::unique_ptr<Memory::Buffer<uint32_t>>       buffer_             = nullptr;
+        vk::DescriptorBufferInfo                        buffer_info_        = {};
+        uint32_t                                        frame_stride_       = 0;    // In words, aligned for dynamic offsets.
+
+        std::array<Aabb, CLUSTER_COUNT>                 bounds_             = {};   // View space.
+        glm::mat4                                       bounds_projection_  = {};
+        std::array<std::vector<uint32_t>, CLUSTER_COUNT> cluster_lights_    = {};
+        std::vector<uint32_t>                           data_               = {};
+
+        void updateBounds(const Camera& camera);
+
+    public:
+
+        LightClusters(std::shared_ptr<Lights> lights, uint32_t frame_count);
+
+        /**
+         * Once per frame, after lights moved and once the GPU is done with 'frame': assign them to the froxels of
+         * 'camera' and upload the lists of 'frame'.
+         * */
+        void update(const Camera& camera, uint32_t frame);
+
+        /**
+         * The lights, then their froxels, both dynamic storage buffers bound at getOffsets() of the frame recorded.
+         * */
+        std::vector<vk::WriteDescriptorSet> getWrites(vk::DescriptorSet desc_set, uint32_t lights_bind, uint32_t clusters_bind);
+        [[nodiscard]] std::vector<uint32_t> getOffsets(uint32_t frame) const;
+    };
+}
+
+#endif //GYMNURE_LIGHTCLUSTERS_H
@@ -0,0 +1,99 @@
+#include <cstring>
+#include "Lights.h"
+
+namespace Engine::Descriptors
+{
+    Lights::Lights(uint32_t frame_count) : stale_frames_(frame_count, true)
+    {
+        const size_t frame_size = (MAX_LIGHTS + 1) * sizeof(LightData);   // The count first.
+        frame_stride_ = static_cast<uint32_t>(Memory::Memory::getStorageAlignment(frame_size) / sizeof(LightData));
+
+        struct BufferData buffer_data = {};
+        buffer_data.usage      = vk::BufferUsageFlagBits::eStorageBuffer;
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        buffer_data.count      = static_cast<size_t>(frame_stride_) * frame_count;
+        buffer_ = std::make_unique<Memory::Buffer<LightData>>(buffer_data);
+
+        buffer_info_.offset = 0;
+        buffer_info_.range  = frame_size;
+        buffer_info_.buffer = buffer_->getBuffer();
+
+        for (uint32_t frame = 0; frame < frame_count; ++frame)
+            update(frame);
+    }
+
+    uint32_t Lights::add(const LightData& light)
+    {
+        // logErrorAndDie() only throws in debug builds, the buffer holds no more lights either way.
+        if (lights_.size() >= MAX_LIGHTS) {
+            Debug::logErrorAndDie("Too many lights, at most " + std::to_string(MAX_LIGHTS) + "!");
+            return UINT32_MAX;
+        }
+
+        lights_.push_back(light);
+        stale_frames_.assign(stale_frames_.size(), true);
+
+        return static_cast<uint32_t>(lights_.size() - 1);
+    }
+
+    void Lights::set(uint32_t index, const LightData& light)
+    {
+        if (index >= lights_.size()) {
+            Debug::logErrorAndDie("Invalid light index!");
+            return;
+        }
+
+        lights_[index] = light;
+        stale_frames_.assign(stale_frames_.size(), true);
+    }
+
+    void Lights::clear()
+    {
+        lights_.clear();
+        stale_frames_.assign(stale_frames_.size(), true);
+    }
+
+    const std::vector<LightData>& Lights::getLights() const
+    {
+        return lights_;
+    }
+
+    void Lights::update(uint32_t frame)
+    {
+        if (frame >= stale_frames_.size() || !stale_frames_[frame])
+            return;
+
+        // Frames still in flight read their own copy.
+        auto* data = static_cast<LightData*>(buffer_->map()) + static_cast<size_t>(frame) * frame_stride_;
+
+        LightData header = {};
+        std::memset(&header, 0, sizeof(header));
+        auto count = static_cast<uint32_t>(lights_.size());
+        std::memcpy(&header, &count, sizeof(count));
+
+        data[0] = header;
+        if (!lights_.empty())
+            std::memcpy(data + 1, lights_.data(), lights_.size() * sizeof(LightData));
+
+        buffer_->unmap();
+        stale_frames_[frame] = false;
+    }
+
+    vk::WriteDescriptorSet Lights::getWrite(vk::DescriptorSet desc_set, uint32_t dst_bind)
+    {
+        vk::WriteDescriptorSet write = {};
+        write.pNext 			= nullptr;
+        write.dstSet 			= desc_set;
+        write.descriptorCount 	= 1;
+        write.descriptorType 	= vk::DescriptorType::eStorageBufferDynamic;
+        write.pBufferInfo 		= &buffer_info_;
+        write.dstBinding 		= dst_bind;
+
+        return write;
+    }
+
+    uint32_t Lights::getOffset(uint32_t frame) const
+    {
+        return frame * frame_stride_ * static_cast<uint32_t>(sizeof(LightData));
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef GYMNURE_LIGHTS_H
+#define GYMNURE_LIGHTS_H
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Memory/Buffer.h"
+
+namespace Engine::Descriptors
+{
+    /**
+     * A point light, as the shaders read it.
+     * */
+    struct LightData
+    {
+        glm::vec4 position  = glm::vec4(0.f, 0.f, 0.f, 50.f);   // w: radius, past which the light is ignored.
+        glm::vec4 color     = glm::vec4(1.f, 1.f, 1.f, 100.f);  // w: intensity.
+    };
+
+    /**
+     * Dynamic point lights of the scene, in a storage buffer: a light count padded to a LightData, then the lights.
+     * The buffer holds a copy per frame in flight, bound at the dynamic offset of the frame: changes are uploaded by
+     * update() to the copy of the frame about to be submitted, without recording command buffers again.
+     * */
+    class Lights
+    {
+    public:
+
+        static constexpr uint32_t MAX_LIGHTS = 1024;
+
+    private:
+
+        std::vector<LightData>                      lights_         = {};
+        std::unique_ptr<Memory::Buffer<LightData>>  buffer_         = nullptr;
+        vk::DescriptorBufferInfo                    buffer_info_    = {};
+        uint32_t                                    frame_stride_   = 0;    // In LightData, aligned for dynamic offsets.
+        std::vector<bool>                           stale_frames_   = {};
+
+    public:
+
+        explicit Lights(uint32_t frame_count);
+
+        /**
+         * Index of the light, for set(). UINT32_MAX when MAX_LIGHTS are already there, the light is dropped.
+         * */
+        uint32_t add(const LightData& light);
+        void set(uint32_t index, const LightData& light);
+        void clear();
+
+        [[nodiscard]] const std::vector<LightData>& getLights() const;
+
+        /**
+         * Once the GPU is done with 'frame', see RenderGraph::execute().
+         * */
+        void update(uint32_t frame);
+
+        /**
+         * Dynamic storage buffer, bound at getOffset() of the frame recorded.
+         * */
+        vk::WriteDescriptorSet getWrite(vk::DescriptorSet desc_set, uint32_t dst_bind);
+        [[nodiscard]] uint32_t getOffset(uint32_t frame) const;
+    };
+}
+
+#endif //GYMNURE_LIGHTS_H
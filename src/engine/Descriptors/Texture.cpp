@@ -1,6 +1,13 @@
 #include <ApplicationData.hpp>
 #include <Util/Util.h>
+#include <Util/MipGenerator.h>
+#include <Util/BlockCompressor.h>
+#include <Util/CookedAsset.h>
+#include <filesystem>
+#include <thread>
 #include <memory>
+#include <cstring>
+#include <utility>
 #include "Texture.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -35,20 +42,236 @@ namespace Engine::Descriptors
         createSampler();
     }
 
-    Texture::Texture(const std::string& texture_path)
+    Texture::Texture(const std::string& texture_path) : Texture(decode(texture_path)) {}
+
+    Texture::Texture(const TextureData& texture_data)
+    {
+        if (texture_data.levels.empty()) {
+            submitPixels(texture_data.pixels.get(), texture_data.width, texture_data.height);
+        } else {
+            if (Util::BlockCompressor::isBlockCompressed(texture_data.format) && !ApplicationData::data->texture_compression_bc)
+                Debug::logErrorAndDie("Fail to create Texture: device does not support BC textures!");
+
+            submitLevels(texture_data.pixels.get(), texture_data.format, texture_data.width, texture_data.height,
+                         texture_data.levels, static_cast<uint32_t>(texture_data.levels.size()));
+        }
+        createSampler();
+    }
+
+    Texture::Texture(const TextureData& texture_data, uint32_t first_level) : streamed_data_(texture_data), resident_level_(first_level)
     {
-        int texWidth, texHeight, texChannels;
+        if (Util::BlockCompressor::isBlockCompressed(texture_data.format) && !ApplicationData::data->texture_compression_bc)
+            Debug::logErrorAndDie("Fail to create Texture: device does not support BC textures!");
 
-        // Load texture and write to vk::Image
+        TextureData levels = getLevels(texture_data, first_level);
+        submitLevels(levels.pixels.get(), levels.format, levels.width, levels.height, levels.levels,
+                     static_cast<uint32_t>(levels.levels.size()));
+        createSampler();
+    }
+
+    TextureData Texture::decode(const std::string& texture_path)
+    {
+        std::string source_path = getSourcePath(texture_path);
+        Util::IOBuffer source = source_path.empty() ? Util::IOBuffer{} : Util::AsyncIO::getInstance()->read(source_path).get();
+
+        return decode(texture_path, source);
+    }
+
+    std::string Texture::getSourcePath(const std::string& texture_path)
+    {
+        if (texture_path.empty())
+            return "";
+
+        bool is_ktx2 = std::filesystem::path(texture_path).extension() == ".ktx2";
+        if (!is_ktx2 && ApplicationData::data->texture_compression_bc && Util::CookedAsset::isAvailable(texture_path, ".ktx2"))
+            return "";
+
+        return std::string(ASSETS_FOLDER_PATH_STR) + "/" + texture_path;
+    }
+
+    TextureData Texture::decode(const std::string& texture_path, const Util::IOBuffer& source)
+    {
         if(texture_path.empty()) { Debug::logErrorAndDie("Fail to create Texture: string path is empty!"); }
         auto assets_texture_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + texture_path;
 
-        stbi_uc *pixels = stbi_load(assets_texture_path.data(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        if (std::filesystem::path(texture_path).extension() == ".ktx2")
+        {
+            Util::Ktx2Image image = {};
+            if (!source || !Util::Ktx2::parse(source.getSpan(), image)) { Debug::logErrorAndDie("Cannot read KTX2 texture: " + texture_path); }
+            return fromKtx2(std::move(image), Util::CookedData{source.getSpan(), source.data});
+        }
+
+        if (!ApplicationData::data->texture_compression_bc)
+            return decodeImage(source);
+
+        Util::CookedData cooked = Util::CookedAsset::load(texture_path, ".ktx2");
+        if (cooked)
+        {
+            Util::Ktx2Image image = {};
+            if (Util::Ktx2::parse(cooked.bytes, image))
+                return fromKtx2(std::move(image), cooked);
+        }
+
+        // Source was not read up front because cooked data was expected.
+        TextureData rgba_data = decodeImage(source ? source : Util::AsyncIO::getInstance()->read(assets_texture_path).get());
+        Util::Ktx2Image image = Util::BlockCompressor::encodeMipChain(rgba_data.pixels.get(), rgba_data.width, rgba_data.height);
+
+        // Write aside and rename, other loads may read the same cooked file.
+        std::string cooked_path = getCookedPath(texture_path);
+        std::error_code error;
+        auto temp_path = cooked_path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        std::filesystem::create_directories(std::filesystem::path(cooked_path).parent_path(), error);
+        if (Util::Ktx2::write(temp_path, image))
+            std::filesystem::rename(temp_path, cooked_path, error);
+        else
+            Debug::logInfo("Cannot write cooked texture: " + cooked_path);
+
+        return fromKtx2(std::move(image));
+    }
+
+    TextureData Texture::decodeImage(const Util::IOBuffer& source)
+    {
+        int texWidth = 0, texHeight = 0, texChannels = 0;
+
+        stbi_uc *pixels = nullptr;
+        if (source)
+            pixels = stbi_load_from_memory(source.data.get(), static_cast<int>(source.size), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
         if(!pixels) { Debug::logErrorAndDie("Cannot stbi_load pixels!"); }
 
-        submitPixels(pixels, texWidth, texHeight);
+        TextureData texture_data = {};
+        texture_data.pixels = std::shared_ptr<unsigned char>(pixels, stbi_image_free);
+        texture_data.width  = static_cast<uint32_t>(texWidth);
+        texture_data.height = static_cast<uint32_t>(texHeight);
+
+        return texture_data;
+    }
+
+    std::string Texture::getCookedPath(const std::string& texture_path)
+    {
+        return Util::CookedAsset::getPath(texture_path, ".ktx2");
+    }
+
+    TextureData Texture::fromKtx2(Util::Ktx2Image&& image)
+    {
+        auto data = std::make_shared<std::vector<uint8_t>>(std::move(image.data));
+
+        TextureData texture_data = {};
+        texture_data.pixels = std::shared_ptr<unsigned char>(data, data->data());
+        texture_data.width  = image.width;
+        texture_data.height = image.height;
+        texture_data.format = image.format;
+        texture_data.levels = std::move(image.levels);
+
+        return texture_data;
+    }
+
+    TextureData Texture::fromKtx2(Util::Ktx2Image&& image, const Util::CookedData& cooked)
+    {
+        // Levels are stored smallest first, rebase them on the first byte of the chain.
+        size_t base = cooked.bytes.size();
+        for (const auto& level : image.levels)
+            base = std::min(base, level.offset);
+        for (auto& level : image.levels)
+            level.offset -= base;
+
+        // Pixels alias the mapping, which stays alive as long as the texture data does.
+        auto* pixels = const_cast<unsigned char*>(cooked.bytes.data() + base);
+
+        TextureData texture_data = {};
+        texture_data.pixels = std::shared_ptr<unsigned char>(cooked.owner, pixels);
+        texture_data.width  = image.width;
+        texture_data.height = image.height;
+        texture_data.format = image.format;
+        texture_data.levels = std::move(image.levels);
+
+        return texture_data;
+    }
+
+    TextureData Texture::getLevels(const TextureData& texture_data, uint32_t first_level)
+    {
+        size_t size = 0;
+        for (uint32_t i = first_level; i < texture_data.levels.size(); ++i)
+            size += texture_data.levels[i].size;
+
+        auto data = std::make_shared<std::vector<uint8_t>>(size);
+
+        TextureData levels = {};
+        levels.pixels = std::shared_ptr<unsigned char>(data, data->data());
+        levels.width  = texture_data.levels[first_level].width;
+        levels.height = texture_data.levels[first_level].height;
+        levels.format = texture_data.format;
+
+        // Touches the source pages, so cooked files are read here rather than at upload.
+        size_t offset = 0;
+        for (uint32_t i = first_level; i < texture_data.levels.size(); ++i)
+        {
+            const Util::MipLevel& level = texture_data.levels[i];
+            memcpy(data->data() + offset, texture_data.pixels.get() + level.offset, level.size);
+            levels.levels.push_back(Util::MipLevel{level.width, level.height, offset, level.size});
+            offset += level.size;
+        }
+
+        return levels;
+    }
+
+    void Texture::setResidentLevel(const TextureData& levels, uint32_t first_level)
+    {
+        retired_.push_back(Retired{std::move(buffer_image_), sampler_});
+
+        submitLevels(levels.pixels.get(), levels.format, levels.width, levels.height, levels.levels,
+                     static_cast<uint32_t>(levels.levels.size()), false);
         createSampler();
+
+        resident_level_ = first_level;
+        version_++;
+    }
+
+    void Texture::releaseRetired()
+    {
+        auto device = ApplicationData::data->device;
+
+        for (Retired& retired : retired_)
+            device.destroySampler(retired.sampler);
+        retired_.clear();
+
+        std::erase_if(uploads_, [device](Upload& upload) {
+            if (device.getFenceStatus(upload.fence) != vk::Result::eSuccess)
+                return false;
+
+            freeUpload(upload);
+            return true;
+        });
+    }
+
+    uint32_t Texture::getVersion() const
+    {
+        return version_;
+    }
+
+    bool Texture::isStreamed() const
+    {
+        return !streamed_data_.levels.empty();
+    }
+
+    const TextureData& Texture::getStreamedData() const
+    {
+        return streamed_data_;
+    }
+
+    uint32_t Texture::getResidentLevel() const
+    {
+        return resident_level_;
+    }
+
+    void Texture::requestLevel(uint32_t level)
+    {
+        requested_level_ = std::min(requested_level_, level);
+    }
+
+    uint32_t Texture::takeRequestedLevel()
+    {
+        return std::exchange(requested_level_, UINT32_MAX);
     }
 
     void Texture::createSampler()
@@ -64,7 +287,7 @@ namespace Engine::Descriptors
         sampler_ci.mipLodBias 		    = 0.0f;
         sampler_ci.compareOp 			= vk::CompareOp::eNever;
         sampler_ci.minLod 			    = 0.0f;
-        sampler_ci.maxLod 			    = 0.0f;
+        sampler_ci.maxLod 			    = static_cast<float>(buffer_image_->mip_levels);
         sampler_ci.maxAnisotropy 		= 1.0;
         sampler_ci.anisotropyEnable 	= VK_FALSE;
         sampler_ci.borderColor 		    = vk::BorderColor::eFloatOpaqueWhite;
@@ -77,7 +300,18 @@ namespace Engine::Descriptors
 
     Texture::~Texture()
     {
-        vkDestroySampler(ApplicationData::data->device, sampler_, nullptr);
+        auto device = ApplicationData::data->device;
+
+        for (Upload& upload : uploads_)
+        {
+            device.waitForFences({upload.fence}, VK_TRUE, UINT64_MAX);
+            freeUpload(upload);
+        }
+
+        for (Retired& retired : retired_)
+            device.destroySampler(retired.sampler);
+
+        vkDestroySampler(device, sampler_, nullptr);
     }
 
     vk::ImageView Texture::getImageView() const
@@ -105,7 +339,26 @@ namespace Engine::Descriptors
 
     void Texture::submitPixels(unsigned char* pixels, uint32_t tex_width, uint32_t tex_height)
     {
-        auto pixel_count = static_cast<size_t>(tex_width * tex_height * 4); // 4 channels
+        const vk::Format format = vk::Format::eR8G8B8A8Unorm;
+
+        uint32_t mip_levels = Util::MipGenerator::getMipLevelCount(tex_width, tex_height);
+        bool blit_mips = mip_levels > 1 && supportsLinearBlit(format);
+
+        // Without linear blits the whole chain is built on CPU and uploaded at once.
+        std::vector<Util::MipLevel> levels = {Util::MipLevel{tex_width, tex_height, 0, static_cast<size_t>(tex_width) * tex_height * 4}};
+        std::vector<uint8_t> cpu_chain = {};
+        if (mip_levels > 1 && !blit_mips) {
+            cpu_chain = Util::MipGenerator::generate(pixels, tex_width, tex_height, levels);
+            pixels = cpu_chain.data();
+        }
+
+        submitLevels(pixels, format, tex_width, tex_height, levels, mip_levels);
+    }
+
+    void Texture::submitLevels(unsigned char* pixels, vk::Format format, uint32_t tex_width, uint32_t tex_height,
+                               const std::vector<Util::MipLevel>& levels, uint32_t mip_levels, bool wait)
+    {
+        auto pixel_count = Util::MipGenerator::getChainSize(levels);
 
         struct BufferData stagingBufferData = {};
         stagingBufferData.usage      = vk::BufferUsageFlagBits::eTransferSrc;
@@ -115,26 +368,111 @@ namespace Engine::Descriptors
         auto staging_buffer = std::make_unique<Memory::Buffer<stbi_uc>>(stagingBufferData);
         staging_buffer->updateBuffer(pixels);
 
-        stbi_image_free(pixels);
+        // Levels missing from 'pixels' are blitted from level 0.
+        bool blit_mips = levels.size() < mip_levels;
 
         Memory::ImageProps img_props = {};
         img_props.width             = static_cast<uint32_t>(tex_width);
         img_props.height            = static_cast<uint32_t>(tex_height);
-        img_props.format            = vk::Format::eR8G8B8A8Unorm;
+        img_props.mip_levels        = mip_levels;
+        img_props.format            = format;
         img_props.usage             = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
         img_props.tiling            = vk::ImageTiling::eOptimal;
         img_props.image_props_flags = vk::MemoryPropertyFlagBits::eDeviceLocal;
 
+        if (blit_mips)
+            img_props.usage |= vk::ImageUsageFlagBits::eTransferSrc;
+
         buffer_image_ = std::make_unique<Memory::BufferImage>(img_props);
 
         if(!buffer_image_) { Debug::logErrorAndDie("Fail to create Texture: unable to create TextureImage!"); }
 
         vk::Queue queue = ApplicationData::data->transfer_queue;
+        vk::CommandBuffer command_buffer = beginSingleTimeCommands();
+
+        transitionImageLayout(command_buffer, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, 0, mip_levels);
+        copyBufferToImage(command_buffer, staging_buffer->getBuffer(), levels);
+
+        if (blit_mips)
+            generateMipmaps(command_buffer, tex_width, tex_height, mip_levels);
+        else
+            transitionImageLayout(command_buffer, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, 0, mip_levels);
 
-        transitionImageLayout(vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, queue);
-        copyBufferToImage(staging_buffer->getBuffer(), static_cast<uint32_t>(tex_width), static_cast<uint32_t>(tex_height), queue);
-        transitionImageLayout(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, queue);
+        if (wait) {
+            endSingleTimeCommands(command_buffer, queue);
+            return;
+        }
+
+        // Frames submitted after it on the same queue wait for the copy through the last barrier.
+        command_buffer.end();
+
+        Upload upload = {};
+        upload.staging_buffer = std::move(staging_buffer);
+        upload.command_buffer = command_buffer;
+        upload.fence          = ApplicationData::data->device.createFence(vk::FenceCreateInfo{});
+
+        vk::SubmitInfo submit_info = {};
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers    = &command_buffer;
+
+        queue.submit({submit_info}, upload.fence);
+        uploads_.push_back(std::move(upload));
+    }
+
+    void Texture::freeUpload(Upload& upload)
+    {
+        auto app_data = ApplicationData::data;
+
+        app_data->device.destroyFence(upload.fence);
+        app_data->device.freeCommandBuffers(app_data->graphic_command_pool, 1, &upload.command_buffer);
+        upload.staging_buffer.reset();
+    }
+
+    bool Texture::supportsLinearBlit(vk::Format format)
+    {
+        vk::FormatFeatureFlags features = ApplicationData::data->gpu.getFormatProperties(format).optimalTilingFeatures;
+        vk::FormatFeatureFlags required = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst |
+                                          vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+
+        return (features & required) == required;
+    }
+
+    void Texture::generateMipmaps(vk::CommandBuffer command_buffer, uint32_t tex_width, uint32_t tex_height, uint32_t mip_levels)
+    {
+        auto mip_width  = static_cast<int32_t>(tex_width);
+        auto mip_height = static_cast<int32_t>(tex_height);
+
+        for (uint32_t i = 1; i < mip_levels; ++i)
+        {
+            // Level i - 1 is complete, read from it.
+            transitionImageLayout(command_buffer, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal, i - 1, 1);
+
+            vk::ImageBlit blit = {};
+            blit.srcOffsets[0]                  = vk::Offset3D{0, 0, 0};
+            blit.srcOffsets[1]                  = vk::Offset3D{mip_width, mip_height, 1};
+            blit.srcSubresource.aspectMask      = vk::ImageAspectFlagBits::eColor;
+            blit.srcSubresource.mipLevel        = i - 1;
+            blit.srcSubresource.baseArrayLayer  = 0;
+            blit.srcSubresource.layerCount      = 1;
+
+            mip_width  = std::max(1, mip_width / 2);
+            mip_height = std::max(1, mip_height / 2);
+
+            blit.dstOffsets[0]                  = vk::Offset3D{0, 0, 0};
+            blit.dstOffsets[1]                  = vk::Offset3D{mip_width, mip_height, 1};
+            blit.dstSubresource.aspectMask      = vk::ImageAspectFlagBits::eColor;
+            blit.dstSubresource.mipLevel        = i;
+            blit.dstSubresource.baseArrayLayer  = 0;
+            blit.dstSubresource.layerCount      = 1;
+
+            command_buffer.blitImage(buffer_image_->image, vk::ImageLayout::eTransferSrcOptimal,
+                                     buffer_image_->image, vk::ImageLayout::eTransferDstOptimal,
+                                     1, &blit, vk::Filter::eLinear);
+
+            transitionImageLayout(command_buffer, vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, i - 1, 1);
+        }
 
+        transitionImageLayout(command_buffer, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, mip_levels - 1, 1);
     }
 
     vk::CommandBuffer Texture::beginSingleTimeCommands()
@@ -173,10 +511,9 @@ namespace Engine::Descriptors
         app_data->device.freeCommandBuffers(app_data->graphic_command_pool, 1, &commandBuffer);
     }
 
-    void Texture::transitionImageLayout(vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::Queue graphicsQueue)
+    void Texture::transitionImageLayout(vk::CommandBuffer commandBuffer, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                                        uint32_t base_mip_level, uint32_t level_count)
     {
-        vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
         vk::ImageMemoryBarrier barrier = {};
         barrier.oldLayout 							= oldLayout;
         barrier.newLayout 							= newLayout;
@@ -184,8 +521,8 @@ namespace Engine::Descriptors
         barrier.dstQueueFamilyIndex 				= VK_QUEUE_FAMILY_IGNORED;
         barrier.image 								= buffer_image_->image;
         barrier.subresourceRange.aspectMask 		= vk::ImageAspectFlagBits::eColor;
-        barrier.subresourceRange.baseMipLevel 		= 0;
-        barrier.subresourceRange.levelCount 		= 1;
+        barrier.subresourceRange.baseMipLevel 		= base_mip_level;
+        barrier.subresourceRange.levelCount 		= level_count;
         barrier.subresourceRange.baseArrayLayer 	= 0;
         barrier.subresourceRange.layerCount 		= 1;
 
@@ -198,38 +535,51 @@ namespace Engine::Descriptors
 
             sourceStage 							= vk::PipelineStageFlagBits::eTopOfPipe;
             destinationStage 						= vk::PipelineStageFlagBits::eTransfer;
+        } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eTransferSrcOptimal) {
+            barrier.srcAccessMask 					= vk::AccessFlagBits::eTransferWrite;
+            barrier.dstAccessMask 					= vk::AccessFlagBits::eTransferRead;
+
+            sourceStage                             = vk::PipelineStageFlagBits::eTransfer;
+            destinationStage                        = vk::PipelineStageFlagBits::eTransfer;
         } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
             barrier.srcAccessMask 					= vk::AccessFlagBits::eTransferWrite;
             barrier.dstAccessMask 					= vk::AccessFlagBits::eShaderRead;
 
             sourceStage                             = vk::PipelineStageFlagBits::eTransfer;
-            destinationStage                        = vk::PipelineStageFlagBits::eFragmentShader;
+            destinationStage                        = vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader;
+        } else if (oldLayout == vk::ImageLayout::eTransferSrcOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+            barrier.srcAccessMask 					= vk::AccessFlagBits::eTransferRead;
+            barrier.dstAccessMask 					= vk::AccessFlagBits::eShaderRead;
+
+            sourceStage                             = vk::PipelineStageFlagBits::eTransfer;
+            destinationStage                        = vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader;
         } else {
             return;
         }
 
         commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
-
-        endSingleTimeCommands(commandBuffer, graphicsQueue);
     }
 
-    void Texture::copyBufferToImage(vk::Buffer buffer, uint32_t width, uint32_t height, vk::Queue graphicsQueue)
+    void Texture::copyBufferToImage(vk::CommandBuffer commandBuffer, vk::Buffer buffer, const std::vector<Util::MipLevel>& levels)
     {
-        vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-        vk::BufferImageCopy region = {};
-        region.bufferOffset 					= 0;
-        region.bufferRowLength 					= 0;
-        region.bufferImageHeight 				= 0;
-        region.imageOffset 						= vk::Offset3D{0, 0, 0};
-        region.imageExtent 						= vk::Extent3D{width, height, 1};
-        region.imageSubresource.aspectMask 		= vk::ImageAspectFlagBits::eColor;
-        region.imageSubresource.mipLevel 		= 0;
-        region.imageSubresource.baseArrayLayer 	= 0;
-        region.imageSubresource.layerCount 		= 1;
-
-        commandBuffer.copyBufferToImage(buffer, buffer_image_->image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+        std::vector<vk::BufferImageCopy> regions = {};
+        regions.reserve(levels.size());
+
+        for (uint32_t i = 0; i < levels.size(); ++i)
+        {
+            vk::BufferImageCopy region = {};
+            region.bufferOffset 					= levels[i].offset;
+            region.bufferRowLength 					= 0;
+            region.bufferImageHeight 				= 0;
+            region.imageOffset 						= vk::Offset3D{0, 0, 0};
+            region.imageExtent 						= vk::Extent3D{levels[i].width, levels[i].height, 1};
+            region.imageSubresource.aspectMask 		= vk::ImageAspectFlagBits::eColor;
+            region.imageSubresource.mipLevel 		= i;
+            region.imageSubresource.baseArrayLayer 	= 0;
+            region.imageSubresource.layerCount 		= 1;
+            regions.push_back(region);
+        }
 
-        endSingleTimeCommands(commandBuffer, graphicsQueue);
+        commandBuffer.copyBufferToImage(buffer, buffer_image_->image, vk::ImageLayout::eTransferDstOptimal, regions);
     }
 }
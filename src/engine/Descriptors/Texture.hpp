@@ -8,6 +8,10 @@
 
 #include <vector>
 #include <Memory/BufferImage.h>
+#include <Util/MipGenerator.h>
+#include <Util/Ktx2.h>
+#include <Util/CookedAsset.h>
+#include <Util/AsyncIO.h>
 #include "Memory/Memory.h"
 #include "Memory/Buffer.h"
 
@@ -15,6 +19,24 @@ namespace Engine
 {
 	namespace Descriptors
 	{
+		/**
+		 * Decoded pixels, ready to be uploaded. Can be produced on any thread (see Texture::decode).
+		 * RGBA8 data without 'levels' gets its mip chain generated at upload, otherwise every level is already stored.
+		 * */
+		struct TextureData
+		{
+			std::shared_ptr<unsigned char> pixels = nullptr;
+			uint32_t width  = 0;
+			uint32_t height = 0;
+			vk::Format format = vk::Format::eR8G8B8A8Unorm;
+			std::vector<Util::MipLevel> levels = {};
+
+			[[nodiscard]] size_t getByteSize() const
+			{
+				return levels.empty() ? static_cast<size_t>(width) * height * 4 : Util::MipGenerator::getChainSize(levels);
+			}
+		};
+
 		class Texture
 		{
 
@@ -24,28 +46,117 @@ namespace Engine
 			vk::Sampler sampler_ = {};
 			vk::DescriptorImageInfo buffer_info_{};
 
+			// Streamed textures only (see TextureStreamer).
+			TextureData streamed_data_ = {};			// Every level, usually mapped from the cooked file.
+			uint32_t resident_level_ = 0;				// Finest level in the image.
+			uint32_t requested_level_ = UINT32_MAX;		// Finest level asked since the last takeRequestedLevel().
+			uint32_t version_ = 0;						// Changes with the image, descriptor sets are written again.
+
+			/**
+			 * Copy queued by setResidentLevel, freed once its fence is signaled.
+			 * */
+			struct Upload
+			{
+				std::unique_ptr<Memory::Buffer<unsigned char>> staging_buffer = nullptr;
+				vk::CommandBuffer command_buffer = {};
+				vk::Fence fence = {};
+			};
+
+			/**
+			 * Image replaced by setResidentLevel, kept while recorded command buffers may still sample it.
+			 * */
+			struct Retired
+			{
+				std::unique_ptr<Memory::BufferImage> buffer_image = nullptr;
+				vk::Sampler sampler = {};
+			};
+
+			std::vector<Upload> uploads_ = {};
+			std::vector<Retired> retired_ = {};
+
 		public:
 
 			Texture(vk::Image image_ptr, uint32_t tex_width, uint32_t tex_height);
 			explicit Texture(const std::string &texture_path);
+			explicit Texture(const TextureData &texture_data);
 			explicit Texture(std::unique_ptr<Memory::BufferImage> buffer_image_);
             explicit Texture(unsigned char* pixels, uint32_t tex_width, uint32_t tex_height);
 
+			/**
+			 * Streamed texture: 'texture_data' must have stored levels, only those from 'first_level' are uploaded.
+			 * */
+			Texture(const TextureData &texture_data, uint32_t first_level);
+
 			~Texture();
 
 			vk::ImageView getImageView() const;
             vk::Image getImage() const;
 			vk::WriteDescriptorSet getWrite(vk::DescriptorSet dst_set, uint32_t dst_binding) const;
 
+			[[nodiscard]] bool isStreamed() const;
+			[[nodiscard]] const TextureData& getStreamedData() const;
+			[[nodiscard]] uint32_t getResidentLevel() const;
+
+			void requestLevel(uint32_t level);
+			uint32_t takeRequestedLevel();
+
+			/**
+			 * Swap the image for one made of 'levels' (see getLevels), 'first_level' and smaller. The copy is queued
+			 * behind the frames in flight without waiting for it. Descriptor sets must be written again (see
+			 * getVersion), the previous image stays valid until releaseRetired().
+			 * */
+			void setResidentLevel(const TextureData &levels, uint32_t first_level);
+
+			/**
+			 * Free the images setResidentLevel replaced, once no recorded command buffer uses them any more.
+			 * */
+			void releaseRetired();
+
+			[[nodiscard]] uint32_t getVersion() const;
+
+			/**
+			 * Copy of the stored levels from 'first_level', as a texture of its own. Safe to call from any thread.
+			 * */
+			static TextureData getLevels(const TextureData &texture_data, uint32_t first_level);
+
+			/**
+			 * Load '<assets>/texture_path'. When the device supports BC formats, images are block-compressed
+			 * once and cached as KTX2 under the cooked folder. '.ktx2' paths are loaded as is.
+			 * Cooked KTX2 (loose or archived) is uploaded straight from its mapping.
+			 * */
+			static TextureData decode(const std::string &texture_path);
+
+			/**
+			 * Same as decode(texture_path), with the file named by getSourcePath() already read (see Util::AsyncIO).
+			 * */
+			static TextureData decode(const std::string &texture_path, const Util::IOBuffer &source);
+
+			/**
+			 * File decode() reads, empty when the texture comes from mapped cooked data.
+			 * */
+			static std::string getSourcePath(const std::string &texture_path);
+			static TextureData decodeImage(const Util::IOBuffer &source);
+			static std::string getCookedPath(const std::string &texture_path);
+
 		private:
 
 			void createSampler();
-			void transitionImageLayout(vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::Queue graphicsQueue);
-			void copyBufferToImage(vk::Buffer buffer, uint32_t width, uint32_t height, vk::Queue graphicsQueue);
+			void transitionImageLayout(vk::CommandBuffer commandBuffer, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+									   uint32_t base_mip_level, uint32_t level_count);
+			void copyBufferToImage(vk::CommandBuffer commandBuffer, vk::Buffer buffer, const std::vector<Util::MipLevel>& levels);
+			void generateMipmaps(vk::CommandBuffer command_buffer, uint32_t tex_width, uint32_t tex_height, uint32_t mip_levels);
             void submitPixels(unsigned char* pixels, uint32_t tex_width, uint32_t tex_height);
+			void submitLevels(unsigned char* pixels, vk::Format format, uint32_t tex_width, uint32_t tex_height,
+							  const std::vector<Util::MipLevel>& levels, uint32_t mip_levels, bool wait = true);
+
+			static TextureData fromKtx2(Util::Ktx2Image&& image);
+			static TextureData fromKtx2(Util::Ktx2Image&& image, const Util::CookedData& cooked);
+
+			static bool supportsLinearBlit(vk::Format format);
 
 			static vk::CommandBuffer beginSingleTimeCommands();
 			static void endSingleTimeCommands(vk::CommandBuffer commandBuffer, vk::Queue graphicsQueue);
+			static void freeUpload(Upload& upload);
 		};
 	}
 }
@@ -0,0 +1,158 @@
+#include <cstring>
+#include <filesystem>
+#include <Util/Util.h>
+#include <Util/AsyncIO.h>
+#include <Util/Hash.h>
+#include <Util/ThreadPool.h>
+#include "TextureStreamer.h"
+#include "TextureCache.h"
+
+namespace Engine::Descriptors
+{
+    std::mutex                                                  TextureCache::mutex_ = {};
+    std::unordered_map<std::string, std::weak_ptr<Texture>>     TextureCache::by_path_ = {};
+    std::unordered_map<uint64_t, TextureCache::ContentEntry>    TextureCache::by_content_ = {};
+
+    std::string TextureCache::getKey(const std::string& texture_path)
+    {
+        std::error_code error;
+        auto assets_texture_path = std::filesystem::path(ASSETS_FOLDER_PATH_STR) / texture_path;
+        auto canonical_path = std::filesystem::weakly_canonical(assets_texture_path, error);
+
+        return error ? assets_texture_path.lexically_normal().string() : canonical_path.string();
+    }
+
+    uint64_t TextureCache::hashContent(const TextureData& texture_data)
+    {
+        // Seeded with image size and format.
+        uint64_t hash = Util::Hash::mix(Util::Hash::FNV_OFFSET, (static_cast<uint64_t>(texture_data.width) << 32u) | texture_data.height);
+        hash = Util::Hash::mix(hash, static_cast<uint64_t>(texture_data.format));
+
+        return Util::Hash::fnv1a(texture_data.pixels.get(), texture_data.getByteSize(), hash);
+    }
+
+    bool TextureCache::matches(const ContentEntry& entry, const TextureData& texture_data)
+    {
+        if (entry.width != texture_data.width || entry.height != texture_data.height)
+            return false;
+        if (entry.format != texture_data.format || entry.byte_size != texture_data.getByteSize())
+            return false;
+
+        auto pixels = entry.pixels.lock();
+        if (!pixels || !texture_data.pixels)
+            return false;
+
+        return pixels == texture_data.pixels || std::memcmp(pixels.get(), texture_data.pixels.get(), entry.byte_size) == 0;
+    }
+
+    std::shared_ptr<Texture> TextureCache::findLocked(const std::string& key)
+    {
+        auto it = by_path_.find(key);
+        if (it == by_path_.end())
+            return nullptr;
+
+        auto texture = it->second.lock();
+        if (!texture)
+            by_path_.erase(it);
+
+        return texture;
+    }
+
+    std::vector<DecodedTexture> TextureCache::decode(const std::vector<std::string>& texture_paths,
+                                                     const std::vector<std::shared_ptr<std::vector<uint8_t>>>& embedded_images)
+    {
+        auto getEmbedded = [&embedded_images](size_t index)
+        {
+            return index < embedded_images.size() ? embedded_images[index] : nullptr;
+        };
+
+        std::vector<DecodedTexture> decoded(texture_paths.size());
+
+        // Index of the first request of each path still to decode.
+        std::unordered_map<std::string, size_t> first_request = {};
+        std::vector<size_t> to_decode = {};
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            for (size_t i = 0; i < texture_paths.size(); ++i)
+            {
+                decoded[i].key = getKey(texture_paths[i]);
+                decoded[i].texture = findLocked(decoded[i].key);
+
+                if (!decoded[i].texture && first_request.emplace(decoded[i].key, i).second)
+                    to_decode.push_back(i);
+            }
+        }
+
+        // Every read is in flight before the first decode waits on one.
+        std::vector<std::string> source_paths = {};
+        for (size_t index : to_decode)
+            source_paths.push_back(getEmbedded(index) ? "" : Texture::getSourcePath(texture_paths[index]));
+
+        auto sources = Util::AsyncIO::getInstance()->read(source_paths);
+
+        Util::ThreadPool::getInstance()->parallelFor(to_decode.size(), [&](size_t i)
+        {
+            DecodedTexture& request = decoded[to_decode[i]];
+            auto embedded = getEmbedded(to_decode[i]);
+
+            if (embedded)
+                request.data = Texture::decodeImage(Util::IOBuffer{std::shared_ptr<uint8_t>(embedded, embedded->data()), embedded->size()});
+            else
+                request.data = Texture::decode(texture_paths[to_decode[i]], sources[i].get());
+            request.content_hash = hashContent(request.data);
+        });
+
+        // Duplicated paths share the decoded pixels.
+        for (auto& request : decoded)
+            if (!request.texture && !request.data.pixels)
+                request = decoded[first_request[request.key]];
+
+        return decoded;
+    }
+
+    std::shared_ptr<Texture> TextureCache::upload(const DecodedTexture& decoded)
+    {
+        if (decoded.texture)
+            return decoded.texture;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (auto texture = findLocked(decoded.key))
+                return texture;
+
+            // Same pixels under another path.
+            auto it = by_content_.find(decoded.content_hash);
+            if (it != by_content_.end()) {
+                auto texture = it->second.texture.lock();
+                if (!texture)
+                    by_content_.erase(it);
+                else if (matches(it->second, decoded.data)) {
+                    by_path_[decoded.key] = texture;
+                    return texture;
+                }
+            }
+        }
+
+        auto texture = TextureStreamer::getInstance()->create(decoded.data);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        by_path_[decoded.key] = texture;
+
+        // A verifiable entry is kept on collision; the new texture is simply not shared.
+        auto it = by_content_.find(decoded.content_hash);
+        if (it == by_content_.end() || it->second.texture.expired() || it->second.pixels.expired()) {
+            by_content_[decoded.content_hash] = {texture, decoded.data.pixels, decoded.data.width, decoded.data.height,
+                                                 decoded.data.format, decoded.data.getByteSize()};
+        }
+
+        return texture;
+    }
+
+    std::shared_ptr<Texture> TextureCache::get(const std::string& texture_path)
+    {
+        return upload(decode({texture_path})[0]);
+    }
+}
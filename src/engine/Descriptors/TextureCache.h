@@ -0,0 +1,80 @@
+#ifndef GYMNURE_TEXTURECACHE_H
+#define GYMNURE_TEXTURECACHE_H
+
+#include <mutex>
+#include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "Texture.hpp"
+
+namespace Engine::Descriptors
+{
+    /**
+     * Texture::decode result tagged for the cache. 'texture' is set when the image was already cached.
+     * */
+    struct DecodedTexture
+    {
+        std::string                 key             = "";
+        uint64_t                    content_hash    = 0;
+        TextureData                 data            = {};
+        std::shared_ptr<Texture>    texture         = nullptr;
+    };
+
+    /**
+     * Shares Texture handles by canonical path, and by pixel content between different paths.
+     * Entries are weak: a texture lives as long as some object uses it.
+     * */
+    class TextureCache
+    {
+
+    private:
+
+        /**
+         * A content hash alone can collide, so each entry keeps what is needed to compare the pixels.
+         * The pixels are weak: once the source data is gone the entry can no longer be verified and
+         * a hit falls back to a new upload.
+         * */
+        struct ContentEntry
+        {
+            std::weak_ptr<Texture>          texture     = {};
+            std::weak_ptr<unsigned char>    pixels      = {};
+            uint32_t                        width       = 0;
+            uint32_t                        height      = 0;
+            vk::Format                      format      = vk::Format::eUndefined;
+            size_t                          byte_size   = 0;
+        };
+
+        static std::mutex                                                   mutex_;
+        static std::unordered_map<std::string, std::weak_ptr<Texture>>      by_path_;
+        static std::unordered_map<uint64_t, ContentEntry>                   by_content_;
+
+        static std::shared_ptr<Texture> findLocked(const std::string& key);
+        static bool matches(const ContentEntry& entry, const TextureData& texture_data);
+
+    public:
+
+        TextureCache() = delete;
+
+        static std::string getKey(const std::string& texture_path);
+        static uint64_t hashContent(const TextureData& texture_data);
+
+        /**
+         * Decode every path missing from cache in parallel, each unique path once.
+         * 'embedded_images', when given, is aligned to 'texture_paths': a non null entry is the encoded image
+         * itself (see Material::texture_bytes) and its path is only the cache key.
+         * Result is aligned to 'texture_paths'. Safe to call from any thread.
+         * */
+        static std::vector<DecodedTexture> decode(const std::vector<std::string>& texture_paths,
+                                                  const std::vector<std::shared_ptr<std::vector<uint8_t>>>& embedded_images = {});
+
+        /**
+         * Create (or reuse) the Texture of a decoded image. Must run on the render thread.
+         * */
+        static std::shared_ptr<Texture> upload(const DecodedTexture& decoded);
+
+        static std::shared_ptr<Texture> get(const std::string& texture_path);
+    };
+}
+
+#endif //GYMNURE_TEXTURECACHE_H
@@ -0,0 +1,226 @@
+#include <cmath>
+#include <mutex>
+#include <algorithm>
+#include <Util/ThreadPool.h>
+#include "TextureStreamer.h"
+
+namespace Engine::Descriptors
+{
+    std::shared_ptr<TextureStreamer> TextureStreamer::instance = nullptr;
+
+    std::shared_ptr<TextureStreamer> TextureStreamer::getInstance()
+    {
+        static std::once_flag once;
+        std::call_once(once, []()
+        {
+            instance = std::make_shared<TextureStreamer>();
+        });
+
+        return instance;
+    }
+
+    size_t TextureStreamer::getLevelsSize(const TextureData& texture_data, uint32_t first_level)
+    {
+        size_t size = 0;
+        for (uint32_t i = first_level; i < texture_data.levels.size(); ++i)
+            size += texture_data.levels[i].size;
+
+        return size;
+    }
+
+    std::shared_ptr<Texture> TextureStreamer::create(const TextureData& texture_data)
+    {
+        auto level_count = static_cast<uint32_t>(texture_data.levels.size());
+
+        uint32_t tail_level = 0;
+        while (tail_level + 1 < level_count &&
+               std::max(texture_data.levels[tail_level].width, texture_data.levels[tail_level].height) > MIP_TAIL_SIZE)
+            tail_level++;
+
+        // Generated chains and images small enough are uploaded whole.
+        if (tail_level == 0)
+            return std::make_shared<Texture>(texture_data);
+
+        auto texture = std::make_shared<Texture>(texture_data, tail_level);
+
+        StreamedTexture streamed = {};
+        streamed.texture      = texture;
+        streamed.tail_level   = tail_level;
+        streamed.target_level = tail_level;
+        streamed.wanted_level = tail_level;
+        streamed.size         = getLevelsSize(texture_data, tail_level);
+        streamed.last_needed  = frame_;
+
+        committed_size_ += streamed.size;
+        textures_.push_back(std::move(streamed));
+
+        return texture;
+    }
+
+    void TextureStreamer::requestLevels(Texture& texture, const Bounds& bounds, float uv_density, const Camera& camera)
+    {
+        if (!texture.isStreamed() || !Camera::isSphereVisible(camera.getFrustumPlanes(), bounds.center, bounds.radius))
+            return;
+
+        float distance = glm::length(bounds.center - camera.getEyePosition()) - bounds.radius;
+        if (uv_density <= 0.f || distance <= 0.f) {
+            texture.requestLevel(0);
+            return;
+        }
+
+        // Texels under a pixel at the closest point of the object, every level halves them.
+        const TextureData& texture_data = texture.getStreamedData();
+        auto texture_size = static_cast<float>(std::max(texture_data.width, texture_data.height));
+        float texels_per_pixel = uv_density * texture_size * distance / camera.getPixelsPerUnit();
+
+        auto level = texels_per_pixel > 1.f ? static_cast<uint32_t>(std::floor(std::log2(texels_per_pixel))) : 0u;
+        texture.requestLevel(std::min(level, static_cast<uint32_t>(texture_data.levels.size() - 1)));
+    }
+
+    void TextureStreamer::startLoad(StreamedTexture& streamed, const Texture& texture, uint32_t level)
+    {
+        // Both images live until the replaced one is released, so only then is its size given back.
+        streamed.target_size = getLevelsSize(texture.getStreamedData(), level);
+        committed_size_ += streamed.target_size;
+        releasing_size_ += streamed.size;
+
+        streamed.target_level = level;
+        streamed.load         = Util::ThreadPool::getInstance()->submit([texture_data = texture.getStreamedData(), level]() {
+            return Texture::getLevels(texture_data, level);
+        });
+    }
+
+    bool TextureStreamer::makeRoom(size_t size)
+    {
+        if (committed_size_ + size <= budget_)
+            return true;
+
+        // Evictions already started count, they only free memory once applied and released.
+        auto isEnough = [this, size]() { return committed_size_ - releasing_size_ + size <= budget_; };
+
+        // Levels nobody needs any more, from the textures that needed them least recently.
+        std::vector<size_t> candidates = {};
+        for (size_t i = 0; i < textures_.size(); ++i)
+            if (!textures_[i].load.valid() && textures_[i].wanted_level > textures_[i].target_level)
+                candidates.push_back(i);
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [this](size_t a, size_t b) { return textures_[a].last_needed < textures_[b].last_needed; });
+
+        for (size_t i = 0; i < candidates.size() && !isEnough(); ++i)
+        {
+            StreamedTexture& streamed = textures_[candidates[i]];
+            if (auto texture = streamed.texture.lock())
+                startLoad(streamed, *texture, streamed.wanted_level);
+        }
+
+        return committed_size_ + size <= budget_;
+    }
+
+    bool TextureStreamer::update()
+    {
+        frame_++;
+
+        struct Upgrade
+        {
+            size_t      index = 0;
+            uint32_t    level = 0;
+        };
+
+        std::vector<Upgrade> upgrades = {};
+        uint32_t pending_loads = 0;
+        bool loads_ready = false;
+
+        for (size_t i = 0; i < textures_.size();)
+        {
+            StreamedTexture& streamed = textures_[i];
+            auto texture = streamed.texture.lock();
+
+            // Released by every object, a pending load is simply dropped. The texture freed its images.
+            if (texture == nullptr) {
+                size_t loading_size = streamed.load.valid() ? streamed.target_size : 0;
+                size_t replaced_size = streamed.load.valid() ? streamed.size : 0;
+                committed_size_ -= streamed.size + loading_size + streamed.retired_size;
+                releasing_size_ -= replaced_size + streamed.retired_size;
+                std::swap(streamed, textures_.back());
+                textures_.pop_back();
+                continue;
+            }
+
+            streamed.wanted_level = std::min(texture->takeRequestedLevel(), streamed.tail_level);
+            if (streamed.wanted_level <= streamed.target_level)
+                streamed.last_needed = frame_;
+
+            if (streamed.load.valid()) {
+                pending_loads++;
+                loads_ready |= streamed.load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            } else if (streamed.wanted_level < streamed.target_level) {
+                upgrades.push_back({i, streamed.wanted_level});
+            }
+
+            ++i;
+        }
+
+        // Most blurry first.
+        std::sort(upgrades.begin(), upgrades.end(), [this](const Upgrade& a, const Upgrade& b) {
+            return textures_[a.index].target_level - a.level > textures_[b.index].target_level - b.level;
+        });
+
+        for (const Upgrade& upgrade : upgrades)
+        {
+            if (pending_loads >= MAX_PENDING_LOADS)
+                break;
+
+            StreamedTexture& streamed = textures_[upgrade.index];
+            auto texture = streamed.texture.lock();
+
+            // The current image stays until the new one replaced it.
+            size_t size = getLevelsSize(texture->getStreamedData(), upgrade.level);
+            if (!makeRoom(size))
+                continue;
+
+            startLoad(streamed, *texture, upgrade.level);
+            pending_loads++;
+        }
+
+        return loads_ready && frame_ - last_swap_frame_ >= SWAP_INTERVAL;
+    }
+
+    void TextureStreamer::applyLoads()
+    {
+        for (StreamedTexture& streamed : textures_)
+        {
+            if (!streamed.load.valid() || streamed.load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+
+            TextureData levels = streamed.load.get();
+            if (auto texture = streamed.texture.lock())
+                texture->setResidentLevel(levels, streamed.target_level);
+
+            streamed.retired_size += streamed.size;
+            streamed.size = streamed.target_size;
+            streamed.target_size = 0;
+        }
+
+        last_swap_frame_ = frame_;
+    }
+
+    void TextureStreamer::releaseRetired()
+    {
+        for (StreamedTexture& streamed : textures_)
+        {
+            // Also frees the staging buffers of finished copies.
+            if (auto texture = streamed.texture.lock())
+                texture->releaseRetired();
+
+            committed_size_ -= streamed.retired_size;
+            releasing_size_ -= streamed.retired_size;
+            streamed.retired_size = 0;
+        }
+    }
+
+    void TextureStreamer::setBudget(size_t budget)
+    {
+        budget_ = budget;
+    }
+}
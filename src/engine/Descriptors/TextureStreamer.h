@@ -0,0 +1,101 @@
+#ifndef GYMNURE_TEXTURESTREAMER_H
+#define GYMNURE_TEXTURESTREAMER_H
+
+#include <future>
+#include <memory>
+#include <vector>
+#include <Util/ModelData.hpp>
+#include "Camera.h"
+#include "Texture.hpp"
+
+namespace Engine::Descriptors
+{
+    /**
+     * Keeps on the GPU the texture levels that objects on screen need, within a memory budget.
+     *
+     * Textures with stored levels (KTX2, cooked or not) start with their mip tail only, the levels up to
+     * MIP_TAIL_SIZE. Every frame programs request the finest level each object needs, from its screen footprint
+     * and UV density (see requestLevels). Missing levels are copied out of the texture data, usually a mapped
+     * cooked file, on the thread pool. When the budget is full, textures least recently needing all their levels
+     * drop the levels they no longer need first.
+     *
+     * New levels mean a new image, so loads are applied together, at most every SWAP_INTERVAL frames. Their copies
+     * are queued without waiting, descriptor sets of the objects using them are written again and command buffers
+     * recorded again as they become free (see Application::draw). Replaced images are released once no recording
+     * uses them, the budget counts them until then.
+     * */
+    class TextureStreamer
+    {
+    public:
+
+        static constexpr uint32_t MIP_TAIL_SIZE  = 128;
+        static constexpr size_t   DEFAULT_BUDGET = 512 * 1024 * 1024;
+
+    private:
+
+        static constexpr uint32_t MAX_PENDING_LOADS = 8;
+        static constexpr uint64_t SWAP_INTERVAL     = 30;
+
+        struct StreamedTexture
+        {
+            std::weak_ptr<Texture>      texture         = {};
+            uint32_t                    tail_level      = 0;    // Coarser levels are always resident.
+            uint32_t                    target_level    = 0;    // Resident level once 'load' is applied.
+            uint32_t                    wanted_level    = 0;    // Finest level needed this frame.
+            size_t                      size            = 0;    // Of the image in use.
+            size_t                      target_size     = 0;    // Of the levels from 'target_level', while loading.
+            size_t                      retired_size    = 0;    // Of the replaced image, until releaseRetired().
+            uint64_t                    last_needed     = 0;    // Last frame every target level was needed.
+            std::future<TextureData>    load            = {};
+        };
+
+        static std::shared_ptr<TextureStreamer> instance;
+
+        std::vector<StreamedTexture>    textures_           = {};
+        size_t                          budget_             = DEFAULT_BUDGET;
+        size_t                          committed_size_     = 0;    // Of every image, loading and replaced ones too.
+        size_t                          releasing_size_     = 0;    // Of the images loads will replace.
+        uint64_t                        frame_              = 0;
+        uint64_t                        last_swap_frame_    = 0;
+
+        static size_t getLevelsSize(const TextureData& texture_data, uint32_t first_level);
+
+        void startLoad(StreamedTexture& streamed, const Texture& texture, uint32_t level);
+        bool makeRoom(size_t size);
+
+    public:
+
+        static std::shared_ptr<TextureStreamer> getInstance();
+
+        /**
+         * Texture of 'texture_data', streamed when it has stored levels past the mip tail. Render thread only.
+         * */
+        std::shared_ptr<Texture> create(const TextureData& texture_data);
+
+        /**
+         * Ask for the levels 'texture' needs on an object of world space 'bounds', with 'uv_density' UV units per
+         * world unit (0 when unknown, asks for every level). Nothing is asked when the object is out of view.
+         * */
+        static void requestLevels(Texture& texture, const Bounds& bounds, float uv_density, const Camera& camera);
+
+        /**
+         * Once per frame, after every request. True when loads are ready for applyLoads().
+         * */
+        bool update();
+
+        /**
+         * Swap finished loads in. Descriptor sets of the textures must be written again (see Texture::getVersion),
+         * and command buffers recorded again with them.
+         * */
+        void applyLoads();
+
+        /**
+         * Free the images loads replaced. Only once every command buffer was recorded again since applyLoads().
+         * */
+        void releaseRetired();
+
+        void setBudget(size_t budget);
+    };
+}
+
+#endif //GYMNURE_TEXTURESTREAMER_H
@@ -1,18 +1,62 @@
+#include <numeric>
 #include "Deferred.hpp"
 
 namespace Engine::GraphicsPipeline
 {
-    Deferred::Deferred() : pipeline_ (std::make_unique<Pipeline>((uint32_t)1)) {}
-
-    uint32_t Deferred::createProgram(Programs::ProgramParams &&mrt, Programs::ProgramParams &&present)
+    Deferred::Deferred(RenderGraph& render_graph, Lighting lighting) : lighting_(lighting)
     {
-        vk::RenderPass renderPass = pipeline_->getRenderPass();
+        std::vector<vk::Format> formats = {};
+        for (const GBufferTarget& target : G_BUFFER_TARGETS)
+            formats.push_back(Memory::ImageFormats::getImageFormat(target.type));
+
+        vk::Format depth_format = Memory::ImageFormats::getImageFormat(Memory::ImageType::GBUFFER_DEPTH);
+        vk::Format surface_format = Memory::ImageFormats::getSurfaceFormat().format;
+
+        Descriptors::LayoutData ld = {};
+        ld.has_model_matrix = false;
+
+        if (lighting_ == Lighting::SUBPASS)
+        {
+            // Lighting reads every target, then depth.
+            std::vector<uint32_t> inputs(formats.size() + 1);
+            std::iota(inputs.begin(), inputs.end(), 0);
+
+            render_pass_ = render_graph.getCompatibleRenderPass({
+                {formats, depth_format, {}},
+                {{surface_format}, vk::Format::eUndefined, inputs}
+            });
+
+            // Camera, then the g-buffer and its depth as input attachments, then the lights.
+            ld.has_view_projection_matrix       = true;
+            ld.fragment_uniform_count           = 1;
+            ld.fragment_input_attachment_count  = static_cast<uint32_t>(inputs.size());
+            ld.fragment_storage_buffer_count    = 1;
+
+            Programs::ProgramParams params = {Vertex::EmptyLayout::describe(), ld, "deferred"};
+            params.subpass = 1;
+            lighting_program_ = std::make_shared<Programs::Program>(std::move(params), render_pass_);
+        }
+        else
+        {
+            render_pass_ = render_graph.getCompatibleRenderPass(formats, depth_format);
+            tiled_lighting_ = std::make_unique<TiledLighting>();
+
+            // The shaded image only.
+            ld.has_view_projection_matrix   = false;
+            ld.fragment_texture_count       = 1;
+
+            lighting_program_ = std::make_shared<Programs::Program>(
+                Programs::ProgramParams{Vertex::EmptyLayout::describe(), ld, "deferred_resolve"},
+                render_graph.getCompatibleRenderPass({surface_format}, vk::Format::eUndefined));
+        }
+    }
 
-        Passes passes;
-        passes.mrt = std::make_shared<Programs::Program>(std::move(mrt), renderPass);
-        passes.present = std::make_shared<Programs::Program>(std::move(present), renderPass);
+    uint32_t Deferred::createProgram(Programs::ProgramParams &&mrt)
+    {
+        mrt.subpass                 = 0;
+        mrt.color_attachment_count  = static_cast<uint32_t>(G_BUFFER_TARGETS.size());
 
-        programs_.push_back(passes);
+        programs_.push_back(std::make_shared<Programs::Program>(std::move(mrt), render_pass_));
 
         return static_cast<uint32_t>(programs_.size() - 1);
     }
@@ -22,30 +66,190 @@ namespace Engine::GraphicsPipeline
         if(programs_.size() <= program_id) { Debug::logErrorAndDie("Invalid program ID!"); }
 
         // Add object only to MRT pass.
-        programs_[program_id].mrt->addObjData(std::move(data), type);
+        programs_[program_id]->addObjData(std::move(data), type);
         object_count_++;
     }
 
-    void Deferred::prepare(const std::shared_ptr<Descriptors::Camera> &camera)
+    void Deferred::uploadObjData(uint32_t program_id, std::vector<Programs::ObjectLoadData>&& load_data)
+    {
+        if(programs_.size() <= program_id) { Debug::logErrorAndDie("Invalid program ID!"); }
+
+        if(load_data.empty()) { return; }
+
+        // Add object only to MRT pass.
+        programs_[program_id]->uploadObjData(std::move(load_data));
+        object_count_++;
+    }
+
+    void Deferred::prepare(const std::shared_ptr<Descriptors::Camera> &camera, const std::shared_ptr<Descriptors::Lights> &lights,
+                           RenderGraph& render_graph)
     {
         if(programs_.empty() || object_count_ == 0) { return; }
 
-        std::vector<std::shared_ptr<Programs::Program>> programs = {};
         for(auto& program : programs_)
-        {
-            program.mrt->prepare(camera);
-            program.present->prepare(camera);
+            program->prepare(camera);
 
-            programs.push_back(program.mrt);
-            programs.push_back(program.present);
+        auto lighting_data = lighting_program_->getProgramsData();
+        lighting_set_ = lighting_data->descriptor_layout->createDescriptorSets(1)[0];
+
+        RenderGraph::Pass& g_buffer = render_graph.addPass("g-buffer");
+        std::vector<uint32_t> targets = {};
+        for (const GBufferTarget& target : G_BUFFER_TARGETS)
+        {
+            targets.push_back(render_graph.createImage(target.name, Memory::ImageFormats::getImageFormat(target.type)));
+            g_buffer.writeColor(targets.back(), vk::ClearColorValue(target.clear));
         }
 
-        pipeline_->prepare(programs);
+        uint32_t depth = render_graph.createImage("g-buffer depth", Memory::ImageFormats::getImageFormat(Memory::ImageType::GBUFFER_DEPTH));
+
+        g_buffer
+            .writeDepth(depth, vk::ClearDepthStencilValue{1.0f, 0u})
+            .setBefore([mrt_programs = programs_](vk::CommandBuffer command_buffer, uint32_t) {
+                CommandBuffer::recordCulling(command_buffer, mrt_programs);
+            })
+            .setRecord([mrt_programs = programs_](vk::CommandBuffer command_buffer, uint32_t frame) {
+                CommandBuffer::recordDraws(command_buffer, mrt_programs, frame);
+            });
+
+        if (lighting_ == Lighting::SUBPASS)
+            prepareSubpassLighting(camera, lights, targets, depth, render_graph);
+        else
+            prepareTiledLighting(camera, lights, targets, depth, render_graph);
     }
 
-    void Deferred::render()
+    void Deferred::prepareSubpassLighting(const std::shared_ptr<Descriptors::Camera> &camera, const std::shared_ptr<Descriptors::Lights> &lights,
+                                          const std::vector<uint32_t>& targets, uint32_t depth, RenderGraph& render_graph)
     {
-        if(programs_.empty() || object_count_ == 0) { return; }
-        pipeline_->render();
+        auto lighting_data = lighting_program_->getProgramsData();
+        vk::Pipeline lighting_pipeline = lighting_data->graphic_pipeline->getPipeline();
+        vk::PipelineLayout lighting_layout = lighting_data->descriptor_layout->getPipelineLayout();
+
+        RenderGraph::Pass& lighting = render_graph.addPass("deferred lighting");
+        for (uint32_t target : targets)
+            lighting.readAttachment(target);
+        lighting.readAttachment(depth);
+
+        // Every pixel is written, the backbuffer needs no clear.
+        lighting
+            .writeColor(render_graph.getBackbuffer())
+            .setBindImages([camera, lights, targets, depth, lighting_set = lighting_set_](const RenderGraph& graph) {
+                std::vector<vk::WriteDescriptorSet> writes = camera->getWrites(lighting_set, 0, 1);
+
+                std::vector<uint32_t> inputs = targets;
+                inputs.push_back(depth);
+
+                std::vector<vk::DescriptorImageInfo> image_infos(inputs.size());
+                for (uint32_t i = 0; i < inputs.size(); ++i)
+                {
+                    image_infos[i].imageView    = graph.getImageView(inputs[i]);
+                    image_infos[i].imageLayout  = inputs[i] == depth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                                                                     : vk::ImageLayout::eShaderReadOnlyOptimal;
+
+                    vk::WriteDescriptorSet write = {};
+                    write.dstSet            = lighting_set;
+                    write.dstBinding        = 2 + i;
+                    write.descriptorCount   = 1;
+                    write.descriptorType    = vk::DescriptorType::eInputAttachment;
+                    write.pImageInfo        = &image_infos[i];
+                    writes.push_back(write);
+                }
+
+                writes.push_back(lights->getWrite(lighting_set, 2 + static_cast<uint32_t>(inputs.size())));
+
+                ApplicationData::data->device.updateDescriptorSets(writes, {});
+            })
+            .setRecord([lighting_pipeline, lighting_layout, lights, lighting_set = lighting_set_](vk::CommandBuffer command_buffer, uint32_t frame) {
+                uint32_t width = ApplicationData::data->view_width;
+                uint32_t height = ApplicationData::data->view_height;
+
+                Util::Util::initViewport(command_buffer, width, height);
+                Util::Util::initScissor(command_buffer, width, height);
+
+                command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, lighting_pipeline);
+                command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, lighting_layout, 0, {lighting_set}, {lights->getOffset(frame)});
+                command_buffer.draw(3, 1, 0, 0);
+            });
+    }
+
+    void Deferred::prepareTiledLighting(const std::shared_ptr<Descriptors::Camera> &camera, const std::shared_ptr<Descriptors::Lights> &lights,
+                                        const std::vector<uint32_t>& targets, uint32_t depth, RenderGraph& render_graph)
+    {
+        // Compute cannot write the swapchain everywhere, it shades into an image copied to the backbuffer.
+        uint32_t lit = render_graph.createImage("deferred lit", vk::Format::eR16G16B16A16Sfloat);
+
+        RenderGraph::Pass& tiled = render_graph.addPass("tiled lighting", RenderGraph::PassType::COMPUTE);
+        for (uint32_t target : targets)
+            tiled.readTexture(target);
+
+        tiled
+            .readTexture(depth)
+            .readWriteStorage(lit)
+            .setBindImages([tiled_lighting = tiled_lighting_.get(), camera, lights, targets, depth, lit](const RenderGraph& graph) {
+                tiled_lighting->bind(camera, *lights, {graph.getImageView(targets[0]), graph.getImageView(targets[1]),
+                                                       graph.getImageView(targets[2]), graph.getImageView(depth)},
+                                     graph.getImageView(lit));
+            })
+            .setRecord([tiled_lighting = tiled_lighting_.get(), lights](vk::CommandBuffer command_buffer, uint32_t frame) {
+                tiled_lighting->record(command_buffer, lights->getOffset(frame));
+            });
+
+        auto resolve_data = lighting_program_->getProgramsData();
+        vk::Pipeline resolve_pipeline = resolve_data->graphic_pipeline->getPipeline();
+        vk::PipelineLayout resolve_layout = resolve_data->descriptor_layout->getPipelineLayout();
+
+        render_graph.addPass("deferred resolve")
+            .readTexture(lit)
+            .writeColor(render_graph.getBackbuffer())
+            .setBindImages([lit, sampler = tiled_lighting_->getSampler(), resolve_set = lighting_set_](const RenderGraph& graph) {
+                vk::DescriptorImageInfo image_info = {};
+                image_info.sampler      = sampler;
+                image_info.imageView    = graph.getImageView(lit);
+                image_info.imageLayout  = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+                vk::WriteDescriptorSet write = {};
+                write.dstSet            = resolve_set;
+                write.dstBinding        = 0;
+                write.descriptorCount   = 1;
+                write.descriptorType    = vk::DescriptorType::eCombinedImageSampler;
+                write.pImageInfo        = &image_info;
+
+                ApplicationData::data->device.updateDescriptorSets({write}, {});
+            })
+            .setRecord([resolve_pipeline, resolve_layout, resolve_set = lighting_set_](vk::CommandBuffer command_buffer, uint32_t) {
+                uint32_t width = ApplicationData::data->view_width;
+                uint32_t height = ApplicationData::data->view_height;
+
+                Util::Util::initViewport(command_buffer, width, height);
+                Util::Util::initScissor(command_buffer, width, height);
+
+                command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, resolve_pipeline);
+                command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, resolve_layout, 0, {resolve_set}, {});
+                command_buffer.draw(3, 1, 0, 0);
+            });
+    }
+
+    void Deferred::update(const Descriptors::Camera &camera)
+    {
+        for(auto& program : programs_)
+            program->update(camera);
+    }
+
+    bool Deferred::updatePipelines()
+    {
+        // Every program, not only up to the first updated one.
+        bool updated = false;
+        for (auto& program : programs_)
+            updated = program->updatePipelines() || updated;
+
+        return updated;
+    }
+
+    bool Deferred::updateTextures()
+    {
+        bool updated = false;
+        for (auto& program : programs_)
+            updated = program->updateTextures() || updated;
+
+        return updated;
     }
 }
@@ -1,40 +1,79 @@
 #ifndef GYMNURE_DEFERRED_HPP
 #define GYMNURE_DEFERRED_HPP
 
+#include <array>
 #include <memory>
-#include "Pipeline.hpp"
+#include <Memory/ImageFormats.hpp>
+#include <Descriptors/Lights.h>
+#include "RenderGraph.h"
+#include "TiledLighting.h"
 
 namespace Engine::GraphicsPipeline
 {
     class Deferred
     {
+    public:
+
+        enum class Lighting
+        {
+            SUBPASS,    // A full-screen subpass reading the g-buffer as input attachments, every light per pixel.
+            TILED       // A compute pass shading each tile with the lights reaching it (see TiledLighting).
+        };
 
     private:
 
-        struct Passes
+        struct GBufferTarget
         {
-            std::shared_ptr<Programs::Program> mrt;
-            std::shared_ptr<Programs::Program> present;
+            const char*             name;
+            Memory::ImageType       type;
+            std::array<float, 4>    clear;
         };
 
-        struct {
-            std::unique_ptr<Descriptors::Texture> albedo = nullptr;
-        } g_buffer_;
+        /**
+         * 12 bytes per pixel and 4 of depth, where RGBA16F albedo, normal, position and material took 32 and a
+         * depth-stencil. Positions are rebuilt from depth, the material ID of cleared pixels marks them unlit.
+         * */
+        static constexpr std::array<GBufferTarget, 3> G_BUFFER_TARGETS = {{
+            {"g-buffer albedo",     Memory::ImageType::GBUFFER_ALBEDO,      {0.4f, 0.4f, 0.4f, 1.0f}},
+            {"g-buffer normal",     Memory::ImageType::GBUFFER_NORMAL,      {0.0f, 0.0f, 0.0f, 0.0f}},
+            {"g-buffer material",   Memory::ImageType::GBUFFER_MATERIAL,    {0.0f, 0.0f, 1.0f / 255.0f, 0.0f}},
+        }};
 
-        std::vector<std::unique_ptr<CommandBuffer>>             command_buffers_ = {};
-
-        std::unique_ptr<Pipeline>                               pipeline_ = {};
-        std::vector<Passes>                                     programs_ = {};
+        Lighting                                                lighting_ = Lighting::TILED;
+        vk::RenderPass                                          render_pass_ = {};     // G-buffer, then the lighting subpass when SUBPASS.
+        std::vector<std::shared_ptr<Programs::Program>>         programs_ = {};
         uint32_t                                                object_count_ = 0;
 
+        // Every object is in the g-buffer, lighting is shared by all programs: the lighting subpass, or the
+        // full-screen copy of what the tiled pass shaded.
+        std::shared_ptr<Programs::Program>                      lighting_program_ = nullptr;
+        std::unique_ptr<TiledLighting>                          tiled_lighting_ = nullptr;
+        vk::DescriptorSet                                       lighting_set_ = {};
+
+        void prepareSubpassLighting(const std::shared_ptr<Descriptors::Camera> &camera, const std::shared_ptr<Descriptors::Lights> &lights,
+                                    const std::vector<uint32_t>& targets, uint32_t depth, RenderGraph& render_graph);
+        void prepareTiledLighting(const std::shared_ptr<Descriptors::Camera> &camera, const std::shared_ptr<Descriptors::Lights> &lights,
+                                  const std::vector<uint32_t>& targets, uint32_t depth, RenderGraph& render_graph);
+
     public:
 
-        Deferred();
+        explicit Deferred(RenderGraph& render_graph, Lighting lighting = Lighting::TILED);
 
-        uint32_t createProgram(Programs::ProgramParams &&mrt, Programs::ProgramParams &&present);
+        /**
+         * 'mrt' draws objects into the g-buffer.
+         * */
+        uint32_t createProgram(Programs::ProgramParams &&mrt);
         void addObjData(uint32_t program_id, GymnureObjData&& data, const GymnureObjDataType& type);
-        void prepare(const std::shared_ptr<Descriptors::Camera> &camera);
-        void render();
+        void uploadObjData(uint32_t program_id, std::vector<Programs::ObjectLoadData>&& load_data);
+
+        /**
+         * Prepare every program and declare the g-buffer pass, then the passes lighting it into the backbuffer.
+         * */
+        void prepare(const std::shared_ptr<Descriptors::Camera> &camera, const std::shared_ptr<Descriptors::Lights> &lights,
+                     RenderGraph& render_graph);
+        void update(const Descriptors::Camera &camera);
+        bool updatePipelines();
+        bool updateTextures();
     };
 }
 #endif //GYMNURE_DEFERRED_HPP
@@ -1,12 +1,16 @@
+#include <Memory/ImageFormats.hpp>
 #include "Forward.hpp"
 
 namespace Engine::GraphicsPipeline
 {
-    Forward::Forward() : pipeline_ (std::make_unique<Pipeline>()) {}
+    Forward::Forward(RenderGraph& render_graph, std::shared_ptr<Descriptors::LightClusters> light_clusters)
+        : render_pass_(render_graph.getCompatibleRenderPass({Memory::ImageFormats::getSurfaceFormat().format},
+                                                            Memory::ImageFormats::getImageFormat(Memory::ImageType::DEPTH_STENCIL))),
+          light_clusters_(std::move(light_clusters)) {}
 
     uint32_t Forward::createProgram(Programs::ProgramParams &&params)
     {
-        programs_.push_back(std::make_shared<Programs::Program>(params, pipeline_->getRenderPass()));
+        programs_.push_back(std::make_shared<Programs::Program>(params, render_pass_));
         return static_cast<uint32_t>(programs_.size() - 1);
     }
 
@@ -17,6 +21,13 @@ namespace Engine::GraphicsPipeline
         programs_[program_id]->addObjData(std::move(data), type);
     }
 
+    void Forward::uploadObjData(uint32_t program_id, std::vector<Programs::ObjectLoadData>&& load_data)
+    {
+        if(programs_.size() <= program_id) { throw "Invalid program ID!"; }
+
+        programs_[program_id]->uploadObjData(std::move(load_data));
+    }
+
     void Forward::addUiData(uint32_t program_id, const std::vector<ImDrawVert>& vertexData, const std::vector<ImDrawIdx>& indexBuffer)
     {
         if(programs_.size() <= program_id) { throw "Invalid program ID!"; }
@@ -24,22 +35,56 @@ namespace Engine::GraphicsPipeline
         programs_[program_id]->addUiData(vertexData, indexBuffer);
     }
 
-    void Forward::prepare(const std::shared_ptr<Descriptors::Camera> &camera)
+    bool Forward::usesMeshletCulling(uint32_t program_id) const
+    {
+        if(programs_.size() <= program_id) { throw "Invalid program ID!"; }
+
+        return programs_[program_id]->getProgramsData()->meshlet_culling != nullptr;
+    }
+
+    void Forward::prepare(const std::shared_ptr<Descriptors::Camera> &camera, RenderGraph& render_graph)
     {
         if(programs_.empty())
             return;
 
         for (auto& program : programs_)
-            program->prepare(camera);
+            program->prepare(camera, light_clusters_);
+
+        uint32_t depth = render_graph.createImage("forward depth", Memory::ImageFormats::getImageFormat(Memory::ImageType::DEPTH_STENCIL));
 
-        pipeline_->prepare(programs_);
+        render_graph.addPass("forward")
+            .writeColor(render_graph.getBackbuffer(), vk::ClearColorValue(std::array<float, 4>({ 0.4f, 0.4f, 0.4f, 1.0f })))
+            .writeDepth(depth, vk::ClearDepthStencilValue{1.0f, 0u})
+            .setBefore([programs = programs_](vk::CommandBuffer command_buffer, uint32_t) {
+                CommandBuffer::recordCulling(command_buffer, programs);
+            })
+            .setRecord([programs = programs_](vk::CommandBuffer command_buffer, uint32_t frame) {
+                CommandBuffer::recordDraws(command_buffer, programs, frame);
+            });
     }
 
-    void Forward::render()
+    void Forward::update(const Descriptors::Camera &camera)
     {
-        if(programs_.empty())
-            return;
+        for (auto& program : programs_)
+            program->update(camera);
+    }
+
+    bool Forward::updatePipelines()
+    {
+        // Every program, not only up to the first updated one.
+        bool updated = false;
+        for (auto& program : programs_)
+            updated = program->updatePipelines() || updated;
+
+        return updated;
+    }
+
+    bool Forward::updateTextures()
+    {
+        bool updated = false;
+        for (auto& program : programs_)
+            updated = program->updateTextures() || updated;
 
-        pipeline_->render();
+        return updated;
     }
 }
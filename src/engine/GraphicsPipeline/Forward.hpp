@@ -1,7 +1,8 @@
 #ifndef GYMNURE_FORWARD_HPP
 #define GYMNURE_FORWARD_HPP
 
-#include <GraphicsPipeline/Pipeline.hpp>
+#include <GraphicsPipeline/RenderGraph.h>
+#include <Descriptors/LightClusters.h>
 
 namespace Engine::GraphicsPipeline
 {
@@ -10,18 +11,30 @@ namespace Engine::GraphicsPipeline
 
     private:
 
-        std::unique_ptr<Pipeline>                           pipeline_ = {};
+        vk::RenderPass                                      render_pass_ = {};
         std::vector<std::shared_ptr<Programs::Program>>     programs_ = {};
+        std::shared_ptr<Descriptors::LightClusters>         light_clusters_ = nullptr;
 
     public:
 
-        Forward();
+        Forward(RenderGraph& render_graph, std::shared_ptr<Descriptors::LightClusters> light_clusters);
 
         uint32_t createProgram(Programs::ProgramParams &&params);
         void addObjData(uint32_t program_id, GymnureObjData&& data, const GymnureObjDataType& type);
+        void uploadObjData(uint32_t program_id, std::vector<Programs::ObjectLoadData>&& load_data);
         void addUiData(uint32_t program_id, const std::vector<ImDrawVert>& vertexData, const std::vector<ImDrawIdx>& indexBuffer);
-        void prepare(const std::shared_ptr<Descriptors::Camera> &camera);
-        void render();
+        [[nodiscard]] bool usesMeshletCulling(uint32_t program_id) const;
+
+        /**
+         * Prepare every program and declare the forward pass, drawing over what earlier passes left in the backbuffer.
+         * */
+        void prepare(const std::shared_ptr<Descriptors::Camera> &camera, RenderGraph& render_graph);
+        /**
+         * Once per frame, after the light clusters were updated for 'camera'.
+         * */
+        void update(const Descriptors::Camera &camera);
+        bool updatePipelines();
+        bool updateTextures();
     };
 }
 
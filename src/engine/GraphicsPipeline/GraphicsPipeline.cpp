@@ -3,6 +3,8 @@
 
 #include <ApplicationData.hpp>
 #include <Util/ModelDataLoader.h>
+#include <Util/ThreadPool.h>
+#include "ShaderModuleCache.h"
 #include "GraphicsPipeline.h"
 
 namespace Engine
@@ -16,7 +18,7 @@ namespace Engine
             // Set shader stages
             for (int i = 0; i < shaders.size(); ++i) {
                 shader_stages_[i].stage  = shaders[i].type;
-                shader_stages_[i].module = Util::Util::loadSPIRVShader(shaders[i].path);
+                shader_stages_[i].module = ShaderModuleCache::get(shaders[i].path);
                 shader_stages_[i].pName  = "main";
                 assert(shader_stages_[i].module);
             }
@@ -26,42 +28,89 @@ namespace Engine
         {
             vk::Device device = ApplicationData::data->device;
 
-            device.destroyPipeline(pipeline_);
-            device.destroyPipelineCache(pipeline_cache_);
+            // Workers still building read this object, wait for them.
+            for (auto& variant : variants_)
+            {
+                try {
+                    device.destroyPipeline(variant.second.get());
+                } catch (...) {
+                    // Failed creations left nothing to destroy.
+                }
+            }
         }
 
         vk::Pipeline GraphicsPipeline::getPipeline() const
         {
-            return pipeline_;
+            return pipeline_.get();
         }
 
-        void GraphicsPipeline::addViAttributes(const std::vector<vk::VertexInputAttributeDescription>& vi_attrs)
+        vk::Pipeline GraphicsPipeline::getPipeline(const ShaderVariant& variant)
         {
-            std::copy(vi_attrs.begin(), vi_attrs.end(), std::back_inserter(vi_attributes_));
+            return request(variant).get();
         }
 
-        void GraphicsPipeline::create(vk::PipelineLayout pipeline_layout, vk::RenderPass render_pass, vk::CullModeFlagBits cull_mode)
+        vk::Pipeline GraphicsPipeline::tryGetPipeline(const ShaderVariant& variant)
         {
-            vk::Device device = ApplicationData::data->device;
+            std::shared_future<vk::Pipeline> pipeline = request(variant);
+            if (pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return nullptr;
+
+            return pipeline.get();
+        }
+
+        void GraphicsPipeline::requestPipeline(const ShaderVariant& variant)
+        {
+            request(variant);
+        }
+
+        std::shared_future<vk::Pipeline> GraphicsPipeline::request(const ShaderVariant& variant)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto it = variants_.find(variant);
+            if (it != variants_.end())
+                return it->second;
+
+            // Everything createVariant() reads is set by create() and never changes after. The device-wide pipeline
+            // cache is synchronized by the driver.
+            std::shared_future<vk::Pipeline> pipeline = Util::ThreadPool::getInstance()->submit([this, variant]() {
+                return createVariant(variant);
+            }).share();
+            variants_.emplace(variant, pipeline);
+
+            return pipeline;
+        }
+
+        void GraphicsPipeline::setVertexInput(const Vertex::VertexInputDescription& vertex_input)
+        {
+            vi_bindings_   = vertex_input.bindings;
+            vi_attributes_ = vertex_input.attributes;
+        }
 
-            vk::VertexInputBindingDescription vi_binding = {};
-            vi_binding.binding 					    = 0;
-            vi_binding.inputRate 				    = vk::VertexInputRate::eVertex;
-            vi_binding.stride 					    = sizeof(VertexData);
+        void GraphicsPipeline::create(vk::PipelineLayout pipeline_layout, vk::RenderPass render_pass, vk::CullModeFlagBits cull_mode,
+                                      uint32_t subpass, uint32_t color_attachment_count, bool blending)
+        {
+            pipeline_layout_        = pipeline_layout;
+            render_pass_            = render_pass;
+            cull_mode_              = cull_mode;
+            subpass_                = subpass;
+            color_attachment_count_ = color_attachment_count;
+            blending_               = blending;
+
+            pipeline_ = request(ShaderVariant{});
+        }
+
+        vk::Pipeline GraphicsPipeline::createVariant(const ShaderVariant& variant) const
+        {
+            vk::Device device = ApplicationData::data->device;
 
             vk::PipelineVertexInputStateCreateInfo vi = {};
             vi.pNext 								= nullptr;
-            vi.vertexBindingDescriptionCount 		= 1;
-            vi.pVertexBindingDescriptions 			= &vi_binding;
+            vi.vertexBindingDescriptionCount 		= static_cast<uint32_t>(vi_bindings_.size());
+            vi.pVertexBindingDescriptions 			= vi_bindings_.data();
             vi.vertexAttributeDescriptionCount 		= static_cast<uint32_t>(vi_attributes_.size());
             vi.pVertexAttributeDescriptions 		= vi_attributes_.data();
 
-            vk::PipelineCacheCreateInfo pipelineCache = {};
-            pipelineCache.pNext 					= nullptr;
-            pipelineCache.initialDataSize 			= 0;
-            pipelineCache.pInitialData 				= nullptr;
-            pipeline_cache_ = device.createPipelineCache(pipelineCache);
-
             vk::PipelineInputAssemblyStateCreateInfo ia = {};
             ia.pNext 								= nullptr;
             ia.primitiveRestartEnable 				= VK_FALSE;
@@ -70,7 +119,7 @@ namespace Engine
             vk::PipelineRasterizationStateCreateInfo rs = {};
             rs.pNext 								= nullptr;
             rs.polygonMode 							= vk::PolygonMode::eFill;
-            rs.cullMode 							= cull_mode;
+            rs.cullMode 							= cull_mode_;
             rs.frontFace 							= vk::FrontFace::eClockwise;
             rs.depthClampEnable 					= VK_FALSE;
             rs.rasterizerDiscardEnable 				= VK_FALSE;
@@ -80,9 +129,16 @@ namespace Engine
             rs.depthBiasSlopeFactor 				= 0;
             rs.lineWidth 							= 1.0f;
 
-            std::array<vk::PipelineColorBlendAttachmentState, 1> att_state = {};
-            att_state[0].colorWriteMask 			= vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB;
-            att_state[0].blendEnable 				= VK_TRUE;
+            std::vector<vk::PipelineColorBlendAttachmentState> att_state(color_attachment_count_);
+            for (auto& state : att_state)
+                state.colorWriteMask                = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                                                      vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+
+            if (color_attachment_count_ == 1 && blending_) {
+                att_state[0].colorWriteMask         = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB;
+                att_state[0].blendEnable            = VK_TRUE;
+            }
+
             att_state[0].srcColorBlendFactor        = vk::BlendFactor::eSrcAlpha;
             att_state[0].dstColorBlendFactor        = vk::BlendFactor::eOneMinusSrcAlpha;
             att_state[0].colorBlendOp               = vk::BlendOp::eAdd;
@@ -146,9 +202,15 @@ namespace Engine
             ms.alphaToOneEnable 					= VK_FALSE;
             ms.minSampleShading 					= 0.0;
 
+            // Every stage is specialized the same way.
+            SpecializationConstants specialization(variant);
+            std::vector<vk::PipelineShaderStageCreateInfo> shader_stages = shader_stages_;
+            for (auto &shader_stage : shader_stages)
+                shader_stage.pSpecializationInfo = specialization.getInfo();
+
             vk::GraphicsPipelineCreateInfo pipeline_info = {};
             pipeline_info.pNext 					= nullptr;
-            pipeline_info.layout 					= pipeline_layout;
+            pipeline_info.layout 					= pipeline_layout_;
             pipeline_info.basePipelineHandle 		= nullptr;
             pipeline_info.basePipelineIndex 		= 0;
             pipeline_info.pVertexInputState 		= &vi;
@@ -160,16 +222,12 @@ namespace Engine
             pipeline_info.pDynamicState 			= &dynamicState;
             pipeline_info.pViewportState 			= &vp;
             pipeline_info.pDepthStencilState 		= &ds;
-            pipeline_info.pStages 					= this->shader_stages_.data();
-            pipeline_info.stageCount 				= static_cast<uint32_t>(this->shader_stages_.size());
-            pipeline_info.renderPass 				= render_pass;
-            pipeline_info.subpass 					= 0;
-
-            pipeline_ = device.createGraphicsPipeline(pipeline_cache_, pipeline_info, nullptr);
+            pipeline_info.pStages 					= shader_stages.data();
+            pipeline_info.stageCount 				= static_cast<uint32_t>(shader_stages.size());
+            pipeline_info.renderPass 				= render_pass_;
+            pipeline_info.subpass 					= subpass_;
 
-            for (auto &shader_stage : shader_stages_) {
-                device.destroyShaderModule(shader_stage.module, nullptr);
-            }
+            return device.createGraphicsPipeline(ApplicationData::data->pipeline_cache, pipeline_info, nullptr);
         }
 
     }
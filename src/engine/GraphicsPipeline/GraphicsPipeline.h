@@ -7,8 +7,13 @@
 
 #include <vulkan/vulkan.hpp>
 #include <array>
+#include <map>
+#include <mutex>
+#include <future>
 #include <Allocator.hpp>
 #include "Util/Util.h"
+#include "Vertex/VertexLayout.hpp"
+#include "ShaderVariant.h"
 
 namespace Engine
 {
@@ -24,18 +29,47 @@ namespace Engine
 
 		private:
 
-            vk::PipelineCache 						                pipeline_cache_{};
-			vk::Pipeline 								            pipeline_{};
-			std::vector<vk::PipelineShaderStageCreateInfo> 			shader_stages_;
+			std::shared_future<vk::Pipeline> 						pipeline_{};    // Of the default variant.
+			std::mutex                                              mutex_;
+			std::map<ShaderVariant, std::shared_future<vk::Pipeline>> variants_;    // Built on Util::ThreadPool workers.
+			std::vector<vk::PipelineShaderStageCreateInfo> 			shader_stages_; // Modules of ShaderModuleCache.
+            std::vector<vk::VertexInputBindingDescription>          vi_bindings_;
             std::vector<vk::VertexInputAttributeDescription>        vi_attributes_;
 
+            // State of create(), shared by every variant.
+            vk::PipelineLayout                                      pipeline_layout_{};
+            vk::RenderPass                                          render_pass_{};
+            vk::CullModeFlagBits                                    cull_mode_ = vk::CullModeFlagBits::eBack;
+            uint32_t                                                subpass_ = 0;
+            uint32_t                                                color_attachment_count_ = 1;
+            bool                                                    blending_ = true;
+
+            vk::Pipeline createVariant(const ShaderVariant& variant) const;
+            std::shared_future<vk::Pipeline> request(const ShaderVariant& variant);
+
 		public:
 
 			explicit GraphicsPipeline(std::vector<Shader>&& shaders);
             ~GraphicsPipeline();
+			/**
+			 * Waits for the default variant, queued by create().
+			 * */
 			vk::Pipeline getPipeline() const;
-			void addViAttributes(const std::vector<vk::VertexInputAttributeDescription>& vi_attrs);
-			void create(vk::PipelineLayout pipeline_layout, vk::RenderPass render_pass, vk::CullModeFlagBits cull_mode);
+			/**
+			 * Variants are queued to worker threads the first time they are asked for, after create(). getPipeline()
+			 * waits for them, tryGetPipeline() returns nothing until they are ready.
+			 * */
+			vk::Pipeline getPipeline(const ShaderVariant& variant);
+			vk::Pipeline tryGetPipeline(const ShaderVariant& variant);
+			void requestPipeline(const ShaderVariant& variant);
+			void setVertexInput(const Vertex::VertexInputDescription& vertex_input);
+			/**
+			 * Targets past the first are G-buffer outputs, written as they are without blending. 'blending' off
+			 * writes a single target as is too, integer targets can not be blended. Returns before the default
+			 * variant is built, pipelines of several programs compile in parallel.
+			 * */
+			void create(vk::PipelineLayout pipeline_layout, vk::RenderPass render_pass, vk::CullModeFlagBits cull_mode,
+			            uint32_t subpass = 0, uint32_t color_attachment_count = 1, bool blending = true);
 
 		};
 	}
@@ -0,0 +1,230 @@
+#include <array>
+#include <algorithm>
+#include <Util/Util.h>
+#include "ShaderModuleCache.h"
+#include "MeshletCulling.h"
+
+namespace Engine::GraphicsPipeline
+{
+    MeshletCulling::MeshletCulling()
+    {
+        vk::Device device = ApplicationData::data->device;
+
+        // Model matrix, view-projection matrix, meshlets, source indices, visible indices, draw command.
+        std::array<vk::DescriptorSetLayoutBinding, 6> bindings = {};
+        for (uint32_t i = 0; i < bindings.size(); ++i)
+        {
+            bindings[i].binding             = i;
+            bindings[i].descriptorType      = vk::DescriptorType::eStorageBuffer;
+            bindings[i].descriptorCount     = 1;
+            bindings[i].stageFlags          = vk::ShaderStageFlagBits::eCompute;
+            bindings[i].pImmutableSamplers  = nullptr;
+        }
+        bindings[0].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+        bindings[1].descriptorType = vk::DescriptorType::eUniformBuffer;
+
+        vk::DescriptorSetLayoutCreateInfo descriptor_layout = {};
+        descriptor_layout.pNext         = nullptr;
+        descriptor_layout.bindingCount  = static_cast<uint32_t>(bindings.size());
+        descriptor_layout.pBindings     = bindings.data();
+        desc_layout_ = device.createDescriptorSetLayout(descriptor_layout);
+
+        vk::PushConstantRange push_constant_range = {};
+        push_constant_range.stageFlags  = vk::ShaderStageFlagBits::eCompute;
+        push_constant_range.offset      = 0;
+        push_constant_range.size        = sizeof(PushConstants);
+
+        vk::PipelineLayoutCreateInfo pipeline_layout = {};
+        pipeline_layout.pNext                   = nullptr;
+        pipeline_layout.setLayoutCount          = 1;
+        pipeline_layout.pSetLayouts             = &desc_layout_;
+        pipeline_layout.pushConstantRangeCount  = 1;
+        pipeline_layout.pPushConstantRanges     = &push_constant_range;
+        pipeline_layout_ = device.createPipelineLayout(pipeline_layout);
+
+        vk::ComputePipelineCreateInfo pipeline_info = {};
+        pipeline_info.pNext                     = nullptr;
+        pipeline_info.stage.stage               = vk::ShaderStageFlagBits::eCompute;
+        pipeline_info.stage.module              = ShaderModuleCache::get("meshlet_cull_cs.spv");
+        pipeline_info.stage.pName               = "main";
+        pipeline_info.layout                    = pipeline_layout_;
+        assert(pipeline_info.stage.module);
+
+        pipeline_ = device.createComputePipeline(ApplicationData::data->pipeline_cache, pipeline_info, nullptr);
+    }
+
+    MeshletCulling::~MeshletCulling()
+    {
+        vk::Device device = ApplicationData::data->device;
+
+        device.destroyPipeline(pipeline_);
+        device.destroyPipelineLayout(pipeline_layout_);
+        device.destroyDescriptorSetLayout(desc_layout_);
+        device.destroyDescriptorPool(desc_pool_);
+    }
+
+    std::shared_ptr<MeshletDrawData> MeshletCulling::createDrawData(const std::vector<Meshlet>& meshlets, const Vertex::VertexBufferBase& vertex_buffer)
+    {
+        auto draw_data = std::make_shared<MeshletDrawData>();
+        draw_data->meshlet_count = static_cast<uint32_t>(meshlets.size());
+        draw_data->index_16bit   = vertex_buffer.getIndexType() == vk::IndexType::eUint16;
+        draw_data->indices       = vertex_buffer.getIndexBuffer();
+
+        struct BufferData buffer_data = {};
+        buffer_data.usage      = vk::BufferUsageFlagBits::eStorageBuffer;
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        buffer_data.count      = meshlets.size();
+        draw_data->meshlets = std::make_unique<Memory::Buffer<Meshlet>>(buffer_data);
+        draw_data->meshlets->updateBuffer(meshlets);
+
+        // Written and read by the GPU only.
+        buffer_data.usage      = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer;
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        buffer_data.count      = vertex_buffer.getIndexCount();
+        draw_data->visible_indices = std::make_unique<Memory::Buffer<uint32_t>>(buffer_data);
+
+        buffer_data.usage      = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+                                 vk::BufferUsageFlagBits::eTransferDst;
+        buffer_data.count      = 1;
+        draw_data->draw_command = std::make_unique<Memory::Buffer<vk::DrawIndexedIndirectCommand>>(buffer_data);
+
+        return draw_data;
+    }
+
+    void MeshletCulling::prepare(const std::vector<std::shared_ptr<MeshletDrawData>>& draw_data, ModelBuffer& model_buffer,
+                                 const std::shared_ptr<Descriptors::Camera>& camera)
+    {
+        vk::Device device = ApplicationData::data->device;
+        size_t dynamic_alignment = Memory::Memory::getDynamicAlignment<glm::mat4>();
+
+        auto set_count = static_cast<uint32_t>(std::count_if(draw_data.begin(), draw_data.end(),
+                                                             [](const auto& data) { return data != nullptr; }));
+        if (set_count == 0)
+            return;
+
+        // Objects were added since last call, sets are allocated again from a new pool.
+        if (desc_pool_)
+            device.destroyDescriptorPool(desc_pool_);
+
+        std::array<vk::DescriptorPoolSize, 3> pool_sizes = {};
+        pool_sizes[0].type              = vk::DescriptorType::eUniformBufferDynamic;
+        pool_sizes[0].descriptorCount   = set_count;
+        pool_sizes[1].type              = vk::DescriptorType::eUniformBuffer;
+        pool_sizes[1].descriptorCount   = set_count;
+        pool_sizes[2].type              = vk::DescriptorType::eStorageBuffer;
+        pool_sizes[2].descriptorCount   = set_count * 4;
+
+        vk::DescriptorPoolCreateInfo descriptor_pool_info = {};
+        descriptor_pool_info.maxSets        = set_count;
+        descriptor_pool_info.poolSizeCount  = static_cast<uint32_t>(pool_sizes.size());
+        descriptor_pool_info.pPoolSizes     = pool_sizes.data();
+        desc_pool_ = device.createDescriptorPool(descriptor_pool_info);
+
+        std::vector<vk::DescriptorSetLayout> layouts(set_count, desc_layout_);
+
+        vk::DescriptorSetAllocateInfo alloc_info = {};
+        alloc_info.pNext                = nullptr;
+        alloc_info.descriptorPool       = desc_pool_;
+        alloc_info.descriptorSetCount   = set_count;
+        alloc_info.pSetLayouts          = layouts.data();
+        std::vector<vk::DescriptorSet> descriptor_sets = device.allocateDescriptorSets(alloc_info);
+
+        // Pointed by the writes, must not move until they are submitted.
+        std::vector<std::array<vk::DescriptorBufferInfo, 4>> buffer_infos(set_count);
+        std::vector<vk::WriteDescriptorSet> writes = {};
+
+        uint32_t set = 0;
+        for (size_t i = 0; i < draw_data.size(); ++i)
+        {
+            if (draw_data[i] == nullptr)
+                continue;
+
+            MeshletDrawData& data = *draw_data[i];
+            data.descriptor_set = descriptor_sets[set];
+            data.dynamic_offset = static_cast<uint32_t>(i * dynamic_alignment);
+
+            writes.push_back(model_buffer.getWrite(data.descriptor_set, 0));
+            // Only the view-projection matrix is read.
+            writes.push_back(camera->getWrites(data.descriptor_set, 1, 2)[0]);
+
+            std::array<vk::Buffer, 4> storage_buffers = {
+                data.meshlets->getBuffer(), data.indices, data.visible_indices->getBuffer(), data.draw_command->getBuffer()
+            };
+
+            for (uint32_t j = 0; j < storage_buffers.size(); ++j)
+            {
+                buffer_infos[set][j].buffer = storage_buffers[j];
+                buffer_infos[set][j].offset = 0;
+                buffer_infos[set][j].range  = VK_WHOLE_SIZE;
+
+                vk::WriteDescriptorSet write = {};
+                write.pNext             = nullptr;
+                write.dstSet            = data.descriptor_set;
+                write.descriptorCount   = 1;
+                write.descriptorType    = vk::DescriptorType::eStorageBuffer;
+                write.pBufferInfo       = &buffer_infos[set][j];
+                write.dstBinding        = 2 + j;
+                writes.push_back(write);
+            }
+
+            set++;
+        }
+
+        device.updateDescriptorSets(writes, {});
+    }
+
+    void MeshletCulling::recordCulling(vk::CommandBuffer command_buffer, const std::vector<std::shared_ptr<MeshletDrawData>>& draw_data) const
+    {
+        if (draw_data.empty())
+            return;
+
+        // Draws of the previous frame may still read the buffers written here.
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput,
+                                       vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader,
+                                       {}, 0, nullptr, 0, nullptr, 0, nullptr);
+
+        // Visible meshlets append their indices to an empty draw.
+        vk::DrawIndexedIndirectCommand reset = {};
+        reset.indexCount    = 0;
+        reset.instanceCount = 1;
+        for (const auto& data : draw_data)
+            command_buffer.updateBuffer(data->draw_command->getBuffer(), 0, sizeof(reset), &reset);
+
+        vk::MemoryBarrier barrier = {};
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+                                       {}, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_);
+        for (const auto& data : draw_data)
+        {
+            if (data->meshlet_count == 0)
+                continue;
+
+            PushConstants push_constants = {};
+            push_constants.meshlet_count = data->meshlet_count;
+            push_constants.index_16bit   = data->index_16bit ? 1 : 0;
+
+            command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_layout_, 0, {data->descriptor_set}, {data->dynamic_offset});
+            command_buffer.pushConstants(pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants), &push_constants);
+
+            // One workgroup per meshlet, wrapped on Y past the minimum guaranteed X count.
+            uint32_t group_count_x = std::min(data->meshlet_count, MAX_GROUP_COUNT_X);
+            uint32_t group_count_y = (data->meshlet_count + group_count_x - 1) / group_count_x;
+            command_buffer.dispatch(group_count_x, group_count_y, 1);
+        }
+
+        barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eIndexRead;
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                       vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput,
+                                       {}, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    void MeshletCulling::recordDraw(vk::CommandBuffer command_buffer, const MeshletDrawData& draw_data)
+    {
+        command_buffer.bindIndexBuffer(draw_data.visible_indices->getBuffer(), 0, vk::IndexType::eUint32);
+        command_buffer.drawIndexedIndirect(draw_data.draw_command->getBuffer(), 0, 1, sizeof(vk::DrawIndexedIndirectCommand));
+    }
+}
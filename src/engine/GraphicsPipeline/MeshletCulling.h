@@ -0,0 +1,76 @@
+#ifndef GYMNURE_MESHLETCULLING_H
+#define GYMNURE_MESHLETCULLING_H
+
+#include <memory>
+#include <vector>
+#include <ModelBuffer.hpp>
+#include <Descriptors/Camera.h>
+#include <Vertex/VertexBuffer.h>
+#include "Memory/Buffer.h"
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * GPU side of one meshlet culled object. Indices of visible meshlets are compacted into 'visible_indices'
+     * and drawn with a single indexed indirect draw.
+     * */
+    struct MeshletDrawData
+    {
+        uint32_t                                                            meshlet_count   = 0;
+        bool                                                                index_16bit     = false;
+        vk::Buffer                                                          indices         = {};       // Owned by the object vertex buffer.
+        std::unique_ptr<Memory::Buffer<Meshlet>>                            meshlets        = nullptr;
+        std::unique_ptr<Memory::Buffer<uint32_t>>                           visible_indices = nullptr;
+        std::unique_ptr<Memory::Buffer<vk::DrawIndexedIndirectCommand>>     draw_command    = nullptr;
+        vk::DescriptorSet                                                   descriptor_set  = {};
+        uint32_t                                                            dynamic_offset  = 0;        // Model matrix.
+    };
+
+    /**
+     * Meshlet frustum and normal cone culling for hardware without mesh shaders: a compute pass recorded before the
+     * render pass, one workgroup per meshlet (see meshlet_cull_cs.glsl).
+     * */
+    class MeshletCulling
+    {
+
+    private:
+
+        static constexpr uint32_t MAX_GROUP_COUNT_X = 65535;
+
+        struct PushConstants
+        {
+            uint32_t meshlet_count  = 0;
+            uint32_t index_16bit    = 0;
+        };
+
+        vk::DescriptorSetLayout     desc_layout_        = {};
+        vk::PipelineLayout          pipeline_layout_    = {};
+        vk::DescriptorPool          desc_pool_          = {};
+        vk::Pipeline                pipeline_           = {};
+
+    public:
+
+        MeshletCulling();
+        ~MeshletCulling();
+
+        /**
+         * Buffers of an object drawn from 'vertex_buffer', whose index list 'meshlets' were built over.
+         * */
+        static std::shared_ptr<MeshletDrawData> createDrawData(const std::vector<Meshlet>& meshlets, const Vertex::VertexBufferBase& vertex_buffer);
+
+        /**
+         * Write descriptor sets of every object, 'draw_data' is aligned to the model buffer instances (null entries are skipped).
+         * */
+        void prepare(const std::vector<std::shared_ptr<MeshletDrawData>>& draw_data, ModelBuffer& model_buffer,
+                     const std::shared_ptr<Descriptors::Camera>& camera);
+
+        /**
+         * Cull every object, must be recorded outside of a render pass.
+         * */
+        void recordCulling(vk::CommandBuffer command_buffer, const std::vector<std::shared_ptr<MeshletDrawData>>& draw_data) const;
+
+        static void recordDraw(vk::CommandBuffer command_buffer, const MeshletDrawData& draw_data);
+    };
+}
+
+#endif //GYMNURE_MESHLETCULLING_H
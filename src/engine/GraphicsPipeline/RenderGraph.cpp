@@ -0,0 +1,958 @@
+#include <tuple>
+#include <algorithm>
+#include <RenderPass/Queue.h>
+#include <Memory/ImageFormats.hpp>
+#include <Util/Hash.h>
+#include <Util/Debug.hpp>
+#include "RenderGraph.h"
+
+namespace Engine::GraphicsPipeline
+{
+    RenderGraph::Pass::Pass(std::string name, PassType type) : name_(std::move(name)), type_(type) {}
+
+    RenderGraph::Pass& RenderGraph::Pass::writeColor(uint32_t image, const vk::ClearColorValue& clear_value)
+    {
+        colors_.push_back({image, true, clear_value});
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::writeColor(uint32_t image)
+    {
+        colors_.push_back({image, false, {}});
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::writeDepth(uint32_t image, const vk::ClearDepthStencilValue& clear_value)
+    {
+        if (!depth_.empty()) { Debug::logErrorAndDie("Pass " + name_ + " already has a depth attachment!"); }
+
+        depth_.push_back({image, true, clear_value});
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::writeDepth(uint32_t image)
+    {
+        if (!depth_.empty()) { Debug::logErrorAndDie("Pass " + name_ + " already has a depth attachment!"); }
+
+        depth_.push_back({image, false, {}});
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::readTexture(uint32_t image)
+    {
+        sampled_.push_back(image);
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::readWriteStorage(uint32_t image)
+    {
+        storage_.push_back(image);
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::readAttachment(uint32_t image)
+    {
+        if (type_ != PassType::GRAPHICS) { Debug::logErrorAndDie("Compute pass " + name_ + " cannot read attachments!"); }
+
+        inputs_.push_back(image);
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::setBefore(Record before)
+    {
+        before_ = std::move(before);
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::setRecord(Record record)
+    {
+        record_ = std::move(record);
+        return *this;
+    }
+
+    RenderGraph::Pass& RenderGraph::Pass::setBindImages(BindImages bind)
+    {
+        bind_ = std::move(bind);
+        return *this;
+    }
+
+    RenderGraph::RenderGraph()
+    {
+        sync_primitives_ = std::make_unique<SyncPrimitives::SyncPrimitives>();
+        sync_primitives_->createSemaphore();
+
+        reset();
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        compiled_passes_.clear();
+        destroyImages();
+    }
+
+    vk::ImageAspectFlags RenderGraph::getAspect(vk::Format format)
+    {
+        switch (format)
+        {
+            case vk::Format::eD32SfloatS8Uint:
+            case vk::Format::eD24UnormS8Uint:
+            case vk::Format::eD16UnormS8Uint:
+                return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+            case vk::Format::eD32Sfloat:
+            case vk::Format::eX8D24UnormPack32:
+            case vk::Format::eD16Unorm:
+                return vk::ImageAspectFlagBits::eDepth;
+            default:
+                return vk::ImageAspectFlagBits::eColor;
+        }
+    }
+
+    vk::ImageLayout RenderGraph::getLayout(Usage usage, vk::Format format)
+    {
+        switch (usage)
+        {
+            case Usage::COLOR:      return vk::ImageLayout::eColorAttachmentOptimal;
+            case Usage::DEPTH:      return vk::ImageLayout::eDepthStencilAttachmentOptimal;
+            case Usage::SAMPLED:    return vk::ImageLayout::eShaderReadOnlyOptimal;
+            case Usage::INPUT:
+                return getAspect(format) & vk::ImageAspectFlagBits::eDepth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                                                                           : vk::ImageLayout::eShaderReadOnlyOptimal;
+            default:                return vk::ImageLayout::eGeneral;
+        }
+    }
+
+    vk::AccessFlags RenderGraph::getAccess(Usage usage)
+    {
+        switch (usage)
+        {
+            case Usage::COLOR:      return vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
+            case Usage::DEPTH:      return vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+            case Usage::SAMPLED:    return vk::AccessFlagBits::eShaderRead;
+            case Usage::INPUT:      return vk::AccessFlagBits::eInputAttachmentRead;
+            default:                return vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+        }
+    }
+
+    vk::PipelineStageFlags RenderGraph::getStage(Usage usage, PassType type)
+    {
+        switch (usage)
+        {
+            case Usage::COLOR:      return vk::PipelineStageFlagBits::eColorAttachmentOutput;
+            case Usage::DEPTH:      return vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+            default:
+                return type == PassType::COMPUTE ? vk::PipelineStageFlagBits::eComputeShader
+                                                 : vk::PipelineStageFlagBits::eFragmentShader;
+        }
+    }
+
+    std::vector<std::pair<uint32_t, RenderGraph::Usage>> RenderGraph::getUses(const Pass& pass)
+    {
+        std::vector<std::pair<uint32_t, Usage>> uses = {};
+
+        for (const Pass::Attachment& color : pass.colors_)
+            uses.emplace_back(color.image, Usage::COLOR);
+        for (const Pass::Attachment& depth : pass.depth_)
+            uses.emplace_back(depth.image, Usage::DEPTH);
+        for (uint32_t image : pass.sampled_)
+            uses.emplace_back(image, Usage::SAMPLED);
+        for (uint32_t image : pass.storage_)
+            uses.emplace_back(image, Usage::STORAGE);
+        for (uint32_t image : pass.inputs_)
+            uses.emplace_back(image, Usage::INPUT);
+
+        return uses;
+    }
+
+    std::vector<std::pair<uint32_t, RenderGraph::Usage>> RenderGraph::getUses(const CompiledPass& compiled_pass) const
+    {
+        std::vector<std::pair<uint32_t, Usage>> uses = {};
+
+        for (uint32_t pass : compiled_pass.passes)
+            for (const auto& use : getUses(passes_[pass]))
+                uses.push_back(use);
+
+        return uses;
+    }
+
+    vk::RenderPass RenderGraph::getCompatibleRenderPass(const std::vector<vk::Format>& color_formats, vk::Format depth_format)
+    {
+        return getCompatibleRenderPass(std::vector<SubpassFormats>{{color_formats, depth_format, {}}});
+    }
+
+    vk::RenderPass RenderGraph::getCompatibleRenderPass(const std::vector<SubpassFormats>& subpasses)
+    {
+        std::vector<uint32_t> key = {};
+        for (const SubpassFormats& subpass : subpasses)
+        {
+            key.push_back(static_cast<uint32_t>(subpass.colors.size()));
+            for (vk::Format format : subpass.colors)
+                key.push_back(static_cast<uint32_t>(format));
+            key.push_back(static_cast<uint32_t>(subpass.depth));
+            key.push_back(static_cast<uint32_t>(subpass.inputs.size()));
+            key.insert(key.end(), subpass.inputs.begin(), subpass.inputs.end());
+        }
+
+        auto it = compatible_render_passes_.find(key);
+        if (it != compatible_render_passes_.end())
+            return it->second->getRenderPass();
+
+        // Only formats and sample counts matter for compatibility, ops and layouts do not.
+        std::vector<RenderPass::RpAttachments> attachments = {};
+        std::vector<RenderPass::RpSubpass> rp_subpasses = {};
+
+        for (const SubpassFormats& subpass : subpasses)
+        {
+            RenderPass::RpSubpass rp_subpass = {};
+
+            for (vk::Format format : subpass.colors)
+            {
+                RenderPass::RpAttachments attachment = {};
+                attachment.format       = format;
+                attachment.usage        = vk::ImageUsageFlagBits::eColorAttachment;
+                attachment.final_layout = vk::ImageLayout::eColorAttachmentOptimal;
+
+                rp_subpass.colors.push_back(static_cast<uint32_t>(attachments.size()));
+                attachments.push_back(attachment);
+            }
+
+            if (subpass.depth != vk::Format::eUndefined)
+            {
+                RenderPass::RpAttachments attachment = {};
+                attachment.format       = subpass.depth;
+                attachment.usage        = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+                attachment.final_layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+                rp_subpass.depth = static_cast<uint32_t>(attachments.size());
+                attachments.push_back(attachment);
+            }
+
+            for (uint32_t input : subpass.inputs)
+                if (input >= attachments.size()) { Debug::logErrorAndDie("Input attachment not written by an earlier subpass!"); }
+
+            rp_subpass.inputs = subpass.inputs;
+            rp_subpasses.push_back(rp_subpass);
+        }
+
+        auto render_pass = std::make_shared<RenderPass::RenderPass>(attachments, rp_subpasses);
+        compatible_render_passes_[key] = render_pass;
+
+        return render_pass->getRenderPass();
+    }
+
+    void RenderGraph::reset()
+    {
+        images_.clear();
+        passes_.clear();
+
+        images_.push_back({"backbuffer", Memory::ImageFormats::getSurfaceFormat().format});
+    }
+
+    uint32_t RenderGraph::getBackbuffer() const
+    {
+        return BACKBUFFER;
+    }
+
+    uint32_t RenderGraph::createImage(const std::string& name, vk::Format format)
+    {
+        images_.push_back({name, format});
+        return static_cast<uint32_t>(images_.size() - 1);
+    }
+
+    RenderGraph::Pass& RenderGraph::addPass(const std::string& name, PassType type)
+    {
+        return passes_.emplace_back(name, type);
+    }
+
+    uint64_t RenderGraph::getSignature() const
+    {
+        uint64_t hash = Util::Hash::FNV_OFFSET;
+
+        for (const ImageDesc& image : images_)
+            hash = Util::Hash::mix(hash, static_cast<uint64_t>(image.format));
+
+        for (const Pass& pass : passes_)
+        {
+            hash = Util::Hash::mix(hash, static_cast<uint64_t>(pass.type_));
+
+            for (const auto* attachments : {&pass.colors_, &pass.depth_})
+            {
+                hash = Util::Hash::mix(hash, attachments->size());
+                for (const Pass::Attachment& attachment : *attachments)
+                    hash = Util::Hash::mix(hash, (static_cast<uint64_t>(attachment.image) << 1u) | attachment.clear);
+            }
+
+            for (const auto* images : {&pass.sampled_, &pass.storage_, &pass.inputs_})
+            {
+                hash = Util::Hash::mix(hash, images->size());
+                for (uint32_t image : *images)
+                    hash = Util::Hash::mix(hash, image);
+            }
+        }
+
+        return hash;
+    }
+
+    std::vector<bool> RenderGraph::cullPasses() const
+    {
+        std::vector<bool> culled(passes_.size(), false);
+        std::vector<uint32_t> pass_refs(passes_.size(), 0);              // Images written.
+        std::vector<uint32_t> image_refs(images_.size(), 0);             // Passes reading.
+        std::vector<std::vector<uint32_t>> writers(images_.size());
+
+        for (uint32_t i = 0; i < passes_.size(); ++i)
+            for (const auto& [image, usage] : getUses(passes_[i]))
+            {
+                if (usage == Usage::SAMPLED || usage == Usage::INPUT) {
+                    image_refs[image]++;
+                } else {
+                    pass_refs[i]++;
+                    writers[image].push_back(i);
+                }
+            }
+
+        std::vector<uint32_t> unused = {};
+        for (uint32_t image = 0; image < images_.size(); ++image)
+            if (image != BACKBUFFER && image_refs[image] == 0)
+                unused.push_back(image);
+
+        auto cull = [&](uint32_t pass) {
+            culled[pass] = true;
+            for (const auto* images : {&passes_[pass].sampled_, &passes_[pass].inputs_})
+                for (uint32_t image : *images)
+                    if (--image_refs[image] == 0 && image != BACKBUFFER)
+                        unused.push_back(image);
+        };
+
+        for (uint32_t i = 0; i < passes_.size(); ++i)
+            if (pass_refs[i] == 0)
+                cull(i);
+
+        // Writers of unread images are useless, and so may become the writers of what they read.
+        while (!unused.empty())
+        {
+            uint32_t image = unused.back();
+            unused.pop_back();
+
+            for (uint32_t pass : writers[image])
+                if (!culled[pass] && --pass_refs[pass] == 0)
+                    cull(pass);
+        }
+
+        return culled;
+    }
+
+    void RenderGraph::allocateImages()
+    {
+        auto app_data = ApplicationData::data;
+
+        physical_images_.assign(images_.size(), {});
+
+        for (uint32_t i = 0; i < compiled_passes_.size(); ++i)
+            for (const auto& [image, usage] : getUses(compiled_passes_[i]))
+            {
+                PhysicalImage& physical_image = physical_images_[image];
+                physical_image.first_pass = std::min(physical_image.first_pass, i);
+                physical_image.last_pass  = std::max(physical_image.last_pass, i);
+
+                switch (usage)
+                {
+                    case Usage::COLOR:   physical_image.usage |= vk::ImageUsageFlagBits::eColorAttachment; break;
+                    case Usage::DEPTH:   physical_image.usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment; break;
+                    case Usage::SAMPLED: physical_image.usage |= vk::ImageUsageFlagBits::eSampled; break;
+                    case Usage::STORAGE: physical_image.usage |= vk::ImageUsageFlagBits::eStorage; break;
+                    case Usage::INPUT:   physical_image.usage |= vk::ImageUsageFlagBits::eInputAttachment; break;
+                }
+            }
+
+        std::vector<uint32_t> aliased = {};
+        std::vector<vk::MemoryRequirements> requirements(images_.size());
+
+        for (uint32_t i = 0; i < images_.size(); ++i)
+        {
+            PhysicalImage& physical_image = physical_images_[i];
+            if (i == BACKBUFFER || physical_image.first_pass == UINT32_MAX)
+                continue;
+
+            // Attachments of a single render pass are never stored, tiled GPUs need no memory for them.
+            bool single_pass = physical_image.first_pass == physical_image.last_pass &&
+                               !(physical_image.usage & (vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage));
+            if (single_pass)
+                physical_image.usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+
+            vk::ImageCreateInfo image_info = {};
+            image_info.imageType        = vk::ImageType::e2D;
+            image_info.extent           = vk::Extent3D{app_data->view_width, app_data->view_height, 1};
+            image_info.mipLevels        = 1;
+            image_info.arrayLayers      = 1;
+            image_info.format           = images_[i].format;
+            image_info.tiling           = vk::ImageTiling::eOptimal;
+            image_info.initialLayout    = vk::ImageLayout::eUndefined;
+            image_info.usage            = physical_image.usage;
+            image_info.samples          = vk::SampleCountFlagBits::e1;
+            image_info.sharingMode      = vk::SharingMode::eExclusive;
+
+            physical_image.image = app_data->device.createImage(image_info);
+            requirements[i] = app_data->device.getImageMemoryRequirements(physical_image.image);
+
+            uint32_t lazy_type = UINT32_MAX;
+            for (uint32_t type = 0; single_pass && type < app_data->memory_properties.memoryTypeCount; ++type)
+                if ((requirements[i].memoryTypeBits & (1u << type)) &&
+                    (app_data->memory_properties.memoryTypes[type].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated)) {
+                    lazy_type = type;
+                    break;
+                }
+
+            if (lazy_type == UINT32_MAX) {
+                aliased.push_back(i);
+                continue;
+            }
+
+            vk::MemoryAllocateInfo alloc_info = {};
+            alloc_info.allocationSize   = requirements[i].size;
+            alloc_info.memoryTypeIndex  = lazy_type;
+            physical_image.memory = app_data->device.allocateMemory(alloc_info);
+            app_data->device.bindImageMemory(physical_image.image, physical_image.memory, 0);
+        }
+
+        // Largest first, each in the first block whose images are all dead by the time it is used.
+        std::sort(aliased.begin(), aliased.end(), [&requirements](uint32_t a, uint32_t b) {
+            return requirements[a].size > requirements[b].size;
+        });
+
+        for (uint32_t image : aliased)
+        {
+            PhysicalImage& physical_image = physical_images_[image];
+
+            for (uint32_t b = 0; b < memory_blocks_.size() && physical_image.block == UINT32_MAX; ++b)
+            {
+                MemoryBlock& block = memory_blocks_[b];
+                if (!(requirements[image].memoryTypeBits & (1u << block.type_index)))
+                    continue;
+
+                bool overlaps = std::any_of(block.images.begin(), block.images.end(), [&](uint32_t other) {
+                    return physical_image.first_pass <= physical_images_[other].last_pass &&
+                           physical_images_[other].first_pass <= physical_image.last_pass;
+                });
+
+                if (!overlaps)
+                    physical_image.block = b;
+            }
+
+            if (physical_image.block == UINT32_MAX)
+            {
+                MemoryBlock block = {};
+                block.type_index = Memory::Memory::findMemoryType(requirements[image].memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+                memory_blocks_.push_back(block);
+                physical_image.block = static_cast<uint32_t>(memory_blocks_.size() - 1);
+            }
+
+            MemoryBlock& block = memory_blocks_[physical_image.block];
+            block.size = std::max(block.size, requirements[image].size);
+            block.images.push_back(image);
+        }
+
+        for (MemoryBlock& block : memory_blocks_)
+        {
+            vk::MemoryAllocateInfo alloc_info = {};
+            alloc_info.allocationSize   = block.size;
+            alloc_info.memoryTypeIndex  = block.type_index;
+            block.memory = app_data->device.allocateMemory(alloc_info);
+
+            for (uint32_t image : block.images)
+                app_data->device.bindImageMemory(physical_images_[image].image, block.memory, 0);
+        }
+
+        for (uint32_t i = 0; i < images_.size(); ++i)
+        {
+            PhysicalImage& physical_image = physical_images_[i];
+            if (!physical_image.image)
+                continue;
+
+            // Depth is read without its stencil.
+            vk::ImageAspectFlags aspect = getAspect(images_[i].format);
+            if (physical_image.usage & (vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eInputAttachment))
+                aspect &= ~vk::ImageAspectFlags(vk::ImageAspectFlagBits::eStencil);
+
+            vk::ImageViewCreateInfo view_info = {};
+            view_info.image                             = physical_image.image;
+            view_info.viewType                          = vk::ImageViewType::e2D;
+            view_info.format                            = images_[i].format;
+            view_info.subresourceRange.aspectMask       = aspect;
+            view_info.subresourceRange.baseMipLevel     = 0;
+            view_info.subresourceRange.levelCount       = 1;
+            view_info.subresourceRange.baseArrayLayer   = 0;
+            view_info.subresourceRange.layerCount       = 1;
+
+            physical_image.view = app_data->device.createImageView(view_info);
+        }
+
+    #ifdef DEBUG
+        vk::DeviceSize transient_size = 0;
+        for (const MemoryBlock& block : memory_blocks_)
+            transient_size += block.size;
+
+        Debug::logInfo("Render graph: " + std::to_string(compiled_passes_.size()) + " compiled passes for " + std::to_string(passes_.size()) +
+                       " declared, " + std::to_string(aliased.size()) + " transient images in " +
+                       std::to_string(memory_blocks_.size()) + " blocks (" + std::to_string(transient_size / (1024 * 1024)) + "MiB).");
+
+        // Measured from the memory each image asks for, padding and compression metadata included.
+        vk::DeviceSize pixel_count = static_cast<vk::DeviceSize>(app_data->view_width) * app_data->view_height;
+        vk::DeviceSize total_tenths = 0;
+        auto toBytes = [](vk::DeviceSize tenths) { return std::to_string(tenths / 10) + "." + std::to_string(tenths % 10); };
+
+        for (uint32_t i = 0; i < images_.size(); ++i)
+        {
+            if (!physical_images_[i].image)
+                continue;
+
+            vk::DeviceSize tenths = requirements[i].size * 10 / pixel_count;
+            total_tenths += tenths;
+
+            Debug::logInfo("\t" + images_[i].name + ": " + toBytes(tenths) + " bytes per pixel" +
+                           (physical_images_[i].memory ? ", lazily allocated." : "."));
+        }
+
+        Debug::logInfo("\tTransient images: " + toBytes(total_tenths) + " bytes per pixel.");
+    #endif
+    }
+
+    void RenderGraph::createRenderPasses()
+    {
+        auto swap_chain = RenderPass::SwapChain::getInstance();
+
+        for (uint32_t i = 0; i < compiled_passes_.size(); ++i)
+        {
+            CompiledPass& compiled_pass = compiled_passes_[i];
+            if (passes_[compiled_pass.passes[0]].type_ != PassType::GRAPHICS)
+                continue;
+
+            std::vector<RenderPass::RpAttachments> attachments = {};
+            std::vector<RenderPass::RpSubpass> subpasses = {};
+
+            auto addAttachment = [&](const Pass::Attachment& attachment, Usage usage) {
+                auto it = std::find(compiled_pass.attachments.begin(), compiled_pass.attachments.end(), attachment.image);
+                if (it != compiled_pass.attachments.end())
+                    return static_cast<uint32_t>(it - compiled_pass.attachments.begin());
+
+                const PhysicalImage& physical_image = physical_images_[attachment.image];
+
+                // Contents are loaded when an earlier pass wrote them, and stored when a later one needs them.
+                bool used_before = physical_image.first_pass < i;
+                bool used_after  = attachment.image == BACKBUFFER || physical_image.last_pass > i;
+
+                RenderPass::RpAttachments rp_attachment = {};
+                rp_attachment.format            = images_[attachment.image].format;
+                rp_attachment.usage             = usage == Usage::COLOR ? vk::ImageUsageFlagBits::eColorAttachment
+                                                                        : vk::ImageUsageFlagBits::eDepthStencilAttachment;
+                rp_attachment.initial_layout    = getLayout(usage, rp_attachment.format);
+                rp_attachment.final_layout      = getLayout(usage, rp_attachment.format);
+                rp_attachment.load_op           = used_before ? vk::AttachmentLoadOp::eLoad
+                                                              : attachment.clear ? vk::AttachmentLoadOp::eClear
+                                                                                 : vk::AttachmentLoadOp::eDontCare;
+                rp_attachment.store_op          = used_after ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+
+                attachments.push_back(rp_attachment);
+                compiled_pass.attachments.push_back(attachment.image);
+                compiled_pass.clear_values.push_back(attachment.clear_value);
+
+                return static_cast<uint32_t>(attachments.size() - 1);
+            };
+
+            for (uint32_t pass_index : compiled_pass.passes)
+            {
+                const Pass& pass = passes_[pass_index];
+                RenderPass::RpSubpass subpass = {};
+
+                for (const Pass::Attachment& color : pass.colors_)
+                    subpass.colors.push_back(addAttachment(color, Usage::COLOR));
+                for (const Pass::Attachment& depth : pass.depth_)
+                    subpass.depth = addAttachment(depth, Usage::DEPTH);
+
+                for (uint32_t image : pass.inputs_)
+                {
+                    auto it = std::find(compiled_pass.attachments.begin(), compiled_pass.attachments.end(), image);
+                    if (it == compiled_pass.attachments.end()) {
+                        Debug::logErrorAndDie("Pass " + pass.name_ + " reads " + images_[image].name + ", not written by an earlier subpass!");
+                    }
+
+                    auto attachment = static_cast<uint32_t>(it - compiled_pass.attachments.begin());
+                    attachments[attachment].final_layout = getLayout(Usage::INPUT, images_[image].format);
+                    subpass.inputs.push_back(attachment);
+                }
+
+                // Written again after being read.
+                for (uint32_t color : subpass.colors)
+                    attachments[color].final_layout = vk::ImageLayout::eColorAttachmentOptimal;
+                if (subpass.depth != VK_ATTACHMENT_UNUSED)
+                    attachments[subpass.depth].final_layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+                subpasses.push_back(subpass);
+            }
+
+            compiled_pass.render_pass = std::make_shared<RenderPass::RenderPass>(attachments, subpasses);
+
+            bool presents = std::find(compiled_pass.attachments.begin(), compiled_pass.attachments.end(), BACKBUFFER) != compiled_pass.attachments.end();
+            uint32_t frame_buffer_count = presents ? swap_chain->getImageCount() : 1;
+
+            for (uint32_t j = 0; j < frame_buffer_count; ++j)
+            {
+                std::vector<vk::ImageView> views = {};
+                for (uint32_t image : compiled_pass.attachments)
+                    views.push_back(image == BACKBUFFER ? swap_chain->getSwapChainImageView(j) : physical_images_[image].view);
+
+                compiled_pass.frame_buffers.push_back(std::make_shared<RenderPass::FrameBuffer>(views, compiled_pass.render_pass));
+            }
+        }
+    }
+
+    void RenderGraph::computeTransitions()
+    {
+        struct SyncState
+        {
+            vk::PipelineStageFlags  stage   = {};
+            vk::AccessFlags         access  = {};
+        };
+
+        const vk::AccessFlags write_access = vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite |
+                                             vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite;
+
+        // Aliased images share the state of their memory: the first use of one waits for the last use of another.
+        auto getSlot = [this](uint32_t image) {
+            uint32_t block = physical_images_[image].block;
+            return block != UINT32_MAX ? block : static_cast<uint32_t>(memory_blocks_.size()) + image;
+        };
+
+        // The frame starts after the previous one, which ended like this one.
+        std::vector<SyncState> slots(memory_blocks_.size() + images_.size());
+        for (const CompiledPass& compiled_pass : compiled_passes_)
+            for (const auto& [image, usage] : getUses(compiled_pass))
+                slots[getSlot(image)] = {getStage(usage, passes_[compiled_pass.passes[0]].type_), getAccess(usage)};
+
+        // Except for the backbuffer, whose acquire semaphore is waited on at color output.
+        slots[getSlot(BACKBUFFER)] = {vk::PipelineStageFlagBits::eColorAttachmentOutput, {}};
+
+        std::vector<vk::ImageLayout> layouts(images_.size(), vk::ImageLayout::eUndefined);
+        std::vector<bool> used(images_.size(), false);
+
+        for (CompiledPass& compiled_pass : compiled_passes_)
+        {
+            PassType type = passes_[compiled_pass.passes[0]].type_;
+
+            // Between subpasses the render pass moves images itself, the pass only waits before its first use.
+            std::vector<uint32_t> images = {};
+            std::vector<SyncState> pass_states(images_.size());
+            std::vector<vk::ImageLayout> last_layouts(images_.size(), vk::ImageLayout::eUndefined);
+            std::vector<Usage> first_usages(images_.size(), Usage::COLOR);
+
+            for (const auto& [image, usage] : getUses(compiled_pass))
+            {
+                if (std::find(images.begin(), images.end(), image) == images.end()) {
+                    images.push_back(image);
+                    first_usages[image] = usage;
+                }
+
+                pass_states[image].stage |= getStage(usage, type);
+                pass_states[image].access |= getAccess(usage);
+                last_layouts[image] = getLayout(usage, images_[image].format);
+            }
+
+            for (uint32_t image : images)
+            {
+                SyncState& slot = slots[getSlot(image)];
+                Usage usage = first_usages[image];
+                vk::ImageLayout layout = getLayout(usage, images_[image].format);
+                const SyncState& state = pass_states[image];
+
+                // Reads after reads in the same layout need nothing, the next write waits for all of them.
+                if (used[image] && layouts[image] == layout && !(slot.access & write_access) && !(state.access & write_access)) {
+                    slot.stage |= state.stage;
+                    slot.access |= state.access;
+                    layouts[image] = last_layouts[image];
+                    continue;
+                }
+
+                Transition transition = {};
+                transition.image        = image;
+                transition.aspect       = getAspect(images_[image].format);
+                transition.old_layout   = used[image] ? layouts[image] : vk::ImageLayout::eUndefined;   // First use discards.
+                transition.new_layout   = layout;
+                transition.src_stage    = slot.stage ? slot.stage : vk::PipelineStageFlagBits::eTopOfPipe;
+                transition.src_access   = slot.access & write_access;
+                transition.dst_stage    = getStage(usage, type);
+                transition.dst_access   = getAccess(usage);
+                compiled_pass.transitions.push_back(transition);
+
+                slot = state;
+                layouts[image] = last_layouts[image];
+                used[image] = true;
+            }
+        }
+
+        if (used[BACKBUFFER])
+        {
+            SyncState& slot = slots[getSlot(BACKBUFFER)];
+
+            Transition transition = {};
+            transition.image        = BACKBUFFER;
+            transition.aspect       = vk::ImageAspectFlagBits::eColor;
+            transition.old_layout   = layouts[BACKBUFFER];
+            transition.new_layout   = vk::ImageLayout::ePresentSrcKHR;
+            transition.src_stage    = slot.stage;
+            transition.src_access   = slot.access & write_access;
+            transition.dst_stage    = vk::PipelineStageFlagBits::eBottomOfPipe;
+            transition.dst_access   = {};
+            present_transitions_.push_back(transition);
+        }
+    }
+
+    void RenderGraph::destroyImages()
+    {
+        auto device = ApplicationData::data->device;
+
+        for (PhysicalImage& physical_image : physical_images_)
+        {
+            if (physical_image.view) device.destroyImageView(physical_image.view);
+            if (physical_image.image) device.destroyImage(physical_image.image);
+            if (physical_image.memory) device.freeMemory(physical_image.memory);
+        }
+
+        for (MemoryBlock& block : memory_blocks_)
+            device.freeMemory(block.memory);
+
+        physical_images_.clear();
+        memory_blocks_.clear();
+    }
+
+    void RenderGraph::compile()
+    {
+        if (command_buffers_.empty())
+        {
+            uint32_t image_count = RenderPass::SwapChain::getInstance()->getImageCount();
+            for (uint32_t i = 0; i < image_count; ++i)
+                command_buffers_.push_back(std::make_unique<CommandBuffer>());
+
+            sync_primitives_->createFences(image_count);
+        }
+        else if (getSignature() == compiled_signature_)
+        {
+            // Same passes over the same images, only what they draw changed.
+            bindImages();
+            record();
+            return;
+        }
+
+        compiled_passes_.clear();
+        present_transitions_.clear();
+        destroyImages();
+
+        std::vector<bool> culled = cullPasses();
+        for (uint32_t i = 0; i < passes_.size(); ++i)
+        {
+            if (culled[i])
+                continue;
+
+            if (passes_[i].inputs_.empty()) {
+                compiled_passes_.push_back({{i}});
+                continue;
+            }
+
+            if (compiled_passes_.empty() || passes_[compiled_passes_.back().passes[0]].type_ != PassType::GRAPHICS) {
+                Debug::logErrorAndDie("Pass " + passes_[i].name_ + " reads attachments, but follows no graphics pass!");
+            }
+
+            compiled_passes_.back().passes.push_back(i);
+        }
+
+        allocateImages();
+        createRenderPasses();
+        computeTransitions();
+        compiled_signature_ = getSignature();
+
+        bindImages();
+        record();
+    }
+
+    void RenderGraph::bindImages() const
+    {
+        for (const CompiledPass& compiled_pass : compiled_passes_)
+            for (uint32_t pass : compiled_pass.passes)
+                if (passes_[pass].bind_ != nullptr)
+                    passes_[pass].bind_(*this);
+    }
+
+    vk::ImageView RenderGraph::getImageView(uint32_t image) const
+    {
+        return image < physical_images_.size() ? physical_images_[image].view : vk::ImageView{};
+    }
+
+    void RenderGraph::recordTransitions(vk::CommandBuffer command_buffer, const std::vector<Transition>& transitions, uint32_t swapchain_index) const
+    {
+        if (transitions.empty())
+            return;
+
+        std::vector<vk::ImageMemoryBarrier> barriers = {};
+        vk::PipelineStageFlags src_stage = {};
+        vk::PipelineStageFlags dst_stage = {};
+
+        for (const Transition& transition : transitions)
+        {
+            vk::ImageMemoryBarrier barrier = {};
+            barrier.srcAccessMask                   = transition.src_access;
+            barrier.dstAccessMask                   = transition.dst_access;
+            barrier.oldLayout                       = transition.old_layout;
+            barrier.newLayout                       = transition.new_layout;
+            barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image                           = transition.image == BACKBUFFER ? RenderPass::SwapChain::getInstance()->getSwapChainImage(swapchain_index)
+                                                                                     : physical_images_[transition.image].image;
+            barrier.subresourceRange.aspectMask     = transition.aspect;
+            barrier.subresourceRange.baseMipLevel   = 0;
+            barrier.subresourceRange.levelCount     = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount     = 1;
+            barriers.push_back(barrier);
+
+            src_stage |= transition.src_stage;
+            dst_stage |= transition.dst_stage;
+        }
+
+        command_buffer.pipelineBarrier(src_stage, dst_stage, {}, 0, nullptr, 0, nullptr,
+                                       static_cast<uint32_t>(barriers.size()), barriers.data());
+    }
+
+    void RenderGraph::invalidateRecords()
+    {
+        stale_buffers_.assign(command_buffers_.size(), true);
+    }
+
+    bool RenderGraph::isRecordCurrent() const
+    {
+        return std::find(stale_buffers_.begin(), stale_buffers_.end(), true) == stale_buffers_.end();
+    }
+
+    void RenderGraph::record()
+    {
+        for (uint32_t j = 0; j < command_buffers_.size(); ++j)
+            recordBuffer(j);
+    }
+
+    void RenderGraph::recordBuffer(uint32_t swapchain_index)
+    {
+        uint32_t width = ApplicationData::data->view_width;
+        uint32_t height = ApplicationData::data->view_height;
+
+        stale_buffers_.resize(command_buffers_.size(), false);
+        stale_buffers_[swapchain_index] = false;
+
+        vk::CommandBuffer command_buffer = command_buffers_[swapchain_index]->getCommandBuffer();
+        command_buffers_[swapchain_index]->begin();
+
+        for (const CompiledPass& compiled_pass : compiled_passes_)
+        {
+            for (uint32_t pass : compiled_pass.passes)
+                if (passes_[pass].before_ != nullptr)
+                    passes_[pass].before_(command_buffer, swapchain_index);
+
+            recordTransitions(command_buffer, compiled_pass.transitions, swapchain_index);
+
+            if (compiled_pass.render_pass == nullptr) {
+                const Pass& pass = passes_[compiled_pass.passes[0]];
+                if (pass.record_ != nullptr)
+                    pass.record_(command_buffer, swapchain_index);
+                continue;
+            }
+
+            const auto& frame_buffer = compiled_pass.frame_buffers.size() > 1 ? compiled_pass.frame_buffers[swapchain_index]
+                                                                                : compiled_pass.frame_buffers[0];
+
+            vk::RenderPassBeginInfo rp_begin = {};
+            rp_begin.renderPass         = compiled_pass.render_pass->getRenderPass();
+            rp_begin.framebuffer        = frame_buffer->getFrameBufferKHR();
+            rp_begin.renderArea.offset  = vk::Offset2D{0, 0};
+            rp_begin.renderArea.extent  = vk::Extent2D{width, height};
+            rp_begin.clearValueCount    = static_cast<uint32_t>(compiled_pass.clear_values.size());
+            rp_begin.pClearValues       = compiled_pass.clear_values.data();
+
+            command_buffer.beginRenderPass(rp_begin, vk::SubpassContents::eInline);
+            for (uint32_t i = 0; i < compiled_pass.passes.size(); ++i)
+            {
+                if (i > 0)
+                    command_buffer.nextSubpass(vk::SubpassContents::eInline);
+
+                const Pass& pass = passes_[compiled_pass.passes[i]];
+                if (pass.record_ != nullptr)
+                    pass.record_(command_buffer, swapchain_index);
+            }
+            command_buffer.endRenderPass();
+        }
+
+        recordTransitions(command_buffer, present_transitions_, swapchain_index);
+        command_buffers_[swapchain_index]->end();
+    }
+
+    uint32_t RenderGraph::getFrameCount() const
+    {
+        return RenderPass::SwapChain::getInstance()->getImageCount();
+    }
+
+    void RenderGraph::execute(const std::function<void(uint32_t)>& update_frame)
+    {
+        if (compiled_passes_.empty())
+            return;
+
+        vk::Result res = vk::Result::eNotReady;
+
+        auto device = ApplicationData::data->device;
+        auto swapchain = RenderPass::SwapChain::getInstance();
+        vk::Queue queue = RenderPass::Queue::GetGraphicQueue();
+
+        DEBUG_CALL(
+            std::tie(res, current_buffer_) = device.acquireNextImageKHR(
+                swapchain->getSwapChainKHR(), UINT64_MAX,
+                sync_primitives_->imageAcquiredSemaphore, {}));
+        assert(res == vk::Result::eSuccess);
+
+        vk::PipelineStageFlags pipe_stage_flags = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        vk::CommandBuffer current_command_buffer = command_buffers_[current_buffer_]->getCommandBuffer();
+        vk::Fence current_buffer_fence = sync_primitives_->getFence(current_buffer_);
+        do {
+            // Fences are created already signaled, so, we can wait for it before queue submit.
+            res = device.waitForFences({current_buffer_fence}, VK_TRUE, UINT64_MAX);
+        } while (res == vk::Result::eTimeout);
+        DEBUG_CALL(device.resetFences({current_buffer_fence}));
+
+        if (update_frame != nullptr)
+            update_frame(current_buffer_);
+
+        // The fence guarantees this buffer is no longer executing.
+        if (current_buffer_ < stale_buffers_.size() && stale_buffers_[current_buffer_]) {
+            recordBuffer(current_buffer_);
+            current_command_buffer = command_buffers_[current_buffer_]->getCommandBuffer();
+        }
+
+        vk::SubmitInfo submit_info = {};
+        submit_info.pNext                     = nullptr;
+        submit_info.waitSemaphoreCount        = 1;
+        submit_info.pWaitSemaphores           = &sync_primitives_->imageAcquiredSemaphore;
+        submit_info.pWaitDstStageMask         = &pipe_stage_flags;
+        submit_info.commandBufferCount        = 1;
+        submit_info.pCommandBuffers           = &current_command_buffer;
+        submit_info.signalSemaphoreCount      = 1;
+        submit_info.pSignalSemaphores         = &sync_primitives_->renderSemaphore;
+
+        DEBUG_CALL(queue.submit({submit_info}, current_buffer_fence));
+
+        auto swapchainKHR = swapchain->getSwapChainKHR();
+
+        vk::PresentInfoKHR present = {};
+        present.pNext 				  = nullptr;
+        present.swapchainCount 		  = 1;
+        present.pSwapchains 		  = &swapchainKHR;
+        present.pImageIndices 		  = &current_buffer_;
+        present.waitSemaphoreCount 	  = 1;
+        present.pWaitSemaphores 	  = &sync_primitives_->renderSemaphore;
+        present.pResults              = nullptr;
+
+        DEBUG_CALL(queue.presentKHR(&present));
+    }
+}
@@ -0,0 +1,294 @@
+#ifndef GYMNURE_RENDERGRAPH_H
+#define GYMNURE_RENDERGRAPH_H
+
+#include <map>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <RenderPass/RenderPass.h>
+#include <RenderPass/FrameBuffer.h>
+#include <SyncPrimitives/SyncPrimitives.h>
+#include <CommandBuffer.h>
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * The frame, as passes reading and writing images. Rebuilt on every Application::prepare().
+     *
+     * Images are either the backbuffer (the swapchain image) or transient: full view size, owned by the graph and
+     * only valid during the frame. compile() then:
+     *  - culls passes whose results nobody reads, the backbuffer being the only output,
+     *  - picks load/store ops: the first writer clears (or does not care), later ones load, and results are only
+     *    stored when a later pass uses them,
+     *  - places transient images with disjoint lifetimes in the same memory, images living in a single pass are
+     *    lazily allocated when the device allows it (they usually never leave tile memory),
+     *  - records layout transitions and barriers between passes, and the final one to present.
+     *
+     * A graphics pass reading attachments is a subpass of the render pass before it: what it reads never leaves
+     * tile memory, and images written and read within that render pass only are never stored.
+     *
+     * Passes run in declaration order. Images are named by the index returned at declaration.
+     * */
+    class RenderGraph
+    {
+    public:
+
+        // The second argument is the frame recorded, one command buffer per swapchain image.
+        using Record = std::function<void(vk::CommandBuffer, uint32_t)>;
+        using BindImages = std::function<void(const RenderGraph&)>;
+
+        enum class PassType
+        {
+            GRAPHICS,   // One render pass, over its attachments, or a subpass of the previous one.
+            COMPUTE
+        };
+
+        /**
+         * Formats of a subpass, to build render passes compatible with the graph's. Attachments are numbered in
+         * order of first use: colors then depth of each subpass, inputs being attachments of earlier subpasses.
+         * */
+        struct SubpassFormats
+        {
+            std::vector<vk::Format>     colors      = {};
+            vk::Format                  depth       = vk::Format::eUndefined;
+            std::vector<uint32_t>       inputs      = {};
+        };
+
+        class Pass
+        {
+            friend class RenderGraph;
+
+        private:
+
+            struct Attachment
+            {
+                uint32_t        image       = 0;
+                bool            clear       = false;
+                vk::ClearValue  clear_value = {};
+            };
+
+            std::string                 name_       = {};
+            PassType                    type_       = PassType::GRAPHICS;
+            std::vector<Attachment>     colors_     = {};
+            std::vector<Attachment>     depth_      = {};   // At most one.
+            std::vector<uint32_t>       sampled_    = {};
+            std::vector<uint32_t>       storage_    = {};
+            std::vector<uint32_t>       inputs_     = {};
+            Record                      before_     = nullptr;
+            Record                      record_     = nullptr;
+            BindImages                  bind_       = nullptr;
+
+        public:
+
+            Pass(std::string name, PassType type);
+
+            /**
+             * 'clear_value' is only used by the first pass writing 'image' in the frame.
+             * */
+            Pass& writeColor(uint32_t image, const vk::ClearColorValue& clear_value);
+            Pass& writeColor(uint32_t image);
+            Pass& writeDepth(uint32_t image, const vk::ClearDepthStencilValue& clear_value);
+            Pass& writeDepth(uint32_t image);
+
+            /**
+             * Sampled in shaders, written by an earlier pass.
+             * */
+            Pass& readTexture(uint32_t image);
+
+            /**
+             * Storage image, read and written by compute passes.
+             * */
+            Pass& readWriteStorage(uint32_t image);
+
+            /**
+             * Input attachment, written by an earlier subpass of the same render pass. Makes this pass a subpass
+             * of the graphics pass declared before it.
+             * */
+            Pass& readAttachment(uint32_t image);
+
+            /**
+             * Work recorded before the render pass begins, e.g. culling.
+             * */
+            Pass& setBefore(Record before);
+
+            /**
+             * Inside the render pass for graphics passes.
+             * */
+            Pass& setRecord(Record record);
+
+            /**
+             * Called once images are allocated and before recording, to write the descriptors using their views.
+             * */
+            Pass& setBindImages(BindImages bind);
+        };
+
+    private:
+
+        static constexpr uint32_t BACKBUFFER = 0;
+
+        struct ImageDesc
+        {
+            std::string     name        = {};
+            vk::Format      format      = vk::Format::eUndefined;
+        };
+
+        enum class Usage
+        {
+            COLOR,
+            DEPTH,
+            SAMPLED,
+            STORAGE,
+            INPUT
+        };
+
+        struct Transition
+        {
+            uint32_t                image       = 0;
+            vk::ImageAspectFlags    aspect      = {};
+            vk::ImageLayout         old_layout  = vk::ImageLayout::eUndefined;
+            vk::ImageLayout         new_layout  = vk::ImageLayout::eUndefined;
+            vk::PipelineStageFlags  src_stage   = {};
+            vk::AccessFlags         src_access  = {};
+            vk::PipelineStageFlags  dst_stage   = {};
+            vk::AccessFlags         dst_access  = {};
+        };
+
+        struct PhysicalImage
+        {
+            vk::Image               image       = {};
+            vk::ImageView           view        = {};
+            vk::DeviceMemory        memory      = {};   // Only when not aliased.
+            vk::ImageUsageFlags     usage       = {};
+            uint32_t                block       = UINT32_MAX;
+            uint32_t                first_pass  = UINT32_MAX;   // Compiled passes.
+            uint32_t                last_pass   = 0;
+        };
+
+        struct MemoryBlock
+        {
+            vk::DeviceMemory        memory      = {};
+            vk::DeviceSize          size        = 0;
+            uint32_t                type_index  = 0;
+            std::vector<uint32_t>   images      = {};
+        };
+
+        struct CompiledPass
+        {
+            std::vector<uint32_t>                                   passes          = {};   // Subpasses, a single one for compute.
+            std::vector<uint32_t>                                   attachments     = {};   // Images, in render pass order.
+            std::vector<vk::ClearValue>                             clear_values    = {};
+            std::vector<Transition>                                 transitions     = {};
+            std::shared_ptr<RenderPass::RenderPass>                 render_pass     = nullptr;
+            std::vector<std::shared_ptr<RenderPass::FrameBuffer>>   frame_buffers   = {};   // One per swapchain image when it draws to the backbuffer.
+        };
+
+        std::vector<ImageDesc>                                      images_                 = {};
+        std::deque<Pass>                                            passes_                 = {};
+
+        std::vector<PhysicalImage>                                  physical_images_        = {};
+        std::vector<MemoryBlock>                                    memory_blocks_          = {};
+        std::vector<CompiledPass>                                   compiled_passes_        = {};
+        std::vector<Transition>                                     present_transitions_    = {};
+        uint64_t                                                    compiled_signature_     = 0;
+
+        std::map<std::vector<uint32_t>, std::shared_ptr<RenderPass::RenderPass>> compatible_render_passes_ = {};
+
+        std::vector<std::unique_ptr<CommandBuffer>>                 command_buffers_        = {};
+        std::vector<bool>                                           stale_buffers_          = {};   // Recorded again before their next submit.
+        std::unique_ptr<SyncPrimitives::SyncPrimitives>             sync_primitives_        = nullptr;
+        uint32_t                                                    current_buffer_         = 0;
+
+        static vk::ImageAspectFlags getAspect(vk::Format format);
+        static vk::ImageLayout getLayout(Usage usage, vk::Format format);
+        static vk::AccessFlags getAccess(Usage usage);
+        static vk::PipelineStageFlags getStage(Usage usage, PassType type);
+        static std::vector<std::pair<uint32_t, Usage>> getUses(const Pass& pass);
+        [[nodiscard]] std::vector<std::pair<uint32_t, Usage>> getUses(const CompiledPass& compiled_pass) const;
+
+        [[nodiscard]] uint64_t getSignature() const;
+        [[nodiscard]] std::vector<bool> cullPasses() const;
+        void allocateImages();
+        void createRenderPasses();
+        void computeTransitions();
+        void destroyImages();
+        void bindImages() const;
+        void record();
+        void recordBuffer(uint32_t swapchain_index);
+        void recordTransitions(vk::CommandBuffer command_buffer, const std::vector<Transition>& transitions, uint32_t swapchain_index) const;
+
+    public:
+
+        RenderGraph();
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        /**
+         * Render pass compatible with every graphics pass writing these formats (colors, then depth if not
+         * eUndefined), to create pipelines before the graph is built.
+         * */
+        vk::RenderPass getCompatibleRenderPass(const std::vector<vk::Format>& color_formats, vk::Format depth_format);
+
+        /**
+         * Same, for a render pass made of subpasses.
+         * */
+        vk::RenderPass getCompatibleRenderPass(const std::vector<SubpassFormats>& subpasses);
+
+        /**
+         * Drop every declared pass and image. Compiled images are kept until the next compile() needs others.
+         * */
+        void reset();
+
+        /**
+         * The swapchain image of the frame, declared by reset(). Never culled, presented after the last pass.
+         * */
+        [[nodiscard]] uint32_t getBackbuffer() const;
+        uint32_t createImage(const std::string& name, vk::Format format);
+
+        /**
+         * The returned reference is valid until reset().
+         * */
+        Pass& addPass(const std::string& name, PassType type = PassType::GRAPHICS);
+
+        /**
+         * Build what the declared passes need, reusing the last build when they did not change, and record the
+         * command buffers again. The GPU must be idle.
+         * */
+        void compile();
+
+        /**
+         * View of a transient image, once compiled. Null when the image is not used by any pass left.
+         * */
+        [[nodiscard]] vk::ImageView getImageView(uint32_t image) const;
+
+        /**
+         * Record the same passes again, for records reading state that changed (e.g. a pipeline built in the
+         * background). Images and descriptors are kept, each command buffer is recorded once the GPU is done with it,
+         * nothing waits for the device.
+         * */
+        void invalidateRecords();
+
+        /**
+         * True once every command buffer was recorded again since invalidateRecords(): no pending one still uses
+         * what the previous records bound.
+         * */
+        [[nodiscard]] bool isRecordCurrent() const;
+
+        /**
+         * Frames in flight, each with its own command buffer. Per frame data is indexed by the frame given to
+         * records.
+         * */
+        [[nodiscard]] uint32_t getFrameCount() const;
+
+        /**
+         * 'update_frame' is called once the GPU is done with the frame about to be submitted, to write what its
+         * command buffer reads.
+         * */
+        void execute(const std::function<void(uint32_t)>& update_frame = nullptr);
+    };
+}
+
+#endif //GYMNURE_RENDERGRAPH_H
@@ -0,0 +1,40 @@
+#include <ApplicationData.hpp>
+#include <Util/Util.h>
+#include "ShaderModuleCache.h"
+
+namespace Engine::GraphicsPipeline
+{
+    std::mutex                                          ShaderModuleCache::mutex_ = {};
+    std::unordered_map<std::string, vk::ShaderModule>   ShaderModuleCache::modules_ = {};
+
+    vk::ShaderModule ShaderModuleCache::get(const std::string& filename)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = modules_.find(filename);
+            if (it != modules_.end())
+                return it->second;
+        }
+
+        // Read outside of the lock, other files load meanwhile. The first of two racing loads wins.
+        vk::ShaderModule module = Util::Util::loadSPIRVShader(filename);
+        if (!module)
+            return module;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto inserted = modules_.emplace(filename, module);
+        if (!inserted.second)
+            ApplicationData::data->device.destroyShaderModule(module, nullptr);
+
+        return inserted.first->second;
+    }
+
+    void ShaderModuleCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto& module : modules_)
+            ApplicationData::data->device.destroyShaderModule(module.second, nullptr);
+        modules_.clear();
+    }
+}
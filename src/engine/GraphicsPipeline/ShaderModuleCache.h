@@ -0,0 +1,36 @@
+#ifndef GYMNURE_SHADERMODULECACHE_H
+#define GYMNURE_SHADERMODULECACHE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vulkan/vulkan.hpp>
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * One vk::ShaderModule per SPIR-V file, shared by every pipeline using it and by every variant of them.
+     * Modules live until clear(), which must run before the device is destroyed.
+     * */
+    class ShaderModuleCache
+    {
+
+    private:
+
+        static std::mutex                                           mutex_;
+        static std::unordered_map<std::string, vk::ShaderModule>    modules_;
+
+    public:
+
+        ShaderModuleCache() = delete;
+
+        /**
+         * Loads 'filename' (see Util::loadSPIRVShader) the first time. Safe to call from any thread.
+         * */
+        static vk::ShaderModule get(const std::string& filename);
+
+        static void clear();
+    };
+}
+
+#endif //GYMNURE_SHADERMODULECACHE_H
@@ -0,0 +1,43 @@
+#include <cstddef>
+#include <Descriptors/LightClusters.h>
+#include "ShaderVariant.h"
+
+namespace Engine::GraphicsPipeline
+{
+    static_assert(ShaderVariant{}.max_lights == Descriptors::LightClusters::MAX_CLUSTER_LIGHTS,
+                  "The default light loop must cover every light a froxel holds!");
+
+    SpecializationConstants::SpecializationConstants(const ShaderVariant& variant)
+    {
+        data_.max_lights        = variant.max_lights;
+        data_.texture           = variant.texture ? VK_TRUE : VK_FALSE;
+        data_.alpha_test        = variant.alpha_test ? VK_TRUE : VK_FALSE;
+        data_.normal_mapping    = variant.normal_mapping ? VK_TRUE : VK_FALSE;
+        data_.ambient           = variant.ambient;
+        data_.specular          = variant.specular;
+        data_.alpha_cutoff      = variant.alpha_cutoff;
+
+        // Every member is 4 bytes, constant_id follows the member order.
+        std::array<uint32_t, 7> offsets = {
+            offsetof(Data, max_lights), offsetof(Data, texture), offsetof(Data, alpha_test), offsetof(Data, normal_mapping),
+            offsetof(Data, ambient), offsetof(Data, specular), offsetof(Data, alpha_cutoff)
+        };
+
+        for (uint32_t i = 0; i < entries_.size(); ++i)
+        {
+            entries_[i].constantID  = i;
+            entries_[i].offset      = offsets[i];
+            entries_[i].size        = sizeof(uint32_t);
+        }
+
+        info_.mapEntryCount = static_cast<uint32_t>(entries_.size());
+        info_.pMapEntries   = entries_.data();
+        info_.dataSize      = sizeof(Data);
+        info_.pData         = &data_;
+    }
+
+    const vk::SpecializationInfo* SpecializationConstants::getInfo() const
+    {
+        return &info_;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef GYMNURE_SHADERVARIANT_H
+#define GYMNURE_SHADERVARIANT_H
+
+#include <array>
+#include <compare>
+#include <vulkan/vulkan.hpp>
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * Permutation keys of a material. They reach shaders as specialization constants, constant_id in declaration
+     * order (see phong_fs.glsl), so each variant is compiled without the features it does not use. Shaders ignore
+     * the constants they do not declare. GraphicsPipeline creates and caches one pipeline per variant.
+     * */
+    struct ShaderVariant
+    {
+        uint32_t    max_lights      = 32;       // Per froxel, bounds the light loop. 0 is ambient only. See LightClusters.
+        bool        texture         = true;     // Else the diffuse color is white.
+        bool        alpha_test      = false;    // Discards fragments under 'alpha_cutoff'.
+        bool        normal_mapping  = true;     // Reads the second texture as a tangent space normal map.
+        float       ambient         = 0.2f;
+        float       specular        = 0.4f;     // Of the light intensity.
+        float       alpha_cutoff    = 0.5f;
+
+        auto operator<=>(const ShaderVariant&) const = default;
+    };
+
+    /**
+     * Specialization info of a variant, pointing into this object.
+     * */
+    class SpecializationConstants
+    {
+    private:
+
+        struct Data
+        {
+            uint32_t    max_lights      = 0;
+            vk::Bool32  texture         = VK_FALSE;
+            vk::Bool32  alpha_test      = VK_FALSE;
+            vk::Bool32  normal_mapping  = VK_FALSE;
+            float       ambient         = 0.f;
+            float       specular        = 0.f;
+            float       alpha_cutoff    = 0.f;
+        };
+
+        Data                                        data_       = {};
+        std::array<vk::SpecializationMapEntry, 7>   entries_    = {};
+        vk::SpecializationInfo                      info_       = {};
+
+    public:
+
+        explicit SpecializationConstants(const ShaderVariant& variant);
+        SpecializationConstants(const SpecializationConstants&) = delete;
+        SpecializationConstants& operator=(const SpecializationConstants&) = delete;
+
+        [[nodiscard]] const vk::SpecializationInfo* getInfo() const;
+    };
+}
+
+#endif //GYMNURE_SHADERVARIANT_H
@@ -0,0 +1,145 @@
+#include <Util/Util.h>
+#include "ShaderModuleCache.h"
+#include "TiledLighting.h"
+
+namespace Engine::GraphicsPipeline
+{
+    TiledLighting::TiledLighting()
+    {
+        vk::Device device = ApplicationData::data->device;
+
+        // View-projection matrices, camera position, lights, g-buffer albedo, normal, material and depth, output.
+        std::array<vk::DescriptorSetLayoutBinding, 8> bindings = {};
+        for (uint32_t i = 0; i < bindings.size(); ++i)
+        {
+            bindings[i].binding             = i;
+            bindings[i].descriptorType      = vk::DescriptorType::eCombinedImageSampler;
+            bindings[i].descriptorCount     = 1;
+            bindings[i].stageFlags          = vk::ShaderStageFlagBits::eCompute;
+            bindings[i].pImmutableSamplers  = nullptr;
+        }
+        bindings[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+        bindings[1].descriptorType = vk::DescriptorType::eUniformBuffer;
+        bindings[2].descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+        bindings[7].descriptorType = vk::DescriptorType::eStorageImage;
+
+        vk::DescriptorSetLayoutCreateInfo descriptor_layout = {};
+        descriptor_layout.pNext         = nullptr;
+        descriptor_layout.bindingCount  = static_cast<uint32_t>(bindings.size());
+        descriptor_layout.pBindings     = bindings.data();
+        desc_layout_ = device.createDescriptorSetLayout(descriptor_layout);
+
+        vk::PipelineLayoutCreateInfo pipeline_layout = {};
+        pipeline_layout.pNext                   = nullptr;
+        pipeline_layout.setLayoutCount          = 1;
+        pipeline_layout.pSetLayouts             = &desc_layout_;
+        pipeline_layout.pushConstantRangeCount  = 0;
+        pipeline_layout.pPushConstantRanges     = nullptr;
+        pipeline_layout_ = device.createPipelineLayout(pipeline_layout);
+
+        // A single set, written again whenever the g-buffer images change.
+        std::array<vk::DescriptorPoolSize, 4> pool_sizes = {};
+        pool_sizes[0].type              = vk::DescriptorType::eUniformBuffer;
+        pool_sizes[0].descriptorCount   = 2;
+        pool_sizes[1].type              = vk::DescriptorType::eStorageBufferDynamic;
+        pool_sizes[1].descriptorCount   = 1;
+        pool_sizes[2].type              = vk::DescriptorType::eCombinedImageSampler;
+        pool_sizes[2].descriptorCount   = 4;
+        pool_sizes[3].type              = vk::DescriptorType::eStorageImage;
+        pool_sizes[3].descriptorCount   = 1;
+
+        vk::DescriptorPoolCreateInfo descriptor_pool_info = {};
+        descriptor_pool_info.maxSets        = 1;
+        descriptor_pool_info.poolSizeCount  = static_cast<uint32_t>(pool_sizes.size());
+        descriptor_pool_info.pPoolSizes     = pool_sizes.data();
+        desc_pool_ = device.createDescriptorPool(descriptor_pool_info);
+
+        vk::DescriptorSetAllocateInfo alloc_info = {};
+        alloc_info.pNext                = nullptr;
+        alloc_info.descriptorPool       = desc_pool_;
+        alloc_info.descriptorSetCount   = 1;
+        alloc_info.pSetLayouts          = &desc_layout_;
+        descriptor_set_ = device.allocateDescriptorSets(alloc_info)[0];
+
+        vk::ComputePipelineCreateInfo pipeline_info = {};
+        pipeline_info.pNext                     = nullptr;
+        pipeline_info.stage.stage               = vk::ShaderStageFlagBits::eCompute;
+        pipeline_info.stage.module              = ShaderModuleCache::get("tiled_lighting_cs.spv");
+        pipeline_info.stage.pName               = "main";
+        pipeline_info.layout                    = pipeline_layout_;
+        assert(pipeline_info.stage.module);
+
+        pipeline_ = device.createComputePipeline(ApplicationData::data->pipeline_cache, pipeline_info, nullptr);
+
+        vk::SamplerCreateInfo sampler_ci = {};
+        sampler_ci.magFilter        = vk::Filter::eNearest;
+        sampler_ci.minFilter        = vk::Filter::eNearest;
+        sampler_ci.mipmapMode       = vk::SamplerMipmapMode::eNearest;
+        sampler_ci.addressModeU     = vk::SamplerAddressMode::eClampToEdge;
+        sampler_ci.addressModeV     = vk::SamplerAddressMode::eClampToEdge;
+        sampler_ci.addressModeW     = vk::SamplerAddressMode::eClampToEdge;
+        sampler_ci.maxAnisotropy    = 1.0f;
+        sampler_ci.minLod           = 0.0f;
+        sampler_ci.maxLod           = 0.0f;
+        sampler_ci.borderColor      = vk::BorderColor::eFloatOpaqueBlack;
+        sampler_ = device.createSampler(sampler_ci);
+    }
+
+    TiledLighting::~TiledLighting()
+    {
+        vk::Device device = ApplicationData::data->device;
+
+        device.destroySampler(sampler_);
+        device.destroyPipeline(pipeline_);
+        device.destroyPipelineLayout(pipeline_layout_);
+        device.destroyDescriptorSetLayout(desc_layout_);
+        device.destroyDescriptorPool(desc_pool_);
+    }
+
+    void TiledLighting::bind(const std::shared_ptr<Descriptors::Camera>& camera, Descriptors::Lights& lights,
+                             const std::array<vk::ImageView, 4>& g_buffer, vk::ImageView output)
+    {
+        std::vector<vk::WriteDescriptorSet> writes = camera->getWrites(descriptor_set_, 0, 1);
+        writes.push_back(lights.getWrite(descriptor_set_, 2));
+
+        // Pointed by the writes.
+        std::array<vk::DescriptorImageInfo, 5> image_infos = {};
+        for (uint32_t i = 0; i < g_buffer.size(); ++i)
+        {
+            image_infos[i].sampler      = sampler_;
+            image_infos[i].imageView    = g_buffer[i];
+            image_infos[i].imageLayout  = vk::ImageLayout::eShaderReadOnlyOptimal;
+        }
+        image_infos[4].imageView    = output;
+        image_infos[4].imageLayout  = vk::ImageLayout::eGeneral;
+
+        for (uint32_t i = 0; i < image_infos.size(); ++i)
+        {
+            vk::WriteDescriptorSet write = {};
+            write.pNext             = nullptr;
+            write.dstSet            = descriptor_set_;
+            write.descriptorCount   = 1;
+            write.descriptorType    = i < g_buffer.size() ? vk::DescriptorType::eCombinedImageSampler : vk::DescriptorType::eStorageImage;
+            write.pImageInfo        = &image_infos[i];
+            write.dstBinding        = 3 + i;
+            writes.push_back(write);
+        }
+
+        ApplicationData::data->device.updateDescriptorSets(writes, {});
+    }
+
+    void TiledLighting::record(vk::CommandBuffer command_buffer, uint32_t lights_offset) const
+    {
+        uint32_t width = ApplicationData::data->view_width;
+        uint32_t height = ApplicationData::data->view_height;
+
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_);
+        command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_layout_, 0, {descriptor_set_}, {lights_offset});
+        command_buffer.dispatch((width + TILE_SIZE - 1) / TILE_SIZE, (height + TILE_SIZE - 1) / TILE_SIZE, 1);
+    }
+
+    vk::Sampler TiledLighting::getSampler() const
+    {
+        return sampler_;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef GYMNURE_TILEDLIGHTING_H
+#define GYMNURE_TILEDLIGHTING_H
+
+#include <array>
+#include <memory>
+#include <Descriptors/Camera.h>
+#include <Descriptors/Lights.h>
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * Deferred shading in one compute pass (see tiled_lighting_cs.glsl). A workgroup per TILE_SIZE² pixels finds
+     * the depth range of its tile, lists the lights reaching it in shared memory, then shades each pixel with
+     * these lights only. The cost follows the lights on screen, not the number of lights.
+     * */
+    class TiledLighting
+    {
+    public:
+
+        static constexpr uint32_t TILE_SIZE = 16;
+
+    private:
+
+        vk::DescriptorSetLayout     desc_layout_        = {};
+        vk::PipelineLayout          pipeline_layout_    = {};
+        vk::DescriptorPool          desc_pool_          = {};
+        vk::DescriptorSet           descriptor_set_     = {};
+        vk::Pipeline                pipeline_           = {};
+        vk::Sampler                 sampler_            = {};   // Nearest, g-buffer texels are fetched.
+
+    public:
+
+        TiledLighting();
+        ~TiledLighting();
+
+        /**
+         * 'g_buffer' is albedo, normal, material and depth, sampled. 'output' is a storage image of the view size.
+         * */
+        void bind(const std::shared_ptr<Descriptors::Camera>& camera, Descriptors::Lights& lights,
+                  const std::array<vk::ImageView, 4>& g_buffer, vk::ImageView output);
+
+        /**
+         * Must be recorded outside of a render pass. 'lights_offset' is Descriptors::Lights::getOffset() of the
+         * frame recorded.
+         * */
+        void record(vk::CommandBuffer command_buffer, uint32_t lights_offset) const;
+
+        [[nodiscard]] vk::Sampler getSampler() const;
+    };
+}
+
+#endif //GYMNURE_TILEDLIGHTING_H
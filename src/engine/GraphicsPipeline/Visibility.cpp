@@ -0,0 +1,257 @@
+#include <numeric>
+#include <algorithm>
+#include <Memory/ImageFormats.hpp>
+#include <Descriptors/TextureCache.h>
+#include <Descriptors/TextureStreamer.h>
+#include "Visibility.hpp"
+
+namespace Engine::GraphicsPipeline
+{
+    Visibility::Visibility(RenderGraph& render_graph, std::shared_ptr<Descriptors::LightClusters> light_clusters)
+        : light_clusters_(std::move(light_clusters))
+    {
+        if (!ApplicationData::data->visibility_buffer) { Debug::logErrorAndDie("Visibility buffer needs descriptor indexing and geometry shaders!"); }
+
+        render_pass_ = render_graph.getCompatibleRenderPass({vk::Format::eR32Uint},
+                                                            Memory::ImageFormats::getImageFormat(Memory::ImageType::DEPTH_STENCIL));
+
+        // Positions and the camera only, objects are already in world space.
+        Descriptors::LayoutData ld = {};
+        ld.has_model_matrix = false;
+        layout_ = std::make_shared<Descriptors::Layout>(ld);
+
+        pipeline_ = std::make_shared<GraphicsPipeline>(std::vector<Shader>{
+            {"visibility_vs.spv", vk::ShaderStageFlagBits::eVertex},
+            {"visibility_fs.spv", vk::ShaderStageFlagBits::eFragment}
+        });
+        pipeline_->setVertexInput(Vertex::PositionLayout::describe());
+        pipeline_->create(layout_->getPipelineLayout(), render_pass_, vk::CullModeFlagBits::eBack, 0, 1, false);
+
+        shading_ = std::make_unique<VisibilityShading>();
+
+        // The shaded image, copied as is.
+        ld.has_view_projection_matrix   = false;
+        ld.fragment_texture_count       = 1;
+        resolve_program_ = std::make_shared<Programs::Program>(
+            Programs::ProgramParams{Vertex::EmptyLayout::describe(), ld, "deferred_resolve"},
+            render_graph.getCompatibleRenderPass({Memory::ImageFormats::getSurfaceFormat().format}, vk::Format::eUndefined));
+
+        std::array<unsigned char, 4> white = {255, 255, 255, 255};
+        textures_.push_back(std::make_shared<Descriptors::Texture>(white.data(), 1, 1));
+    }
+
+    void Visibility::addObjData(GymnureObjData&& data, const GymnureObjDataType& type)
+    {
+        uploadObjData(Programs::Program::loadObjData(std::move(data), type, false));
+    }
+
+    void Visibility::uploadObjData(std::vector<Programs::ObjectLoadData>&& load_data)
+    {
+        for (Programs::ObjectLoadData& load_object : load_data)
+        {
+            if (load_object.streamed_mesh != nullptr) { Debug::logErrorAndDie("Streamed geometry can not be drawn in the visibility buffer!"); }
+
+            // The first texture of the object, as other programs. Cached textures are shared by objects.
+            std::shared_ptr<Descriptors::Texture> object_texture = textures_[0];
+            if (!load_object.decoded_textures.empty())
+                object_texture = Descriptors::TextureCache::upload(load_object.decoded_textures[0]);
+            else if (!load_object.textures.empty())
+                object_texture = load_object.textures[0];
+
+            auto texture = static_cast<uint32_t>(std::find(textures_.begin(), textures_.end(), object_texture) - textures_.begin());
+            if (texture == textures_.size())
+                textures_.push_back(object_texture);
+
+            if (textures_.size() > VisibilityShading::MAX_TEXTURES) { Debug::logErrorAndDie("Too many visibility buffer textures!"); }
+
+            for (const std::shared_ptr<Mesh>& mesh : load_object.meshes)
+            {
+                if (objects_.size() >= MAX_OBJECTS) { Debug::logErrorAndDie("Too many visibility buffer objects!"); }
+
+                ObjectData object = {};
+                object.first_index   = static_cast<uint32_t>(indices_.size());
+                object.vertex_offset = static_cast<uint32_t>(vertices_.size());
+                object.texture       = texture;
+
+                if (mesh->indexData != nullptr) {
+                    indices_.insert(indices_.end(), mesh->indexData->begin(), mesh->indexData->end());
+                } else {
+                    size_t first = indices_.size();
+                    indices_.resize(first + mesh->vertexData->size());
+                    std::iota(indices_.begin() + static_cast<std::ptrdiff_t>(first), indices_.end(), 0u);
+                }
+
+                ObjectDraw draw = {};
+                draw.index_count = static_cast<uint32_t>(indices_.size()) - object.first_index;
+                draw.bounds      = mesh->bounds;
+                draw.uv_density  = mesh->uv_density;
+                draw.texture     = textures_[texture];
+
+                if (draw.index_count / 3 >= (1u << TRIANGLE_BITS)) { Debug::logErrorAndDie("Mesh has too many triangles for the visibility buffer!"); }
+
+                vertices_.insert(vertices_.end(), mesh->vertexData->begin(), mesh->vertexData->end());
+                for (const VertexData& vertex : *mesh->vertexData)
+                    positions_.push_back(vertex.pos);
+
+                objects_.push_back(object);
+                draws_.push_back(std::move(draw));
+            }
+        }
+
+        geometry_dirty_ = true;
+    }
+
+    void Visibility::uploadGeometry()
+    {
+        struct BufferData buffer_data = {};
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        buffer_data.usage = vk::BufferUsageFlagBits::eVertexBuffer;
+        buffer_data.count = positions_.size();
+        position_buffer_ = std::make_unique<Memory::Buffer<glm::vec3>>(buffer_data);
+        position_buffer_->updateBuffer(positions_);
+
+        // Only read by shading.
+        buffer_data.usage = vk::BufferUsageFlagBits::eStorageBuffer;
+        buffer_data.count = vertices_.size();
+        vertex_buffer_ = std::make_unique<Memory::Buffer<VertexData>>(buffer_data);
+        vertex_buffer_->updateBuffer(vertices_);
+
+        buffer_data.usage = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+        buffer_data.count = indices_.size();
+        index_buffer_ = std::make_unique<Memory::Buffer<uint32_t>>(buffer_data);
+        index_buffer_->updateBuffer(indices_);
+
+        buffer_data.usage = vk::BufferUsageFlagBits::eStorageBuffer;
+        buffer_data.count = objects_.size();
+        object_buffer_ = std::make_unique<Memory::Buffer<ObjectData>>(buffer_data);
+        object_buffer_->updateBuffer(objects_);
+
+        geometry_dirty_ = false;
+    }
+
+    void Visibility::prepare(const std::shared_ptr<Descriptors::Camera> &camera, RenderGraph& render_graph)
+    {
+        if (objects_.empty())
+            return;
+
+        if (geometry_dirty_)
+            uploadGeometry();
+
+        texture_versions_.clear();
+        for (const auto& texture : textures_)
+            texture_versions_.push_back(texture->getVersion());
+
+        vk::DescriptorSet visibility_set = layout_->createDescriptorSets(1)[0];
+        ApplicationData::data->device.updateDescriptorSets({camera->getWrites(visibility_set, 0, 1)[0]}, {});
+
+        uint32_t visibility = render_graph.createImage("visibility", vk::Format::eR32Uint);
+        uint32_t depth = render_graph.createImage("visibility depth", Memory::ImageFormats::getImageFormat(Memory::ImageType::DEPTH_STENCIL));
+
+        vk::Pipeline pipeline = pipeline_->getPipeline();
+        vk::PipelineLayout pipeline_layout = layout_->getPipelineLayout();
+        vk::Buffer position_buffer = position_buffer_->getBuffer();
+        vk::Buffer index_buffer = index_buffer_->getBuffer();
+
+        std::vector<uint32_t> index_counts = {};
+        for (const ObjectDraw& draw : draws_)
+            index_counts.push_back(draw.index_count);
+
+        render_graph.addPass("visibility")
+            .writeColor(visibility, vk::ClearColorValue(std::array<uint32_t, 4>({0u, 0u, 0u, 0u})))
+            .writeDepth(depth, vk::ClearDepthStencilValue{1.0f, 0u})
+            .setRecord([pipeline, pipeline_layout, visibility_set, position_buffer, index_buffer, objects = objects_, index_counts](vk::CommandBuffer command_buffer, uint32_t) {
+                uint32_t width = ApplicationData::data->view_width;
+                uint32_t height = ApplicationData::data->view_height;
+
+                Util::Util::initViewport(command_buffer, width, height);
+                Util::Util::initScissor(command_buffer, width, height);
+
+                command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+                command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0, {visibility_set}, {});
+                command_buffer.bindVertexBuffers(0, {position_buffer}, {0});
+                command_buffer.bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32);
+
+                // The first instance names the object.
+                for (uint32_t i = 0; i < objects.size(); ++i)
+                    command_buffer.drawIndexed(index_counts[i], 1, objects[i].first_index, static_cast<int32_t>(objects[i].vertex_offset), i);
+            });
+
+        uint32_t lit = render_graph.createImage("visibility lit", vk::Format::eR16G16B16A16Sfloat);
+
+        VisibilityShading::Geometry geometry = {};
+        geometry.objects  = {object_buffer_->getBuffer(), 0, VK_WHOLE_SIZE};
+        geometry.indices  = {index_buffer_->getBuffer(), 0, VK_WHOLE_SIZE};
+        geometry.vertices = {vertex_buffer_->getBuffer(), 0, VK_WHOLE_SIZE};
+
+        render_graph.addPass("visibility shading", RenderGraph::PassType::COMPUTE)
+            .readTexture(visibility)
+            .readWriteStorage(lit)
+            .setBindImages([shading = shading_.get(), camera, light_clusters = light_clusters_, geometry, textures = textures_, visibility, lit](const RenderGraph& graph) {
+                shading->bind(camera, *light_clusters, geometry, textures, graph.getImageView(visibility), graph.getImageView(lit));
+            })
+            .setRecord([shading = shading_.get(), light_clusters = light_clusters_](vk::CommandBuffer command_buffer, uint32_t frame) {
+                shading->record(command_buffer, light_clusters->getOffsets(frame));
+            });
+
+        auto resolve_data = resolve_program_->getProgramsData();
+        vk::Pipeline resolve_pipeline = resolve_data->graphic_pipeline->getPipeline();
+        vk::PipelineLayout resolve_layout = resolve_data->descriptor_layout->getPipelineLayout();
+        vk::DescriptorSet resolve_set = resolve_data->descriptor_layout->createDescriptorSets(1)[0];
+
+        render_graph.addPass("visibility resolve")
+            .readTexture(lit)
+            .writeColor(render_graph.getBackbuffer())
+            .setBindImages([lit, sampler = shading_->getSampler(), resolve_set](const RenderGraph& graph) {
+                vk::DescriptorImageInfo image_info = {};
+                image_info.sampler      = sampler;
+                image_info.imageView    = graph.getImageView(lit);
+                image_info.imageLayout  = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+                vk::WriteDescriptorSet write = {};
+                write.dstSet            = resolve_set;
+                write.dstBinding        = 0;
+                write.descriptorCount   = 1;
+                write.descriptorType    = vk::DescriptorType::eCombinedImageSampler;
+                write.pImageInfo        = &image_info;
+
+                ApplicationData::data->device.updateDescriptorSets({write}, {});
+            })
+            .setRecord([resolve_pipeline, resolve_layout, resolve_set](vk::CommandBuffer command_buffer, uint32_t) {
+                uint32_t width = ApplicationData::data->view_width;
+                uint32_t height = ApplicationData::data->view_height;
+
+                Util::Util::initViewport(command_buffer, width, height);
+                Util::Util::initScissor(command_buffer, width, height);
+
+                command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, resolve_pipeline);
+                command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, resolve_layout, 0, {resolve_set}, {});
+                command_buffer.draw(3, 1, 0, 0);
+            });
+    }
+
+    bool Visibility::updateTextures()
+    {
+        // Objects were added since prepare(), which binds them all.
+        if (texture_versions_.size() != textures_.size())
+            return false;
+
+        bool changed = false;
+        for (uint32_t i = 0; i < textures_.size(); ++i)
+        {
+            changed |= textures_[i]->getVersion() != texture_versions_[i];
+            texture_versions_[i] = textures_[i]->getVersion();
+        }
+
+        if (changed)
+            shading_->updateTextures(textures_);
+
+        return changed;
+    }
+
+    void Visibility::update(const Descriptors::Camera &camera)
+    {
+        for (const ObjectDraw& draw : draws_)
+            Descriptors::TextureStreamer::requestLevels(*draw.texture, draw.bounds, draw.uv_density, camera);
+    }
+}
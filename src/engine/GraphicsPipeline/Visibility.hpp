@@ -0,0 +1,96 @@
+#ifndef GYMNURE_VISIBILITY_HPP
+#define GYMNURE_VISIBILITY_HPP
+
+#include <memory>
+#include <Descriptors/LightClusters.h>
+#include "RenderGraph.h"
+#include "VisibilityShading.h"
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * Visibility buffer rendering: objects are drawn once, writing only a 32 bits ID per pixel, the object in the
+     * high bits and its triangle in the TRIANGLE_BITS low ones, and depth. VisibilityShading then shades each
+     * pixel exactly once, whatever the overdraw, from the vertices of its triangle.
+     *
+     * Every object is merged in the same vertex and index buffers, so shading reaches any triangle. Objects are
+     * drawn with their index as first instance, and index a texture array, which needs descriptor indexing.
+     * */
+    class Visibility
+    {
+    public:
+
+        static constexpr uint32_t TRIANGLE_BITS = 22;
+        static constexpr uint32_t MAX_OBJECTS   = (1u << (32 - TRIANGLE_BITS)) - 1;   // ID 0 is the background.
+
+    private:
+
+        /**
+         * As the shading reads it.
+         * */
+        struct ObjectData
+        {
+            uint32_t    first_index     = 0;
+            uint32_t    vertex_offset   = 0;
+            uint32_t    texture         = 0;
+            uint32_t    padding         = 0;
+        };
+
+        struct ObjectDraw
+        {
+            uint32_t                                index_count     = 0;
+            Bounds                                  bounds          = {};
+            float                                   uv_density      = 0.f;
+            std::shared_ptr<Descriptors::Texture>   texture         = nullptr;
+        };
+
+        vk::RenderPass                                          render_pass_        = {};
+        std::shared_ptr<Descriptors::Layout>                    layout_             = nullptr;
+        std::shared_ptr<GraphicsPipeline>                       pipeline_           = nullptr;
+        std::unique_ptr<VisibilityShading>                      shading_            = nullptr;
+        std::shared_ptr<Programs::Program>                      resolve_program_    = nullptr;
+        std::shared_ptr<Descriptors::LightClusters>             light_clusters_     = nullptr;
+
+        // Merged geometry, uploaded again by prepare() when objects were added.
+        std::vector<VertexData>                                 vertices_           = {};
+        std::vector<glm::vec3>                                  positions_          = {};
+        std::vector<uint32_t>                                   indices_            = {};
+        std::vector<ObjectData>                                 objects_            = {};
+        std::vector<ObjectDraw>                                 draws_              = {};
+        std::vector<std::shared_ptr<Descriptors::Texture>>      textures_           = {};   // The first one white, for objects without any.
+        std::vector<uint32_t>                                   texture_versions_   = {};   // Of 'textures_' as last bound.
+        bool                                                    geometry_dirty_     = false;
+
+        std::unique_ptr<Memory::Buffer<VertexData>>             vertex_buffer_      = nullptr;
+        std::unique_ptr<Memory::Buffer<glm::vec3>>              position_buffer_    = nullptr;
+        std::unique_ptr<Memory::Buffer<uint32_t>>               index_buffer_       = nullptr;
+        std::unique_ptr<Memory::Buffer<ObjectData>>             object_buffer_      = nullptr;
+
+        void uploadGeometry();
+
+    public:
+
+        Visibility(RenderGraph& render_graph, std::shared_ptr<Descriptors::LightClusters> light_clusters);
+
+        void addObjData(GymnureObjData&& data, const GymnureObjDataType& type);
+        void uploadObjData(std::vector<Programs::ObjectLoadData>&& load_data);
+
+        /**
+         * Declare the visibility pass, its shading and the copy of the result to the backbuffer.
+         * */
+        void prepare(const std::shared_ptr<Descriptors::Camera> &camera, RenderGraph& render_graph);
+
+        /**
+         * Once per frame: texture levels of every object. The light clusters are updated by their owner.
+         * */
+        void update(const Descriptors::Camera &camera);
+
+        /**
+         * Bind the new images of streamed textures (see Descriptors::TextureStreamer). True when the shading pass
+         * must be recorded again.
+         * */
+        bool updateTextures();
+    };
+}
+
+#endif //GYMNURE_VISIBILITY_HPP
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <Util/Util.h>
+#include "ShaderModuleCache.h"
+#include "VisibilityShading.h"
+
+namespace Engine::GraphicsPipeline
+{
+    VisibilityShading::VisibilityShading()
+    {
+        vk::Device device = ApplicationData::data->device;
+
+        // View-projection matrices, camera position, lights, light clusters, objects, indices, vertices, visibility,
+        // output, then the textures of every object.
+        std::array<vk::DescriptorSetLayoutBinding, 10> bindings = {};
+        for (uint32_t i = 0; i < bindings.size(); ++i)
+        {
+            bindings[i].binding             = i;
+            bindings[i].descriptorType      = vk::DescriptorType::eStorageBuffer;
+            bindings[i].descriptorCount     = 1;
+            bindings[i].stageFlags          = vk::ShaderStageFlagBits::eCompute;
+            bindings[i].pImmutableSamplers  = nullptr;
+        }
+        bindings[0].descriptorType  = vk::DescriptorType::eUniformBuffer;
+        bindings[1].descriptorType  = vk::DescriptorType::eUniformBuffer;
+        bindings[2].descriptorType  = vk::DescriptorType::eStorageBufferDynamic;   // One region per frame in flight.
+        bindings[3].descriptorType  = vk::DescriptorType::eStorageBufferDynamic;
+        bindings[7].descriptorType  = vk::DescriptorType::eCombinedImageSampler;
+        bindings[8].descriptorType  = vk::DescriptorType::eStorageImage;
+        bindings[9].descriptorType  = vk::DescriptorType::eCombinedImageSampler;
+        bindings[9].descriptorCount = MAX_TEXTURES;
+
+        vk::DescriptorSetLayoutCreateInfo descriptor_layout = {};
+        descriptor_layout.pNext         = nullptr;
+        descriptor_layout.bindingCount  = static_cast<uint32_t>(bindings.size());
+        descriptor_layout.pBindings     = bindings.data();
+        desc_layout_ = device.createDescriptorSetLayout(descriptor_layout);
+
+        vk::PipelineLayoutCreateInfo pipeline_layout = {};
+        pipeline_layout.pNext                   = nullptr;
+        pipeline_layout.setLayoutCount          = 1;
+        pipeline_layout.pSetLayouts             = &desc_layout_;
+        pipeline_layout.pushConstantRangeCount  = 0;
+        pipeline_layout.pPushConstantRanges     = nullptr;
+        pipeline_layout_ = device.createPipelineLayout(pipeline_layout);
+
+        // Two sets, each written again whenever objects or images change while the other one may be bound.
+        const auto set_count = static_cast<uint32_t>(descriptor_sets_.size());
+        std::array<vk::DescriptorPoolSize, 5> pool_sizes = {};
+        pool_sizes[0].type              = vk::DescriptorType::eUniformBuffer;
+        pool_sizes[0].descriptorCount   = 2 * set_count;
+        pool_sizes[1].type              = vk::DescriptorType::eStorageBuffer;
+        pool_sizes[1].descriptorCount   = 3 * set_count;
+        pool_sizes[2].type              = vk::DescriptorType::eCombinedImageSampler;
+        pool_sizes[2].descriptorCount   = (1 + MAX_TEXTURES) * set_count;
+        pool_sizes[3].type              = vk::DescriptorType::eStorageImage;
+        pool_sizes[3].descriptorCount   = set_count;
+        pool_sizes[4].type              = vk::DescriptorType::eStorageBufferDynamic;
+        pool_sizes[4].descriptorCount   = 2 * set_count;
+
+        vk::DescriptorPoolCreateInfo descriptor_pool_info = {};
+        descriptor_pool_info.maxSets        = set_count;
+        descriptor_pool_info.poolSizeCount  = static_cast<uint32_t>(pool_sizes.size());
+        descriptor_pool_info.pPoolSizes     = pool_sizes.data();
+        desc_pool_ = device.createDescriptorPool(descriptor_pool_info);
+
+        std::array<vk::DescriptorSetLayout, 2> set_layouts = {desc_layout_, desc_layout_};
+
+        vk::DescriptorSetAllocateInfo alloc_info = {};
+        alloc_info.pNext                = nullptr;
+        alloc_info.descriptorPool       = desc_pool_;
+        alloc_info.descriptorSetCount   = set_count;
+        alloc_info.pSetLayouts          = set_layouts.data();
+        std::vector<vk::DescriptorSet> descriptor_sets = device.allocateDescriptorSets(alloc_info);
+        std::copy(descriptor_sets.begin(), descriptor_sets.end(), descriptor_sets_.begin());
+
+        vk::ComputePipelineCreateInfo pipeline_info = {};
+        pipeline_info.pNext                     = nullptr;
+        pipeline_info.stage.stage               = vk::ShaderStageFlagBits::eCompute;
+        pipeline_info.stage.module              = ShaderModuleCache::get("visibility_shading_cs.spv");
+        pipeline_info.stage.pName               = "main";
+        pipeline_info.layout                    = pipeline_layout_;
+        assert(pipeline_info.stage.module);
+
+        pipeline_ = device.createComputePipeline(ApplicationData::data->pipeline_cache, pipeline_info, nullptr);
+
+        vk::SamplerCreateInfo sampler_ci = {};
+        sampler_ci.magFilter        = vk::Filter::eNearest;
+        sampler_ci.minFilter        = vk::Filter::eNearest;
+        sampler_ci.mipmapMode       = vk::SamplerMipmapMode::eNearest;
+        sampler_ci.addressModeU     = vk::SamplerAddressMode::eClampToEdge;
+        sampler_ci.addressModeV     = vk::SamplerAddressMode::eClampToEdge;
+        sampler_ci.addressModeW     = vk::SamplerAddressMode::eClampToEdge;
+        sampler_ci.maxAnisotropy    = 1.0f;
+        sampler_ci.minLod           = 0.0f;
+        sampler_ci.maxLod           = 0.0f;
+        sampler_ci.borderColor      = vk::BorderColor::eFloatOpaqueBlack;
+        sampler_ = device.createSampler(sampler_ci);
+    }
+
+    VisibilityShading::~VisibilityShading()
+    {
+        vk::Device device = ApplicationData::data->device;
+
+        device.destroySampler(sampler_);
+        device.destroyPipeline(pipeline_);
+        device.destroyPipelineLayout(pipeline_layout_);
+        device.destroyDescriptorSetLayout(desc_layout_);
+        device.destroyDescriptorPool(desc_pool_);
+    }
+
+    void VisibilityShading::bind(const std::shared_ptr<Descriptors::Camera>& camera, Descriptors::LightClusters& light_clusters,
+                                 const Geometry& geometry, const std::vector<std::shared_ptr<Descriptors::Texture>>& textures,
+                                 vk::ImageView visibility, vk::ImageView output)
+    {
+        if (textures.empty() || textures.size() > MAX_TEXTURES) { Debug::logErrorAndDie("Invalid visibility buffer texture count!"); }
+
+        vk::DescriptorSet descriptor_set = descriptor_sets_[current_set_ ^ 1];
+
+        std::vector<vk::WriteDescriptorSet> writes = camera->getWrites(descriptor_set, 0, 1);
+        std::vector<vk::WriteDescriptorSet> light_writes = light_clusters.getWrites(descriptor_set, 2, 3);
+        writes.insert(writes.end(), light_writes.begin(), light_writes.end());
+
+        // Pointed by the writes.
+        std::array<const vk::DescriptorBufferInfo*, 3> buffer_infos = {&geometry.objects, &geometry.indices, &geometry.vertices};
+        for (uint32_t i = 0; i < buffer_infos.size(); ++i)
+        {
+            vk::WriteDescriptorSet write = {};
+            write.pNext             = nullptr;
+            write.dstSet            = descriptor_set;
+            write.descriptorCount   = 1;
+            write.descriptorType    = vk::DescriptorType::eStorageBuffer;
+            write.pBufferInfo       = buffer_infos[i];
+            write.dstBinding        = 4 + i;
+            writes.push_back(write);
+        }
+
+        std::array<vk::DescriptorImageInfo, 2> image_infos = {};
+        image_infos[0].sampler      = sampler_;
+        image_infos[0].imageView    = visibility;
+        image_infos[0].imageLayout  = vk::ImageLayout::eShaderReadOnlyOptimal;
+        image_infos[1].imageView    = output;
+        image_infos[1].imageLayout  = vk::ImageLayout::eGeneral;
+
+        for (uint32_t i = 0; i < image_infos.size(); ++i)
+        {
+            vk::WriteDescriptorSet write = {};
+            write.pNext             = nullptr;
+            write.dstSet            = descriptor_set;
+            write.descriptorCount   = 1;
+            write.descriptorType    = i == 0 ? vk::DescriptorType::eCombinedImageSampler : vk::DescriptorType::eStorageImage;
+            write.pImageInfo        = &image_infos[i];
+            write.dstBinding        = 7 + i;
+            writes.push_back(write);
+        }
+
+        getTextureWrites(descriptor_set, textures, writes);
+
+        ApplicationData::data->device.updateDescriptorSets(writes, {});
+        current_set_ ^= 1;
+    }
+
+    void VisibilityShading::updateTextures(const std::vector<std::shared_ptr<Descriptors::Texture>>& textures)
+    {
+        vk::DescriptorSet descriptor_set = descriptor_sets_[current_set_ ^ 1];
+
+        // Every binding before the textures is the same as in the current set.
+        std::vector<vk::CopyDescriptorSet> copies = {};
+        for (uint32_t binding = 0; binding < 9; ++binding)
+        {
+            vk::CopyDescriptorSet copy = {};
+            copy.srcSet             = descriptor_sets_[current_set_];
+            copy.srcBinding         = binding;
+            copy.dstSet             = descriptor_set;
+            copy.dstBinding         = binding;
+            copy.descriptorCount    = 1;
+            copies.push_back(copy);
+        }
+
+        std::vector<vk::WriteDescriptorSet> writes = {};
+        getTextureWrites(descriptor_set, textures, writes);
+
+        ApplicationData::data->device.updateDescriptorSets(writes, copies);
+        current_set_ ^= 1;
+    }
+
+    void VisibilityShading::getTextureWrites(vk::DescriptorSet descriptor_set, const std::vector<std::shared_ptr<Descriptors::Texture>>& textures,
+                                             std::vector<vk::WriteDescriptorSet>& writes)
+    {
+        // Every element must be valid, unused ones repeat the first texture.
+        for (uint32_t i = 0; i < MAX_TEXTURES; ++i)
+        {
+            vk::WriteDescriptorSet write = textures[i < textures.size() ? i : 0]->getWrite(descriptor_set, 9);
+            write.dstArrayElement = i;
+            writes.push_back(write);
+        }
+    }
+
+
+    void VisibilityShading::record(vk::CommandBuffer command_buffer, const std::vector<uint32_t>& light_offsets) const
+    {
+        uint32_t width = ApplicationData::data->view_width;
+        uint32_t height = ApplicationData::data->view_height;
+
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_);
+        command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_layout_, 0, {descriptor_sets_[current_set_]}, light_offsets);
+        command_buffer.dispatch((width + GROUP_SIZE - 1) / GROUP_SIZE, (height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+    }
+
+    vk::Sampler VisibilityShading::getSampler() const
+    {
+        return sampler_;
+    }
+}
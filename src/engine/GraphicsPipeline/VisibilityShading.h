@@ -0,0 +1,76 @@
+#ifndef GYMNURE_VISIBILITYSHADING_H
+#define GYMNURE_VISIBILITYSHADING_H
+
+#include <array>
+#include <memory>
+#include <Descriptors/Camera.h>
+#include <Descriptors/LightClusters.h>
+#include <Descriptors/Texture.hpp>
+
+namespace Engine::GraphicsPipeline
+{
+    /**
+     * Shading of the visibility buffer, in one compute pass (see visibility_shading_cs.glsl). Each pixel fetches
+     * the three vertices of its triangle, rebuilds perspective correct attributes and their screen derivatives,
+     * then is shaded once with the lights of its froxel.
+     * */
+    class VisibilityShading
+    {
+    public:
+
+        static constexpr uint32_t GROUP_SIZE    = 8;
+        static constexpr uint32_t MAX_TEXTURES  = 256;
+
+        /**
+         * Merged geometry, as storage buffers.
+         * */
+        struct Geometry
+        {
+            vk::DescriptorBufferInfo    objects     = {};
+            vk::DescriptorBufferInfo    indices     = {};
+            vk::DescriptorBufferInfo    vertices    = {};
+        };
+
+    private:
+
+        vk::DescriptorSetLayout          desc_layout_        = {};
+        vk::PipelineLayout               pipeline_layout_    = {};
+        vk::DescriptorPool               desc_pool_          = {};
+        std::array<vk::DescriptorSet, 2> descriptor_sets_    = {};   // The current one, and the one written next.
+        uint32_t                         current_set_        = 0;
+        vk::Pipeline                     pipeline_           = {};
+        vk::Sampler                      sampler_            = {};   // Nearest, IDs are fetched.
+
+        static void getTextureWrites(vk::DescriptorSet descriptor_set, const std::vector<std::shared_ptr<Descriptors::Texture>>& textures,
+                                     std::vector<vk::WriteDescriptorSet>& writes);
+
+    public:
+
+        VisibilityShading();
+        ~VisibilityShading();
+
+        /**
+         * 'textures' are indexed by objects, at most MAX_TEXTURES and at least one. 'output' is a storage image
+         * of the view size.
+         * */
+        void bind(const std::shared_ptr<Descriptors::Camera>& camera, Descriptors::LightClusters& light_clusters,
+                  const Geometry& geometry, const std::vector<std::shared_ptr<Descriptors::Texture>>& textures,
+                  vk::ImageView visibility, vk::ImageView output);
+
+        /**
+         * Same bindings with new images for 'textures' (see Descriptors::TextureStreamer), in the other set as command
+         * buffers may still bind the current one. They must be recorded again.
+         * */
+        void updateTextures(const std::vector<std::shared_ptr<Descriptors::Texture>>& textures);
+
+        /**
+         * Must be recorded outside of a render pass. 'light_offsets' is Descriptors::LightClusters::getOffsets() of
+         * the frame recorded.
+         * */
+        void record(vk::CommandBuffer command_buffer, const std::vector<uint32_t>& light_offsets) const;
+
+        [[nodiscard]] vk::Sampler getSampler() const;
+    };
+}
+
+#endif //GYMNURE_VISIBILITYSHADING_H
@@ -78,6 +78,19 @@ namespace Engine::Memory
             device.unmapMemory(this->mem);
         }
 
+        /**
+         * Mapping of the whole buffer, for host visible buffers written a range at a time. Valid until unmap().
+         * */
+        [[nodiscard]] void* map()
+        {
+            return ApplicationData::data->device.mapMemory(this->mem, 0, getSize());
+        }
+
+        void unmap()
+        {
+            ApplicationData::data->device.unmapMemory(this->mem);
+        }
+
         void updateBuffer(std::vector<T, std::allocator<T>> data)
         {
             if (data.size() != count)
@@ -31,7 +31,7 @@ namespace Engine::Memory
         viewInfo.components                      = img_props.component;
         viewInfo.subresourceRange.aspectMask 	 = aspectMask;
         viewInfo.subresourceRange.baseMipLevel 	 = 0;
-        viewInfo.subresourceRange.levelCount 	 = 1;
+        viewInfo.subresourceRange.levelCount 	 = img_props.mip_levels;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount 	 = 1;
 
@@ -50,7 +50,7 @@ namespace Engine::Memory
         imageInfo.extent.width 	= img_props.width;
         imageInfo.extent.height = img_props.height;
         imageInfo.extent.depth 	= 1;
-        imageInfo.mipLevels 	= 1;
+        imageInfo.mipLevels 	= img_props.mip_levels;
         imageInfo.arrayLayers 	= 1;
         imageInfo.format 		= img_props.format;
         imageInfo.tiling 		= img_props.tiling;
@@ -12,6 +12,7 @@ namespace Engine
         {
             uint32_t                width = 0;
             uint32_t                height = 0;
+            uint32_t                mip_levels = 1;
             vk::Format              format = vk::Format::eUndefined;
             vk::ImageTiling         tiling{};
             vk::ImageUsageFlags     usage{};
@@ -31,12 +32,13 @@ namespace Engine
             vk::Image image = {};
             vk::ImageView view = {};
             vk::DeviceMemory memory = {};
+            uint32_t mip_levels = 1;
 
             /**
              * Create an Image, Memory and ImageView buffers.
              * */
             explicit BufferImage(const struct ImageProps& img_props)
-                : image(createImage(img_props)), view(createImageView(img_props)),
+                : image(createImage(img_props)), view(createImageView(img_props)), mip_levels(img_props.mip_levels),
                 // 'image_created = true' marks that Image has been created by this class.
                 // If it wont (came from another resource, e.g. swapchain) we cant destroy it here! (see destructor)
                 image_created(true) {};
@@ -45,7 +47,7 @@ namespace Engine
              * Create a image buffer using an external Image/Memory resources.
              * */
             explicit BufferImage(const struct ImageProps& img_props, vk::Image image_ptr)
-                : image(image_ptr), view(createImageView(img_props)) {};
+                : image(image_ptr), view(createImageView(img_props)), mip_levels(img_props.mip_levels) {};
 
             ~BufferImage();
 
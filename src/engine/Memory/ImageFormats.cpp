@@ -48,11 +48,55 @@ namespace Engine
 
                     return formats_[DEPTH_STENCIL];
 
+                case GBUFFER_ALBEDO:
+                    if(formats_.find(GBUFFER_ALBEDO) == formats_.end())
+                        formats_[GBUFFER_ALBEDO] = findFormat({vk::Format::eR8G8B8A8Srgb}, vk::FormatFeatureFlagBits::eColorAttachment);
+
+                    return formats_[GBUFFER_ALBEDO];
+
+                case GBUFFER_NORMAL:
+                    // Snorm attachments are optional, half floats hold [-1, 1] as well.
+                    if(formats_.find(GBUFFER_NORMAL) == formats_.end())
+                        formats_[GBUFFER_NORMAL] = findFormat({vk::Format::eR16G16Snorm, vk::Format::eR16G16Sfloat},
+                                                              vk::FormatFeatureFlagBits::eColorAttachment);
+
+                    return formats_[GBUFFER_NORMAL];
+
+                case GBUFFER_MATERIAL:
+                    if(formats_.find(GBUFFER_MATERIAL) == formats_.end())
+                        formats_[GBUFFER_MATERIAL] = findFormat({vk::Format::eR8G8B8A8Unorm}, vk::FormatFeatureFlagBits::eColorAttachment);
+
+                    return formats_[GBUFFER_MATERIAL];
+
+                case GBUFFER_DEPTH:
+                    // Sampled by tiled lighting.
+                    if(formats_.find(GBUFFER_DEPTH) == formats_.end())
+                        formats_[GBUFFER_DEPTH] = findFormat({vk::Format::eD32Sfloat, vk::Format::eX8D24UnormPack32, vk::Format::eD16Unorm},
+                                                             vk::FormatFeatureFlagBits::eDepthStencilAttachment |
+                                                             vk::FormatFeatureFlagBits::eSampledImage);
+
+                    return formats_[GBUFFER_DEPTH];
+
                 default:
                     throw "getImageFormat(): Invalid ImageType!";
             }
         }
 
+        vk::Format ImageFormats::findFormat(const std::vector<vk::Format>& candidates, vk::FormatFeatureFlags features)
+        {
+            auto app_data = ApplicationData::data;
+
+            auto format_it = std::find_if(candidates.begin(), candidates.end(), [app_data, features](vk::Format format) -> bool {
+                vk::FormatProperties formatProps = app_data->gpu.getFormatProperties(format);
+                return (formatProps.optimalTilingFeatures & features) == features;
+            });
+
+            if(format_it == candidates.end())
+                throw "Cannot find a supported format!";
+
+            return *format_it;
+        }
+
         vk::SurfaceFormatKHR ImageFormats::getSurfaceFormat()
         {
             auto app_data = ApplicationData::data;
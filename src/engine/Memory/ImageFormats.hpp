@@ -10,6 +10,10 @@ namespace Engine::Memory
     {
         COLOR_TEXTURE,
         DEPTH_STENCIL,
+        GBUFFER_ALBEDO,     // sRGB, 8 bits per channel.
+        GBUFFER_NORMAL,     // Octahedral, 16 bits per axis.
+        GBUFFER_MATERIAL,   // Roughness, metalness and material ID, 8 bits each.
+        GBUFFER_DEPTH,      // No stencil, position is rebuilt from it.
     };
 
     class ImageFormats
@@ -20,6 +24,11 @@ namespace Engine::Memory
         static std::map<ImageType, vk::Format> formats_;
         static vk::SurfaceFormatKHR surface_format;
 
+        /**
+         * First of 'candidates' whose optimal tiling supports 'features'.
+         * */
+        static vk::Format findFormat(const std::vector<vk::Format>& candidates, vk::FormatFeatureFlags features);
+
     public:
 
         ImageFormats() = delete;
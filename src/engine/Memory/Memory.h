@@ -30,6 +30,18 @@ namespace Engine::Memory
 			return dynamicAlignment;
 		}
 
+		/**
+		 * 'size' bytes rounded up to the offset alignment of storage buffers, for regions bound at dynamic offsets.
+		 * */
+		static size_t getStorageAlignment(size_t size)
+		{
+			size_t minSsboAlignment = ApplicationData::data->gpu.getProperties().limits.minStorageBufferOffsetAlignment;
+			if (minSsboAlignment > 0) {
+				size = (size + minSsboAlignment - 1) & ~(minSsboAlignment - 1);
+			}
+			return size;
+		}
+
         template <class T>
         static void alignedFree(T* data)
         {
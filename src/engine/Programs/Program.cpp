@@ -1,16 +1,23 @@
 #include <GraphicsPipeline/GraphicsPipeline.h>
 #include <Util/ModelDataLoader.h>
+#include <Util/MeshletBuilder.h>
+#include <Util/CookedAsset.h>
+#include <Util/MeshOptimizer.h>
+#include <Descriptors/TextureStreamer.h>
 #include "Program.h"
 
 namespace Engine::Programs
 {
     Program::Program(const ProgramParams &p_config, vk::RenderPass render_pass)
+        : quantized_vertices_(p_config.quantized_vertices), shader_variants_(p_config.shader_variants), variant_(p_config.variant)
     {
-        program_data_->descriptor_layout = std::make_shared<Descriptors::Layout>(p_config.layout_data);
+        Descriptors::LayoutData layout_data = p_config.layout_data;
+        layout_data.has_vertex_dequantization = quantized_vertices_;
+        program_data_->descriptor_layout = std::make_shared<Descriptors::Layout>(layout_data);
 
         auto vert = Engine::GraphicsPipeline::Shader{};
         vert.type = vk::ShaderStageFlagBits::eVertex;
-        vert.path = p_config.shaders_name + "_vs.spv";
+        vert.path = p_config.shaders_name + (quantized_vertices_ ? "_packed_vs.spv" : "_vs.spv");
 
         auto frag = Engine::GraphicsPipeline::Shader{};
         frag.type = vk::ShaderStageFlagBits::eFragment;
@@ -19,51 +26,21 @@ namespace Engine::Programs
         std::vector<Engine::GraphicsPipeline::Shader> shaders = {vert, frag};
         program_data_->graphic_pipeline = std::make_shared<GraphicsPipeline::GraphicsPipeline>(std::move(shaders));
 
-        std::vector<vk::VertexInputAttributeDescription> vi_attribs = {};
-        vk::VertexInputAttributeDescription vi_attrib{};
-        vi_attrib.binding = 0;
+        program_data_->vertex_input = p_config.vertex_input;
+        program_data_->graphic_pipeline->setVertexInput(p_config.vertex_input);
 
-        uint32_t location = 0;
-        if (p_config.vi_types_mask & VertexInputType::POSITION)
-        {
-            vi_attrib.location = location++;
-            vi_attrib.format = vk::Format::eR32G32B32Sfloat;
-            vi_attrib.offset = static_cast<uint32_t>(offsetof(VertexData, pos));
-
-            vi_attribs.push_back(vi_attrib);
-        }
-
-        if (p_config.vi_types_mask & VertexInputType::UV)
-        {
-            vi_attrib.location = location++;
-            vi_attrib.format = vk::Format::eR32G32Sfloat;
-            vi_attrib.offset = static_cast<uint32_t>(offsetof(VertexData, uv));
-
-            vi_attribs.push_back(vi_attrib);
-        }
-
-        if (p_config.vi_types_mask & VertexInputType::NORMAL)
-        {
-            vi_attrib.location = location++;
-            vi_attrib.format = vk::Format::eR32G32B32Sfloat;
-            vi_attrib.offset = static_cast<uint32_t>(offsetof(VertexData, normal));
-
-            vi_attribs.push_back(vi_attrib);
-        }
-
-        if (p_config.vi_types_mask & VertexInputType::COLOR)
-        {
-            vi_attrib.location = location++;
-            vi_attrib.format = vk::Format::eR8G8B8A8Unorm;
-            vi_attrib.offset = static_cast<uint32_t>(offsetof(VertexData, color));
-
-            vi_attribs.push_back(vi_attrib);
-        }
+        vk::PipelineLayout pl = program_data_->descriptor_layout->getPipelineLayout();
+        program_data_->graphic_pipeline->create(pl, render_pass, vk::CullModeFlagBits::eBack, p_config.subpass, p_config.color_attachment_count);
+        // The fallback of objects whose variant is not built yet.
+        program_data_->graphic_pipeline->requestPipeline(variant_);
 
-        program_data_->graphic_pipeline->addViAttributes(vi_attribs);
+        if (p_config.meshlet_culling)
+            program_data_->meshlet_culling = std::make_shared<GraphicsPipeline::MeshletCulling>();
 
-        vk::PipelineLayout pl = program_data_->descriptor_layout->getPipelineLayout();
-        program_data_->graphic_pipeline->create(pl, render_pass, vk::CullModeFlagBits::eBack);
+        std::array<unsigned char, 4> white = {255, 255, 255, 255};
+        std::array<unsigned char, 4> flat_normal = {128, 128, 255, 255};
+        for (uint32_t i = 0; i < p_config.layout_data.fragment_texture_count; ++i)
+            program_data_->default_textures.push_back(std::make_shared<Descriptors::Texture>(i == 0 ? white.data() : flat_normal.data(), 1, 1));
     }
 
     void Program::addUiData(const std::vector<ImDrawVert>& vertexData, const std::vector<ImDrawIdx>& indexBuffer)
@@ -77,65 +54,263 @@ namespace Engine::Programs
 
     void Program::addObjData(GymnureObjData &&obj_data, const GymnureObjDataType& data_type)
     {
+        uploadObjData(loadObjData(std::move(obj_data), data_type, program_data_->meshlet_culling != nullptr));
+    }
+
+    std::vector<ObjectLoadData> Program::loadObjData(GymnureObjData &&obj_data, const GymnureObjDataType& data_type,
+                                                     bool build_meshlets)
+    {
+        std::vector<ObjectLoadData> load_data = loadMeshes(std::move(obj_data), data_type);
+
+        for (ObjectLoadData& object_data : load_data)
+            for (const std::shared_ptr<Mesh>& mesh : object_data.meshes)
+            {
+                if (build_meshlets && mesh->meshlets.empty())
+                    Util::MeshletBuilder::build(*mesh);
+
+                // Only cooked meshes come with bounds.
+                if (mesh->bounds.radius == 0.f)
+                    mesh->bounds = Util::MeshOptimizer::computeBounds(*mesh->vertexData);
+                if (mesh->indexData != nullptr)
+                    mesh->uv_density = Util::MeshOptimizer::computeUvDensity(*mesh->vertexData, *mesh->indexData);
+            }
+
+        return load_data;
+    }
+
+    std::vector<ObjectLoadData> Program::loadMeshes(GymnureObjData &&obj_data, const GymnureObjDataType& data_type)
+    {
+        std::vector<ObjectLoadData> load_data = {};
+
         if(data_type == GymnureObjDataType::OBJ)
         {
-            auto app_data = ApplicationData::data;
-            auto object_data = std::make_shared<ObjectData>();
+            ObjectLoadData object_data = {};
 
-            // Load Textures
+            // Decode Textures
+            std::vector<std::string> texture_paths = {};
             for (std::string &texture_path : obj_data.paths_textures)
                 if (!texture_path.empty())
-                    object_data->textures.push_back(std::make_shared<Descriptors::Texture>(texture_path));
+                    texture_paths.push_back(texture_path);
+            object_data.decoded_textures = Descriptors::TextureCache::decode(texture_paths);
             for (auto &texture : obj_data.textures)
-                object_data->textures.push_back(std::move(texture));
+                object_data.textures.push_back(std::move(texture));
 
             // Load Vertex
-            object_data->vertex_buffer = std::make_shared<Vertex::VertexBuffer<VertexData, uint32_t>>();
-            if (!obj_data.obj_path.empty())
-            {
-                std::unique_ptr<Model> model = Util::ModelDataLoader::LoadOBJData(obj_data.obj_path, obj_data.obj_mtl);
-                for (const std::shared_ptr<Mesh>& mesh : *model->meshes)
-                {
-                    // @TODO support .obj with multiple meshes
-                    object_data->vertex_buffer->initBuffers(*mesh->vertexData);
-                }
-            }
-            else
-                // Empty obj_path. Use triangle as default vertex data.
-                object_data->vertex_buffer->createPrimitiveQuad();
+            std::unique_ptr<Model> model = nullptr;
+            if (obj_data.obj_path.empty())
+                // Empty obj_path. Use quad as default vertex data.
+                model = Util::ModelDataLoader::CreatePrimitiveQuad();
+            else if ((model = Util::ModelDataLoader::LoadCookedData(obj_data.obj_path)) == nullptr)
+                model = Util::ModelDataLoader::LoadOBJData(obj_data.obj_path, obj_data.obj_mtl);
 
-            program_data_->objects_data.push_back(std::move(object_data));
+            object_data.meshes = *model->meshes;
+            load_data.push_back(std::move(object_data));
 
-            return;
+            return load_data;
         }
-        else if(data_type == GymnureObjDataType::FBX)
+        else if(data_type == GymnureObjDataType::FBX || data_type == GymnureObjDataType::GLTF)
         {
-            std::unique_ptr<Model> model = Util::ModelDataLoader::LoadFBXData(obj_data.obj_path);
+            std::unique_ptr<Model> model = nullptr;
+            if (data_type == GymnureObjDataType::GLTF)
+                // Read in place from the mapped file, cooking would not make it faster and would drop embedded images.
+                model = Util::ModelDataLoader::LoadGLTFData(obj_data.obj_path);
+            else if ((model = Util::ModelDataLoader::LoadCookedData(obj_data.obj_path)) == nullptr)
+                model = Util::ModelDataLoader::LoadFBXData(obj_data.obj_path);
+
+            if (model == nullptr)
+                throw std::runtime_error("Failed to load " + obj_data.obj_path + "!");
+
+            // Meshes usually share few texture files: decode each one once, all in parallel.
+            std::vector<std::string> texture_paths = {};
+            std::vector<std::shared_ptr<std::vector<uint8_t>>> embedded_images = {};
+            for (const std::shared_ptr<Mesh>& mesh : *model->meshes)
+                if (!mesh->material->texture_path.empty()) {
+                    texture_paths.push_back(mesh->material->texture_path);
+                    embedded_images.push_back(mesh->material->texture_bytes);
+                }
+
+            std::vector<Descriptors::DecodedTexture> decoded_textures = Descriptors::TextureCache::decode(texture_paths, embedded_images);
 
+            size_t texture_index = 0;
             for (const std::shared_ptr<Mesh>& mesh : *model->meshes)
             {
-                auto object_data = std::make_shared<ObjectData>();
-                object_data->vertex_buffer = std::make_shared<Vertex::VertexBuffer<VertexData, uint32_t>>();
-                object_data->vertex_buffer->initBuffers(*mesh->vertexData);
+                ObjectLoadData object_data = {};
+                object_data.meshes.push_back(mesh);
 
-                std::string texture_path = mesh->material->texture_path;
-                if(!texture_path.empty())
-                {
-                    std::cout << texture_path << std::endl;
-                    auto texture = std::make_shared<Descriptors::Texture>(texture_path);
+                if (!mesh->material->texture_path.empty())
+                    object_data.decoded_textures.push_back(decoded_textures[texture_index++]);
 
-                    object_data->textures.push_back(std::move(texture));
-                }
-                program_data_->objects_data.push_back(std::move(object_data));
+                load_data.push_back(std::move(object_data));
             }
 
-            return;
+            return load_data;
+        }
+
+        else if(data_type == GymnureObjDataType::PLY || data_type == GymnureObjDataType::STL)
+        {
+            ObjectLoadData object_data = {};
+
+            // Single mesh without materials: textures come with the obj data, as for .obj.
+            std::vector<std::string> texture_paths = {};
+            for (std::string &texture_path : obj_data.paths_textures)
+                if (!texture_path.empty())
+                    texture_paths.push_back(texture_path);
+            object_data.decoded_textures = Descriptors::TextureCache::decode(texture_paths);
+            for (auto &texture : obj_data.textures)
+                object_data.textures.push_back(std::move(texture));
+
+            std::unique_ptr<Model> model = Util::ModelDataLoader::LoadCookedData(obj_data.obj_path);
+            if (model == nullptr)
+                model = data_type == GymnureObjDataType::PLY ? Util::ModelDataLoader::LoadPLYData(obj_data.obj_path)
+                                                             : Util::ModelDataLoader::LoadSTLData(obj_data.obj_path);
+            if (model == nullptr)
+                throw std::runtime_error("Failed to load " + obj_data.obj_path + "!");
+
+            object_data.meshes = *model->meshes;
+            load_data.push_back(std::move(object_data));
+
+            return load_data;
+        }
+
+        else if(data_type == GymnureObjDataType::STREAMED)
+        {
+            // Only the node tables are read here, geometry is paged in by Vertex::StreamedGeometry.
+            std::string streamed_path = Util::CookedAsset::getPath(obj_data.obj_path, ".gstream");
+            if (!Util::CookedAsset::isFresh(streamed_path, std::string(ASSETS_FOLDER_PATH_STR) + "/" + obj_data.obj_path))
+                throw std::runtime_error(obj_data.obj_path + " is not cooked for streaming, run gymnure_cook!");
+
+            std::vector<std::shared_ptr<Util::StreamedMesh>> streamed_meshes = Util::StreamedMeshFile::read(streamed_path);
+            if (streamed_meshes.empty())
+                throw std::runtime_error("Failed to load " + streamed_path + "!");
+
+            // Mesh material first, else the first texture of the obj data, as for .obj. Each path is decoded once.
+            std::string default_texture_path = obj_data.paths_textures.empty() ? "" : obj_data.paths_textures[0];
+            auto getTexturePath = [&default_texture_path](const Util::StreamedMesh& mesh) {
+                return mesh.texture_path.empty() ? default_texture_path : mesh.texture_path;
+            };
+
+            std::vector<std::string> texture_paths = {};
+            for (const auto& streamed_mesh : streamed_meshes)
+                if (!getTexturePath(*streamed_mesh).empty())
+                    texture_paths.push_back(getTexturePath(*streamed_mesh));
+
+            std::vector<Descriptors::DecodedTexture> decoded_textures = Descriptors::TextureCache::decode(texture_paths);
+
+            size_t texture_index = 0;
+            for (auto& streamed_mesh : streamed_meshes)
+            {
+                ObjectLoadData object_data = {};
+                if (!getTexturePath(*streamed_mesh).empty())
+                    object_data.decoded_textures.push_back(decoded_textures[texture_index++]);
+                object_data.streamed_mesh = std::move(streamed_mesh);
+
+                for (const auto &texture : obj_data.textures)
+                    object_data.textures.push_back(texture);
+
+                load_data.push_back(std::move(object_data));
+            }
+
+            return load_data;
         }
 
         throw std::invalid_argument("data_type param not supported!");
     }
 
-    void Program::prepare(const std::shared_ptr<Descriptors::Camera> &camera)
+    void Program::uploadObjData(std::vector<ObjectLoadData> &&load_data)
+    {
+        for (ObjectLoadData& load_object : load_data)
+        {
+            auto object_data = std::make_shared<ObjectData>();
+
+            for (const auto& decoded_texture : load_object.decoded_textures)
+                object_data->textures.push_back(Descriptors::TextureCache::upload(decoded_texture));
+            for (auto& texture : load_object.textures)
+                object_data->textures.push_back(std::move(texture));
+
+            // Compiled in the background meanwhile, prepare() picks it up.
+            object_data->variant = variant_;
+            if (shader_variants_)
+            {
+                object_data->variant.texture        = variant_.texture && !object_data->textures.empty();
+                object_data->variant.normal_mapping = variant_.normal_mapping && object_data->textures.size() > 1;
+            }
+            program_data_->graphic_pipeline->requestPipeline(object_data->variant);
+
+            for (const std::shared_ptr<Mesh>& mesh : load_object.meshes)
+            {
+                // @TODO support .obj with multiple meshes
+                initVertexBuffer(*object_data, *mesh);
+            }
+
+            if (load_object.streamed_mesh != nullptr)
+            {
+                // Slots hold packed vertices only.
+                if (!quantized_vertices_ || program_data_->vertex_input.usesStream(Vertex::VertexStream::POSITION))
+                    Debug::logErrorAndDie("Streamed geometry needs a quantized program without position stream!");
+
+                object_data->quantization = load_object.streamed_mesh->quantization;
+                object_data->bounds = load_object.streamed_mesh->bounds;
+                object_data->streamed_geometry = std::make_shared<Vertex::StreamedGeometry>(std::move(load_object.streamed_mesh));
+            }
+
+            program_data_->objects_data.push_back(std::move(object_data));
+        }
+    }
+
+    void Program::initVertexBuffer(ObjectData& object_data, const Mesh& mesh) const
+    {
+        static const std::vector<uint32_t> no_indices = {};
+        const std::vector<uint32_t>& indices = mesh.indexData != nullptr ? *mesh.indexData : no_indices;
+
+        if (!quantized_vertices_)
+        {
+            auto vertex_buffer = std::make_shared<Vertex::VertexBuffer<VertexData, uint32_t>>();
+            vertex_buffer->initBuffers(*mesh.vertexData, indices);
+            object_data.vertex_buffer = std::move(vertex_buffer);
+        }
+        else
+        {
+            initQuantizedVertexBuffer(object_data, mesh, indices);
+        }
+
+        object_data.bounds = mesh.bounds;
+        object_data.uv_density = mesh.uv_density;
+
+        if (program_data_->meshlet_culling != nullptr && !mesh.meshlets.empty())
+            object_data.meshlet_draw = GraphicsPipeline::MeshletCulling::createDrawData(mesh.meshlets, *object_data.vertex_buffer);
+
+        if (program_data_->vertex_input.usesStream(Vertex::VertexStream::POSITION))
+        {
+            std::vector<glm::vec3> positions = {};
+            positions.reserve(mesh.vertexData->size());
+            for (const auto& vertex : *mesh.vertexData)
+                positions.push_back(vertex.pos);
+
+            object_data.vertex_buffer->initPositionStream(positions);
+        }
+    }
+
+    void Program::initQuantizedVertexBuffer(ObjectData& object_data, const Mesh& mesh, const std::vector<uint32_t>& indices)
+    {
+        Vertex::QuantizedMesh quantized = Vertex::VertexQuantizer::quantize(*mesh.vertexData, indices);
+        object_data.quantization = quantized.params;
+
+        if (quantized.indices32.empty())
+        {
+            auto vertex_buffer = std::make_shared<Vertex::VertexBuffer<Vertex::PackedVertexData, uint16_t>>();
+            vertex_buffer->initBuffers(quantized.vertices, quantized.indices16);
+            object_data.vertex_buffer = std::move(vertex_buffer);
+        }
+        else
+        {
+            auto vertex_buffer = std::make_shared<Vertex::VertexBuffer<Vertex::PackedVertexData, uint32_t>>();
+            vertex_buffer->initBuffers(quantized.vertices, quantized.indices32);
+            object_data.vertex_buffer = std::move(vertex_buffer);
+        }
+    }
+
+    void Program::prepare(const std::shared_ptr<Descriptors::Camera> &camera,
+                          const std::shared_ptr<Descriptors::LightClusters> &light_clusters)
     {
         auto app_data = ApplicationData::data;
         auto data_size = static_cast<uint32_t>(program_data_->objects_data.size());
@@ -144,37 +319,143 @@ namespace Engine::Programs
             return;
 
         program_data_->model_buffer_ = std::make_shared<ModelBuffer>(data_size);
+        camera_ = camera;
+        light_clusters_ = light_clusters;
 
         std::vector<vk::WriteDescriptorSet> writes = {};
 
-        // Create program Descriptor Set.
-        auto descriptors_sets = program_data_->descriptor_layout->createDescriptorSets(data_size);
+        // Create program Descriptor Set, two per object (see updateTextures).
+        auto descriptors_sets = program_data_->descriptor_layout->createDescriptorSets(data_size * 2);
+
+        auto& graphic_pipeline = program_data_->graphic_pipeline;
+        for (uint32_t i = 0; i < data_size; i++)
+        {
+            auto& object_data = program_data_->objects_data[i];
+            object_data->descriptor_set = descriptors_sets[i * 2];
+            object_data->spare_descriptor_set = descriptors_sets[i * 2 + 1];
+
+            // Until its variant is built, an object draws with the base one, or not at all.
+            if (!app_data->async_pipelines)
+                object_data->pipeline = graphic_pipeline->getPipeline(object_data->variant);
+            else if (!(object_data->pipeline = graphic_pipeline->tryGetPipeline(object_data->variant)))
+                object_data->pipeline = graphic_pipeline->tryGetPipeline(variant_);
+
+            getWrites(*object_data, writes);
+        }
+
+        app_data->device.updateDescriptorSets(writes, {});
+
+        if (program_data_->meshlet_culling != nullptr)
+        {
+            std::vector<std::shared_ptr<GraphicsPipeline::MeshletDrawData>> draw_data = {};
+            for (const auto& object_data : program_data_->objects_data)
+                draw_data.push_back(object_data->meshlet_draw);
+
+            program_data_->meshlet_culling->prepare(draw_data, *program_data_->model_buffer_, camera);
+        }
+    }
 
+    void Program::getWrites(ObjectData& object_data, std::vector<vk::WriteDescriptorSet>& writes) const
+    {
         std::shared_ptr<Descriptors::LayoutData> layout_data = program_data_->descriptor_layout->getLayoutData();
+        vk::DescriptorSet descriptor_set = object_data.descriptor_set;
 
-        for (uint32_t i = 0; i < data_size; i++)
+        // Storage buffers come after textures and input attachments, see Descriptors::Layout.
+        const uint32_t texture_bind = 3;
+        const uint32_t storage_bind = texture_bind + layout_data->fragment_texture_count + layout_data->fragment_input_attachment_count;
+
+        if (layout_data->has_model_matrix) {
+            auto model_bind = program_data_->model_buffer_->getWrite(descriptor_set, 0);
+            writes.push_back(model_bind);
+        }
+
+        if (layout_data->has_view_projection_matrix) {
+            auto camera_binds = camera_->getWrites(descriptor_set, 1, 2);
+            writes.push_back(camera_binds[0]);
+            writes.push_back(camera_binds[1]);
+        }
+
+        const auto& textures = object_data.textures;
+        object_data.texture_versions.clear();
+        for (uint32_t j = 0; j < layout_data->fragment_texture_count; ++j) {
+            const auto& texture = j < textures.size() ? textures[j] : program_data_->default_textures[j];
+            writes.push_back(texture->getWrite(descriptor_set, texture_bind + j));
+            object_data.texture_versions.push_back(texture->getVersion());
+        }
+
+        if (layout_data->fragment_storage_buffer_count > 0 && light_clusters_ != nullptr) {
+            auto light_binds = light_clusters_->getWrites(descriptor_set, storage_bind, storage_bind + 1);
+            writes.insert(writes.end(), light_binds.begin(), light_binds.end());
+        }
+    }
+
+    void Program::update(const Descriptors::Camera &camera)
+    {
+        for (const auto& object_data : program_data_->objects_data)
         {
-            program_data_->objects_data[i]->descriptor_set = descriptors_sets[i];
+            if (object_data->streamed_geometry != nullptr)
+                object_data->streamed_geometry->update(camera);
 
-            if (layout_data->has_model_matrix) {
-                auto model_bind = program_data_->model_buffer_->getWrite(descriptors_sets[i], 0);
-                writes.push_back(model_bind);
-            }
+            for (const auto& texture : object_data->textures)
+                Descriptors::TextureStreamer::requestLevels(*texture, object_data->bounds, object_data->uv_density, camera);
+        }
+    }
 
-            if (layout_data->has_view_projection_matrix) {
-                auto camera_binds = camera->getWrites(descriptors_sets[i], 1, 2);
-                writes.push_back(camera_binds[0]);
-                writes.push_back(camera_binds[1]);
-            }
+    bool Program::updatePipelines()
+    {
+        bool updated = false;
 
-            if (layout_data->fragment_texture_count > 0) {
-                auto texture_bind = program_data_->objects_data[i]->textures[0]->getWrite(
-                    descriptors_sets[i], 3);
-                writes.push_back(texture_bind);
+        for (const auto& object_data : program_data_->objects_data)
+        {
+            // Still compiling: keep drawing with the fallback, or skipping the object.
+            vk::Pipeline pipeline = program_data_->graphic_pipeline->tryGetPipeline(object_data->variant);
+            if (!pipeline || pipeline == object_data->pipeline)
+                continue;
+
+            object_data->pipeline = pipeline;
+            updated = true;
+        }
+
+        return updated;
+    }
+
+    bool Program::updateTextures()
+    {
+        std::vector<vk::WriteDescriptorSet> writes = {};
+
+        for (const auto& object_data : program_data_->objects_data)
+        {
+            // Not prepared yet, or the same images as when its set was written.
+            if (!object_data->spare_descriptor_set)
+                continue;
+
+            const auto& textures = object_data->textures;
+            bool changed = false;
+            for (uint32_t j = 0; j < object_data->texture_versions.size(); ++j) {
+                const auto& texture = j < textures.size() ? textures[j] : program_data_->default_textures[j];
+                changed |= texture->getVersion() != object_data->texture_versions[j];
             }
+
+            if (!changed)
+                continue;
+
+            std::swap(object_data->descriptor_set, object_data->spare_descriptor_set);
+            getWrites(*object_data, writes);
         }
 
-        app_data->device.updateDescriptorSets(writes, {});
+        if (writes.empty())
+            return false;
+
+        ApplicationData::data->device.updateDescriptorSets(writes, {});
+        return true;
+    }
+
+    std::vector<uint32_t> Program::getFrameOffsets(uint32_t frame) const
+    {
+        if (program_data_->descriptor_layout->getLayoutData()->fragment_storage_buffer_count == 0 || light_clusters_ == nullptr)
+            return {};
+
+        return light_clusters_->getOffsets(frame);
     }
 
     [[nodiscard]] std::shared_ptr<Program::ProgramData> Program::getProgramsData() const
@@ -4,8 +4,15 @@
 #include <imgui/imgui.h>
 #include <Descriptors/Camera.h>
 #include <Descriptors/Layout.h>
+#include <Descriptors/LightClusters.h>
+#include <Descriptors/TextureCache.h>
 #include <ModelBuffer.hpp>
+#include <GraphicsPipeline/MeshletCulling.h>
+#include <GraphicsPipeline/ShaderVariant.h>
 #include "Vertex/VertexBuffer.h"
+#include "Vertex/StreamedGeometry.h"
+#include "Vertex/VertexQuantizer.h"
+#include "Vertex/Layouts.hpp"
 
 struct GymnureObjData
 {
@@ -18,24 +25,43 @@ struct GymnureObjData
 enum GymnureObjDataType
 {
     OBJ,
-    FBX
+    FBX,
+    PLY,
+    STL,
+    GLTF,
+    // Cooked .gstream of any of the above (see Util::StreamedMeshFile), paged in as the camera moves.
+    STREAMED
 };
 
 namespace Engine::Programs
 {
-    enum VertexInputType
+    /**
+     * CPU side of one object: parsed meshes and decoded textures, not yet uploaded.
+     * */
+    struct ObjectLoadData
     {
-        NONE     = 1 << 0,
-        POSITION = 1 << 1,
-        NORMAL   = 1 << 2,
-        UV       = 1 << 3,
-        COLOR    = 1 << 4,
+        std::vector<std::shared_ptr<Mesh>> meshes = {};
+        std::shared_ptr<Util::StreamedMesh> streamed_mesh = nullptr;
+        std::vector<Descriptors::DecodedTexture> decoded_textures = {};
+        std::vector<std::shared_ptr<Descriptors::Texture>> textures = {};
     };
 
     struct ProgramParams {
-        uint32_t vi_types_mask = 0;
+        // Built from a compile-time layout, e.g. Vertex::MeshLayout::describe().
+        Vertex::VertexInputDescription vertex_input{};
         Descriptors::LayoutData layout_data{};
         std::string shaders_name;
+        // Use Vertex::PackedVertexData and '<shaders_name>_packed_vs' vertex shader.
+        bool quantized_vertices = false;
+        // Cull meshlets in a compute pass and draw what is left indirectly (see GraphicsPipeline::MeshletCulling).
+        bool meshlet_culling = false;
+        // Subpass of 'render_pass' drawn in, and its color attachments (several for a G-buffer).
+        uint32_t subpass = 0;
+        uint32_t color_attachment_count = 1;
+        // Pick each object's pipeline from 'variant', with 'texture' and 'normal_mapping' following the textures of
+        // the object (the second one is its normal map). For shaders declaring the ShaderVariant constants.
+        bool shader_variants = false;
+        GraphicsPipeline::ShaderVariant variant{};
     };
 
     class Program {
@@ -45,8 +71,18 @@ namespace Engine::Programs
         struct ObjectData
         {
             std::vector<std::shared_ptr<Descriptors::Texture>> textures = {};
-            std::shared_ptr<Vertex::VertexBuffer<VertexData, uint32_t>> vertex_buffer = nullptr;
+            std::shared_ptr<Vertex::VertexBufferBase> vertex_buffer = nullptr;
+            Vertex::QuantizationParams quantization = {};
+            Bounds bounds = {};
+            float uv_density = 0.f;
+            std::shared_ptr<GraphicsPipeline::MeshletDrawData> meshlet_draw = nullptr;
+            std::shared_ptr<Vertex::StreamedGeometry> streamed_geometry = nullptr; // Instead of 'vertex_buffer'.
+            GraphicsPipeline::ShaderVariant variant = {};
+            vk::Pipeline pipeline = {}; // Of 'variant', set by prepare(). Null while it is not built yet.
             vk::DescriptorSet descriptor_set = {}; // Each object must have a different DS
+            // Written instead of 'descriptor_set' while recorded command buffers may still bind it, see updateTextures().
+            vk::DescriptorSet spare_descriptor_set = {};
+            std::vector<uint32_t> texture_versions = {}; // Of 'textures' when 'descriptor_set' was written.
         };
 
         struct UiData
@@ -63,9 +99,24 @@ namespace Engine::Programs
             std::shared_ptr<Descriptors::Layout> descriptor_layout = nullptr;
             std::shared_ptr<GraphicsPipeline::GraphicsPipeline> graphic_pipeline = nullptr;
             std::shared_ptr<ModelBuffer> model_buffer_ = nullptr;
+            std::shared_ptr<GraphicsPipeline::MeshletCulling> meshlet_culling = nullptr;
+            Vertex::VertexInputDescription vertex_input = {};
+            // Bound to the texture slots an object has nothing for: white, then flat normals.
+            std::vector<std::shared_ptr<Descriptors::Texture>> default_textures = {};
         };
 
         std::shared_ptr<ProgramData> program_data_ = std::make_shared<ProgramData>();
+        std::shared_ptr<Descriptors::Camera> camera_ = nullptr; // Of the last prepare().
+        std::shared_ptr<Descriptors::LightClusters> light_clusters_ = nullptr;
+        bool quantized_vertices_ = false;
+        bool shader_variants_ = false;
+        GraphicsPipeline::ShaderVariant variant_ = {};
+
+        static std::vector<ObjectLoadData> loadMeshes(GymnureObjData &&obj_data, const GymnureObjDataType& data_type);
+
+        void initVertexBuffer(ObjectData& object_data, const Mesh& mesh) const;
+        void getWrites(ObjectData& object_data, std::vector<vk::WriteDescriptorSet>& writes) const;
+        static void initQuantizedVertexBuffer(ObjectData& object_data, const Mesh& mesh, const std::vector<uint32_t>& indices);
 
     public:
 
@@ -74,7 +125,45 @@ namespace Engine::Programs
         void addUiData(const std::vector<ImDrawVert>& vertexData, const std::vector<ImDrawIdx>& indexBuffer);
         void addObjData(GymnureObjData &&obj_data, const GymnureObjDataType& data_type);
 
-        void prepare(const std::shared_ptr<Descriptors::Camera> &camera);
+        /**
+         * Parse and decode an object without touching the GPU, safe to call from any thread.
+         * Meshes are measured for texture streaming here, and split in meshlets (see Util::MeshletBuilder) when
+         * 'build_meshlets' is set, for programs culling them.
+         * */
+        static std::vector<ObjectLoadData> loadObjData(GymnureObjData &&obj_data, const GymnureObjDataType& data_type,
+                                                       bool build_meshlets);
+        void uploadObjData(std::vector<ObjectLoadData> &&load_data);
+
+        /**
+         * 'light_clusters' feeds the storage buffers of lit programs: the lights, then their froxels.
+         * */
+        void prepare(const std::shared_ptr<Descriptors::Camera> &camera,
+                     const std::shared_ptr<Descriptors::LightClusters> &light_clusters = nullptr);
+
+        /**
+         * Once per frame, before the frame is submitted: pages streamed geometry in and out for the camera and
+         * requests the texture levels of every object (see Descriptors::TextureStreamer).
+         * */
+        void update(const Descriptors::Camera &camera);
+        /**
+         * With ApplicationData::async_pipelines, prepare() draws objects whose variant is still compiling with the
+         * base variant of the program, or skips them. Swaps in the variants built since, true when some were: the
+         * command buffers drawing them must be recorded again, descriptors stay valid.
+         * */
+        bool updatePipelines();
+
+        /**
+         * Objects whose textures got new images (see Descriptors::TextureStreamer) switch to their spare descriptor
+         * set, written with them. True when some did: the command buffers drawing them must be recorded again. Only
+         * once every command buffer was recorded since the last call, so no pending one binds the spare sets.
+         * */
+        bool updateTextures();
+
+        /**
+         * Dynamic offsets of the storage buffers for 'frame', after the model matrix offset (see
+         * Descriptors::LightClusters::getOffsets()).
+         * */
+        [[nodiscard]] std::vector<uint32_t> getFrameOffsets(uint32_t frame) const;
         [[nodiscard]] std::shared_ptr<ProgramData> getProgramsData() const;
     };
 }
@@ -15,46 +15,79 @@ namespace Engine
         }
 
         RenderPass::RenderPass(std::vector<RpAttachments> att_vector)
+        {
+            RpSubpass subpass = {};
+            for (uint32_t i = 0; i < att_vector.size(); ++i)
+            {
+                if (att_vector[i].usage & vk::ImageUsageFlagBits::eDepthStencilAttachment)
+                    subpass.depth = i;
+                else
+                    subpass.colors.push_back(i);
+            }
+
+            create(att_vector, {subpass});
+        }
+
+        RenderPass::RenderPass(const std::vector<RpAttachments>& att_vector, const std::vector<RpSubpass>& subpasses)
+        {
+            create(att_vector, subpasses);
+        }
+
+        void RenderPass::create(const std::vector<RpAttachments>& att_vector, const std::vector<RpSubpass>& subpasses)
         {
             std::vector<vk::AttachmentDescription> attachments = {};
-            std::vector<vk::AttachmentReference> color_references = {};
-            vk::AttachmentReference depth_reference = {};
 
-            uint32_t idx = 0;
             for (auto& att_vec : att_vector)
             {
                 vk::AttachmentDescription attachment{};
                 attachment.format           = att_vec.format;
                 attachment.samples			= vk::SampleCountFlagBits::e1;
-                attachment.loadOp 			= vk::AttachmentLoadOp::eClear;
-                attachment.storeOp			= vk::AttachmentStoreOp::eStore;
+                attachment.loadOp 			= att_vec.load_op;
+                attachment.storeOp			= att_vec.store_op;
                 attachment.stencilLoadOp 	= vk::AttachmentLoadOp::eDontCare;
                 attachment.stencilStoreOp 	= vk::AttachmentStoreOp::eDontCare;
-                attachment.initialLayout 	= vk::ImageLayout::eUndefined;
+                attachment.initialLayout 	= att_vec.initial_layout;
                 attachment.finalLayout 		= att_vec.final_layout; //vk::ImageLayout::ePresentSrcKHR / vk::ImageLayout::eDepthStencilAttachmentOptimal;
                 attachments.push_back(std::move(attachment));
+            }
 
-                if (att_vec.usage & vk::ImageUsageFlagBits::eDepthStencilAttachment)
-                    depth_reference = {idx, vk::ImageLayout::eDepthStencilAttachmentOptimal};
-                else
-                    color_references.emplace_back(idx, vk::ImageLayout::eColorAttachmentOptimal);
+            // References must outlive the descriptions pointing at them.
+            std::vector<std::vector<vk::AttachmentReference>> color_references(subpasses.size());
+            std::vector<std::vector<vk::AttachmentReference>> input_references(subpasses.size());
+            std::vector<vk::AttachmentReference> depth_references(subpasses.size());
+            std::vector<vk::SubpassDescription> descriptions(subpasses.size());
 
-                idx++;
-            }
+            for (size_t i = 0; i < subpasses.size(); ++i)
+            {
+                const RpSubpass& rp_subpass = subpasses[i];
+
+                for (uint32_t color : rp_subpass.colors)
+                    color_references[i].emplace_back(color, vk::ImageLayout::eColorAttachmentOptimal);
+
+                for (uint32_t input : rp_subpass.inputs)
+                {
+                    bool depth = static_cast<bool>(att_vector[input].usage & vk::ImageUsageFlagBits::eDepthStencilAttachment);
+                    input_references[i].emplace_back(input, depth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                                                                   : vk::ImageLayout::eShaderReadOnlyOptimal);
+                }
 
-            vk::SubpassDescription subpass = {};
-            subpass.pipelineBindPoint 					= vk::PipelineBindPoint::eGraphics;
-            subpass.inputAttachmentCount 				= 0;
-            subpass.pInputAttachments 					= nullptr;
-            subpass.colorAttachmentCount 				= static_cast<uint32_t>(color_references.size());
-            subpass.pColorAttachments 					= color_references.data();
-            subpass.pResolveAttachments 				= nullptr;
-            subpass.pDepthStencilAttachment 			= &depth_reference;
-            subpass.preserveAttachmentCount 			= 0;
-            subpass.pPreserveAttachments 				= nullptr;
+                depth_references[i] = {rp_subpass.depth, vk::ImageLayout::eDepthStencilAttachmentOptimal};
+
+                vk::SubpassDescription& subpass = descriptions[i];
+                subpass.pipelineBindPoint 					= vk::PipelineBindPoint::eGraphics;
+                subpass.inputAttachmentCount 				= static_cast<uint32_t>(input_references[i].size());
+                subpass.pInputAttachments 					= input_references[i].data();
+                subpass.colorAttachmentCount 				= static_cast<uint32_t>(color_references[i].size());
+                subpass.pColorAttachments 					= color_references[i].data();
+                subpass.pResolveAttachments 				= nullptr;
+                subpass.pDepthStencilAttachment 			= rp_subpass.depth != VK_ATTACHMENT_UNUSED ? &depth_references[i] : nullptr;
+                subpass.preserveAttachmentCount 			= 0;
+                subpass.pPreserveAttachments 				= nullptr;
+            }
 
             // Subpass dependencies for layout transitions
-            std::array<vk::SubpassDependency, 2> dependencies = {};
+            std::vector<vk::SubpassDependency> dependencies(2);
+            auto last_subpass = static_cast<uint32_t>(subpasses.size() - 1);
 
             dependencies[0].srcSubpass 		= VK_SUBPASS_EXTERNAL;
             dependencies[0].dstSubpass 		= 0;
@@ -64,7 +97,7 @@ namespace Engine
             dependencies[0].dstAccessMask 	= vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
             dependencies[0].dependencyFlags = vk::DependencyFlagBits::eByRegion;
 
-            dependencies[1].srcSubpass 		= 0;
+            dependencies[1].srcSubpass 		= last_subpass;
             dependencies[1].dstSubpass 		= VK_SUBPASS_EXTERNAL;
             dependencies[1].srcStageMask 	= vk::PipelineStageFlagBits::eColorAttachmentOutput;
             dependencies[1].dstStageMask 	= vk::PipelineStageFlagBits::eBottomOfPipe;
@@ -72,13 +105,30 @@ namespace Engine
             dependencies[1].dstAccessMask 	= vk::AccessFlagBits::eMemoryRead;
             dependencies[1].dependencyFlags = vk::DependencyFlagBits::eByRegion;
 
+            // Each subpass reads, at the same pixel, what the previous one wrote.
+            for (uint32_t i = 1; i <= last_subpass; ++i)
+            {
+                vk::SubpassDependency dependency = {};
+                dependency.srcSubpass       = i - 1;
+                dependency.dstSubpass       = i;
+                dependency.srcStageMask     = vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                                              vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+                dependency.dstStageMask     = vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                                              vk::PipelineStageFlagBits::eEarlyFragmentTests;
+                dependency.srcAccessMask    = vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+                dependency.dstAccessMask    = vk::AccessFlagBits::eInputAttachmentRead | vk::AccessFlagBits::eColorAttachmentRead |
+                                              vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead;
+                dependency.dependencyFlags  = vk::DependencyFlagBits::eByRegion;
+                dependencies.push_back(dependency);
+            }
+
             vk::RenderPassCreateInfo rp_info = {};
             rp_info.pNext 								= nullptr;
             rp_info.attachmentCount 					= static_cast<uint32_t>(attachments.size());
             rp_info.pAttachments 						= attachments.data();
-            rp_info.subpassCount 						= 1;
-            rp_info.pSubpasses 							= &subpass;
-            rp_info.dependencyCount 					= dependencies.size();
+            rp_info.subpassCount 						= static_cast<uint32_t>(descriptions.size());
+            rp_info.pSubpasses 							= descriptions.data();
+            rp_info.dependencyCount 					= static_cast<uint32_t>(dependencies.size());
             rp_info.pDependencies 						= dependencies.data();
 
             render_pass_ = ApplicationData::data->device.createRenderPass(rp_info);
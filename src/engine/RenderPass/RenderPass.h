@@ -6,6 +6,7 @@
 #define OBSIDIAN2D_RENDERPASS_H
 
 #include <array>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace Engine
@@ -17,6 +18,20 @@ namespace Engine
 			vk::Format format{};
 			vk::ImageUsageFlags usage{};
 			vk::ImageLayout final_layout{};
+			vk::ImageLayout initial_layout = vk::ImageLayout::eUndefined;
+			vk::AttachmentLoadOp load_op = vk::AttachmentLoadOp::eClear;
+			vk::AttachmentStoreOp store_op = vk::AttachmentStoreOp::eStore;
+		};
+
+		/**
+		 * Attachments of a subpass, as indices in the render pass attachments. Each subpass reads what the
+		 * previous ones wrote, as input attachments.
+		 * */
+		struct RpSubpass
+		{
+			std::vector<uint32_t> colors = {};
+			std::vector<uint32_t> inputs = {};
+			uint32_t depth = VK_ATTACHMENT_UNUSED;
 		};
 
 		class RenderPass {
@@ -25,9 +40,15 @@ namespace Engine
 
 			vk::RenderPass render_pass_{};
 
+			void create(const std::vector<RpAttachments>& att_vector, const std::vector<RpSubpass>& subpasses);
+
 		public:
 
+            /**
+             * A single subpass over every attachment.
+             * */
             explicit RenderPass(std::vector<RpAttachments> att_vector);
+            RenderPass(const std::vector<RpAttachments>& att_vector, const std::vector<RpSubpass>& subpasses);
 
 			~RenderPass();
 
@@ -63,6 +63,11 @@ namespace Engine
             return image_count_;
         }
 
+        vk::Image SwapChain::getSwapChainImage(uint32_t swapchain_index) const
+        {
+            return swap_chain_buffer_[swapchain_index]->image;
+        }
+
         vk::ImageView SwapChain::getSwapChainImageView(uint32_t swapchain_index) const
         {
             return swap_chain_buffer_[swapchain_index]->view;
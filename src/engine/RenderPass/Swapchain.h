@@ -35,6 +35,7 @@ namespace Engine
 			static std::shared_ptr<SwapChain> getInstance();
 
 			uint32_t getImageCount() const;
+			vk::Image getSwapChainImage(uint32_t i) const;
 			vk::ImageView getSwapChainImageView(uint32_t i) const;
 			vk::SwapchainKHR getSwapChainKHR() const;
 
@@ -0,0 +1,192 @@
+#include <mutex>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include "CookedAsset.h"
+#include "Hash.h"
+#include "Lz4.h"
+#include "Archive.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        const char MAGIC[4] = {'G', 'P', 'A', 'K'};
+
+        struct ArchiveHeader
+        {
+            char     magic[4];
+            uint32_t version;
+            uint32_t entry_count;
+            uint32_t reserved;
+            uint64_t toc_offset;
+        };
+
+        static_assert(sizeof(ArchiveHeader) == 24, "Archive header must be tightly packed!");
+        static_assert(sizeof(ArchiveEntry) == 40, "Archive entry must be tightly packed!");
+
+        uint64_t alignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    std::shared_ptr<Archive> Archive::instance = nullptr;
+
+    Archive::Archive(const std::string& path) : path_(path), file_(path, false)
+    {
+        if (!file_.isOpen() || file_.size() < sizeof(ArchiveHeader))
+            return;
+
+        ArchiveHeader header = {};
+        std::memcpy(&header, file_.data(), sizeof(ArchiveHeader));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+            return;
+
+        if (header.toc_offset + static_cast<uint64_t>(header.entry_count) * sizeof(ArchiveEntry) > file_.size())
+            return;
+
+        entries_.resize(header.entry_count);
+        std::memcpy(entries_.data(), file_.data() + header.toc_offset, entries_.size() * sizeof(ArchiveEntry));
+
+        // Drop malformed entries, a truncated archive must not be read past its end.
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [this](const ArchiveEntry& entry)
+        {
+            return entry.offset + entry.stored_size > file_.size() ||
+                   (entry.compression == ARCHIVE_STORED && entry.stored_size != entry.size);
+        }), entries_.end());
+    }
+
+    std::shared_ptr<Archive> Archive::getInstance()
+    {
+        static std::once_flag once;
+        std::call_once(once, []()
+        {
+            instance = std::make_shared<Archive>(std::string(COOKED_FOLDER_PATH_STR) + "/assets.gpak");
+        });
+
+        return instance;
+    }
+
+    uint64_t Archive::hashName(const std::string& name)
+    {
+        return Hash::fnv1a(name.data(), name.size());
+    }
+
+    bool Archive::write(const std::string& path, const std::vector<ArchiveSource>& sources, bool compress)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        std::vector<ArchiveEntry> entries = {};
+        entries.reserve(sources.size());
+
+        // Entries first, header and table of contents once their offsets are known.
+        uint64_t toc_offset = sizeof(ArchiveHeader);
+        uint64_t offset = alignUp(toc_offset + sources.size() * sizeof(ArchiveEntry), SMALL_ALIGNMENT);
+
+        for (const auto& source : sources)
+        {
+            std::ifstream source_file(source.path, std::ios::binary);
+            if (!source_file.is_open())
+                return false;
+
+            std::vector<uint8_t> data((std::istreambuf_iterator<char>(source_file)), std::istreambuf_iterator<char>());
+
+            ArchiveEntry entry = {};
+            entry.name_hash   = hashName(source.name);
+            entry.size        = data.size();
+            entry.compression = ARCHIVE_STORED;
+
+            if (compress) {
+                std::vector<uint8_t> compressed = Lz4::compress(data);
+                if (compressed.size() * 4 <= data.size() * 3) {
+                    data = std::move(compressed);
+                    entry.compression = ARCHIVE_LZ4;
+                }
+            }
+
+            entry.stored_size = data.size();
+            entry.offset      = alignUp(offset, data.size() >= LARGE_ALIGNMENT ? LARGE_ALIGNMENT : SMALL_ALIGNMENT);
+
+            file.seekp(static_cast<std::streamoff>(entry.offset));
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+            offset = entry.offset + entry.stored_size;
+            entries.push_back(entry);
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const ArchiveEntry& a, const ArchiveEntry& b) { return a.name_hash < b.name_hash; });
+        for (size_t i = 1; i < entries.size(); ++i)
+            if (entries[i].name_hash == entries[i - 1].name_hash)
+                return false; // Name hash collision, rename one of the assets.
+
+        ArchiveHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version     = VERSION;
+        header.entry_count = static_cast<uint32_t>(entries.size());
+        header.toc_offset  = toc_offset;
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry)));
+
+        return file.good();
+    }
+
+    const ArchiveEntry* Archive::find(const std::string& name) const
+    {
+        uint64_t name_hash = hashName(name);
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), name_hash,
+                                   [](const ArchiveEntry& entry, uint64_t hash) { return entry.name_hash < hash; });
+
+        return it != entries_.end() && it->name_hash == name_hash ? &*it : nullptr;
+    }
+
+    bool Archive::isOpen() const
+    {
+        return file_.isOpen() && !entries_.empty();
+    }
+
+    const std::string& Archive::getPath() const
+    {
+        return path_;
+    }
+
+    bool Archive::contains(const std::string& name) const
+    {
+        return find(name) != nullptr;
+    }
+
+    std::span<const uint8_t> Archive::getSpan(const std::string& name) const
+    {
+        const ArchiveEntry* entry = find(name);
+        if (entry == nullptr || entry->compression != ARCHIVE_STORED)
+            return {};
+
+        return {file_.data() + entry->offset, static_cast<size_t>(entry->size)};
+    }
+
+    bool Archive::read(const std::string& name, std::vector<uint8_t>& out) const
+    {
+        const ArchiveEntry* entry = find(name);
+        if (entry == nullptr)
+            return false;
+
+        std::span<const uint8_t> stored = {file_.data() + entry->offset, static_cast<size_t>(entry->stored_size)};
+        out.resize(static_cast<size_t>(entry->size));
+
+        switch (entry->compression)
+        {
+            case ARCHIVE_STORED:
+                std::memcpy(out.data(), stored.data(), stored.size());
+                return true;
+            case ARCHIVE_LZ4:
+                return Lz4::decompress(stored, out);
+            default:
+                return false;
+        }
+    }
+}
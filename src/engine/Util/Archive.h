@@ -0,0 +1,91 @@
+#ifndef GYMNURE_ARCHIVE_H
+#define GYMNURE_ARCHIVE_H
+
+#include <span>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+
+namespace Engine::Util
+{
+    enum ArchiveCompression : uint32_t
+    {
+        ARCHIVE_STORED = 0,
+        ARCHIVE_LZ4    = 1,
+    };
+
+    struct ArchiveEntry
+    {
+        uint64_t name_hash;     // Hash::fnv1a of the entry name.
+        uint64_t offset;
+        uint64_t stored_size;
+        uint64_t size;          // Decompressed size.
+        uint32_t compression;
+        uint32_t reserved;
+    };
+
+    struct ArchiveSource
+    {
+        std::string name;       // Entry name, '/' separated.
+        std::string path;       // File to pack.
+    };
+
+    /**
+     * Packed asset archive (.gpak): header, table of contents sorted by name hash, then entries.
+     *
+     * Entries start on 4K boundaries (64K for entries of 64K and more) so stored ones can be served,
+     * and uploaded, straight from the mapping. The whole file is mapped once at open.
+     * */
+    class Archive
+    {
+
+    private:
+
+        static constexpr uint32_t VERSION         = 1;
+        static constexpr uint64_t SMALL_ALIGNMENT = 4 * 1024;
+        static constexpr uint64_t LARGE_ALIGNMENT = 64 * 1024;
+
+        static std::shared_ptr<Archive> instance;
+
+        std::string                 path_;
+        MappedFile                  file_;
+        std::vector<ArchiveEntry>   entries_ = {};
+
+        [[nodiscard]] const ArchiveEntry* find(const std::string& name) const;
+
+    public:
+
+        explicit Archive(const std::string& path);
+
+        /**
+         * The archive cooked next to the loose cooked files. Check isOpen(), shipping one is optional.
+         * */
+        static std::shared_ptr<Archive> getInstance();
+
+        static uint64_t hashName(const std::string& name);
+
+        /**
+         * Pack 'sources' into 'path'. Entries are LZ4 compressed when 'compress' is set and it saves a quarter
+         * of their size, compressed entries cost a copy on read.
+         * */
+        static bool write(const std::string& path, const std::vector<ArchiveSource>& sources, bool compress);
+
+        [[nodiscard]] bool isOpen() const;
+        [[nodiscard]] const std::string& getPath() const;
+        [[nodiscard]] bool contains(const std::string& name) const;
+
+        /**
+         * Bytes of a stored entry, pointing into the mapping. Empty when missing or compressed.
+         * */
+        [[nodiscard]] std::span<const uint8_t> getSpan(const std::string& name) const;
+
+        /**
+         * Copy (or decompress) an entry into 'out'.
+         * */
+        bool read(const std::string& name, std::vector<uint8_t>& out) const;
+    };
+}
+
+#endif //GYMNURE_ARCHIVE_H
@@ -0,0 +1,491 @@
+#include <new>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include "AsyncIO.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+namespace Engine::Util
+{
+#ifdef __linux__
+    /**
+     * Minimal io_uring over the raw syscalls (no liburing dependency): read requests in, completions out.
+     * Only used from the AsyncIO completion thread.
+     * */
+    class IoUring
+    {
+
+    private:
+
+        int             fd_         = -1;
+        uint32_t        entries_    = 0;
+        uint32_t        to_submit_  = 0;
+
+        void*           sq_ring_    = MAP_FAILED;
+        void*           cq_ring_    = MAP_FAILED;
+        size_t          sq_size_    = 0;
+        size_t          cq_size_    = 0;
+        io_uring_sqe*   sqes_       = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t          sqes_size_  = 0;
+
+        uint32_t*       sq_head_    = nullptr;
+        uint32_t*       sq_tail_    = nullptr;
+        uint32_t*       sq_mask_    = nullptr;
+        uint32_t*       sq_array_   = nullptr;
+        uint32_t*       cq_head_    = nullptr;
+        uint32_t*       cq_tail_    = nullptr;
+        uint32_t*       cq_mask_    = nullptr;
+        io_uring_cqe*   cqes_       = nullptr;
+
+        template <class T>
+        static T* at(void* base, uint32_t offset)
+        {
+            return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+        }
+
+    public:
+
+        IoUring() = default;
+
+        ~IoUring()
+        {
+            if (sqes_ != MAP_FAILED)                        munmap(sqes_, sqes_size_);
+            if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_size_);
+            if (sq_ring_ != MAP_FAILED)                     munmap(sq_ring_, sq_size_);
+            if (fd_ >= 0)                                   close(fd_);
+        }
+
+        bool init(uint32_t entries)
+        {
+            io_uring_params params = {};
+            fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd_ < 0)
+                return false;
+
+            entries_ = params.sq_entries;
+            sq_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+                sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+            sq_ring_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+            if (sq_ring_ == MAP_FAILED)
+                return false;
+
+            cq_ring_ = single_mmap ? sq_ring_ : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED)
+                return false;
+
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+            if (sqes_ == MAP_FAILED)
+                return false;
+
+            sq_head_  = at<uint32_t>(sq_ring_, params.sq_off.head);
+            sq_tail_  = at<uint32_t>(sq_ring_, params.sq_off.tail);
+            sq_mask_  = at<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+            sq_array_ = at<uint32_t>(sq_ring_, params.sq_off.array);
+            cq_head_  = at<uint32_t>(cq_ring_, params.cq_off.head);
+            cq_tail_  = at<uint32_t>(cq_ring_, params.cq_off.tail);
+            cq_mask_  = at<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+            cqes_     = at<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+            return true;
+        }
+
+        bool pushRead(int fd, void* buffer, uint32_t length, uint64_t offset, uint64_t user_data)
+        {
+            uint32_t tail = *sq_tail_;
+            uint32_t head = std::atomic_ref<uint32_t>(*sq_head_).load(std::memory_order_acquire);
+            if (tail - head >= entries_)
+                return false;
+
+            uint32_t index = tail & *sq_mask_;
+            io_uring_sqe& sqe = sqes_[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode    = IORING_OP_READ;
+            sqe.fd        = fd;
+            sqe.addr      = reinterpret_cast<uint64_t>(buffer);
+            sqe.len       = length;
+            sqe.off       = offset;
+            sqe.user_data = user_data;
+
+            sq_array_[index] = index;
+            std::atomic_ref<uint32_t>(*sq_tail_).store(tail + 1, std::memory_order_release);
+            ++to_submit_;
+
+            return true;
+        }
+
+        /**
+         * Submit pushed reads and block until at least 'wait_count' completions are available.
+         * */
+        bool submitAndWait(uint32_t wait_count)
+        {
+            while (true)
+            {
+                long submitted = syscall(__NR_io_uring_enter, fd_, to_submit_, wait_count, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (submitted >= 0) {
+                    to_submit_ -= std::min<uint32_t>(to_submit_, static_cast<uint32_t>(submitted));
+                    return true;
+                }
+                if (errno != EINTR)
+                    return false;
+            }
+        }
+
+        /**
+         * After submitAndWait() failed: take back the last read the kernel never saw.
+         * */
+        bool takeUnsubmitted(uint64_t& user_data)
+        {
+            if (to_submit_ == 0)
+                return false;
+
+            uint32_t tail = *sq_tail_ - 1;
+            user_data = sqes_[tail & *sq_mask_].user_data;
+
+            std::atomic_ref<uint32_t>(*sq_tail_).store(tail, std::memory_order_release);
+            --to_submit_;
+
+            return true;
+        }
+
+        bool popCompletion(uint64_t& user_data, int32_t& result)
+        {
+            uint32_t head = *cq_head_;
+            uint32_t tail = std::atomic_ref<uint32_t>(*cq_tail_).load(std::memory_order_acquire);
+            if (head == tail)
+                return false;
+
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            user_data = cqe.user_data;
+            result    = cqe.res;
+
+            std::atomic_ref<uint32_t>(*cq_head_).store(head + 1, std::memory_order_release);
+            return true;
+        }
+    };
+#else
+    class IoUring {};
+#endif
+
+    std::shared_ptr<AsyncIO> AsyncIO::instance = nullptr;
+
+    AsyncIO::AsyncIO()
+    {
+        io_pool_ = std::make_unique<ThreadPool>(IO_THREAD_COUNT);
+
+    #ifdef __linux__
+        auto ring = std::make_unique<IoUring>();
+        if (ring->init(QUEUE_DEPTH)) {
+            ring_ = std::move(ring);
+            completion_thread_ = std::thread(&AsyncIO::ringLoop, this);
+        }
+    #endif
+    }
+
+    AsyncIO::~AsyncIO()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+
+        if (completion_thread_.joinable())
+            completion_thread_.join();
+    }
+
+    std::shared_ptr<AsyncIO> AsyncIO::getInstance()
+    {
+        static std::once_flag once;
+        std::call_once(once, []()
+        {
+            instance = std::make_shared<AsyncIO>();
+        });
+
+        return instance;
+    }
+
+    bool AsyncIO::usesIoUring() const
+    {
+        return ring_ != nullptr && !ring_failed_;
+    }
+
+    IOBuffer AsyncIO::allocate(size_t size)
+    {
+        size_t capacity = std::max(ALIGNMENT, (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+        auto* data = static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(ALIGNMENT)));
+
+        IOBuffer buffer = {};
+        buffer.data = std::shared_ptr<uint8_t>(data, [](uint8_t* ptr) { ::operator delete(ptr, std::align_val_t(ALIGNMENT)); });
+        buffer.size = size;
+
+        return buffer;
+    }
+
+    IOBuffer AsyncIO::readBlocking(const FileRange& range)
+    {
+        std::ifstream file(range.path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return {};
+
+        auto file_size = static_cast<uint64_t>(file.tellg());
+        if (range.offset > file_size)
+            return {};
+
+        auto size = static_cast<size_t>(std::min<uint64_t>(range.size, file_size - range.offset));
+        file.seekg(static_cast<std::streamoff>(range.offset), std::ios::beg);
+
+        IOBuffer buffer = allocate(size);
+        if (!file.read(reinterpret_cast<char*>(buffer.data.get()), static_cast<std::streamsize>(size)))
+            return {};
+
+        return buffer;
+    }
+
+    std::future<IOBuffer> AsyncIO::read(const std::string& path)
+    {
+        return std::move(read(std::vector<std::string>{path})[0]);
+    }
+
+    std::future<IOBuffer> AsyncIO::read(const std::string& path, uint64_t offset, size_t size)
+    {
+        return std::move(read(std::vector<FileRange>{FileRange{path, offset, size}})[0]);
+    }
+
+    std::vector<std::future<IOBuffer>> AsyncIO::read(const std::vector<std::string>& paths)
+    {
+        std::vector<FileRange> ranges = {};
+        ranges.reserve(paths.size());
+        for (const auto& path : paths)
+            ranges.push_back(FileRange{path});
+
+        return read(ranges);
+    }
+
+    std::vector<std::future<IOBuffer>> AsyncIO::read(const std::vector<FileRange>& ranges)
+    {
+        std::vector<std::future<IOBuffer>> futures = {};
+        futures.reserve(ranges.size());
+
+        std::vector<ChunkRead> chunks = {};
+
+        for (const auto& range : ranges)
+        {
+            if (range.path.empty()) {
+                std::promise<IOBuffer> empty;
+                empty.set_value({});
+                futures.push_back(empty.get_future());
+                continue;
+            }
+
+            if (!usesIoUring()) {
+                futures.push_back(io_pool_->submit([range]() { return readBlocking(range); }));
+                continue;
+            }
+
+            std::shared_ptr<FileRead> file = openFile(range, chunks);
+            futures.push_back(file->promise.get_future());
+
+            if (file->pending_chunks == 0)
+                finishFile(file);
+        }
+
+        if (!chunks.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.insert(queue_.end(), chunks.begin(), chunks.end());
+            }
+            condition_.notify_one();
+        }
+
+        return futures;
+    }
+
+    std::shared_ptr<AsyncIO::FileRead> AsyncIO::openFile(const FileRange& range, std::vector<ChunkRead>& chunks)
+    {
+        auto file = std::make_shared<FileRead>();
+        file->range = range;
+
+    #ifdef __linux__
+        // Page cache bypass when the file system supports it (tmpfs and some others do not).
+        file->fd = open(range.path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        if (file->fd < 0)
+            file->fd = open(range.path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        struct stat file_stat = {};
+        if (file->fd < 0 || fstat(file->fd, &file_stat) != 0 || range.offset > static_cast<uint64_t>(file_stat.st_size)) {
+            file->failed = true;
+            return file;
+        }
+
+        // O_DIRECT offsets must be aligned too: read from the page holding the range start.
+        auto end = static_cast<uint64_t>(file_stat.st_size);
+        if (range.size < end - range.offset)
+            end = range.offset + range.size;
+        file->file_offset = range.offset / ALIGNMENT * ALIGNMENT;
+
+        auto size = static_cast<size_t>(end - file->file_offset);
+        file->buffer = allocate(size);
+
+        // Lengths are rounded up to whole pages, the buffer has room for it and the read stops at end of file.
+        for (size_t offset = 0; offset < size; offset += CHUNK_SIZE)
+        {
+            size_t length = std::min(CHUNK_SIZE, (size - offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+            chunks.push_back(ChunkRead{file, offset, static_cast<uint32_t>(length)});
+            ++file->pending_chunks;
+        }
+    #else
+        file->failed = true;
+    #endif
+
+        return file;
+    }
+
+    void AsyncIO::ringLoop()
+    {
+    #ifdef __linux__
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true)
+        {
+            if (in_flight_.empty()) {
+                condition_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+                if (queue_.empty())
+                    return; // Stopped with nothing left in flight.
+            }
+
+            if (ring_failed_) {
+                // Chunks queued before read() saw the ring fail, they go to the blocking path too.
+                std::deque<ChunkRead> failed = std::move(queue_);
+                queue_.clear();
+
+                lock.unlock();
+                for (auto& chunk : failed)
+                    completeChunk(chunk, -EIO);
+                lock.lock();
+                continue;
+            }
+
+            while (!queue_.empty() && in_flight_.size() < QUEUE_DEPTH)
+            {
+                ChunkRead& chunk = queue_.front();
+                auto* request = new ChunkRead(chunk);
+                uint8_t* destination = chunk.file->buffer.data.get() + chunk.offset;
+
+                uint64_t file_offset = chunk.file->file_offset + chunk.offset;
+
+                if (!ring_->pushRead(chunk.file->fd, destination, chunk.length, file_offset, reinterpret_cast<uint64_t>(request))) {
+                    delete request;
+                    break;
+                }
+
+                queue_.pop_front();
+                in_flight_.insert(request);
+            }
+
+            lock.unlock();
+            bool waited = ring_->submitAndWait(1);
+
+            uint64_t user_data;
+            int32_t result;
+            std::vector<std::pair<ChunkRead*, int32_t>> completions = {};
+            while (ring_->popCompletion(user_data, result))
+                completions.emplace_back(reinterpret_cast<ChunkRead*>(user_data), result);
+
+            // A failed submit is not retried: the reads the kernel never took fail with the rest of the batch and
+            // their files are read again on the blocking path.
+            bool took_back = false;
+            while (!waited && ring_->takeUnsubmitted(user_data)) {
+                completions.emplace_back(reinterpret_cast<ChunkRead*>(user_data), -EIO);
+                took_back = true;
+            }
+
+            lock.lock();
+            for (auto& completion : completions)
+                in_flight_.erase(completion.first);
+
+            std::vector<ChunkRead*> abandoned = {};
+            if (!waited) {
+                for (auto& chunk : queue_)
+                    completions.emplace_back(new ChunkRead(chunk), -EIO);
+                queue_.clear();
+
+                // Not even a wait goes through, the ring is unusable. Reads the kernel still owns are failed too but
+                // never freed, it may write their buffers yet.
+                if (!took_back) {
+                    ring_failed_ = true;
+                    abandoned.assign(in_flight_.begin(), in_flight_.end());
+                    in_flight_.clear();
+                }
+            }
+
+            lock.unlock();
+            for (auto& [request, chunk_result] : completions) {
+                completeChunk(*request, chunk_result);
+                delete request;
+            }
+            for (ChunkRead* request : abandoned)
+                completeChunk(*request, -EIO);
+            lock.lock();
+        }
+    #endif
+    }
+
+    void AsyncIO::completeChunk(const ChunkRead& chunk, int32_t result)
+    {
+        FileRead& file = *chunk.file;
+
+        if (result < 0) {
+            file.failed = true;
+        } else if (static_cast<uint32_t>(result) < chunk.length && chunk.offset + result < file.buffer.size && result > 0) {
+            // Short read before end of file, queue the rest.
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(ChunkRead{chunk.file, chunk.offset + result, chunk.length - static_cast<uint32_t>(result)});
+            return;
+        } else if (chunk.offset + result < std::min<size_t>(file.buffer.size, chunk.offset + chunk.length)) {
+            file.failed = true; // File shrank under us.
+        }
+
+        if (--file.pending_chunks == 0)
+            finishFile(chunk.file);
+    }
+
+    void AsyncIO::finishFile(const std::shared_ptr<FileRead>& file)
+    {
+    #ifdef __linux__
+        if (file->fd >= 0) {
+            close(file->fd);
+            file->fd = -1;
+        }
+    #endif
+
+        if (!file->failed) {
+            // Skip the head of the first page when the range starts inside it.
+            auto skip = static_cast<size_t>(file->range.offset - file->file_offset);
+            IOBuffer buffer = std::move(file->buffer);
+            if (skip > 0)
+                buffer = IOBuffer{std::shared_ptr<uint8_t>(buffer.data, buffer.data.get() + skip), buffer.size - skip};
+
+            file->promise.set_value(std::move(buffer));
+            return;
+        }
+
+        // O_DIRECT refused, or no ring: retry with plain blocking reads.
+        io_pool_->submit([file]() { file->promise.set_value(readBlocking(file->range)); });
+    }
+}
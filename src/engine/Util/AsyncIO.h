@@ -0,0 +1,129 @@
+#ifndef GYMNURE_ASYNCIO_H
+#define GYMNURE_ASYNCIO_H
+
+#include <span>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
+#include <condition_variable>
+#include "ThreadPool.h"
+
+namespace Engine::Util
+{
+    /**
+     * File contents in a page aligned buffer (capacity rounded up to ALIGNMENT, as O_DIRECT reads need). Ranges
+     * not starting on a page point inside it. 'data' is null when the file could not be read.
+     * */
+    struct IOBuffer
+    {
+        std::shared_ptr<uint8_t> data = nullptr;
+        size_t                   size = 0;
+
+        explicit operator bool() const { return data != nullptr; }
+        [[nodiscard]] std::span<const uint8_t> getSpan() const { return {data.get(), size}; }
+    };
+
+    /**
+     * 'size' bytes of 'path' from 'offset', clamped to the end of the file. Whole file by default.
+     * */
+    struct FileRange
+    {
+        std::string path    = {};
+        uint64_t    offset  = 0;
+        size_t      size    = SIZE_MAX;
+    };
+
+    class IoUring;
+
+    /**
+     * Batched asynchronous file reads.
+     *
+     * On Linux reads go through io_uring: every file of a batch is split in CHUNK_SIZE reads and queued at once,
+     * a completion thread keeps up to QUEUE_DEPTH of them in flight and fulfills each future when its last chunk lands.
+     * Files are opened with O_DIRECT when the file system allows it. Without io_uring (other platforms, old kernels,
+     * sandboxes, or once the ring fails) files are read with blocking reads on a small I/O thread pool, apart from the CPU pool so decode
+     * tasks waiting on reads never starve them.
+     * */
+    class AsyncIO
+    {
+
+    private:
+
+        static constexpr size_t   ALIGNMENT       = 4096;
+        static constexpr size_t   CHUNK_SIZE      = 1024 * 1024;
+        static constexpr uint32_t QUEUE_DEPTH     = 64;
+        static constexpr uint32_t IO_THREAD_COUNT = 4;
+
+        struct FileRead
+        {
+            FileRange               range           = {};
+            int                     fd              = -1;
+            uint64_t                file_offset     = 0;        // Of buffer start, 'range.offset' rounded down to ALIGNMENT.
+            IOBuffer                buffer          = {};
+            size_t                  pending_chunks  = 0;
+            bool                    failed          = false;
+            std::promise<IOBuffer>  promise         = {};
+        };
+
+        struct ChunkRead
+        {
+            std::shared_ptr<FileRead>   file    = nullptr;
+            uint64_t                    offset  = 0;
+            uint32_t                    length  = 0;
+        };
+
+        static std::shared_ptr<AsyncIO> instance;
+
+        std::unique_ptr<IoUring>        ring_;
+        std::unique_ptr<ThreadPool>     io_pool_            = nullptr;
+        std::thread                     completion_thread_  = {};
+        std::deque<ChunkRead>           queue_              = {};
+        std::mutex                      mutex_              = {};
+        std::condition_variable         condition_          = {};
+        std::unordered_set<ChunkRead*>  in_flight_          = {};   // Owned by the ring until they complete.
+        std::atomic<bool>               ring_failed_        = false;
+        bool                            stop_               = false;
+
+        void ringLoop();
+        void completeChunk(const ChunkRead& chunk, int32_t result);
+        void finishFile(const std::shared_ptr<FileRead>& file);
+        std::shared_ptr<FileRead> openFile(const FileRange& range, std::vector<ChunkRead>& chunks);
+
+        static IOBuffer allocate(size_t size);
+        static IOBuffer readBlocking(const FileRange& range);
+
+    public:
+
+        AsyncIO();
+        ~AsyncIO();
+
+        AsyncIO(const AsyncIO&) = delete;
+        AsyncIO& operator=(const AsyncIO&) = delete;
+
+        static std::shared_ptr<AsyncIO> getInstance();
+
+        /**
+         * Queue reads of every path before returning. Empty paths resolve to an empty buffer right away.
+         * */
+        std::vector<std::future<IOBuffer>> read(const std::vector<std::string>& paths);
+        std::future<IOBuffer> read(const std::string& path);
+
+        /**
+         * Same as whole file reads, for parts of files (streamed geometry pages). An offset past the end of the
+         * file resolves to an empty buffer.
+         * */
+        std::vector<std::future<IOBuffer>> read(const std::vector<FileRange>& ranges);
+        std::future<IOBuffer> read(const std::string& path, uint64_t offset, size_t size);
+
+        [[nodiscard]] bool usesIoUring() const;
+    };
+}
+
+#endif //GYMNURE_ASYNCIO_H
@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <Util/Debug.hpp>
+#include "ThreadPool.h"
+#include "BlockCompressor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GYMNURE_BC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Engine::Util
+{
+    namespace
+    {
+        uint16_t to565(const uint8_t* color)
+        {
+            return static_cast<uint16_t>(((color[0] * 31 + 127) / 255) << 11u |
+                                         ((color[1] * 63 + 127) / 255) << 5u |
+                                         ((color[2] * 31 + 127) / 255));
+        }
+
+        void from565(uint16_t packed, int32_t* color)
+        {
+            int32_t r = (packed >> 11u) & 31u, g = (packed >> 5u) & 63u, b = packed & 31u;
+            color[0] = (r << 3) | (r >> 2);
+            color[1] = (g << 2) | (g >> 4);
+            color[2] = (b << 3) | (b >> 2);
+        }
+
+        // Per channel min/max of the 16 block pixels.
+        void blockRange(const uint8_t* block, uint8_t* min, uint8_t* max)
+        {
+#ifdef GYMNURE_BC_SSE2
+            const auto* rows = reinterpret_cast<const __m128i*>(block);
+            __m128i lo = _mm_min_epu8(_mm_min_epu8(_mm_loadu_si128(rows), _mm_loadu_si128(rows + 1)),
+                                      _mm_min_epu8(_mm_loadu_si128(rows + 2), _mm_loadu_si128(rows + 3)));
+            __m128i hi = _mm_max_epu8(_mm_max_epu8(_mm_loadu_si128(rows), _mm_loadu_si128(rows + 1)),
+                                      _mm_max_epu8(_mm_loadu_si128(rows + 2), _mm_loadu_si128(rows + 3)));
+
+            // Fold the four pixels of each register into the first one.
+            lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 8));
+            lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+            hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 8));
+            hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+
+            auto lo_bits = static_cast<uint32_t>(_mm_cvtsi128_si32(lo));
+            auto hi_bits = static_cast<uint32_t>(_mm_cvtsi128_si32(hi));
+            std::memcpy(min, &lo_bits, 4);
+            std::memcpy(max, &hi_bits, 4);
+#else
+            for (uint32_t c = 0; c < 4; ++c) {
+                min[c] = 255;
+                max[c] = 0;
+            }
+            for (uint32_t i = 0; i < 16; ++i) {
+                for (uint32_t c = 0; c < 4; ++c) {
+                    min[c] = std::min(min[c], block[i * 4 + c]);
+                    max[c] = std::max(max[c], block[i * 4 + c]);
+                }
+            }
+#endif
+        }
+    }
+
+    uint32_t BlockCompressor::getBlockBytes(vk::Format format)
+    {
+        switch (format)
+        {
+            case vk::Format::eBc1RgbUnormBlock:
+            case vk::Format::eBc1RgbaUnormBlock:
+            case vk::Format::eBc4UnormBlock:        return 8;
+            case vk::Format::eBc3UnormBlock:
+            case vk::Format::eBc5UnormBlock:
+            case vk::Format::eBc7UnormBlock:        return 16;
+            default:                                return 0;
+        }
+    }
+
+    bool BlockCompressor::isBlockCompressed(vk::Format format)
+    {
+        return getBlockBytes(format) > 0;
+    }
+
+    size_t BlockCompressor::getLevelSize(vk::Format format, uint32_t width, uint32_t height)
+    {
+        uint32_t block_bytes = getBlockBytes(format);
+        if (block_bytes == 0)
+            return static_cast<size_t>(width) * height * 4;
+
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * block_bytes;
+    }
+
+    vk::Format BlockCompressor::chooseFormat(const uint8_t* rgba, uint32_t width, uint32_t height)
+    {
+        size_t pixel_count = static_cast<size_t>(width) * height;
+        for (size_t i = 0; i < pixel_count; ++i)
+            if (rgba[i * 4 + 3] != 255)
+                return vk::Format::eBc3UnormBlock;
+
+        return vk::Format::eBc1RgbUnormBlock;
+    }
+
+    std::vector<uint8_t> BlockCompressor::encodeImage(const uint8_t* rgba, uint32_t width, uint32_t height, vk::Format format)
+    {
+        uint32_t block_bytes = getBlockBytes(format);
+        if (block_bytes == 0) { Debug::logErrorAndDie("BlockCompressor: unsupported format!"); }
+
+        uint32_t blocks_x = (width + 3) / 4;
+        uint32_t blocks_y = (height + 3) / 4;
+
+        std::vector<uint8_t> encoded(static_cast<size_t>(blocks_x) * blocks_y * block_bytes);
+
+        ThreadPool::getInstance()->parallelFor(blocks_y, [&](size_t by)
+        {
+            uint8_t block[64];
+            for (uint32_t bx = 0; bx < blocks_x; ++bx)
+            {
+                // Edge blocks repeat the last row/column.
+                for (uint32_t y = 0; y < 4; ++y) {
+                    uint32_t src_y = std::min(static_cast<uint32_t>(by) * 4 + y, height - 1);
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        uint32_t src_x = std::min(bx * 4 + x, width - 1);
+                        std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(src_y) * width + src_x) * 4, 4);
+                    }
+                }
+
+                encodeBlock(block, format, encoded.data() + (by * blocks_x + bx) * block_bytes);
+            }
+        });
+
+        return encoded;
+    }
+
+    Ktx2Image BlockCompressor::encodeMipChain(const uint8_t* rgba, uint32_t width, uint32_t height)
+    {
+        std::vector<MipLevel> rgba_levels = {};
+        std::vector<uint8_t> rgba_chain = MipGenerator::generate(rgba, width, height, rgba_levels);
+
+        Ktx2Image image = {};
+        image.format = chooseFormat(rgba, width, height);
+        image.width  = width;
+        image.height = height;
+
+        for (const auto& rgba_level : rgba_levels)
+        {
+            std::vector<uint8_t> blocks = encodeImage(rgba_chain.data() + rgba_level.offset, rgba_level.width, rgba_level.height, image.format);
+            image.levels.push_back(MipLevel{rgba_level.width, rgba_level.height, image.data.size(), blocks.size()});
+            image.data.insert(image.data.end(), blocks.begin(), blocks.end());
+        }
+
+        return image;
+    }
+
+    void BlockCompressor::encodeBlock(const uint8_t* block, vk::Format format, uint8_t* out)
+    {
+        switch (format)
+        {
+            case vk::Format::eBc1RgbUnormBlock:
+            case vk::Format::eBc1RgbaUnormBlock:
+                encodeBC1Block(block, out);
+                break;
+            case vk::Format::eBc3UnormBlock:
+                encodeBC4Block(block, 3, out);
+                encodeBC1Block(block, out + 8);
+                break;
+            case vk::Format::eBc4UnormBlock:
+                encodeBC4Block(block, 0, out);
+                break;
+            case vk::Format::eBc5UnormBlock:
+                encodeBC4Block(block, 0, out);
+                encodeBC4Block(block, 1, out + 8);
+                break;
+            default:
+                Debug::logErrorAndDie("BlockCompressor: unsupported format!");
+        }
+    }
+
+    void BlockCompressor::encodeBC1Block(const uint8_t* block, uint8_t* out)
+    {
+        uint8_t min[4], max[4];
+        blockRange(block, min, max);
+
+        // Inset the box by 1/16 of its size, reduces error from outliers.
+        for (uint32_t c = 0; c < 3; ++c) {
+            uint8_t inset = (max[c] - min[c]) >> 4u;
+            min[c] = static_cast<uint8_t>(min[c] + inset);
+            max[c] = static_cast<uint8_t>(max[c] - inset);
+        }
+
+        uint16_t color0 = to565(max);
+        uint16_t color1 = to565(min);
+        uint32_t indices = 0;
+
+        // color0 > color1 selects the opaque four color mode.
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        if (color0 != color1)
+        {
+            int32_t palette[4][3];
+            from565(color0, palette[0]);
+            from565(color1, palette[1]);
+            for (uint32_t c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                int32_t best_distance = INT32_MAX;
+                for (uint32_t p = 0; p < 4; ++p)
+                {
+                    int32_t dr = block[i * 4 + 0] - palette[p][0];
+                    int32_t dg = block[i * 4 + 1] - palette[p][1];
+                    int32_t db = block[i * 4 + 2] - palette[p][2];
+                    int32_t distance = dr * dr + dg * dg + db * db;
+                    if (distance < best_distance) {
+                        best_distance = distance;
+                        best = p;
+                    }
+                }
+                indices |= best << (i * 2);
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(color0 & 0xFFu);
+        out[1] = static_cast<uint8_t>(color0 >> 8u);
+        out[2] = static_cast<uint8_t>(color1 & 0xFFu);
+        out[3] = static_cast<uint8_t>(color1 >> 8u);
+        for (uint32_t i = 0; i < 4; ++i)
+            out[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+
+    void BlockCompressor::encodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* out)
+    {
+        uint8_t min[4], max[4];
+        blockRange(block, min, max);
+
+        int32_t value0 = max[channel];
+        int32_t value1 = min[channel];
+        uint64_t indices = 0;
+
+        if (value0 != value1)
+        {
+            // Eight value mode (value0 > value1): endpoints then six interpolated values.
+            int32_t palette[8] = {value0, value1};
+            for (int32_t i = 2; i < 8; ++i)
+                palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7;
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                int32_t value = block[i * 4 + channel];
+                uint64_t best = 0;
+                int32_t best_distance = INT32_MAX;
+                for (uint32_t p = 0; p < 8; ++p)
+                {
+                    int32_t distance = std::abs(value - palette[p]);
+                    if (distance < best_distance) {
+                        best_distance = distance;
+                        best = p;
+                    }
+                }
+                indices |= best << (i * 3);
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(value0);
+        out[1] = static_cast<uint8_t>(value1);
+        for (uint32_t i = 0; i < 6; ++i)
+            out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+}
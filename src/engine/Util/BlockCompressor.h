@@ -0,0 +1,47 @@
+#ifndef GYMNURE_BLOCKCOMPRESSOR_H
+#define GYMNURE_BLOCKCOMPRESSOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <vulkan/vulkan.hpp>
+#include "Ktx2.h"
+
+namespace Engine::Util
+{
+    /**
+     * CPU encoder for BC1 (opaque RGB), BC3 (RGBA) and BC5 (two channel, e.g. normal maps) from RGBA8.
+     * Endpoints are the inset bounding box of each 4x4 block.
+     * */
+    class BlockCompressor
+    {
+    public:
+
+        BlockCompressor() = delete;
+
+        // Bytes per 4x4 block, 0 for non block-compressed formats.
+        static uint32_t getBlockBytes(vk::Format format);
+        static size_t getLevelSize(vk::Format format, uint32_t width, uint32_t height);
+        static bool isBlockCompressed(vk::Format format);
+
+        // BC3 when some pixel is not opaque, BC1 otherwise.
+        static vk::Format chooseFormat(const uint8_t* rgba, uint32_t width, uint32_t height);
+
+        /**
+         * Encode a whole image, block rows are spread over the engine ThreadPool.
+         * */
+        static std::vector<uint8_t> encodeImage(const uint8_t* rgba, uint32_t width, uint32_t height, vk::Format format);
+
+        /**
+         * Box filtered mip chain of an RGBA8 image, every level encoded with chooseFormat().
+         * */
+        static Ktx2Image encodeMipChain(const uint8_t* rgba, uint32_t width, uint32_t height);
+
+        // 'block' is 4x4 RGBA8 pixels, row major (64 bytes).
+        static void encodeBlock(const uint8_t* block, vk::Format format, uint8_t* out);
+        static void encodeBC1Block(const uint8_t* block, uint8_t* out);
+        static void encodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* out);
+    };
+}
+
+#endif //GYMNURE_BLOCKCOMPRESSOR_H
@@ -0,0 +1,67 @@
+#include <vector>
+#include <filesystem>
+#include "Archive.h"
+#include "MappedFile.h"
+#include "CookedAsset.h"
+
+namespace Engine::Util
+{
+    std::string CookedAsset::getPath(const std::string& asset_path, const std::string& extension, const std::string& cooked_folder)
+    {
+        return cooked_folder + "/" + asset_path + extension;
+    }
+
+    std::string CookedAsset::getArchiveName(const std::string& asset_path, const std::string& extension)
+    {
+        return std::filesystem::path(asset_path + extension).lexically_normal().generic_string();
+    }
+
+    bool CookedAsset::isFresh(const std::string& cooked_path, const std::string& source_path)
+    {
+        std::error_code error;
+        auto cooked_time = std::filesystem::last_write_time(cooked_path, error);
+        if (error)
+            return false;
+
+        auto source_time = std::filesystem::last_write_time(source_path, error);
+        return error || cooked_time >= source_time;
+    }
+
+    bool CookedAsset::isAvailable(const std::string& asset_path, const std::string& extension)
+    {
+        auto source_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + asset_path;
+        if (isFresh(getPath(asset_path, extension), source_path))
+            return true;
+
+        auto archive = Archive::getInstance();
+        return archive->isOpen() && isFresh(archive->getPath(), source_path) && archive->contains(getArchiveName(asset_path, extension));
+    }
+
+    CookedData CookedAsset::load(const std::string& asset_path, const std::string& extension)
+    {
+        auto source_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + asset_path;
+
+        auto cooked_path = getPath(asset_path, extension);
+        if (isFresh(cooked_path, source_path))
+        {
+            auto file = std::make_shared<MappedFile>(cooked_path);
+            if (file->isOpen())
+                return CookedData{file->getSpan(), file};
+        }
+
+        auto archive = Archive::getInstance();
+        if (!archive->isOpen() || !isFresh(archive->getPath(), source_path))
+            return {};
+
+        auto name = getArchiveName(asset_path, extension);
+        auto bytes = archive->getSpan(name);
+        if (!bytes.empty())
+            return CookedData{bytes, archive};
+
+        auto data = std::make_shared<std::vector<uint8_t>>();
+        if (!archive->read(name, *data) || data->empty())
+            return {};
+
+        return CookedData{*data, data};
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GYMNURE_COOKEDASSET_H
+#define GYMNURE_COOKEDASSET_H
+
+#include <span>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "Util.h"
+
+namespace Engine::Util
+{
+    struct CookedData
+    {
+        std::span<const uint8_t>    bytes = {};
+        std::shared_ptr<const void> owner = nullptr; // Keeps 'bytes' alive (file mapping, archive or decompressed copy).
+
+        explicit operator bool() const { return !bytes.empty(); }
+    };
+
+    /**
+     * Location and freshness of cooked assets. 'textures/a.png' is cooked as '<cooked>/textures/a.png<extension>'.
+     * */
+    class CookedAsset
+    {
+    public:
+
+        CookedAsset() = delete;
+
+        static std::string getPath(const std::string& asset_path, const std::string& extension,
+                                   const std::string& cooked_folder = COOKED_FOLDER_PATH_STR);
+
+        /**
+         * Name of the cooked asset inside the asset archive.
+         * */
+        static std::string getArchiveName(const std::string& asset_path, const std::string& extension);
+
+        /**
+         * Cooked file exists and is not older than its source. A missing source (shipped without sources) is fine.
+         * */
+        static bool isFresh(const std::string& cooked_path, const std::string& source_path);
+
+        /**
+         * load() would find something, without mapping anything.
+         * */
+        static bool isAvailable(const std::string& asset_path, const std::string& extension);
+
+        /**
+         * Fresh cooked bytes of an asset: the loose cooked file, else the entry of the mounted archive
+         * ('<asset_path><extension>'), else nothing. Stored data is served from the mapping without copies.
+         * */
+        static CookedData load(const std::string& asset_path, const std::string& extension);
+    };
+}
+
+#endif //GYMNURE_COOKEDASSET_H
@@ -0,0 +1,45 @@
+#ifndef GYMNURE_HASH_H
+#define GYMNURE_HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace Engine::Util
+{
+    class Hash
+    {
+    public:
+
+        Hash() = delete;
+
+        static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+        static constexpr uint64_t FNV_PRIME  = 1099511628211ull;
+
+        static inline uint64_t mix(uint64_t hash, uint64_t word)
+        {
+            return (hash ^ word) * FNV_PRIME;
+        }
+
+        /**
+         * FNV-1a over 8 byte words (then the remaining bytes). Not for security, just change detection.
+         * */
+        static inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+                uint64_t word;
+                std::memcpy(&word, bytes + i, sizeof(uint64_t));
+                hash = mix(hash, word);
+            }
+            for (; i < size; ++i)
+                hash = mix(hash, bytes[i]);
+
+            return hash;
+        }
+    };
+}
+
+#endif //GYMNURE_HASH_H
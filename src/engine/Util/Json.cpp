@@ -0,0 +1,288 @@
+#include <charconv>
+#include <cstring>
+#include "Json.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        void skipWhitespace(const char*& ptr, const char* end)
+        {
+            while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r'))
+                ++ptr;
+        }
+
+        bool consume(const char*& ptr, const char* end, std::string_view literal)
+        {
+            if (static_cast<size_t>(end - ptr) < literal.size() || std::memcmp(ptr, literal.data(), literal.size()) != 0)
+                return false;
+
+            ptr += literal.size();
+            return true;
+        }
+
+        bool parseHex4(const char*& ptr, const char* end, uint32_t& code)
+        {
+            if (end - ptr < 4)
+                return false;
+
+            auto result = std::from_chars(ptr, ptr + 4, code, 16);
+            if (result.ec != std::errc() || result.ptr != ptr + 4)
+                return false;
+
+            ptr += 4;
+            return true;
+        }
+
+        void appendUtf8(std::string& out, uint32_t code)
+        {
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+    }
+
+    const JsonValue& JsonValue::getNull()
+    {
+        static const JsonValue null_value = {};
+        return null_value;
+    }
+
+    bool JsonValue::parse(std::string_view text, JsonValue& out)
+    {
+        const char* ptr = text.data();
+        const char* end = text.data() + text.size();
+
+        out = {};
+        if (!parseValue(ptr, end, out, 0)) {
+            out = {};
+            return false;
+        }
+
+        skipWhitespace(ptr, end);
+        if (ptr != end) {
+            out = {};
+            return false;
+        }
+
+        return true;
+    }
+
+    bool JsonValue::parseString(const char*& ptr, const char* end, std::string& out)
+    {
+        if (ptr >= end || *ptr != '"')
+            return false;
+        ++ptr;
+
+        while (ptr < end)
+        {
+            // Copy runs without escapes at once.
+            const char* run = ptr;
+            while (ptr < end && *ptr != '"' && *ptr != '\\')
+                ++ptr;
+            out.append(run, ptr);
+
+            if (ptr >= end)
+                return false;
+
+            if (*ptr++ == '"')
+                return true;
+
+            if (ptr >= end)
+                return false;
+
+            switch (*ptr++)
+            {
+                case '"':  out += '"';  break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/';  break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u':
+                {
+                    uint32_t code = 0;
+                    if (!parseHex4(ptr, end, code))
+                        return false;
+
+                    // Surrogate pair.
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        uint32_t low = 0;
+                        if (!consume(ptr, end, "\\u") || !parseHex4(ptr, end, low) || low < 0xDC00 || low >= 0xE000)
+                            return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        return false;
+    }
+
+    bool JsonValue::parseValue(const char*& ptr, const char* end, JsonValue& out, uint32_t depth)
+    {
+        if (depth > MAX_DEPTH)
+            return false;
+
+        skipWhitespace(ptr, end);
+        if (ptr >= end)
+            return false;
+
+        switch (*ptr)
+        {
+            case '{':
+            {
+                out.type_ = JSON_OBJECT;
+                ++ptr;
+                skipWhitespace(ptr, end);
+                if (ptr < end && *ptr == '}') {
+                    ++ptr;
+                    return true;
+                }
+
+                while (true)
+                {
+                    skipWhitespace(ptr, end);
+                    out.keys_.emplace_back();
+                    if (!parseString(ptr, end, out.keys_.back()))
+                        return false;
+
+                    skipWhitespace(ptr, end);
+                    if (ptr >= end || *ptr++ != ':')
+                        return false;
+
+                    out.values_.emplace_back();
+                    if (!parseValue(ptr, end, out.values_.back(), depth + 1))
+                        return false;
+
+                    skipWhitespace(ptr, end);
+                    if (ptr >= end)
+                        return false;
+                    if (*ptr == '}') {
+                        ++ptr;
+                        return true;
+                    }
+                    if (*ptr++ != ',')
+                        return false;
+                }
+            }
+            case '[':
+            {
+                out.type_ = JSON_ARRAY;
+                ++ptr;
+                skipWhitespace(ptr, end);
+                if (ptr < end && *ptr == ']') {
+                    ++ptr;
+                    return true;
+                }
+
+                while (true)
+                {
+                    out.values_.emplace_back();
+                    if (!parseValue(ptr, end, out.values_.back(), depth + 1))
+                        return false;
+
+                    skipWhitespace(ptr, end);
+                    if (ptr >= end)
+                        return false;
+                    if (*ptr == ']') {
+                        ++ptr;
+                        return true;
+                    }
+                    if (*ptr++ != ',')
+                        return false;
+                }
+            }
+            case '"':
+                out.type_ = JSON_STRING;
+                return parseString(ptr, end, out.string_);
+            case 't':
+                out.type_ = JSON_BOOL;
+                out.boolean_ = true;
+                return consume(ptr, end, "true");
+            case 'f':
+                out.type_ = JSON_BOOL;
+                return consume(ptr, end, "false");
+            case 'n':
+                return consume(ptr, end, "null");
+            default:
+            {
+                auto result = std::from_chars(ptr, end, out.number_);
+                if (result.ec != std::errc())
+                    return false;
+
+                out.type_ = JSON_NUMBER;
+                ptr = result.ptr;
+                return true;
+            }
+        }
+    }
+
+    bool JsonValue::contains(std::string_view key) const
+    {
+        for (const auto& member_key : keys_)
+            if (member_key == key)
+                return true;
+
+        return false;
+    }
+
+    size_t JsonValue::size() const
+    {
+        return values_.size();
+    }
+
+    const JsonValue& JsonValue::operator[](std::string_view key) const
+    {
+        for (size_t i = 0; i < keys_.size(); ++i)
+            if (keys_[i] == key)
+                return values_[i];
+
+        return getNull();
+    }
+
+    const JsonValue& JsonValue::operator[](size_t index) const
+    {
+        return type_ == JSON_ARRAY && index < values_.size() ? values_[index] : getNull();
+    }
+
+    bool JsonValue::getBool(bool fallback) const
+    {
+        return type_ == JSON_BOOL ? boolean_ : fallback;
+    }
+
+    double JsonValue::getNumber(double fallback) const
+    {
+        return type_ == JSON_NUMBER ? number_ : fallback;
+    }
+
+    int64_t JsonValue::getInt(int64_t fallback) const
+    {
+        return type_ == JSON_NUMBER ? static_cast<int64_t>(number_) : fallback;
+    }
+
+    const std::string& JsonValue::getString() const
+    {
+        static const std::string empty = {};
+        return type_ == JSON_STRING ? string_ : empty;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef GYMNURE_JSON_H
+#define GYMNURE_JSON_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace Engine::Util
+{
+    enum JsonType
+    {
+        JSON_NULL,
+        JSON_BOOL,
+        JSON_NUMBER,
+        JSON_STRING,
+        JSON_ARRAY,
+        JSON_OBJECT
+    };
+
+    /**
+     * Read-only JSON document (RFC 8259), enough for asset descriptions like glTF.
+     * Lookups never fail: missing members and out of range elements are null values.
+     * */
+    class JsonValue
+    {
+
+    private:
+
+        static constexpr uint32_t MAX_DEPTH = 256;
+
+        JsonType                    type_       = JSON_NULL;
+        bool                        boolean_    = false;
+        double                      number_     = 0.0;
+        std::string                 string_     = {};
+        std::vector<std::string>    keys_       = {};   // Object member names, aligned to values_.
+        std::vector<JsonValue>      values_     = {};   // Array elements or object member values.
+
+        static const JsonValue& getNull();
+
+        static bool parseValue(const char*& ptr, const char* end, JsonValue& out, uint32_t depth);
+        static bool parseString(const char*& ptr, const char* end, std::string& out);
+
+    public:
+
+        /**
+         * False on malformed input, 'out' is then left null.
+         * */
+        static bool parse(std::string_view text, JsonValue& out);
+
+        [[nodiscard]] JsonType getType() const { return type_; }
+        [[nodiscard]] bool isNull() const { return type_ == JSON_NULL; }
+        [[nodiscard]] bool isNumber() const { return type_ == JSON_NUMBER; }
+        [[nodiscard]] bool isString() const { return type_ == JSON_STRING; }
+        [[nodiscard]] bool isArray() const { return type_ == JSON_ARRAY; }
+        [[nodiscard]] bool isObject() const { return type_ == JSON_OBJECT; }
+
+        [[nodiscard]] bool contains(std::string_view key) const;
+
+        /**
+         * Elements of an array, member values of an object, zero otherwise.
+         * */
+        [[nodiscard]] size_t size() const;
+
+        const JsonValue& operator[](std::string_view key) const;
+        const JsonValue& operator[](size_t index) const;
+
+        [[nodiscard]] bool getBool(bool fallback = false) const;
+        [[nodiscard]] double getNumber(double fallback = 0.0) const;
+        [[nodiscard]] int64_t getInt(int64_t fallback = 0) const;
+        [[nodiscard]] const std::string& getString() const;
+    };
+}
+
+#endif //GYMNURE_JSON_H
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include "BlockCompressor.h"
+#include "MappedFile.h"
+#include "Ktx2.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        struct Ktx2Header
+        {
+            uint8_t  identifier[12];
+            uint32_t vk_format;
+            uint32_t type_size;
+            uint32_t pixel_width;
+            uint32_t pixel_height;
+            uint32_t pixel_depth;
+            uint32_t layer_count;
+            uint32_t face_count;
+            uint32_t level_count;
+            uint32_t supercompression_scheme;
+            uint32_t dfd_byte_offset;
+            uint32_t dfd_byte_length;
+            uint32_t kvd_byte_offset;
+            uint32_t kvd_byte_length;
+            uint64_t sgd_byte_offset;
+            uint64_t sgd_byte_length;
+        };
+
+        struct Ktx2LevelIndex
+        {
+            uint64_t byte_offset;
+            uint64_t byte_length;
+            uint64_t uncompressed_byte_length;
+        };
+
+        static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must be tightly packed!");
+        static_assert(sizeof(Ktx2LevelIndex) == 24, "KTX2 level index must be tightly packed!");
+
+        // Khronos Data Format color models and channel ids used below.
+        enum : uint32_t
+        {
+            KHR_DF_MODEL_RGBSDA = 1,
+            KHR_DF_MODEL_BC1A   = 128,
+            KHR_DF_MODEL_BC3    = 130,
+            KHR_DF_MODEL_BC4    = 131,
+            KHR_DF_MODEL_BC5    = 132,
+            KHR_DF_MODEL_BC7    = 134,
+            KHR_DF_CHANNEL_ALPHA = 15,
+        };
+
+        struct DfdSample
+        {
+            uint32_t bit_offset;
+            uint32_t bit_length;
+            uint32_t channel;
+            uint32_t upper;
+        };
+    }
+
+    bool Ktx2::parse(std::span<const uint8_t> bytes, Ktx2Image& image)
+    {
+        if (bytes.size() < sizeof(Ktx2Header))
+            return false;
+
+        Ktx2Header header = {};
+        std::memcpy(&header, bytes.data(), sizeof(Ktx2Header));
+
+        if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+            return false;
+
+        if (header.supercompression_scheme != 0 || header.face_count != 1 || header.layer_count > 1 || header.pixel_depth > 1)
+            return false;
+
+        if (header.pixel_width == 0 || header.pixel_height == 0 || header.level_count > 32)
+            return false;
+
+        uint32_t level_count = std::max(1u, header.level_count);
+        size_t level_index_offset = sizeof(Ktx2Header);
+        if (bytes.size() < level_index_offset + level_count * sizeof(Ktx2LevelIndex))
+            return false;
+
+        image.format = static_cast<vk::Format>(header.vk_format);
+        if (image.format != vk::Format::eR8G8B8A8Unorm && !BlockCompressor::isBlockCompressed(image.format))
+            return false;
+
+        image.width  = header.pixel_width;
+        image.height = header.pixel_height;
+        image.levels.clear();
+        image.data.clear();
+
+        for (uint32_t i = 0; i < level_count; ++i)
+        {
+            Ktx2LevelIndex level_index = {};
+            std::memcpy(&level_index, bytes.data() + level_index_offset + i * sizeof(Ktx2LevelIndex), sizeof(Ktx2LevelIndex));
+
+            // Written so a crafted offset cannot wrap around the bounds check.
+            if (level_index.byte_offset > bytes.size() || level_index.byte_length > bytes.size() - level_index.byte_offset)
+                return false;
+
+            MipLevel level = {};
+            level.width  = std::max(1u, header.pixel_width >> i);
+            level.height = std::max(1u, header.pixel_height >> i);
+
+            if (level_index.byte_length != BlockCompressor::getLevelSize(image.format, level.width, level.height))
+                return false;
+
+            level.offset = static_cast<size_t>(level_index.byte_offset);
+            level.size   = static_cast<size_t>(level_index.byte_length);
+            image.levels.push_back(level);
+        }
+
+        return true;
+    }
+
+    bool Ktx2::read(const std::string& path, Ktx2Image& image)
+    {
+        MappedFile file(path);
+        if (!file.isOpen() || !parse(file.getSpan(), image))
+            return false;
+
+        size_t data_size = 0;
+        for (const auto& level : image.levels)
+            data_size += level.size;
+
+        image.data.resize(data_size);
+
+        size_t offset = 0;
+        for (auto& level : image.levels)
+        {
+            std::memcpy(image.data.data() + offset, file.data() + level.offset, level.size);
+            level.offset = offset;
+            offset += level.size;
+        }
+
+        return true;
+    }
+
+    bool Ktx2::write(const std::string& path, const Ktx2Image& image)
+    {
+        std::vector<uint32_t> dfd = createDataFormatDescriptor(image.format);
+        if (dfd.empty() || image.levels.empty())
+            return false;
+
+        uint32_t block_bytes = BlockCompressor::getBlockBytes(image.format);
+        auto level_count = static_cast<uint32_t>(image.levels.size());
+
+        Ktx2Header header = {};
+        std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+        header.vk_format                = static_cast<uint32_t>(image.format);
+        header.type_size                = 1; // RGBA8 and block formats are both byte addressed.
+        header.pixel_width              = image.width;
+        header.pixel_height             = image.height;
+        header.pixel_depth              = 0;
+        header.layer_count              = 0;
+        header.face_count               = 1;
+        header.level_count              = level_count;
+        header.supercompression_scheme  = 0;
+        header.dfd_byte_offset          = static_cast<uint32_t>(sizeof(Ktx2Header) + level_count * sizeof(Ktx2LevelIndex));
+        header.dfd_byte_length          = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+        // Levels are stored smallest first, each aligned to lcm(texel block size, 4).
+        size_t alignment = std::lcm<size_t>(block_bytes > 0 ? block_bytes : 4, 4);
+        std::vector<Ktx2LevelIndex> level_index(level_count);
+
+        size_t offset = header.dfd_byte_offset + header.dfd_byte_length;
+        for (uint32_t i = level_count; i-- > 0;)
+        {
+            offset = (offset + alignment - 1) / alignment * alignment;
+            level_index[i].byte_offset              = offset;
+            level_index[i].byte_length              = image.levels[i].size;
+            level_index[i].uncompressed_byte_length = image.levels[i].size;
+            offset += image.levels[i].size;
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Ktx2Header));
+        file.write(reinterpret_cast<const char*>(level_index.data()), level_index.size() * sizeof(Ktx2LevelIndex));
+        file.write(reinterpret_cast<const char*>(dfd.data()), dfd.size() * sizeof(uint32_t));
+
+        for (uint32_t i = level_count; i-- > 0;)
+        {
+            auto padding = static_cast<std::streamoff>(level_index[i].byte_offset) - file.tellp();
+            for (; padding > 0; --padding)
+                file.put(0);
+
+            file.write(reinterpret_cast<const char*>(image.data.data() + image.levels[i].offset), image.levels[i].size);
+        }
+
+        return file.good();
+    }
+
+    std::vector<uint32_t> Ktx2::createDataFormatDescriptor(vk::Format format)
+    {
+        uint32_t color_model;
+        uint32_t block_dimension;
+        uint32_t bytes_plane;
+        std::vector<DfdSample> samples = {};
+
+        switch (format)
+        {
+            case vk::Format::eR8G8B8A8Unorm:
+                color_model = KHR_DF_MODEL_RGBSDA; block_dimension = 0; bytes_plane = 4;
+                samples = {{0, 8, 0, 255}, {8, 8, 1, 255}, {16, 8, 2, 255}, {24, 8, KHR_DF_CHANNEL_ALPHA, 255}};
+                break;
+            case vk::Format::eBc1RgbUnormBlock:
+                color_model = KHR_DF_MODEL_BC1A; block_dimension = 0x0303; bytes_plane = 8;
+                samples = {{0, 64, 0, UINT32_MAX}};
+                break;
+            case vk::Format::eBc3UnormBlock:
+                color_model = KHR_DF_MODEL_BC3; block_dimension = 0x0303; bytes_plane = 16;
+                samples = {{0, 64, KHR_DF_CHANNEL_ALPHA, UINT32_MAX}, {64, 64, 0, UINT32_MAX}};
+                break;
+            case vk::Format::eBc4UnormBlock:
+                color_model = KHR_DF_MODEL_BC4; block_dimension = 0x0303; bytes_plane = 8;
+                samples = {{0, 64, 0, UINT32_MAX}};
+                break;
+            case vk::Format::eBc5UnormBlock:
+                color_model = KHR_DF_MODEL_BC5; block_dimension = 0x0303; bytes_plane = 16;
+                samples = {{0, 64, 0, UINT32_MAX}, {64, 64, 1, UINT32_MAX}};
+                break;
+            case vk::Format::eBc7UnormBlock:
+                color_model = KHR_DF_MODEL_BC7; block_dimension = 0x0303; bytes_plane = 16;
+                samples = {{0, 128, 0, UINT32_MAX}};
+                break;
+            default:
+                return {};
+        }
+
+        auto block_size = static_cast<uint32_t>(24 + 16 * samples.size());
+
+        std::vector<uint32_t> dfd = {};
+        dfd.push_back(4 + block_size);                  // dfdTotalSize
+        dfd.push_back(0);                               // vendorId = Khronos, descriptorType = basic
+        dfd.push_back(2u | (block_size << 16u));        // versionNumber 1.3, descriptorBlockSize
+        dfd.push_back(color_model | (1u << 8u) | (1u << 16u)); // BT709 primaries, linear transfer, no flags
+        dfd.push_back(block_dimension);
+        dfd.push_back(bytes_plane);
+        dfd.push_back(0);
+
+        for (const auto& sample : samples)
+        {
+            dfd.push_back(sample.bit_offset | ((sample.bit_length - 1) << 16u) | (sample.channel << 24u));
+            dfd.push_back(0);
+            dfd.push_back(0);
+            dfd.push_back(sample.upper);
+        }
+
+        return dfd;
+    }
+}
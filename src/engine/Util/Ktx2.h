@@ -0,0 +1,49 @@
+#ifndef GYMNURE_KTX2_H
+#define GYMNURE_KTX2_H
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+#include "MipGenerator.h"
+
+namespace Engine::Util
+{
+    /**
+     * Single 2D image with its mip chain, levels tightly packed in 'data' from level 0 down.
+     * */
+    struct Ktx2Image
+    {
+        vk::Format              format  = vk::Format::eUndefined;
+        uint32_t                width   = 0;
+        uint32_t                height  = 0;
+        std::vector<MipLevel>   levels  = {};
+        std::vector<uint8_t>    data    = {};
+    };
+
+    /**
+     * KTX2 container reader/writer. Only 2D, single layer/face and non supercompressed files are handled.
+     * */
+    class Ktx2
+    {
+    public:
+
+        Ktx2() = delete;
+
+        static bool read(const std::string& path, Ktx2Image& image);
+
+        /**
+         * Header and level table only: level offsets are left relative to 'bytes' and 'data' stays empty,
+         * so mapped files can be uploaded in place. Levels are stored smallest first.
+         * */
+        static bool parse(std::span<const uint8_t> bytes, Ktx2Image& image);
+        static bool write(const std::string& path, const Ktx2Image& image);
+
+    private:
+
+        static std::vector<uint32_t> createDataFormatDescriptor(vk::Format format);
+    };
+}
+
+#endif //GYMNURE_KTX2_H
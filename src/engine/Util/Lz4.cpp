@@ -0,0 +1,155 @@
+#include <cstring>
+#include <algorithm>
+#include "Lz4.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        inline uint32_t read32(const uint8_t* ptr)
+        {
+            uint32_t value;
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        }
+    }
+
+    void Lz4::writeLength(std::vector<uint8_t>& out, size_t length)
+    {
+        // Lengths that do not fit the token nibble continue in 255 steps.
+        for (; length >= 255; length -= 255)
+            out.push_back(255);
+        out.push_back(static_cast<uint8_t>(length));
+    }
+
+    void Lz4::writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length)
+    {
+        size_t match_code = match_length >= MIN_MATCH ? match_length - MIN_MATCH : 0;
+
+        out.push_back(static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) | std::min<size_t>(match_code, 15)));
+        if (literal_count >= 15)
+            writeLength(out, literal_count - 15);
+
+        out.insert(out.end(), literals, literals + literal_count);
+
+        // Last sequence: literals only.
+        if (match_length == 0)
+            return;
+
+        out.push_back(static_cast<uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (match_code >= 15)
+            writeLength(out, match_code - 15);
+    }
+
+    std::vector<uint8_t> Lz4::compress(std::span<const uint8_t> src)
+    {
+        const uint8_t* data = src.data();
+        const size_t size = src.size();
+
+        std::vector<uint8_t> out = {};
+        out.reserve(size + size / 255 + 16);
+
+        std::vector<int64_t> table(size_t(1) << HASH_LOG, -1);
+
+        size_t anchor = 0;
+        if (size > MF_LIMIT)
+        {
+            const size_t match_limit = size - LAST_LITERALS;
+            size_t i = 0;
+
+            while (i < size - MF_LIMIT)
+            {
+                uint32_t sequence = read32(data + i);
+                uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_LOG);
+
+                int64_t candidate = table[hash];
+                table[hash] = static_cast<int64_t>(i);
+
+                if (candidate < 0 || i - static_cast<size_t>(candidate) > MAX_OFFSET || read32(data + candidate) != sequence) {
+                    ++i;
+                    continue;
+                }
+
+                auto match = static_cast<size_t>(candidate);
+                size_t match_length = MIN_MATCH;
+                while (i + match_length < match_limit && data[match + match_length] == data[i + match_length])
+                    ++match_length;
+
+                writeSequence(out, data + anchor, i - anchor, i - match, match_length);
+
+                i += match_length;
+                anchor = i;
+            }
+        }
+
+        writeSequence(out, data + anchor, size - anchor, 0, 0);
+
+        return out;
+    }
+
+    bool Lz4::decompress(std::span<const uint8_t> src, std::span<uint8_t> dst)
+    {
+        const uint8_t* in     = src.data();
+        const uint8_t* in_end = in + src.size();
+        uint8_t* out          = dst.data();
+        uint8_t* out_end      = out + dst.size();
+
+        auto readLength = [&in, in_end](size_t length) -> size_t
+        {
+            if (length != 15)
+                return length;
+
+            uint8_t byte;
+            do {
+                if (in >= in_end) return SIZE_MAX;
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+
+            return length;
+        };
+
+        while (in < in_end)
+        {
+            uint8_t token = *in++;
+
+            size_t literal_count = readLength(token >> 4);
+            if (literal_count == SIZE_MAX || literal_count > static_cast<size_t>(in_end - in) || literal_count > static_cast<size_t>(out_end - out))
+                return false;
+
+            std::memcpy(out, in, literal_count);
+            in  += literal_count;
+            out += literal_count;
+
+            if (in == in_end)
+                break;
+
+            if (in_end - in < 2)
+                return false;
+
+            size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+            in += 2;
+
+            size_t match_length = readLength(token & 0x0F);
+            if (match_length == SIZE_MAX)
+                return false;
+            match_length += MIN_MATCH;
+
+            if (offset == 0 || offset > static_cast<size_t>(out - dst.data()) || match_length > static_cast<size_t>(out_end - out))
+                return false;
+
+            // Matches may overlap their own output (offset < length), copy forward.
+            const uint8_t* match = out - offset;
+            if (offset >= match_length) {
+                std::memcpy(out, match, match_length);
+                out += match_length;
+            } else {
+                for (size_t i = 0; i < match_length; ++i)
+                    *out++ = match[i];
+            }
+        }
+
+        return out == out_end;
+    }
+}
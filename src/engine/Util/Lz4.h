@@ -0,0 +1,41 @@
+#ifndef GYMNURE_LZ4_H
+#define GYMNURE_LZ4_H
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Engine::Util
+{
+    /**
+     * LZ4 block format (no frame). Greedy single probe compressor, output is readable by any LZ4 decoder.
+     * */
+    class Lz4
+    {
+
+    private:
+
+        static constexpr uint32_t MIN_MATCH     = 4;
+        static constexpr uint32_t LAST_LITERALS = 5;    // Block always ends with literals.
+        static constexpr uint32_t MF_LIMIT      = 12;   // No match starts in the last 12 bytes.
+        static constexpr uint32_t HASH_LOG      = 16;
+        static constexpr uint32_t MAX_OFFSET    = 65535;
+
+        static void writeLength(std::vector<uint8_t>& out, size_t length);
+        static void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length);
+
+    public:
+
+        Lz4() = delete;
+
+        static std::vector<uint8_t> compress(std::span<const uint8_t> src);
+
+        /**
+         * Decode a whole block into 'dst'. False on malformed input or when it does not decode to exactly dst.size() bytes.
+         * */
+        static bool decompress(std::span<const uint8_t> src, std::span<uint8_t> dst);
+    };
+}
+
+#endif //GYMNURE_LZ4_H
@@ -0,0 +1,90 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine::Util
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& path, bool sequential)
+    {
+        DWORD flags = sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+        file_handle_ = file;
+
+        LARGE_INTEGER file_size = {};
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+            return;
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+            return;
+        mapping_handle_ = mapping;
+
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        size_ = data_ != nullptr ? static_cast<size_t>(file_size.QuadPart) : 0;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data_ != nullptr)           UnmapViewOfFile(data_);
+        if (mapping_handle_ != nullptr) CloseHandle(mapping_handle_);
+        if (file_handle_ != nullptr)    CloseHandle(file_handle_);
+    }
+#else
+    MappedFile::MappedFile(const std::string& path, bool sequential)
+    {
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            return;
+
+        struct stat file_stat = {};
+        if (fstat(fd_, &file_stat) != 0 || file_stat.st_size == 0)
+            return;
+
+        void* mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapping == MAP_FAILED)
+            return;
+
+        // Loaders parse files front to back.
+        madvise(mapping, static_cast<size_t>(file_stat.st_size), sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+
+        data_ = static_cast<const uint8_t*>(mapping);
+        size_ = static_cast<size_t>(file_stat.st_size);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data_ != nullptr) munmap(const_cast<uint8_t*>(data_), size_);
+        if (fd_ >= 0)         close(fd_);
+    }
+#endif
+
+    bool MappedFile::isOpen() const
+    {
+        return data_ != nullptr;
+    }
+
+    const uint8_t* MappedFile::data() const
+    {
+        return data_;
+    }
+
+    size_t MappedFile::size() const
+    {
+        return size_;
+    }
+
+    std::span<const uint8_t> MappedFile::getSpan() const
+    {
+        return {data_, size_};
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef GYMNURE_MAPPEDFILE_H
+#define GYMNURE_MAPPEDFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace Engine::Util
+{
+    /**
+     * Read-only memory mapping of a whole file. The mapping is released on destruction.
+     * */
+    class MappedFile
+    {
+
+    private:
+
+        const uint8_t*  data_ = nullptr;
+        size_t          size_ = 0;
+
+    #ifdef _WIN32
+        void*           file_handle_    = nullptr;
+        void*           mapping_handle_ = nullptr;
+    #else
+        int             fd_ = -1;
+    #endif
+
+    public:
+
+        /**
+         * 'sequential' hints the OS to read ahead, turn it off for files read at random offsets (archives).
+         * */
+        explicit MappedFile(const std::string& path, bool sequential = true);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] bool isOpen() const;
+        [[nodiscard]] const uint8_t* data() const;
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] std::span<const uint8_t> getSpan() const;
+    };
+}
+
+#endif //GYMNURE_MAPPEDFILE_H
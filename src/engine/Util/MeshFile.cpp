@@ -0,0 +1,229 @@
+#include <cstring>
+#include <fstream>
+#include <Vertex/VertexQuantizer.h>
+#include "MappedFile.h"
+#include "MeshFile.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        const char MAGIC[4] = {'G', 'M', 'S', 'H'};
+
+        struct FileHeader
+        {
+            char     magic[4];
+            uint32_t version;
+            uint32_t mesh_count;
+            uint32_t reserved;
+        };
+
+        struct MeshHeader
+        {
+            uint32_t vertex_count;
+            uint32_t index_size;    // 2 or 4 bytes.
+            uint32_t lod_count;     // LOD 0 included.
+            uint32_t texture_path_length;
+            float    bounds_min[3];
+            float    bounds_max[3];
+            float    center[3];
+            float    radius;
+            float    quantization_min[4];
+            float    quantization_extent[4];
+        };
+
+        struct LodHeader
+        {
+            uint32_t index_count;
+            float    error;
+        };
+
+        size_t align4(size_t size)
+        {
+            return (size + 3) & ~static_cast<size_t>(3);
+        }
+
+        class Reader
+        {
+            const uint8_t* data_;
+            size_t size_;
+            size_t offset_ = 0;
+
+        public:
+
+            Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+            const uint8_t* take(size_t size)
+            {
+                if (offset_ + size > size_)
+                    return nullptr;
+
+                const uint8_t* ptr = data_ + offset_;
+                offset_ = align4(offset_ + size);
+                return ptr;
+            }
+
+            template <class T>
+            bool read(T& value)
+            {
+                const uint8_t* ptr = take(sizeof(T));
+                if (ptr != nullptr)
+                    std::memcpy(&value, ptr, sizeof(T));
+                return ptr != nullptr;
+            }
+        };
+
+        void writeAligned(std::ofstream& file, const void* data, size_t size)
+        {
+            static const char padding[4] = {};
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            file.write(padding, static_cast<std::streamsize>(align4(size) - size));
+        }
+    }
+
+    bool MeshFile::write(const std::string& path, const Model& model)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        FileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version    = VERSION;
+        header.mesh_count = static_cast<uint32_t>(model.meshes->size());
+        writeAligned(file, &header, sizeof(header));
+
+        for (const std::shared_ptr<Mesh>& mesh : *model.meshes)
+        {
+            static const std::vector<uint32_t> no_indices = {};
+            std::vector<const std::vector<uint32_t>*> lods = {mesh->indexData != nullptr ? mesh->indexData.get() : &no_indices};
+            for (const auto& lod : mesh->lods)
+                lods.push_back(lod.indexData.get());
+
+            Vertex::QuantizedMesh quantized = Vertex::VertexQuantizer::quantize(*mesh->vertexData, {});
+            std::string texture_path = mesh->material != nullptr ? mesh->material->texture_path : "";
+
+            MeshHeader mesh_header = {};
+            mesh_header.vertex_count        = static_cast<uint32_t>(quantized.vertices.size());
+            mesh_header.index_size          = quantized.vertices.size() <= UINT16_MAX + 1 ? 2 : 4;
+            mesh_header.lod_count           = static_cast<uint32_t>(lods.size());
+            mesh_header.texture_path_length = static_cast<uint32_t>(texture_path.size());
+            std::memcpy(mesh_header.bounds_min, &mesh->bounds.min, sizeof(mesh_header.bounds_min));
+            std::memcpy(mesh_header.bounds_max, &mesh->bounds.max, sizeof(mesh_header.bounds_max));
+            std::memcpy(mesh_header.center, &mesh->bounds.center, sizeof(mesh_header.center));
+            mesh_header.radius = mesh->bounds.radius;
+            std::memcpy(mesh_header.quantization_min, &quantized.params.bounds_min, sizeof(mesh_header.quantization_min));
+            std::memcpy(mesh_header.quantization_extent, &quantized.params.bounds_extent, sizeof(mesh_header.quantization_extent));
+
+            writeAligned(file, &mesh_header, sizeof(mesh_header));
+            writeAligned(file, texture_path.data(), texture_path.size());
+
+            std::vector<LodHeader> lod_headers = {};
+            lod_headers.push_back(LodHeader{static_cast<uint32_t>(lods[0]->size()), 0.f});
+            for (const auto& lod : mesh->lods)
+                lod_headers.push_back(LodHeader{static_cast<uint32_t>(lod.indexData->size()), lod.error});
+            writeAligned(file, lod_headers.data(), lod_headers.size() * sizeof(LodHeader));
+
+            writeAligned(file, quantized.vertices.data(), quantized.vertices.size() * sizeof(Vertex::PackedVertexData));
+
+            for (const auto* lod : lods)
+            {
+                if (mesh_header.index_size == 2) {
+                    std::vector<uint16_t> indices16(lod->begin(), lod->end());
+                    writeAligned(file, indices16.data(), indices16.size() * sizeof(uint16_t));
+                } else {
+                    writeAligned(file, lod->data(), lod->size() * sizeof(uint32_t));
+                }
+            }
+        }
+
+        return file.good();
+    }
+
+    std::unique_ptr<Model> MeshFile::read(const std::string& path)
+    {
+        MappedFile file(path);
+        if (!file.isOpen())
+            return nullptr;
+
+        return read(file.getSpan());
+    }
+
+    std::unique_ptr<Model> MeshFile::read(std::span<const uint8_t> bytes)
+    {
+        Reader reader(bytes.data(), bytes.size());
+
+        FileHeader header = {};
+        if (!reader.read(header) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+            return nullptr;
+
+        auto model = std::make_unique<Model>();
+        model->meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>();
+
+        for (uint32_t m = 0; m < header.mesh_count; ++m)
+        {
+            MeshHeader mesh_header = {};
+            if (!reader.read(mesh_header) || mesh_header.lod_count == 0)
+                return nullptr;
+
+            auto mesh = std::make_shared<Mesh>();
+            mesh->material = std::make_shared<Material>();
+
+            const uint8_t* texture_path = reader.take(mesh_header.texture_path_length);
+            const uint8_t* lod_table = reader.take(mesh_header.lod_count * sizeof(LodHeader));
+            const uint8_t* vertices = reader.take(mesh_header.vertex_count * sizeof(Vertex::PackedVertexData));
+            if (texture_path == nullptr || lod_table == nullptr || vertices == nullptr)
+                return nullptr;
+
+            mesh->material->texture_path.assign(reinterpret_cast<const char*>(texture_path), mesh_header.texture_path_length);
+
+            std::memcpy(&mesh->bounds.min, mesh_header.bounds_min, sizeof(mesh_header.bounds_min));
+            std::memcpy(&mesh->bounds.max, mesh_header.bounds_max, sizeof(mesh_header.bounds_max));
+            std::memcpy(&mesh->bounds.center, mesh_header.center, sizeof(mesh_header.center));
+            mesh->bounds.radius = mesh_header.radius;
+
+            Vertex::QuantizationParams params = {};
+            std::memcpy(&params.bounds_min, mesh_header.quantization_min, sizeof(mesh_header.quantization_min));
+            std::memcpy(&params.bounds_extent, mesh_header.quantization_extent, sizeof(mesh_header.quantization_extent));
+
+            mesh->vertexData = std::make_shared<std::vector<VertexData>>(mesh_header.vertex_count);
+            for (uint32_t v = 0; v < mesh_header.vertex_count; ++v)
+            {
+                Vertex::PackedVertexData packed = {};
+                std::memcpy(&packed, vertices + v * sizeof(Vertex::PackedVertexData), sizeof(packed));
+                (*mesh->vertexData)[v] = Vertex::VertexQuantizer::unpackVertex(packed, params);
+            }
+
+            for (uint32_t l = 0; l < mesh_header.lod_count; ++l)
+            {
+                LodHeader lod_header = {};
+                std::memcpy(&lod_header, lod_table + l * sizeof(LodHeader), sizeof(LodHeader));
+
+                const uint8_t* indices = reader.take(lod_header.index_count * mesh_header.index_size);
+                if (indices == nullptr)
+                    return nullptr;
+
+                auto index_data = std::make_shared<std::vector<uint32_t>>(lod_header.index_count);
+                for (uint32_t i = 0; i < lod_header.index_count; ++i)
+                {
+                    if (mesh_header.index_size == 2) {
+                        uint16_t index;
+                        std::memcpy(&index, indices + i * 2, 2);
+                        (*index_data)[i] = index;
+                    } else {
+                        std::memcpy(&(*index_data)[i], indices + i * 4, 4);
+                    }
+                }
+
+                if (l == 0)
+                    mesh->indexData = std::move(index_data);
+                else
+                    mesh->lods.push_back(MeshLod{std::move(index_data), lod_header.error});
+            }
+
+            model->meshes->push_back(std::move(mesh));
+        }
+
+        return model;
+    }
+}
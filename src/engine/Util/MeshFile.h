@@ -0,0 +1,32 @@
+#ifndef GYMNURE_MESHFILE_H
+#define GYMNURE_MESHFILE_H
+
+#include <span>
+#include <memory>
+#include <string>
+#include "ModelData.hpp"
+
+namespace Engine::Util
+{
+    /**
+     * Engine native mesh file (.gmesh) written by gymnure_cook.
+     *
+     * Header, then per mesh: MeshHeader, material texture path, LOD table, quantized vertices
+     * (Vertex::PackedVertexData) and the index lists of every LOD (16 bits when possible).
+     * Sections are 4 bytes aligned, values are little endian.
+     * */
+    class MeshFile
+    {
+    public:
+
+        static constexpr uint32_t VERSION = 2;
+
+        MeshFile() = delete;
+
+        static bool write(const std::string& path, const Model& model);
+        static std::unique_ptr<Model> read(const std::string& path);
+        static std::unique_ptr<Model> read(std::span<const uint8_t> bytes);
+    };
+}
+
+#endif //GYMNURE_MESHFILE_H
@@ -0,0 +1,243 @@
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include "MeshOptimizer.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        constexpr uint32_t CACHE_SIZE = 32;
+        constexpr uint32_t MAX_VALENCE = 32;
+
+        float vertexScore(int32_t cache_position, uint32_t live_triangles)
+        {
+            if (live_triangles == 0)
+                return -1.f;
+
+            float score = 0.f;
+            if (cache_position >= 0)
+            {
+                // Last triangle vertices get a fixed score, so the next triangle does not just reuse them.
+                if (cache_position < 3)
+                    score = 0.75f;
+                else
+                    score = std::pow(1.f - static_cast<float>(cache_position - 3) / (CACHE_SIZE - 3), 1.5f);
+            }
+
+            // Vertices with few triangles left are worth finishing.
+            score += 2.f / std::sqrt(static_cast<float>(std::min(live_triangles, MAX_VALENCE)));
+
+            return score;
+        }
+    }
+
+    void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count)
+    {
+        size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0)
+            return;
+
+        // Vertex -> triangles adjacency (CSR).
+        std::vector<uint32_t> live(vertex_count, 0);
+        for (uint32_t index : indices)
+            live[index]++;
+
+        std::vector<uint32_t> offsets(vertex_count + 1, 0);
+        for (size_t v = 0; v < vertex_count; ++v)
+            offsets[v + 1] = offsets[v] + live[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangle_count; ++t)
+            for (size_t k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+
+        std::vector<int32_t> cache_position(vertex_count, -1);
+        std::vector<float> vertex_scores(vertex_count);
+        for (size_t v = 0; v < vertex_count; ++v)
+            vertex_scores[v] = vertexScore(-1, live[v]);
+
+        std::vector<bool> emitted(triangle_count, false);
+
+        std::vector<uint32_t> cache = {};
+        std::vector<uint32_t> next_cache = {};
+        cache.reserve(CACHE_SIZE + 3);
+        next_cache.reserve(CACHE_SIZE + 3);
+
+        std::vector<uint32_t> result = {};
+        result.reserve(indices.size());
+
+        size_t scan_cursor = 0;
+        int64_t best_triangle = 0;
+
+        while (best_triangle >= 0)
+        {
+            auto triangle = static_cast<size_t>(best_triangle);
+            emitted[triangle] = true;
+
+            // Emitted vertices go to the cache front, the rest keep their order.
+            next_cache.clear();
+            for (size_t k = 0; k < 3; ++k)
+            {
+                uint32_t v = indices[triangle * 3 + k];
+                result.push_back(v);
+                next_cache.push_back(v);
+
+                // Drop the triangle from the vertex live list.
+                auto begin = adjacency.begin() + offsets[v];
+                auto end = begin + live[v];
+                std::iter_swap(std::find(begin, end, static_cast<uint32_t>(triangle)), end - 1);
+                live[v]--;
+            }
+            for (uint32_t v : cache)
+                if (v != next_cache[0] && v != next_cache[1] && v != next_cache[2])
+                    next_cache.push_back(v);
+            std::swap(cache, next_cache);
+
+            // Refresh scores of cached vertices (evicted ones lose their position).
+            for (size_t i = 0; i < cache.size(); ++i)
+            {
+                uint32_t v = cache[i];
+                cache_position[v] = i < CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+                vertex_scores[v] = vertexScore(cache_position[v], live[v]);
+            }
+            if (cache.size() > CACHE_SIZE)
+                cache.resize(CACHE_SIZE);
+
+            // Best candidate among triangles touching the cache.
+            best_triangle = -1;
+            float best_score = -1.f;
+            for (uint32_t v : cache)
+            {
+                for (uint32_t i = 0; i < live[v]; ++i)
+                {
+                    uint32_t t = adjacency[offsets[v] + i];
+                    float score = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+                    if (score > best_score) {
+                        best_score = score;
+                        best_triangle = t;
+                    }
+                }
+            }
+
+            // Cache ran dry: continue from the next triangle not emitted yet.
+            if (best_triangle < 0)
+            {
+                while (scan_cursor < triangle_count && emitted[scan_cursor])
+                    scan_cursor++;
+                if (scan_cursor < triangle_count)
+                    best_triangle = static_cast<int64_t>(scan_cursor);
+            }
+        }
+
+        indices = std::move(result);
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(std::vector<VertexData>& vertices, const std::vector<std::vector<uint32_t>*>& index_lists)
+    {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<VertexData> reordered = {};
+        reordered.reserve(vertices.size());
+
+        for (auto* index_list : index_lists)
+        {
+            for (uint32_t& index : *index_list)
+            {
+                if (remap[index] == UINT32_MAX) {
+                    remap[index] = static_cast<uint32_t>(reordered.size());
+                    reordered.push_back(vertices[index]);
+                }
+                index = remap[index];
+            }
+        }
+
+        // Vertices no index refers to are dropped.
+        vertices = std::move(reordered);
+    }
+
+    std::vector<uint32_t> MeshOptimizer::simplifyClustered(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices,
+                                                           const Bounds& bounds, uint32_t grid_size)
+    {
+        return collapseTriangles(indices, clusterVertices(vertices, bounds, grid_size));
+    }
+
+    std::vector<uint32_t> MeshOptimizer::clusterVertices(const std::vector<VertexData>& vertices, const Bounds& bounds, uint32_t grid_size)
+    {
+        glm::vec3 extent = glm::max(bounds.max - bounds.min, glm::vec3(1e-6f));
+        glm::vec3 scale = static_cast<float>(grid_size) / extent;
+
+        // Cell representative: first vertex that falls in it.
+        std::unordered_map<uint64_t, uint32_t> cells = {};
+        std::vector<uint32_t> representative(vertices.size());
+        for (size_t v = 0; v < vertices.size(); ++v)
+        {
+            glm::uvec3 cell = glm::min(glm::uvec3((vertices[v].pos - bounds.min) * scale), glm::uvec3(grid_size - 1));
+            uint64_t key = (static_cast<uint64_t>(cell.x) << 42u) | (static_cast<uint64_t>(cell.y) << 21u) | cell.z;
+            representative[v] = cells.emplace(key, static_cast<uint32_t>(v)).first->second;
+        }
+
+        return representative;
+    }
+
+    std::vector<uint32_t> MeshOptimizer::collapseTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& representative)
+    {
+        std::vector<uint32_t> simplified = {};
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            uint32_t a = representative[indices[t]];
+            uint32_t b = representative[indices[t + 1]];
+            uint32_t c = representative[indices[t + 2]];
+
+            // Collapsed triangles disappear.
+            if (a == b || b == c || a == c)
+                continue;
+
+            simplified.push_back(a);
+            simplified.push_back(b);
+            simplified.push_back(c);
+        }
+
+        return simplified;
+    }
+
+    Bounds MeshOptimizer::computeBounds(const std::vector<VertexData>& vertices)
+    {
+        Bounds bounds = {};
+        if (vertices.empty())
+            return bounds;
+
+        bounds.min = vertices[0].pos;
+        bounds.max = vertices[0].pos;
+        for (const auto& vertex : vertices) {
+            bounds.min = glm::min(bounds.min, vertex.pos);
+            bounds.max = glm::max(bounds.max, vertex.pos);
+        }
+
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+        for (const auto& vertex : vertices)
+            bounds.radius = std::max(bounds.radius, glm::length(vertex.pos - bounds.center));
+
+        return bounds;
+    }
+
+    float MeshOptimizer::computeUvDensity(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices)
+    {
+        double uv_area = 0.0;
+        double area = 0.0;
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const VertexData& a = vertices[indices[i]];
+            const VertexData& b = vertices[indices[i + 1]];
+            const VertexData& c = vertices[indices[i + 2]];
+
+            glm::vec2 uv_ab = b.uv - a.uv;
+            glm::vec2 uv_ac = c.uv - a.uv;
+            uv_area += std::abs(uv_ab.x * uv_ac.y - uv_ab.y * uv_ac.x);
+            area += glm::length(glm::cross(b.pos - a.pos, c.pos - a.pos));
+        }
+
+        return area > 0.0 ? static_cast<float>(std::sqrt(uv_area / area)) : 0.f;
+    }
+}
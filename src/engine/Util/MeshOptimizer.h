@@ -0,0 +1,56 @@
+#ifndef GYMNURE_MESHOPTIMIZER_H
+#define GYMNURE_MESHOPTIMIZER_H
+
+#include <vector>
+#include <cstdint>
+#include "ModelData.hpp"
+
+namespace Engine::Util
+{
+    /**
+     * Offline mesh processing used by the cooker.
+     * */
+    class MeshOptimizer
+    {
+    public:
+
+        MeshOptimizer() = delete;
+
+        /**
+         * Reorder triangles for post-transform cache hits (Forsyth, "Linear-Speed Vertex Cache Optimisation").
+         * */
+        static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count);
+
+        /**
+         * Reorder vertices by first use so fetches walk memory forward. Remaps every index list given.
+         * */
+        static void optimizeVertexFetch(std::vector<VertexData>& vertices, const std::vector<std::vector<uint32_t>*>& index_lists);
+
+        /**
+         * Vertex clustering: vertices sharing a cell of a 'grid_size'^3 grid over the bounds collapse into one.
+         * Returns triangles over the same vertex buffer.
+         * */
+        static std::vector<uint32_t> simplifyClustered(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices,
+                                                       const Bounds& bounds, uint32_t grid_size);
+
+        /**
+         * Vertex each vertex collapses to in simplifyClustered: the first one of its grid cell. Meshes simplified
+         * piece by piece share it, so pieces cut from the same grid stay watertight.
+         * */
+        static std::vector<uint32_t> clusterVertices(const std::vector<VertexData>& vertices, const Bounds& bounds, uint32_t grid_size);
+
+        /**
+         * Triangles of 'indices' with vertices replaced by their 'representative', collapsed ones are dropped.
+         * */
+        static std::vector<uint32_t> collapseTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& representative);
+
+        static Bounds computeBounds(const std::vector<VertexData>& vertices);
+
+        /**
+         * UV units per object space unit, area weighted over all triangles. 0 for meshes without UVs.
+         * */
+        static float computeUvDensity(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices);
+    };
+}
+
+#endif //GYMNURE_MESHOPTIMIZER_H
@@ -0,0 +1,228 @@
+#include <cmath>
+#include <algorithm>
+#include "ThreadPool.h"
+#include "MeshletBuilder.h"
+
+namespace Engine::Util
+{
+    MeshletBuilder::Adjacency MeshletBuilder::buildAdjacency(const std::vector<uint32_t>& indices, size_t vertex_count)
+    {
+        Adjacency adjacency = {};
+        size_t triangle_count = indices.size() / 3;
+
+        adjacency.offsets.assign(vertex_count + 1, 0);
+        for (size_t c = 0; c < triangle_count * 3; ++c)
+            adjacency.offsets[indices[c] + 1]++;
+
+        for (size_t v = 0; v < vertex_count; ++v)
+            adjacency.offsets[v + 1] += adjacency.offsets[v];
+
+        std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        adjacency.triangles.resize(triangle_count * 3);
+        for (size_t t = 0; t < triangle_count; ++t)
+            for (size_t k = 0; k < 3; ++k)
+                adjacency.triangles[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+
+        return adjacency;
+    }
+
+    void MeshletBuilder::build(Mesh& mesh)
+    {
+        mesh.meshlets.clear();
+        if (mesh.vertexData == nullptr || mesh.indexData == nullptr || mesh.indexData->size() < 3)
+            return;
+
+        const auto& vertices = *mesh.vertexData;
+        const auto& indices = *mesh.indexData;
+        size_t triangle_count = indices.size() / 3;
+
+        for (size_t c = 0; c < triangle_count * 3; ++c)
+            if (indices[c] >= vertices.size())
+                return;
+
+        Adjacency adjacency = buildAdjacency(indices, vertices.size());
+
+        // Free triangles of vertex v are the first live[v] ones of its adjacency, emitted ones are swapped out.
+        std::vector<uint32_t> live(vertices.size());
+        for (size_t v = 0; v < vertices.size(); ++v)
+            live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+        std::vector<bool> emitted(triangle_count, false);
+        // Meshlet each vertex was last added to, so testing membership of the current one is a single compare.
+        std::vector<uint32_t> vertex_meshlet(vertices.size(), UINT32_MAX);
+        uint32_t meshlet_vertices[MAX_VERTICES] = {};
+
+        std::vector<uint32_t> clustered = {};
+        clustered.reserve(triangle_count * 3);
+
+        Meshlet meshlet = {};
+        auto meshlet_id = 0u;
+
+        auto newVertexCount = [&](uint32_t triangle)
+        {
+            uint32_t a = indices[triangle * 3], b = indices[triangle * 3 + 1], c = indices[triangle * 3 + 2];
+            return static_cast<uint32_t>(vertex_meshlet[a] != meshlet_id) +
+                   static_cast<uint32_t>(vertex_meshlet[b] != meshlet_id && b != a) +
+                   static_cast<uint32_t>(vertex_meshlet[c] != meshlet_id && c != a && c != b);
+        };
+
+        // Free triangle around 'corners' adding the fewest vertices to the meshlet.
+        auto bestNeighbour = [&](const uint32_t* corners, size_t corner_count)
+        {
+            uint32_t best = UINT32_MAX;
+            uint32_t best_score = UINT32_MAX;
+            for (size_t i = 0; i < corner_count; ++i)
+            {
+                uint32_t v = corners[i];
+                for (uint32_t j = adjacency.offsets[v]; j < adjacency.offsets[v] + live[v]; ++j)
+                {
+                    uint32_t score = newVertexCount(adjacency.triangles[j]);
+                    if (score < best_score) {
+                        best = adjacency.triangles[j];
+                        best_score = score;
+                        if (score == 0)
+                            return best;
+                    }
+                }
+            }
+
+            return best;
+        };
+
+        auto flush = [&]()
+        {
+            mesh.meshlets.push_back(meshlet);
+
+            meshlet = {};
+            meshlet.index_offset = static_cast<uint32_t>(clustered.size());
+            meshlet_id++;
+        };
+
+        size_t seed = 0;
+        uint32_t last_triangle = UINT32_MAX;
+        for (size_t emitted_count = 0; emitted_count < triangle_count; ++emitted_count)
+        {
+            uint32_t triangle = UINT32_MAX;
+            if (last_triangle != UINT32_MAX) {
+                triangle = bestNeighbour(&indices[last_triangle * 3], 3);
+                if (triangle == UINT32_MAX)
+                    triangle = bestNeighbour(meshlet_vertices, meshlet.vertex_count);
+            }
+
+            // Nothing connected left: continue from the next triangle in index order, close to the last ones
+            // in cache optimized meshes.
+            if (triangle == UINT32_MAX) {
+                while (emitted[seed])
+                    ++seed;
+                triangle = static_cast<uint32_t>(seed);
+            }
+
+            if (meshlet.vertex_count + newVertexCount(triangle) > MAX_VERTICES || meshlet.index_count == MAX_TRIANGLES * 3)
+                flush();
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                uint32_t v = indices[triangle * 3 + k];
+                if (vertex_meshlet[v] != meshlet_id) {
+                    vertex_meshlet[v] = meshlet_id;
+                    meshlet_vertices[meshlet.vertex_count++] = v;
+                }
+                clustered.push_back(v);
+
+                // Swap the triangle out of the free ones of v (once per distinct corner).
+                uint32_t* begin = &adjacency.triangles[adjacency.offsets[v]];
+                uint32_t* end = begin + live[v];
+                uint32_t* it = std::find(begin, end, triangle);
+                if (it != end) {
+                    std::swap(*it, *(end - 1));
+                    live[v]--;
+                }
+            }
+
+            meshlet.index_count += 3;
+            emitted[triangle] = true;
+            last_triangle = triangle;
+        }
+
+        if (meshlet.index_count > 0)
+            flush();
+
+        size_t batch_count = (mesh.meshlets.size() + BOUNDS_BATCH_SIZE - 1) / BOUNDS_BATCH_SIZE;
+        ThreadPool::getInstance()->parallelFor(batch_count, [&](size_t batch)
+        {
+            size_t batch_end = std::min((batch + 1) * BOUNDS_BATCH_SIZE, mesh.meshlets.size());
+            for (size_t i = batch * BOUNDS_BATCH_SIZE; i < batch_end; ++i)
+                computeBounds(mesh.meshlets[i], vertices, clustered);
+        });
+
+        // Other owners of the index list keep the original order.
+        mesh.indexData = std::make_shared<std::vector<uint32_t>>(std::move(clustered));
+    }
+
+    void MeshletBuilder::computeBounds(Meshlet& meshlet, const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices)
+    {
+        uint32_t begin = meshlet.index_offset;
+        uint32_t end = meshlet.index_offset + meshlet.index_count;
+        if (begin >= end)
+            return;
+
+        glm::vec3 min = vertices[indices[begin]].pos;
+        glm::vec3 max = min;
+        for (uint32_t i = begin; i < end; ++i) {
+            min = glm::min(min, vertices[indices[i]].pos);
+            max = glm::max(max, vertices[indices[i]].pos);
+        }
+
+        meshlet.center = (min + max) * 0.5f;
+        meshlet.radius = 0.f;
+        for (uint32_t i = begin; i < end; ++i)
+            meshlet.radius = std::max(meshlet.radius, glm::length(vertices[indices[i]].pos - meshlet.center));
+
+        // Normal cone, as meshoptimizer's meshopt_computeClusterBounds: axis is the average of triangle normals,
+        // cutoff comes from the widest normal and the apex sits behind every triangle plane.
+        meshlet.cone_axis = glm::vec3(0.f);
+        meshlet.cone_cutoff = 1.f;
+        meshlet.cone_apex = meshlet.center;
+
+        glm::vec3 normals[MAX_TRIANGLES];
+        uint32_t corners[MAX_TRIANGLES];
+        uint32_t normal_count = 0;
+
+        glm::vec3 axis = glm::vec3(0.f);
+        for (uint32_t i = begin; i + 2 < end && normal_count < MAX_TRIANGLES; i += 3)
+        {
+            const glm::vec3& a = vertices[indices[i]].pos;
+            glm::vec3 normal = glm::cross(vertices[indices[i + 1]].pos - a, vertices[indices[i + 2]].pos - a);
+            float length = glm::length(normal);
+            if (length <= 0.f)
+                continue;
+
+            normals[normal_count] = normal / length;
+            corners[normal_count++] = indices[i];
+            axis += normal / length;
+        }
+
+        float axis_length = glm::length(axis);
+        // Larger meshlets than built here are left without a cone.
+        if (axis_length <= 0.f || end - begin > MAX_TRIANGLES * 3)
+            return;
+
+        axis /= axis_length;
+        meshlet.cone_axis = axis;
+
+        float min_dot = 1.f;
+        for (uint32_t i = 0; i < normal_count; ++i)
+            min_dot = std::min(min_dot, glm::dot(normals[i], axis));
+
+        // Normals spread over a half space: some triangle always faces the eye, keep cutoff at 1 (never culled).
+        if (min_dot <= 0.f)
+            return;
+
+        float max_t = 0.f;
+        for (uint32_t i = 0; i < normal_count; ++i)
+            max_t = std::max(max_t, glm::dot(meshlet.center - vertices[corners[i]].pos, normals[i]) / glm::dot(normals[i], axis));
+
+        meshlet.cone_apex = meshlet.center - axis * max_t;
+        meshlet.cone_cutoff = std::sqrt(1.f - min_dot * min_dot);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef GYMNURE_MESHLETBUILDER_H
+#define GYMNURE_MESHLETBUILDER_H
+
+#include <vector>
+#include <cstdint>
+#include "ModelData.hpp"
+
+namespace Engine::Util
+{
+    static_assert(sizeof(Meshlet) == 64, "Meshlet must match the std430 layout of meshlet_cull_cs.glsl!");
+
+    /**
+     * Splits meshes in meshlets for cluster culling without mesh shaders: meshlets only group triangles, they are
+     * still drawn from the mesh index list.
+     * */
+    class MeshletBuilder
+    {
+
+    private:
+
+        static constexpr size_t BOUNDS_BATCH_SIZE = 256;
+
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets   = {};  // Triangles of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]].
+            std::vector<uint32_t> triangles = {};
+        };
+
+        static Adjacency buildAdjacency(const std::vector<uint32_t>& indices, size_t vertex_count);
+
+    public:
+
+        static constexpr uint32_t MAX_VERTICES  = 64;
+        static constexpr uint32_t MAX_TRIANGLES = 124;
+
+        MeshletBuilder() = delete;
+
+        /**
+         * Greedy clustering: each meshlet grows through the triangles sharing the most vertices with it, starting over
+         * from the next free triangle in index order. Reorders mesh.indexData so meshlets are contiguous.
+         * */
+        static void build(Mesh& mesh);
+
+        /**
+         * Bounding sphere and normal cone of 'meshlet' (whose index range must be set).
+         * */
+        static void computeBounds(Meshlet& meshlet, const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices);
+    };
+}
+
+#endif //GYMNURE_MESHLETBUILDER_H
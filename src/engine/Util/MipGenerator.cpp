@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstring>
+#include "MipGenerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GYMNURE_MIP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Engine::Util
+{
+    uint32_t MipGenerator::getMipLevelCount(uint32_t width, uint32_t height)
+    {
+        uint32_t size = std::max(width, height);
+        uint32_t levels = 1;
+        while (size > 1) {
+            size >>= 1u;
+            levels++;
+        }
+
+        return levels;
+    }
+
+    size_t MipGenerator::getChainSize(const std::vector<MipLevel>& levels)
+    {
+        size_t size = 0;
+        for (const auto& level : levels)
+            size = std::max(size, level.offset + level.size);
+
+        return size;
+    }
+
+    std::vector<uint8_t> MipGenerator::generate(const uint8_t* pixels, uint32_t width, uint32_t height, std::vector<MipLevel>& levels)
+    {
+        uint32_t level_count = getMipLevelCount(width, height);
+
+        levels.clear();
+        levels.reserve(level_count);
+
+        size_t chain_size = 0;
+        for (uint32_t i = 0, w = width, h = height; i < level_count; ++i)
+        {
+            size_t level_size = static_cast<size_t>(w) * h * 4;
+            levels.push_back(MipLevel{w, h, chain_size, level_size});
+            chain_size += level_size;
+            w = std::max(1u, w / 2);
+            h = std::max(1u, h / 2);
+        }
+
+        std::vector<uint8_t> chain(chain_size);
+        std::memcpy(chain.data(), pixels, static_cast<size_t>(width) * height * 4);
+
+        for (uint32_t i = 1; i < level_count; ++i)
+        {
+            const MipLevel& src = levels[i - 1];
+            downsample(chain.data() + src.offset, src.width, src.height, chain.data() + levels[i].offset);
+        }
+
+        return chain;
+    }
+
+    void MipGenerator::downsample(const uint8_t* src, uint32_t src_width, uint32_t src_height, uint8_t* dst)
+    {
+        uint32_t dst_width  = std::max(1u, src_width / 2);
+        uint32_t dst_height = std::max(1u, src_height / 2);
+        size_t   src_pitch  = static_cast<size_t>(src_width) * 4;
+
+        for (uint32_t y = 0; y < dst_height; ++y)
+        {
+            const uint8_t* row0 = src + std::min(2 * y, src_height - 1) * src_pitch;
+            const uint8_t* row1 = src + std::min(2 * y + 1, src_height - 1) * src_pitch;
+            uint8_t* out = dst + static_cast<size_t>(y) * dst_width * 4;
+
+            uint32_t x = 0;
+
+#ifdef GYMNURE_MIP_SSE2
+            // Two output pixels (four source columns) per iteration.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(2);
+            for (; 2 * x + 3 < src_width && x + 1 < dst_width; x += 2)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+                // Vertical sums, 16 bits per channel: [p0 p1] and [p2 p3].
+                __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                // Horizontal sums: p0 + p1 and p2 + p3.
+                lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+                __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, zero));
+            }
+#endif
+
+            for (; x < dst_width; ++x)
+            {
+                size_t x0 = static_cast<size_t>(std::min(2 * x, src_width - 1)) * 4;
+                size_t x1 = static_cast<size_t>(std::min(2 * x + 1, src_width - 1)) * 4;
+
+                for (uint32_t c = 0; c < 4; ++c)
+                    out[x * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2u);
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef GYMNURE_MIPGENERATOR_H
+#define GYMNURE_MIPGENERATOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Engine::Util
+{
+    struct MipLevel
+    {
+        uint32_t width  = 0;
+        uint32_t height = 0;
+        size_t   offset = 0; // Byte offset inside the chain.
+        size_t   size   = 0; // Bytes of this level.
+    };
+
+    /**
+     * CPU mip chain for RGBA8 images, used where the GPU cannot blit the format.
+     * */
+    class MipGenerator
+    {
+    public:
+
+        MipGenerator() = delete;
+
+        static uint32_t getMipLevelCount(uint32_t width, uint32_t height);
+
+        /**
+         * Bytes spanned by 'levels', whatever their order in memory.
+         * */
+        static size_t getChainSize(const std::vector<MipLevel>& levels);
+
+        /**
+         * Full chain with level 0 included, levels tightly packed one after another.
+         * */
+        static std::vector<uint8_t> generate(const uint8_t* pixels, uint32_t width, uint32_t height, std::vector<MipLevel>& levels);
+
+        /**
+         * 2x2 box filter into a max(1, width/2) x max(1, height/2) image. Odd edges are clamped.
+         * */
+        static void downsample(const uint8_t* src, uint32_t src_width, uint32_t src_height, uint8_t* dst);
+    };
+}
+
+#endif //GYMNURE_MIPGENERATOR_H
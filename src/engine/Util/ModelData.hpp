@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -18,21 +19,63 @@ namespace Engine
         glm::vec2 uv;
         glm::vec3 normal;
         glm::vec4 color;
+        glm::vec4 tangent; // w is the bitangent sign, see TangentSpace.
 
         bool operator==(const VertexData &other) const {
-            return pos == other.pos && uv == other.uv;
+            return pos == other.pos && uv == other.uv && normal == other.normal && color == other.color && tangent == other.tangent;
         }
     };
 
     struct Material
     {
         std::string texture_path;
+        // Encoded image stored inside the model file (glTF), texture_path then only names it.
+        std::shared_ptr<std::vector<uint8_t>> texture_bytes;
+    };
+
+    struct Bounds
+    {
+        glm::vec3 min    = glm::vec3(0.f);
+        glm::vec3 max    = glm::vec3(0.f);
+        glm::vec3 center = glm::vec3(0.f);
+        float     radius = 0.f;
+    };
+
+    struct MeshLod
+    {
+        std::shared_ptr<std::vector<uint32_t>> indexData;
+        float error; // Object space distance vertices were moved by.
+    };
+
+    /**
+     * At most MeshletBuilder::MAX_VERTICES vertices and MAX_TRIANGLES triangles, contiguous in Mesh::indexData.
+     * std430 layout, uploaded as is for GPU culling (see meshlet_cull_cs.glsl).
+     * */
+    struct Meshlet
+    {
+        glm::vec3   center          = glm::vec3(0.f);   // Bounding sphere.
+        float       radius          = 0.f;
+        glm::vec3   cone_axis       = glm::vec3(0.f);   // Every triangle faces away from the eye when
+        float       cone_cutoff     = 1.f;              // dot(normalize(cone_apex - eye), cone_axis) >= cone_cutoff.
+        glm::vec3   cone_apex       = glm::vec3(0.f);
+        uint32_t    index_offset    = 0;
+        uint32_t    index_count     = 0;
+        uint32_t    vertex_count    = 0;
+        uint32_t    padding[2]      = {};
     };
 
     struct Mesh
     {
         std::shared_ptr<std::vector<VertexData>> vertexData;
+        std::shared_ptr<std::vector<uint32_t>> indexData;
         std::shared_ptr<Material> material;
+        // Coarser index lists over the same vertexData, indexData is LOD 0. Filled by the cooker.
+        std::vector<MeshLod> lods;
+        // Clusters of indexData (LOD 0). Filled at load time by MeshletBuilder.
+        std::vector<Meshlet> meshlets;
+        Bounds bounds;
+        // UV units per object space unit, picks the texture levels to stream (see Descriptors::TextureStreamer).
+        float uv_density = 0.f;
     };
 
     struct Model
@@ -45,7 +88,8 @@ template<> struct std::hash<Engine::VertexData>
 {
     size_t operator()(Engine::VertexData const& vertex) const
     {
-        return std::hash<glm::vec3>()(vertex.pos) ^ (std::hash<glm::vec2>()(vertex.uv) << 1);
+        return std::hash<glm::vec3>()(vertex.pos) ^ (std::hash<glm::vec2>()(vertex.uv) << 1) ^ (std::hash<glm::vec3>()(vertex.normal) << 2)
+             ^ (std::hash<glm::vec4>()(vertex.color) << 3) ^ (std::hash<glm::vec4>()(vertex.tangent) << 4);
     }
 };
 
@@ -1,40 +1,560 @@
 #include "ModelDataLoader.h"
-#include <iostream>
+#include <chrono>
+#include <Util/Debug.hpp>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include "CookedAsset.h"
+#include "Json.h"
+#include "MappedFile.h"
+#include "MeshFile.h"
+#include "Process.h"
+#include "TangentSpace.h"
+#include "ThreadPool.h"
 #include <OpenFBX/src/ofbx.h>
+#include <glm/gtc/quaternion.hpp>
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tinyobjloader/tiny_obj_loader.h>
 
 namespace Engine::Util
 {
+    namespace
+    {
+        enum PlyType
+        {
+            PLY_INVALID,
+            PLY_INT8,
+            PLY_UINT8,
+            PLY_INT16,
+            PLY_UINT16,
+            PLY_INT32,
+            PLY_UINT32,
+            PLY_FLOAT32,
+            PLY_FLOAT64,
+        };
+
+        struct PlyProperty
+        {
+            std::string name        = {};
+            PlyType     type        = PLY_INVALID;
+            PlyType     count_type  = PLY_INVALID;  // Set for list properties.
+            int32_t     target      = -1;           // Float slot in a decoded vertex, see PLY_VERTEX_SLOTS.
+        };
+
+        struct PlyElement
+        {
+            std::string                 name        = {};
+            size_t                      count       = 0;
+            std::vector<PlyProperty>    properties  = {};
+        };
+
+        // Vertex property names by float slot: position, texture coordinates, normal, color.
+        const std::vector<std::vector<std::string_view>> PLY_VERTEX_SLOTS =
+        {
+            {"x"}, {"y"}, {"z"},
+            {"s", "u", "texture_u", "texture_s"}, {"t", "v", "texture_v", "texture_t"},
+            {"nx"}, {"ny"}, {"nz"},
+            {"red", "r"}, {"green", "g"}, {"blue", "b"}, {"alpha", "a"},
+        };
+
+        enum : int32_t { SLOT_UV = 3, SLOT_NORMAL = 5, SLOT_COLOR = 8, SLOT_COUNT = 12 };
+
+        PlyType parsePlyType(std::string_view name)
+        {
+            if (name == "char"   || name == "int8")     return PLY_INT8;
+            if (name == "uchar"  || name == "uint8")    return PLY_UINT8;
+            if (name == "short"  || name == "int16")    return PLY_INT16;
+            if (name == "ushort" || name == "uint16")   return PLY_UINT16;
+            if (name == "int"    || name == "int32")    return PLY_INT32;
+            if (name == "uint"   || name == "uint32")   return PLY_UINT32;
+            if (name == "float"  || name == "float32")  return PLY_FLOAT32;
+            if (name == "double" || name == "float64")  return PLY_FLOAT64;
+            return PLY_INVALID;
+        }
+
+        size_t plyTypeSize(PlyType type)
+        {
+            switch (type)
+            {
+                case PLY_INT8:    case PLY_UINT8:   return 1;
+                case PLY_INT16:   case PLY_UINT16:  return 2;
+                case PLY_INT32:   case PLY_UINT32:  case PLY_FLOAT32: return 4;
+                case PLY_FLOAT64: return 8;
+                default:          return 0;
+            }
+        }
+
+        template <class T>
+        T loadScalar(const uint8_t* ptr, bool swap)
+        {
+            uint8_t bytes[sizeof(T)];
+            std::memcpy(bytes, ptr, sizeof(T));
+            if (swap)
+                std::reverse(bytes, bytes + sizeof(T));
+
+            T value;
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+
+        double loadPlyValue(const uint8_t* ptr, PlyType type, bool swap)
+        {
+            switch (type)
+            {
+                case PLY_INT8:    return static_cast<int8_t>(*ptr);
+                case PLY_UINT8:   return *ptr;
+                case PLY_INT16:   return loadScalar<int16_t>(ptr, swap);
+                case PLY_UINT16:  return loadScalar<uint16_t>(ptr, swap);
+                case PLY_INT32:   return loadScalar<int32_t>(ptr, swap);
+                case PLY_UINT32:  return loadScalar<uint32_t>(ptr, swap);
+                case PLY_FLOAT32: return loadScalar<float>(ptr, swap);
+                case PLY_FLOAT64: return loadScalar<double>(ptr, swap);
+                default:          return 0.0;
+            }
+        }
+
+        /**
+         * Whitespace separated tokens of ASCII PLY/STL bodies.
+         * */
+        class TextReader
+        {
+            const char* ptr_;
+            const char* end_;
+
+        public:
+
+            TextReader(const char* begin, const char* end) : ptr_(begin), end_(end) {}
+
+            std::string_view next()
+            {
+                while (ptr_ < end_ && std::isspace(static_cast<unsigned char>(*ptr_))) ++ptr_;
+                const char* start = ptr_;
+                while (ptr_ < end_ && !std::isspace(static_cast<unsigned char>(*ptr_))) ++ptr_;
+                return {start, static_cast<size_t>(ptr_ - start)};
+            }
+
+            bool nextNumber(double& value)
+            {
+                std::string_view token = next();
+                return !token.empty() && std::from_chars(token.data(), token.data() + token.size(), value).ec == std::errc();
+            }
+
+            [[nodiscard]] bool done() const { return ptr_ >= end_; }
+            [[nodiscard]] size_t remaining() const { return static_cast<size_t>(end_ - ptr_); }
+        };
+
+        /**
+         * Fan-triangulate one polygon into 'indices', dropping polygons that reference missing vertices.
+         * */
+        void addPolygon(const uint32_t* polygon, size_t corner_count, size_t vertex_count, std::vector<uint32_t>& indices)
+        {
+            for (size_t k = 0; k < corner_count; ++k)
+                if (polygon[k] >= vertex_count)
+                    return;
+
+            for (size_t k = 2; k < corner_count; ++k) {
+                indices.push_back(polygon[0]);
+                indices.push_back(polygon[k - 1]);
+                indices.push_back(polygon[k]);
+            }
+        }
+
+        /**
+         * Byte offset of 'count' consecutive float slots in a vertex item, or -1 when they are stored otherwise.
+         * */
+        int64_t plyFloatRange(const std::vector<int64_t>& slot_offsets, int32_t first_slot, int32_t count)
+        {
+            for (int32_t i = 0; i < count; ++i)
+                if (slot_offsets[first_slot + i] < 0 || slot_offsets[first_slot + i] != slot_offsets[first_slot] + i * 4)
+                    return -1;
+            return slot_offsets[first_slot];
+        }
+
+        VertexData makePlyVertex(const float* slots, bool has_uv)
+        {
+            VertexData vertex = {};
+            vertex.pos    = glm::vec3(slots[0], slots[1], slots[2]);
+            vertex.uv     = has_uv ? glm::vec2(slots[SLOT_UV], 1.0f - slots[SLOT_UV + 1]) : glm::vec2(0.0f);
+            vertex.normal = glm::vec3(slots[SLOT_NORMAL], slots[SLOT_NORMAL + 1], slots[SLOT_NORMAL + 2]);
+            vertex.color  = glm::vec4(slots[SLOT_COLOR], slots[SLOT_COLOR + 1], slots[SLOT_COLOR + 2], slots[SLOT_COLOR + 3]);
+            return vertex;
+        }
+
+        // glTF 2.0 constants, binary data is always little endian.
+        constexpr uint32_t GLB_MAGIC        = 0x46546C67; // "glTF"
+        constexpr uint32_t GLB_CHUNK_JSON   = 0x4E4F534A;
+        constexpr uint32_t GLB_CHUNK_BIN    = 0x004E4942;
+
+        enum GltfComponentType : int64_t
+        {
+            GLTF_BYTE           = 5120,
+            GLTF_UNSIGNED_BYTE  = 5121,
+            GLTF_SHORT          = 5122,
+            GLTF_UNSIGNED_SHORT = 5123,
+            GLTF_UNSIGNED_INT   = 5125,
+            GLTF_FLOAT          = 5126
+        };
+
+        enum GltfMode : int64_t
+        {
+            GLTF_TRIANGLES      = 4,
+            GLTF_TRIANGLE_STRIP = 5,
+            GLTF_TRIANGLE_FAN   = 6
+        };
+
+        /**
+         * Accessor resolved to its bytes, pointing into the mapped file or a decoded buffer.
+         * */
+        struct GltfAccessor
+        {
+            const uint8_t*  data            = nullptr;
+            size_t          count           = 0;
+            size_t          stride          = 0;
+            int64_t         component_type  = 0;
+            uint32_t        components      = 0;
+            bool            normalized      = false;
+        };
+
+        struct GltfDraw
+        {
+            const JsonValue*    primitive = nullptr;
+            glm::mat4           transform = glm::mat4(1.0f);
+        };
+
+        size_t gltfComponentSize(int64_t component_type)
+        {
+            switch (component_type)
+            {
+                case GLTF_BYTE:  case GLTF_UNSIGNED_BYTE:  return 1;
+                case GLTF_SHORT: case GLTF_UNSIGNED_SHORT: return 2;
+                case GLTF_UNSIGNED_INT: case GLTF_FLOAT:   return 4;
+                default:                                   return 0;
+            }
+        }
+
+        uint32_t gltfComponentCount(const std::string& type)
+        {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2")   return 2;
+            if (type == "VEC3")   return 3;
+            if (type == "VEC4")   return 4;
+            return 0;
+        }
+
+        bool getGltfAccessor(const JsonValue& gltf, const std::vector<std::span<const uint8_t>>& buffers, const JsonValue& index, GltfAccessor& accessor)
+        {
+            if (!index.isNumber())
+                return false;
+
+            const JsonValue& description = gltf["accessors"][static_cast<size_t>(index.getInt())];
+            const JsonValue& view = gltf["bufferViews"][static_cast<size_t>(description["bufferView"].getInt(-1))];
+
+            // Sparse accessors and accessors without view (all zeros) are not supported.
+            if (view.isNull() || description.contains("sparse"))
+                return false;
+
+            auto buffer = static_cast<size_t>(view["buffer"].getInt(-1));
+            if (buffer >= buffers.size())
+                return false;
+
+            accessor.component_type = description["componentType"].getInt();
+            accessor.components     = gltfComponentCount(description["type"].getString());
+            accessor.count          = static_cast<size_t>(description["count"].getInt());
+            accessor.normalized     = description["normalized"].getBool();
+
+            size_t element_size = gltfComponentSize(accessor.component_type) * accessor.components;
+            accessor.stride = static_cast<size_t>(view["byteStride"].getInt(0));
+            if (accessor.stride == 0)
+                accessor.stride = element_size;
+
+            auto view_offset     = static_cast<size_t>(view["byteOffset"].getInt(0));
+            auto view_length     = static_cast<size_t>(view["byteLength"].getInt(0));
+            auto accessor_offset = static_cast<size_t>(description["byteOffset"].getInt(0));
+
+            if (element_size == 0 || view_offset > buffers[buffer].size() || view_length > buffers[buffer].size() - view_offset)
+                return false;
+            if (accessor.count > view_length || (accessor.count > 0 && accessor_offset + accessor.stride * (accessor.count - 1) + element_size > view_length))
+                return false;
+
+            accessor.data = buffers[buffer].data() + view_offset + accessor_offset;
+            return true;
+        }
+
+        float loadGltfComponent(const uint8_t* ptr, int64_t component_type, bool normalized, bool swap)
+        {
+            switch (component_type)
+            {
+                case GLTF_BYTE: {
+                    auto value = static_cast<float>(static_cast<int8_t>(*ptr));
+                    return normalized ? std::max(value / 127.0f, -1.0f) : value;
+                }
+                case GLTF_UNSIGNED_BYTE:
+                    return normalized ? *ptr / 255.0f : *ptr;
+                case GLTF_SHORT: {
+                    auto value = static_cast<float>(loadScalar<int16_t>(ptr, swap));
+                    return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+                }
+                case GLTF_UNSIGNED_SHORT: {
+                    auto value = static_cast<float>(loadScalar<uint16_t>(ptr, swap));
+                    return normalized ? value / 65535.0f : value;
+                }
+                case GLTF_UNSIGNED_INT:
+                    return static_cast<float>(loadScalar<uint32_t>(ptr, swap));
+                case GLTF_FLOAT:
+                    return loadScalar<float>(ptr, swap);
+                default:
+                    return 0.0f;
+            }
+        }
+
+        /**
+         * Gather an attribute into one VertexData member ('dst' points at it in the first vertex).
+         * Float data is copied element by element, other component types are converted in the same pass.
+         * */
+        void readGltfAttribute(const GltfAccessor& accessor, float* dst, uint32_t dst_components)
+        {
+            const size_t dst_stride = sizeof(VertexData) / sizeof(float);
+            const uint32_t components = std::min(accessor.components, dst_components);
+            const bool swap = std::endian::native != std::endian::little;
+
+            if (accessor.component_type == GLTF_FLOAT && !swap)
+            {
+                for (size_t i = 0; i < accessor.count; ++i)
+                    std::memcpy(dst + i * dst_stride, accessor.data + i * accessor.stride, components * sizeof(float));
+                return;
+            }
+
+            const size_t component_size = gltfComponentSize(accessor.component_type);
+            for (size_t i = 0; i < accessor.count; ++i)
+                for (uint32_t c = 0; c < components; ++c)
+                    dst[i * dst_stride + c] = loadGltfComponent(accessor.data + i * accessor.stride + c * component_size,
+                                                                accessor.component_type, accessor.normalized, swap);
+        }
+
+        bool readGltfIndices(const GltfAccessor& accessor, std::vector<uint32_t>& indices)
+        {
+            const bool swap = std::endian::native != std::endian::little;
+            if (accessor.components != 1)
+                return false;
+
+            indices.resize(accessor.count);
+
+            // Tightly packed 32 bit indices are the index buffer already.
+            if (accessor.component_type == GLTF_UNSIGNED_INT && accessor.stride == sizeof(uint32_t) && !swap)
+            {
+                std::memcpy(indices.data(), accessor.data, indices.size() * sizeof(uint32_t));
+                return true;
+            }
+
+            for (size_t i = 0; i < accessor.count; ++i)
+            {
+                const uint8_t* ptr = accessor.data + i * accessor.stride;
+                switch (accessor.component_type)
+                {
+                    case GLTF_UNSIGNED_BYTE:  indices[i] = *ptr; break;
+                    case GLTF_UNSIGNED_SHORT: indices[i] = loadScalar<uint16_t>(ptr, swap); break;
+                    case GLTF_UNSIGNED_INT:   indices[i] = loadScalar<uint32_t>(ptr, swap); break;
+                    default:                  return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Triangle list of a triangles/strip/fan primitive, dropping triangles that reference missing vertices.
+         * 'flip' reverses the winding (mirroring transforms).
+         * */
+        std::vector<uint32_t> triangulateGltf(int64_t mode, const std::vector<uint32_t>& indices, size_t vertex_count, bool flip)
+        {
+            std::vector<uint32_t> triangles = {};
+            triangles.reserve(mode == GLTF_TRIANGLES ? indices.size() : indices.size() * 3);
+
+            auto addTriangle = [&](uint32_t a, uint32_t b, uint32_t c)
+            {
+                if (a >= vertex_count || b >= vertex_count || c >= vertex_count)
+                    return;
+
+                triangles.push_back(a);
+                triangles.push_back(flip ? c : b);
+                triangles.push_back(flip ? b : c);
+            };
+
+            if (mode == GLTF_TRIANGLES)
+                for (size_t i = 0; i + 2 < indices.size(); i += 3)
+                    addTriangle(indices[i], indices[i + 1], indices[i + 2]);
+            else if (mode == GLTF_TRIANGLE_STRIP)
+                for (size_t i = 2; i < indices.size(); ++i) {
+                    if (i % 2 == 0)
+                        addTriangle(indices[i - 2], indices[i - 1], indices[i]);
+                    else
+                        addTriangle(indices[i - 1], indices[i - 2], indices[i]);
+                }
+            else if (mode == GLTF_TRIANGLE_FAN)
+                for (size_t i = 2; i < indices.size(); ++i)
+                    addTriangle(indices[0], indices[i - 1], indices[i]);
+
+            return triangles;
+        }
+
+        glm::mat4 getGltfLocalTransform(const JsonValue& node)
+        {
+            glm::mat4 transform = glm::mat4(1.0f);
+
+            const JsonValue& matrix = node["matrix"];
+            if (matrix.size() == 16)
+            {
+                // Column major, as glm.
+                for (glm::length_t column = 0; column < 4; ++column)
+                    for (glm::length_t row = 0; row < 4; ++row)
+                        transform[column][row] = static_cast<float>(matrix[static_cast<size_t>(column * 4 + row)].getNumber());
+                return transform;
+            }
+
+            const JsonValue& t = node["translation"];
+            const JsonValue& r = node["rotation"];
+            const JsonValue& s = node["scale"];
+
+            glm::vec3 translation = glm::vec3(t[0].getNumber(0.0), t[1].getNumber(0.0), t[2].getNumber(0.0));
+            glm::quat rotation    = glm::quat(static_cast<float>(r[3].getNumber(1.0)), static_cast<float>(r[0].getNumber(0.0)),
+                                              static_cast<float>(r[1].getNumber(0.0)), static_cast<float>(r[2].getNumber(0.0)));
+            glm::vec3 scale       = glm::vec3(s[0].getNumber(1.0), s[1].getNumber(1.0), s[2].getNumber(1.0));
+
+            return glm::translate(transform, translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+        }
+
+        /**
+         * Percent-decoded relative URI.
+         * */
+        std::string decodeUri(const std::string& uri)
+        {
+            std::string decoded = {};
+            for (size_t i = 0; i < uri.size(); ++i)
+            {
+                uint32_t code = 0;
+                if (uri[i] == '%' && i + 2 < uri.size() && std::from_chars(uri.data() + i + 1, uri.data() + i + 3, code, 16).ptr == uri.data() + i + 3) {
+                    decoded += static_cast<char>(code);
+                    i += 2;
+                } else {
+                    decoded += uri[i];
+                }
+            }
+            return decoded;
+        }
+
+        /**
+         * Payload of a base64 "data:" URI.
+         * */
+        bool decodeDataUri(const std::string& uri, std::vector<uint8_t>& out)
+        {
+            size_t comma = uri.find(',');
+            if (uri.compare(0, 5, "data:") != 0 || comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos)
+                return false;
+
+            uint32_t accumulator = 0;
+            int32_t bits = 0;
+            for (size_t i = comma + 1; i < uri.size() && uri[i] != '='; ++i)
+            {
+                char c = uri[i];
+                int32_t value = c >= 'A' && c <= 'Z' ? c - 'A' :
+                                c >= 'a' && c <= 'z' ? c - 'a' + 26 :
+                                c >= '0' && c <= '9' ? c - '0' + 52 :
+                                c == '+' ? 62 : c == '/' ? 63 : -1;
+                if (value < 0)
+                    return false;
+
+                accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+                bits += 6;
+                if (bits >= 8) {
+                    bits -= 8;
+                    out.push_back(static_cast<uint8_t>(accumulator >> bits));
+                }
+            }
+            return true;
+        }
+
+        void logLoaded(const std::string& model_path, const Model& model, std::chrono::high_resolution_clock::time_point start)
+        {
+            auto end = std::chrono::high_resolution_clock::now();
+            size_t vertex_count = 0, index_count = 0;
+            for (const auto& mesh : *model.meshes) {
+                vertex_count += mesh->vertexData->size();
+                index_count  += mesh->indexData->size();
+            }
+
+            Debug::logInfo("Loaded " + model_path + ": " + std::to_string(model.meshes->size()) + " meshes, " +
+                std::to_string(vertex_count) + " vertices, " + std::to_string(index_count) + " indices in " +
+                std::to_string(std::chrono::duration<double, std::milli>(end - start).count()) + "ms (peak RSS: " +
+                std::to_string(Process::getPeakRSS() / (1024 * 1024)) + "MB)");
+        }
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::LoadModelData(const std::string& model_path)
+    {
+        std::string extension = std::filesystem::path(model_path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+
+        if (extension == ".obj")
+            return LoadOBJData(model_path, std::filesystem::path(model_path).parent_path().string() + "/");
+        if (extension == ".fbx")
+            return LoadFBXData(model_path);
+        if (extension == ".ply")
+            return LoadPLYData(model_path);
+        if (extension == ".stl")
+            return LoadSTLData(model_path);
+        if (extension == ".glb" || extension == ".gltf")
+            return LoadGLTFData(model_path);
+
+        return nullptr;
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::LoadCookedData(const std::string& model_path)
+    {
+        CookedData cooked = CookedAsset::load(model_path, ".gmesh");
+        if (!cooked)
+            return nullptr;
+
+        return MeshFile::read(cooked.bytes);
+    }
+
     std::unique_ptr<Model> ModelDataLoader::LoadFBXData(const std::string& model_path)
     {
-        auto assets_texture_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + model_path;
+        auto start = std::chrono::high_resolution_clock::now();
+        auto assets_model_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + model_path;
 
-        FILE* fp = std::fopen(assets_texture_path.c_str(), "rb");
-        if (!fp) { return nullptr; }
+        ofbx::IScene* g_scene = nullptr;
+        {
+            MappedFile file(assets_model_path);
+            if (!file.isOpen()) { return nullptr; }
 
-        fseek(fp, 0, SEEK_END);
-        long file_size = ftell(fp);
-        fseek(fp, 0, SEEK_SET);
-        auto* content = new ofbx::u8[file_size];
-        fread(content, 1, file_size, fp);
+            // OpenFBX keeps its own copy of the data, file is unmapped at the end of this scope.
+            g_scene = ofbx::load((ofbx::u8*)file.data(), static_cast<int>(file.size()), (ofbx::u64)ofbx::LoadFlags::TRIANGULATE);
+        }
+        if (g_scene == nullptr) { return nullptr; }
 
-        auto g_scene = ofbx::load((ofbx::u8*)content, file_size, (ofbx::u64)ofbx::LoadFlags::TRIANGULATE);
+        auto mesh_count = static_cast<size_t>(g_scene->getMeshCount());
+        auto meshes = std::make_unique<std::vector<std::shared_ptr<Mesh>>>(mesh_count);
 
-        auto meshes = std::make_unique<std::vector<std::shared_ptr<Mesh>>>();
-        for (int i = 0; i < g_scene->getMeshCount(); ++i)
+        ThreadPool::getInstance()->parallelFor(mesh_count, [g_scene, &meshes](size_t i)
         {
-            const ofbx::Mesh& mesh = *g_scene->getMesh(i);
+            const ofbx::Mesh& mesh = *g_scene->getMesh(static_cast<int>(i));
             const ofbx::Geometry& geom = *mesh.getGeometry();
             const ofbx::Vec3* normals = geom.getNormals();
             const ofbx::Vec2* uvs = geom.getUVs();
+            const ofbx::Vec4* colors = geom.getColors();
             const ofbx::Vec3* vertices = geom.getVertices();
 
-            std::unique_ptr<Mesh> mesh_1 = std::make_unique<Mesh>();
-            mesh_1->vertexData = std::make_shared<std::vector<VertexData>>();
-            for (int k = 0; k < geom.getIndexCount(); ++k)
+            // Triangulated geometry comes unindexed, one vertex per index.
+            std::vector<VertexData> unindexed_data(static_cast<size_t>(geom.getIndexCount()));
+            for (size_t k = 0; k < unindexed_data.size(); ++k)
             {
-                VertexData vd{};
+                VertexData& vd = unindexed_data[k];
                 vd.pos = glm::vec3(vertices[k].x, vertices[k].y, vertices[k].z);
                 if (normals != nullptr) {
                     vd.normal = glm::vec3(normals[k].x, normals[k].y, normals[k].z);
@@ -42,40 +562,71 @@ namespace Engine::Util
                 if (uvs != nullptr) {
                     vd.uv = glm::vec2(uvs[k].x, uvs[k].y);
                 }
-
-                mesh_1->vertexData->push_back(vd);
+                vd.color = colors != nullptr ? glm::vec4(colors[k].x, colors[k].y, colors[k].z, colors[k].w) : glm::vec4(1.0f);
             }
 
-            std::unique_ptr<Material> mat_1 = std::make_unique<Material>();
+            std::shared_ptr<Mesh> mesh_1 = WeldVertices(unindexed_data);
+
+            std::shared_ptr<Material> mat_1 = std::make_shared<Material>();
             for (int j = 0; j < mesh.getMaterialCount(); ++j)
             {
                 const ofbx::Material& mat = *mesh.getMaterial(j);
-                const ofbx::Texture& texture_diff = *mat.getTexture(ofbx::Texture::TextureType::DIFFUSE);
-
-                std::cout << mesh.name << std::endl;
-                std::cout << mesh.id << std::endl;
+                const ofbx::Texture* texture_diff = mat.getTexture(ofbx::Texture::TextureType::DIFFUSE);
+                if (texture_diff == nullptr)
+                    continue;
 
                 char texture_path[255];
-                texture_diff.getRelativeFileName().toString(texture_path);
+                texture_diff->getRelativeFileName().toString(texture_path);
 
                 mat_1->texture_path = texture_path;
             }
 
             mesh_1->material = std::move(mat_1);
-            meshes->push_back(std::move(mesh_1));
-        }
+
+            if (normals == nullptr)
+                TangentSpace::generateNormals(*mesh_1);
+            TangentSpace::generateTangents(*mesh_1);
+
+            (*meshes)[i] = std::move(mesh_1);
+        });
+
+        // Release parsed scene as soon as it's converted.
+        g_scene->destroy();
 
         std::unique_ptr<Model> model = std::make_unique<Model>();
         model->meshes = std::move(meshes);
 
-        return std::move(model);
+        logLoaded(model_path, *model, start);
+
+        return model;
     }
 
-    std::unique_ptr<Model> ModelDataLoader::LoadOBJData(const std::string& model_path, const std::string& obj_mtl)
+    std::shared_ptr<Mesh> ModelDataLoader::WeldVertices(const std::vector<VertexData>& unindexed_data)
     {
-        std::vector <VertexData> vertex_data = {};
-        std::vector <uint32_t> index_data = {};
+        auto mesh = std::make_shared<Mesh>();
+        mesh->vertexData = std::make_shared<std::vector<VertexData>>();
+        mesh->indexData  = std::make_shared<std::vector<uint32_t>>();
+        mesh->indexData->reserve(unindexed_data.size());
+
+        std::unordered_map<VertexData, uint32_t> unique_vertices = {};
+        unique_vertices.reserve(unindexed_data.size());
+
+        for (const auto& vertex : unindexed_data)
+        {
+            auto [it, inserted] = unique_vertices.try_emplace(vertex, static_cast<uint32_t>(mesh->vertexData->size()));
+            if (inserted)
+                mesh->vertexData->push_back(vertex);
 
+            mesh->indexData->push_back(it->second);
+        }
+
+        mesh->vertexData->shrink_to_fit();
+
+        return mesh;
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::LoadOBJData(const std::string& model_path, const std::string& obj_mtl)
+    {
         auto assets_model_path = std::string(ASSETS_FOLDER_PATH_STR) + "/" + model_path;
         auto assets_obj_mtl    = std::string(ASSETS_FOLDER_PATH_STR) + "/" + obj_mtl;
 
@@ -91,12 +642,15 @@ namespace Engine::Util
         }
 
         auto meshes = std::make_unique<std::vector<std::shared_ptr<Mesh>>>();
-        std::unordered_map<VertexData, uint32_t> uniqueVertices = {};
 
         for (const auto &shape : shapes)
         {
+            std::unordered_map<VertexData, uint32_t> uniqueVertices = {};
+            bool has_normals = true;
+
             std::unique_ptr<Mesh> mesh_1 = std::make_unique<Mesh>();
             mesh_1->vertexData = std::make_shared<std::vector<VertexData>>();
+            mesh_1->indexData  = std::make_shared<std::vector<uint32_t>>();
 
             for (const auto &index : shape.mesh.indices)
             {
@@ -117,17 +671,23 @@ namespace Engine::Util
                     index.normal_index > -1 ? attrib.normals[3 * index.normal_index + 2] : 1.0f
                 };
 
-                struct VertexData vertex = { pos, uv, normal };
+                has_normals &= index.normal_index > -1;
+
+                struct VertexData vertex = { pos, uv, normal, glm::vec4(1.0f) };
 
                 if (uniqueVertices.count(vertex) == 0)
                 {
-                    uniqueVertices[vertex] = static_cast<uint32_t>(vertex_data.size());
+                    uniqueVertices[vertex] = static_cast<uint32_t>(mesh_1->vertexData->size());
                     mesh_1->vertexData->push_back(vertex);
                 }
 
-                index_data.push_back(uniqueVertices[vertex]);
+                mesh_1->indexData->push_back(uniqueVertices[vertex]);
             }
 
+            if (!has_normals)
+                TangentSpace::generateNormals(*mesh_1);
+            TangentSpace::generateTangents(*mesh_1);
+
             meshes->push_back(std::move(mesh_1));
         }
 
@@ -136,4 +696,640 @@ namespace Engine::Util
 
         return model;
     }
-}
\ No newline at end of file
+
+    std::unique_ptr<Model> ModelDataLoader::LoadPLYData(const std::string& model_path)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        MappedFile file(std::string(ASSETS_FOLDER_PATH_STR) + "/" + model_path);
+        if (!file.isOpen()) { return nullptr; }
+
+        std::string_view contents(reinterpret_cast<const char*>(file.data()), file.size());
+        size_t header_end = contents.find("end_header");
+        if (contents.substr(0, 3) != "ply" || header_end == std::string_view::npos) { return nullptr; }
+
+        enum { PLY_ASCII, PLY_BINARY_LE, PLY_BINARY_BE } format = PLY_ASCII;
+        std::vector<PlyElement> elements = {};
+
+        for (size_t line_start = 0; line_start < header_end;)
+        {
+            size_t line_end = std::min(contents.find('\n', line_start), header_end);
+            TextReader words(contents.data() + line_start, contents.data() + line_end);
+            line_start = line_end + 1;
+
+            std::string_view keyword = words.next();
+            if (keyword == "format")
+            {
+                std::string_view name = words.next();
+                if (name == "binary_little_endian")     format = PLY_BINARY_LE;
+                else if (name == "binary_big_endian")   format = PLY_BINARY_BE;
+                else if (name != "ascii")               return nullptr;
+            }
+            else if (keyword == "element")
+            {
+                PlyElement element = {};
+                element.name = words.next();
+
+                // No item takes less than a byte, larger counts are corrupt.
+                double count = 0.0;
+                if (!words.nextNumber(count) || count < 0.0 || count > static_cast<double>(contents.size())) { return nullptr; }
+                element.count = static_cast<size_t>(count);
+
+                elements.push_back(std::move(element));
+            }
+            else if (keyword == "property" && !elements.empty())
+            {
+                PlyProperty property = {};
+                std::string_view type = words.next();
+                if (type == "list") {
+                    property.count_type = parsePlyType(words.next());
+                    property.type = parsePlyType(words.next());
+                    if (property.count_type == PLY_INVALID) { return nullptr; }
+                } else {
+                    property.type = parsePlyType(type);
+                }
+                property.name = words.next();
+
+                if (property.type == PLY_INVALID) { return nullptr; }
+                elements.back().properties.push_back(std::move(property));
+            }
+        }
+
+        // Map vertex properties to VertexData slots, colors are normalized from integer types.
+        size_t vertex_count = 0;
+        bool has_uv = false, has_normals = false;
+        std::vector<float> scales = {};
+
+        for (auto& element : elements)
+        {
+            if (element.name != "vertex")
+                continue;
+
+            vertex_count = element.count;
+            for (auto& property : element.properties)
+            {
+                for (size_t slot = 0; slot < PLY_VERTEX_SLOTS.size() && property.count_type == PLY_INVALID; ++slot)
+                    if (std::find(PLY_VERTEX_SLOTS[slot].begin(), PLY_VERTEX_SLOTS[slot].end(), property.name) != PLY_VERTEX_SLOTS[slot].end())
+                        property.target = static_cast<int32_t>(slot);
+
+                has_uv      |= property.target == SLOT_UV;
+                has_normals |= property.target == SLOT_NORMAL;
+
+                bool is_color = property.target >= SLOT_COLOR;
+                if (is_color && property.type == PLY_UINT8)         scales.push_back(1.0f / 255.0f);
+                else if (is_color && property.type == PLY_UINT16)   scales.push_back(1.0f / 65535.0f);
+                else                                                scales.push_back(1.0f);
+            }
+        }
+
+        auto mesh = std::make_shared<Mesh>();
+        mesh->vertexData = std::make_shared<std::vector<VertexData>>();
+        mesh->indexData  = std::make_shared<std::vector<uint32_t>>();
+        mesh->material   = std::make_shared<Material>();
+
+        auto& vertices = *mesh->vertexData;
+        auto& indices  = *mesh->indexData;
+
+        float slots[SLOT_COUNT] = {};
+        std::fill(slots + SLOT_COLOR, slots + SLOT_COUNT, 1.0f);
+
+        std::vector<uint32_t> polygon = {};
+        auto isFaceIndices = [](const PlyElement& element, const PlyProperty& property)
+        {
+            return element.name == "face" && (property.name == "vertex_indices" || property.name == "vertex_index");
+        };
+
+        size_t body_start = contents.find('\n', header_end) + 1;
+
+        if (format == PLY_ASCII)
+        {
+            TextReader reader(contents.data() + body_start, contents.data() + contents.size());
+
+            for (const auto& element : elements)
+            {
+                // Values take a character and a separator, bound the count before allocating.
+                if (element.count > (reader.remaining() + 1) / std::max<size_t>(element.properties.size() * 2, 1)) { return nullptr; }
+
+                bool is_vertex = element.name == "vertex";
+                if (is_vertex)
+                    vertices.resize(element.count);
+
+                for (size_t item = 0; item < element.count; ++item)
+                {
+                    for (size_t p = 0; p < element.properties.size(); ++p)
+                    {
+                        const PlyProperty& property = element.properties[p];
+                        double value = 0.0;
+
+                        if (property.count_type == PLY_INVALID) {
+                            if (!reader.nextNumber(value)) { return nullptr; }
+                            if (is_vertex && property.target >= 0)
+                                slots[property.target] = static_cast<float>(value) * scales[p];
+                            continue;
+                        }
+
+                        if (!reader.nextNumber(value) || value < 0.0 || value > static_cast<double>((reader.remaining() + 1) / 2)) { return nullptr; }
+                        polygon.resize(static_cast<size_t>(value));
+                        for (auto& index : polygon) {
+                            if (!reader.nextNumber(value)) { return nullptr; }
+                            index = static_cast<uint32_t>(value);
+                        }
+
+                        if (isFaceIndices(element, property))
+                            addPolygon(polygon.data(), polygon.size(), vertex_count, indices);
+                    }
+
+                    if (is_vertex)
+                        vertices[item] = makePlyVertex(slots, has_uv);
+                }
+            }
+        }
+        else
+        {
+            bool swap = (format == PLY_BINARY_LE) != (std::endian::native == std::endian::little);
+            const uint8_t* ptr = file.data() + body_start;
+            const uint8_t* end = file.data() + file.size();
+
+            for (const auto& element : elements)
+            {
+                bool fixed_size = std::all_of(element.properties.begin(), element.properties.end(),
+                                              [](const PlyProperty& property) { return property.count_type == PLY_INVALID; });
+
+                if (fixed_size)
+                {
+                    std::vector<size_t> offsets = {};
+                    size_t stride = 0;
+                    for (const auto& property : element.properties) {
+                        offsets.push_back(stride);
+                        stride += plyTypeSize(property.type);
+                    }
+
+                    if (stride != 0 && element.count > static_cast<size_t>(end - ptr) / stride) { return nullptr; }
+
+                    if (element.name == "vertex")
+                    {
+                        std::vector<int64_t> slot_offsets(SLOT_COUNT, -1);
+                        bool native_floats = !swap;
+                        for (size_t p = 0; p < element.properties.size(); ++p)
+                            if (element.properties[p].target >= 0) {
+                                slot_offsets[element.properties[p].target] = static_cast<int64_t>(offsets[p]);
+                                native_floats &= element.properties[p].type == PLY_FLOAT32 && element.properties[p].target < SLOT_COLOR;
+                            }
+
+                        int64_t pos_offset    = plyFloatRange(slot_offsets, 0, 3);
+                        int64_t normal_offset = has_normals ? plyFloatRange(slot_offsets, SLOT_NORMAL, 3) : 0;
+                        int64_t uv_offset     = has_uv ? plyFloatRange(slot_offsets, SLOT_UV, 2) : 0;
+
+                        vertices.resize(element.count);
+
+                        if (native_floats && pos_offset >= 0 && normal_offset >= 0 && uv_offset >= 0)
+                        {
+                            // Float x y z, nx ny nz and u v runs, the usual scanner output: copy them as they are.
+                            VertexData vertex = {};
+                            vertex.color = glm::vec4(1.0f);
+                            for (size_t v = 0; v < element.count; ++v, ptr += stride)
+                            {
+                                std::memcpy(&vertex.pos, ptr + pos_offset, sizeof(glm::vec3));
+                                if (has_normals)
+                                    std::memcpy(&vertex.normal, ptr + normal_offset, sizeof(glm::vec3));
+                                if (has_uv) {
+                                    std::memcpy(&vertex.uv, ptr + uv_offset, sizeof(glm::vec2));
+                                    vertex.uv.y = 1.0f - vertex.uv.y;
+                                }
+                                vertices[v] = vertex;
+                            }
+                        }
+                        else
+                        {
+                            // One pass over the vertex block, straight into VertexData.
+                            for (size_t v = 0; v < element.count; ++v, ptr += stride)
+                            {
+                                for (size_t p = 0; p < element.properties.size(); ++p)
+                                    if (element.properties[p].target >= 0)
+                                        slots[element.properties[p].target] = static_cast<float>(loadPlyValue(ptr + offsets[p], element.properties[p].type, swap)) * scales[p];
+
+                                vertices[v] = makePlyVertex(slots, has_uv);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        ptr += element.count * stride;
+                    }
+                    continue;
+                }
+
+                // Lists take at least their count.
+                size_t min_item_size = 0;
+                for (const auto& property : element.properties)
+                    min_item_size += plyTypeSize(property.count_type != PLY_INVALID ? property.count_type : property.type);
+                if (element.count > static_cast<size_t>(end - ptr) / min_item_size) { return nullptr; }
+
+                for (size_t item = 0; item < element.count; ++item)
+                {
+                    for (const auto& property : element.properties)
+                    {
+                        size_t count = 1;
+                        if (property.count_type != PLY_INVALID) {
+                            size_t count_size = plyTypeSize(property.count_type);
+                            if (static_cast<size_t>(end - ptr) < count_size) { return nullptr; }
+                            double list_count = loadPlyValue(ptr, property.count_type, swap);
+                            if (list_count < 0.0) { return nullptr; }
+                            count = static_cast<size_t>(list_count);
+                            ptr += count_size;
+                        }
+
+                        size_t type_size = plyTypeSize(property.type);
+                        if (static_cast<size_t>(end - ptr) < count * type_size) { return nullptr; }
+
+                        if (isFaceIndices(element, property)) {
+                            polygon.resize(count);
+                            for (size_t k = 0; k < count; ++k)
+                                polygon[k] = static_cast<uint32_t>(loadPlyValue(ptr + k * type_size, property.type, swap));
+                            addPolygon(polygon.data(), polygon.size(), vertex_count, indices);
+                        }
+
+                        ptr += count * type_size;
+                    }
+                }
+            }
+        }
+
+        if (vertices.size() != vertex_count) { return nullptr; }
+
+        if (!has_normals)
+            TangentSpace::generateNormals(*mesh);
+        TangentSpace::generateTangents(*mesh);
+
+        std::unique_ptr<Model> model = std::make_unique<Model>();
+        model->meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>(1, std::move(mesh));
+
+        logLoaded(model_path, *model, start);
+
+        return model;
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::LoadSTLData(const std::string& model_path)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        MappedFile file(std::string(ASSETS_FOLDER_PATH_STR) + "/" + model_path);
+        if (!file.isOpen()) { return nullptr; }
+
+        const size_t header_size = 80 + sizeof(uint32_t);
+        const size_t facet_size  = 12 * sizeof(float) + sizeof(uint16_t);
+
+        std::vector<VertexData> unindexed_data = {};
+        const VertexData default_vertex = { glm::vec3(0.0f), glm::vec2(0.0f), glm::vec3(0.0f), glm::vec4(1.0f) };
+
+        // Binary files may start with "solid" too, the size tells them apart.
+        bool swap = std::endian::native != std::endian::little;
+        uint32_t facet_count = file.size() >= header_size ? loadScalar<uint32_t>(file.data() + 80, swap) : 0;
+        bool binary = file.size() >= header_size && file.size() == header_size + static_cast<size_t>(facet_count) * facet_size;
+
+        // Facet normals are dropped: corners are welded on position only and shaded smooth.
+        if (binary)
+        {
+            unindexed_data.resize(static_cast<size_t>(facet_count) * 3, default_vertex);
+
+            const uint8_t* facet = file.data() + header_size;
+            for (size_t f = 0; f < facet_count; ++f, facet += facet_size)
+            {
+                float values[9];
+                std::memcpy(values, facet + 3 * sizeof(float), sizeof(values));
+                if (swap)
+                    for (float& value : values)
+                        value = loadScalar<float>(reinterpret_cast<const uint8_t*>(&value), true);
+
+                for (size_t k = 0; k < 3; ++k)
+                    unindexed_data[f * 3 + k].pos = glm::vec3(values[k * 3], values[k * 3 + 1], values[k * 3 + 2]);
+            }
+        }
+        else
+        {
+            std::string_view contents(reinterpret_cast<const char*>(file.data()), file.size());
+            if (contents.substr(0, 5) != "solid") { return nullptr; }
+
+            TextReader reader(contents.data(), contents.data() + contents.size());
+            while (!reader.done())
+            {
+                if (reader.next() != "vertex")
+                    continue;
+
+                double x, y, z;
+                if (!reader.nextNumber(x) || !reader.nextNumber(y) || !reader.nextNumber(z)) { return nullptr; }
+
+                VertexData vertex = default_vertex;
+                vertex.pos = glm::vec3(x, y, z);
+                unindexed_data.push_back(vertex);
+            }
+
+            unindexed_data.resize(unindexed_data.size() / 3 * 3);
+        }
+
+        std::shared_ptr<Mesh> mesh = WeldVertices(unindexed_data);
+        mesh->material = std::make_shared<Material>();
+        TangentSpace::generateNormals(*mesh);
+        TangentSpace::generateTangents(*mesh);
+
+        std::unique_ptr<Model> model = std::make_unique<Model>();
+        model->meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>(1, std::move(mesh));
+
+        logLoaded(model_path, *model, start);
+
+        return model;
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::LoadGLTFData(const std::string& model_path)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto model_folder = std::filesystem::path(model_path).parent_path();
+
+        MappedFile file(std::string(ASSETS_FOLDER_PATH_STR) + "/" + model_path);
+        if (!file.isOpen()) { return nullptr; }
+
+        // GLB: 12 bytes header, JSON chunk, optional BIN chunk. Anything else is read as a .gltf document.
+        std::string_view json_text(reinterpret_cast<const char*>(file.data()), file.size());
+        std::span<const uint8_t> bin_chunk = {};
+
+        if (file.size() >= 12 && loadScalar<uint32_t>(file.data(), std::endian::native != std::endian::little) == GLB_MAGIC)
+        {
+            bool swap = std::endian::native != std::endian::little;
+            size_t offset = 12;
+            json_text = {};
+
+            while (offset + 8 <= file.size())
+            {
+                auto chunk_length = static_cast<size_t>(loadScalar<uint32_t>(file.data() + offset, swap));
+                uint32_t chunk_type = loadScalar<uint32_t>(file.data() + offset + 4, swap);
+                offset += 8;
+                if (chunk_length > file.size() - offset) { return nullptr; }
+
+                if (chunk_type == GLB_CHUNK_JSON && json_text.empty())
+                    json_text = {reinterpret_cast<const char*>(file.data() + offset), chunk_length};
+                else if (chunk_type == GLB_CHUNK_BIN && bin_chunk.empty())
+                    bin_chunk = {file.data() + offset, chunk_length};
+
+                offset += (chunk_length + 3) & ~size_t(3);
+            }
+        }
+
+        JsonValue gltf = {};
+        if (!JsonValue::parse(json_text, gltf) || gltf["asset"]["version"].getString().compare(0, 1, "2") != 0) {
+            Debug::logInfo("Not a glTF 2.0 model: " + model_path);
+            return nullptr;
+        }
+
+        // Buffers: the GLB binary chunk and external files stay mapped, only data URIs are decoded.
+        std::vector<std::span<const uint8_t>> buffers = {};
+        std::vector<std::shared_ptr<MappedFile>> external_files = {};
+        std::vector<std::shared_ptr<std::vector<uint8_t>>> decoded_buffers = {};
+
+        for (size_t i = 0; i < gltf["buffers"].size(); ++i)
+        {
+            const JsonValue& buffer = gltf["buffers"][i];
+            const std::string& uri = buffer["uri"].getString();
+            std::span<const uint8_t> bytes = {};
+
+            if (uri.empty() && i == 0) {
+                bytes = bin_chunk;
+            } else if (uri.compare(0, 5, "data:") == 0) {
+                auto decoded = std::make_shared<std::vector<uint8_t>>();
+                if (decodeDataUri(uri, *decoded))
+                    bytes = *decoded;
+                decoded_buffers.push_back(std::move(decoded));
+            } else if (!uri.empty()) {
+                auto external = std::make_shared<MappedFile>(std::string(ASSETS_FOLDER_PATH_STR) + "/" + (model_folder / decodeUri(uri)).string());
+                if (external->isOpen())
+                    bytes = external->getSpan();
+                external_files.push_back(std::move(external));
+            }
+
+            auto byte_length = static_cast<size_t>(buffer["byteLength"].getInt(0));
+            if (bytes.size() < byte_length) {
+                Debug::logInfo("Missing glTF buffer " + std::to_string(i) + " of " + model_path);
+                return nullptr;
+            }
+            buffers.push_back(bytes.first(byte_length));
+        }
+
+        // Materials are shared by every primitive using them, the last one is the default material.
+        const JsonValue& gltf_materials = gltf["materials"];
+        std::vector<std::shared_ptr<Material>> materials(gltf_materials.size() + 1);
+        std::vector<glm::vec4> base_colors(materials.size(), glm::vec4(1.0f));
+
+        for (size_t i = 0; i < materials.size(); ++i)
+        {
+            materials[i] = std::make_shared<Material>();
+
+            const JsonValue& pbr = gltf_materials[i]["pbrMetallicRoughness"];
+            const JsonValue& factor = pbr["baseColorFactor"];
+            if (factor.size() == 4)
+                base_colors[i] = glm::vec4(factor[0].getNumber(), factor[1].getNumber(), factor[2].getNumber(), factor[3].getNumber());
+
+            const JsonValue& texture = gltf["textures"][static_cast<size_t>(pbr["baseColorTexture"]["index"].getInt(-1))];
+            auto image_index = static_cast<size_t>(texture["source"].getInt(-1));
+            const JsonValue& image = gltf["images"][image_index];
+            const std::string& uri = image["uri"].getString();
+
+            if (!uri.empty() && uri.compare(0, 5, "data:") != 0) {
+                materials[i]->texture_path = (model_folder / decodeUri(uri)).generic_string();
+                continue;
+            }
+
+            // Embedded image: the path only names it in the texture cache.
+            auto bytes = std::make_shared<std::vector<uint8_t>>();
+            if (!uri.empty()) {
+                decodeDataUri(uri, *bytes);
+            } else if (image.contains("bufferView")) {
+                const JsonValue& buffer_view = gltf["bufferViews"][static_cast<size_t>(image["bufferView"].getInt())];
+                auto buffer = static_cast<size_t>(buffer_view["buffer"].getInt(-1));
+                auto offset = static_cast<size_t>(buffer_view["byteOffset"].getInt(0));
+                auto length = static_cast<size_t>(buffer_view["byteLength"].getInt(0));
+                if (buffer < buffers.size() && offset <= buffers[buffer].size() && length <= buffers[buffer].size() - offset)
+                    bytes->assign(buffers[buffer].data() + offset, buffers[buffer].data() + offset + length);
+            }
+
+            if (!bytes->empty()) {
+                materials[i]->texture_path  = model_path + "#image" + std::to_string(image_index);
+                materials[i]->texture_bytes = std::move(bytes);
+            }
+        }
+
+        // Walk the default scene, every mesh primitive is drawn once per node referencing it.
+        std::vector<GltfDraw> draws = {};
+        const JsonValue& nodes = gltf["nodes"];
+        const JsonValue& scene = gltf["scenes"][static_cast<size_t>(gltf["scene"].getInt(0))];
+
+        if (scene.isNull())
+        {
+            for (size_t m = 0; m < gltf["meshes"].size(); ++m)
+                for (size_t p = 0; p < gltf["meshes"][m]["primitives"].size(); ++p)
+                    draws.push_back({&gltf["meshes"][m]["primitives"][p], glm::mat4(1.0f)});
+        }
+        else
+        {
+            std::vector<std::pair<size_t, glm::mat4>> stack = {};
+            for (size_t i = 0; i < scene["nodes"].size(); ++i)
+                stack.emplace_back(static_cast<size_t>(scene["nodes"][i].getInt(-1)), glm::mat4(1.0f));
+
+            // Node graphs are trees, more visits than nodes means a cycle.
+            size_t visits = 0;
+            while (!stack.empty() && visits++ < nodes.size())
+            {
+                auto [node_index, parent_transform] = stack.back();
+                stack.pop_back();
+
+                const JsonValue& node = nodes[node_index];
+                glm::mat4 transform = parent_transform * getGltfLocalTransform(node);
+
+                const JsonValue& primitives = gltf["meshes"][static_cast<size_t>(node["mesh"].getInt(-1))]["primitives"];
+                for (size_t p = 0; p < primitives.size(); ++p)
+                    draws.push_back({&primitives[p], transform});
+
+                for (size_t c = 0; c < node["children"].size(); ++c)
+                    stack.emplace_back(static_cast<size_t>(node["children"][c].getInt(-1)), transform);
+            }
+        }
+
+        auto meshes = std::make_unique<std::vector<std::shared_ptr<Mesh>>>(draws.size());
+
+        ThreadPool::getInstance()->parallelFor(draws.size(), [&](size_t i)
+        {
+            const JsonValue& primitive = *draws[i].primitive;
+            const JsonValue& attributes = primitive["attributes"];
+            int64_t mode = primitive["mode"].getInt(GLTF_TRIANGLES);
+
+            GltfAccessor positions = {};
+            if (mode < GLTF_TRIANGLES || mode > GLTF_TRIANGLE_FAN || !getGltfAccessor(gltf, buffers, attributes["POSITION"], positions) || positions.components != 3)
+                return;
+
+            auto material_index = static_cast<size_t>(primitive["material"].getInt(-1));
+            if (material_index >= gltf_materials.size())
+                material_index = gltf_materials.size();
+
+            auto mesh = std::make_shared<Mesh>();
+            mesh->vertexData = std::make_shared<std::vector<VertexData>>(positions.count,
+                VertexData{ glm::vec3(0.0f), glm::vec2(0.0f), glm::vec3(0.0f), base_colors[material_index] });
+            mesh->material   = materials[material_index];
+
+            auto& vertices = *mesh->vertexData;
+            readGltfAttribute(positions, &vertices[0].pos.x, 3);
+
+            GltfAccessor accessor = {};
+            bool has_normals = getGltfAccessor(gltf, buffers, attributes["NORMAL"], accessor) && accessor.count == positions.count;
+            if (has_normals)
+                readGltfAttribute(accessor, &vertices[0].normal.x, 3);
+            bool has_tangents = getGltfAccessor(gltf, buffers, attributes["TANGENT"], accessor) && accessor.count == positions.count && accessor.components == 4;
+            if (has_tangents)
+                readGltfAttribute(accessor, &vertices[0].tangent.x, 4);
+            if (getGltfAccessor(gltf, buffers, attributes["TEXCOORD_0"], accessor) && accessor.count == positions.count)
+                readGltfAttribute(accessor, &vertices[0].uv.x, 2);
+            if (getGltfAccessor(gltf, buffers, attributes["COLOR_0"], accessor) && accessor.count == positions.count) {
+                // An RGB color leaves alpha untouched, it has to start at 1 before the base color is applied.
+                for (auto& vertex : vertices)
+                    vertex.color = glm::vec4(1.0f);
+                readGltfAttribute(accessor, &vertices[0].color.x, 4);
+                for (auto& vertex : vertices)
+                    vertex.color *= base_colors[material_index];
+            }
+
+            std::vector<uint32_t> indices = {};
+            if (primitive.contains("indices")) {
+                if (!getGltfAccessor(gltf, buffers, primitive["indices"], accessor) || !readGltfIndices(accessor, indices))
+                    return;
+            } else {
+                indices.resize(vertices.size());
+                std::iota(indices.begin(), indices.end(), 0u);
+            }
+
+            // Node transforms are baked in, mirroring ones flip the winding back.
+            const glm::mat4& transform = draws[i].transform;
+            bool is_identity = transform == glm::mat4(1.0f);
+            bool flip = glm::determinant(transform) < 0.0f;
+
+            bool in_range = std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < vertices.size(); });
+            if (mode != GLTF_TRIANGLES || flip || !in_range)
+                indices = triangulateGltf(mode, indices, vertices.size(), flip);
+            mesh->indexData = std::make_shared<std::vector<uint32_t>>(std::move(indices));
+
+            if (!is_identity)
+            {
+                glm::mat3 tangent_transform = glm::mat3(transform);
+                glm::mat3 normal_transform = glm::transpose(glm::inverse(tangent_transform));
+                for (auto& vertex : vertices) {
+                    vertex.pos = glm::vec3(transform * glm::vec4(vertex.pos, 1.0f));
+                    vertex.normal = normal_transform * vertex.normal;
+                    float length = glm::length(vertex.normal);
+                    if (length > 0.0f)
+                        vertex.normal /= length;
+
+                    if (has_tangents) {
+                        glm::vec3 tangent = tangent_transform * glm::vec3(vertex.tangent);
+                        length = glm::length(tangent);
+                        vertex.tangent = glm::vec4(length > 0.0f ? tangent / length : tangent, flip ? -vertex.tangent.w : vertex.tangent.w);
+                    }
+                }
+            }
+
+            if (!has_normals)
+                TangentSpace::generateNormals(*mesh);
+            if (!has_tangents)
+                TangentSpace::generateTangents(*mesh);
+
+            (*meshes)[i] = std::move(mesh);
+        });
+
+        meshes->erase(std::remove(meshes->begin(), meshes->end(), nullptr), meshes->end());
+        if (meshes->size() != draws.size())
+            Debug::logInfo("Skipped " + std::to_string(draws.size() - meshes->size()) + " unsupported primitives of " + model_path);
+
+        std::unique_ptr<Model> model = std::make_unique<Model>();
+        model->meshes = std::move(meshes);
+
+        logLoaded(model_path, *model, start);
+
+        return model;
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::CreatePrimitiveTriangle()
+    {
+        auto mesh = std::make_shared<Mesh>();
+        mesh->vertexData = std::make_shared<std::vector<VertexData>>(std::vector<VertexData>
+        {
+            //     POSITION              UV              NORMAL              COLOR
+            { { 1.0f,  1.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, glm::vec4(1.0f) },
+            { {-1.0f,  1.0f, 0.0f}, {0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, glm::vec4(1.0f) },
+            { { 0.0f, -1.0f, 0.0f}, {0.5f, 1.0f}, {0.0f, 0.0f, -1.0f}, glm::vec4(1.0f) }
+        });
+        mesh->indexData = std::make_shared<std::vector<uint32_t>>(std::vector<uint32_t>{ 0, 1, 2 });
+        mesh->material  = std::make_shared<Material>();
+        TangentSpace::generateTangents(*mesh);
+
+        std::unique_ptr<Model> model = std::make_unique<Model>();
+        model->meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>(1, std::move(mesh));
+
+        return model;
+    }
+
+    std::unique_ptr<Model> ModelDataLoader::CreatePrimitiveQuad()
+    {
+        auto mesh = std::make_shared<Mesh>();
+        mesh->vertexData = std::make_shared<std::vector<VertexData>>(std::vector<VertexData>
+        {
+            //     POSITION              UV              NORMAL              COLOR
+            { { 10.0f, 0.0f,  10.0f}, {1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, glm::vec4(1.0f) },
+            { { 10.0f, 0.0f, -10.0f}, {1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, glm::vec4(1.0f) },
+            { {-10.0f, 0.0f, -10.0f}, {0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, glm::vec4(1.0f) },
+            { {-10.0f, 0.0f,  10.0f}, {0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, glm::vec4(1.0f) },
+        });
+        mesh->indexData = std::make_shared<std::vector<uint32_t>>(std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3 });
+        mesh->material  = std::make_shared<Material>();
+        TangentSpace::generateTangents(*mesh);
+
+        std::unique_ptr<Model> model = std::make_unique<Model>();
+        model->meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>(1, std::move(mesh));
+
+        return model;
+    }
+}
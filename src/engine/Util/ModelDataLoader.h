@@ -16,8 +16,42 @@ namespace Engine:: Util
     {
     public:
 
+        /**
+         * Load any supported source by extension, obj materials are searched next to the obj.
+         * */
+        static std::unique_ptr<Model> LoadModelData(const std::string& model_path);
+
+        /**
+         * Cooked .gmesh of 'model_path' (loose or from the asset archive), nullptr when it is missing or older than its source.
+         * */
+        static std::unique_ptr<Model> LoadCookedData(const std::string& model_path);
+
         static std::unique_ptr<Model> LoadFBXData(const std::string& model_path);
         static std::unique_ptr<Model> LoadOBJData(const std::string& model_path, const std::string& obj_mtl);
+
+        /**
+         * ASCII and binary (both endians) PLY. Polygons are fan triangulated, missing normals are generated.
+         * */
+        static std::unique_ptr<Model> LoadPLYData(const std::string& model_path);
+
+        /**
+         * ASCII and binary STL, corners welded into an indexed mesh with smooth normals.
+         * */
+        static std::unique_ptr<Model> LoadSTLData(const std::string& model_path);
+
+        /**
+         * glTF 2.0, binary (.glb) or with external/data URI buffers. Accessors are read straight from the mapped file,
+         * node transforms are baked into the vertices and base color textures may be embedded (Material::texture_bytes).
+         * */
+        static std::unique_ptr<Model> LoadGLTFData(const std::string& model_path);
+
+        static std::unique_ptr<Model> CreatePrimitiveTriangle();
+        static std::unique_ptr<Model> CreatePrimitiveQuad();
+
+        /**
+         * Merge duplicated vertices of an unindexed triangle list into an indexed mesh.
+         * */
+        static std::shared_ptr<Mesh> WeldVertices(const std::vector<VertexData>& unindexed_data);
     };
 }
 
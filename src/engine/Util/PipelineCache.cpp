@@ -0,0 +1,148 @@
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include "Hash.h"
+#include "Debug.hpp"
+#include "PipelineCache.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        constexpr char      MAGIC[4]    = {'G', 'P', 'S', 'O'};
+        constexpr uint32_t  VERSION     = 1;
+
+        struct FileHeader
+        {
+            char        magic[4]                    = {};
+            uint32_t    version                     = 0;
+            uint32_t    vendor_id                   = 0;
+            uint32_t    device_id                   = 0;
+            uint32_t    driver_version              = 0;
+            uint8_t     cache_uuid[VK_UUID_SIZE]    = {};
+            uint64_t    data_size                   = 0;
+            uint64_t    data_hash                   = 0;
+        };
+
+        // Start of the data, as written by every driver (VK_PIPELINE_CACHE_HEADER_VERSION_ONE).
+        struct VulkanHeader
+        {
+            uint32_t    header_size                 = 0;
+            uint32_t    header_version              = 0;
+            uint32_t    vendor_id                   = 0;
+            uint32_t    device_id                   = 0;
+            uint8_t     cache_uuid[VK_UUID_SIZE]    = {};
+        };
+
+        FileHeader getExpectedHeader()
+        {
+            vk::PhysicalDeviceProperties properties = ApplicationData::data->gpu.getProperties();
+
+            FileHeader header = {};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version          = VERSION;
+            header.vendor_id        = properties.vendorID;
+            header.device_id        = properties.deviceID;
+            header.driver_version   = properties.driverVersion;
+            std::memcpy(header.cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+            return header;
+        }
+
+        bool isValid(const FileHeader& header, const std::vector<uint8_t>& data)
+        {
+            FileHeader expected = getExpectedHeader();
+
+            if (std::memcmp(header.magic, expected.magic, sizeof(MAGIC)) != 0 || header.version != expected.version ||
+                header.vendor_id != expected.vendor_id || header.device_id != expected.device_id ||
+                header.driver_version != expected.driver_version ||
+                std::memcmp(header.cache_uuid, expected.cache_uuid, VK_UUID_SIZE) != 0)
+                return false;
+
+            if (header.data_size != data.size() || header.data_hash != Hash::fnv1a(data.data(), data.size()))
+                return false;
+
+            // Drivers should reject foreign data themselves, not all of them do.
+            VulkanHeader vulkan_header = {};
+            if (data.size() < sizeof(VulkanHeader))
+                return false;
+            std::memcpy(&vulkan_header, data.data(), sizeof(VulkanHeader));
+
+            return vulkan_header.header_size >= sizeof(VulkanHeader) && vulkan_header.header_size <= data.size() &&
+                   vulkan_header.header_version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                   vulkan_header.vendor_id == expected.vendor_id && vulkan_header.device_id == expected.device_id &&
+                   std::memcmp(vulkan_header.cache_uuid, expected.cache_uuid, VK_UUID_SIZE) == 0;
+        }
+
+        std::vector<uint8_t> readData(const std::string& path)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open())
+                return {};
+
+            auto file_size = static_cast<size_t>(file.tellg());
+            if (file_size < sizeof(FileHeader))
+                return {};
+
+            FileHeader header = {};
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+            std::vector<uint8_t> data(file_size - sizeof(FileHeader));
+            file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file || !isValid(header, data))
+                return {};
+
+            return data;
+        }
+    }
+
+    std::string PipelineCache::getDefaultPath()
+    {
+        return std::string(COOKED_FOLDER_PATH_STR) + "/pipelines.cache";
+    }
+
+    vk::PipelineCache PipelineCache::load(const std::string& path)
+    {
+        std::vector<uint8_t> data = readData(path);
+        if (data.empty())
+            Debug::logInfo("No valid pipeline cache at " + path + ", pipelines are compiled from scratch.");
+
+        vk::PipelineCacheCreateInfo cache_info = {};
+        cache_info.pNext            = nullptr;
+        cache_info.initialDataSize  = data.size();
+        cache_info.pInitialData     = data.empty() ? nullptr : data.data();
+
+        return ApplicationData::data->device.createPipelineCache(cache_info);
+    }
+
+    bool PipelineCache::save(vk::PipelineCache cache, const std::string& path)
+    {
+        std::vector<uint8_t> data = ApplicationData::data->device.getPipelineCacheData(cache);
+        if (data.empty())
+            return false;
+
+        FileHeader header = getExpectedHeader();
+        header.data_size = data.size();
+        header.data_hash = Hash::fnv1a(data.data(), data.size());
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+        std::string temporary_path = path + ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file)
+                return false;
+        }
+
+        std::filesystem::rename(temporary_path, path, error);
+        return !error;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef GYMNURE_PIPELINECACHE_H
+#define GYMNURE_PIPELINECACHE_H
+
+#include <string>
+#include <ApplicationData.hpp>
+#include "Util.h"
+
+namespace Engine::Util
+{
+    /**
+     * The device-wide vk::PipelineCache (ApplicationData::pipeline_cache), kept on disk between runs. The file is
+     * only used by the GPU and driver that wrote it: vendor, device, driver version and cache UUID are checked
+     * against both our header and the Vulkan one, anything else starts an empty cache.
+     * */
+    class PipelineCache
+    {
+    public:
+
+        PipelineCache() = delete;
+
+        static std::string getDefaultPath();
+
+        /**
+         * Needs ApplicationData::device and gpu.
+         * */
+        static vk::PipelineCache load(const std::string& path = getDefaultPath());
+
+        /**
+         * Every pipeline was created through 'cache', so it holds what was loaded and what was built since.
+         * Written to a temporary file first, a crash never leaves a truncated cache behind.
+         * */
+        static bool save(vk::PipelineCache cache, const std::string& path = getDefaultPath());
+    };
+}
+
+#endif //GYMNURE_PIPELINECACHE_H
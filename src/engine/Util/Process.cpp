@@ -0,0 +1,31 @@
+#include "Process.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Engine::Util
+{
+    size_t Process::getPeakRSS()
+    {
+    #ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return static_cast<size_t>(counters.PeakWorkingSetSize);
+        return 0;
+    #else
+        struct rusage usage = {};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+        #ifdef __APPLE__
+            return static_cast<size_t>(usage.ru_maxrss);        // bytes
+        #else
+            return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+        #endif
+    #endif
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef GYMNURE_PROCESS_H
+#define GYMNURE_PROCESS_H
+
+#include <cstddef>
+
+namespace Engine::Util
+{
+    class Process
+    {
+    public:
+
+        Process() = delete;
+
+        /**
+         * Peak resident set size of the current process, in bytes (0 if unavailable).
+         * */
+        static size_t getPeakRSS();
+    };
+}
+
+#endif //GYMNURE_PROCESS_H
@@ -0,0 +1,543 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include "StreamedMeshFile.h"
+
+namespace Engine::Util
+{
+    namespace
+    {
+        const char MAGIC[4] = {'G', 'S', 'T', 'R'};
+
+        struct FileHeader
+        {
+            char     magic[4];
+            uint32_t version;
+            uint32_t mesh_count;
+            uint32_t reserved;
+        };
+
+        struct MeshHeader
+        {
+            uint32_t node_count;
+            uint32_t cluster_count;
+            uint32_t texture_path_length;
+            uint32_t reserved;
+            float    bounds_min[3];
+            float    bounds_max[3];
+            float    center[3];
+            float    radius;
+            float    quantization_min[4];
+            float    quantization_extent[4];
+        };
+
+        struct NodeHeader
+        {
+            float    center[3];
+            float    radius;
+            float    error;
+            uint32_t parent;
+            uint32_t first_child;
+            uint32_t child_count;
+            uint32_t first_cluster;
+            uint32_t cluster_count;
+            uint32_t payload_size;
+            uint32_t reserved;
+            uint64_t payload_offset;
+        };
+
+        struct ClusterHeader
+        {
+            uint32_t payload_offset;
+            uint32_t vertex_count;
+            uint32_t index_count;
+            uint32_t reserved;
+        };
+
+        struct BuildNode
+        {
+            StreamedNode                    node        = {};
+            uint32_t                        depth       = 0;
+            glm::uvec3                      cell        = glm::uvec3(0);
+            std::vector<uint32_t>           triangles   = {};   // LOD 0 triangles whose centroid is in the cell.
+            std::vector<StreamedCluster>    clusters    = {};
+            std::vector<uint8_t>            payload     = {};
+        };
+
+        struct MeshBuild
+        {
+            std::vector<BuildNode>          nodes           = {};
+            Bounds                          bounds          = {};
+            Vertex::QuantizationParams      quantization    = {};
+        };
+
+        size_t alignUp(size_t size, size_t alignment)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        void appendAligned(std::vector<uint8_t>& bytes, const void* data, size_t size)
+        {
+            auto* begin = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+            bytes.resize(alignUp(bytes.size(), 4), 0);
+        }
+
+        void writeAligned(std::ofstream& file, const void* data, size_t size, size_t alignment = 4)
+        {
+            static const char padding[StreamedMeshFile::PAGE_SIZE] = {};
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            file.write(padding, static_cast<std::streamsize>(alignUp(size, alignment) - size));
+        }
+
+        /**
+         * Smallest sphere around both spheres, written to the first one.
+         * */
+        void mergeSphere(glm::vec3& center, float& radius, const glm::vec3& other_center, float other_radius)
+        {
+            float distance = glm::length(other_center - center);
+            if (distance + other_radius <= radius)
+                return;
+
+            if (distance + radius <= other_radius) {
+                center = other_center;
+                radius = other_radius;
+                return;
+            }
+
+            float merged_radius = (distance + radius + other_radius) * 0.5f;
+            center += (other_center - center) * ((merged_radius - radius) / distance);
+            radius = merged_radius;
+        }
+
+        /**
+         * Split the triangles of a node in clusters and fill its payload and bounds. Triangles keep the mesh order,
+         * cache optimized by the cooker.
+         * */
+        void buildClusters(BuildNode& build, const std::vector<uint32_t>& indices, const std::vector<VertexData>& vertices,
+                           const std::vector<Vertex::PackedVertexData>& packed)
+        {
+            std::unordered_map<uint32_t, uint32_t> local = {};
+            std::vector<uint32_t> node_vertices = {};
+            std::vector<uint32_t> local_indices(indices.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                auto [it, inserted] = local.emplace(indices[i], static_cast<uint32_t>(node_vertices.size()));
+                if (inserted)
+                    node_vertices.push_back(indices[i]);
+                local_indices[i] = it->second;
+            }
+
+            if (node_vertices.empty())
+                return;
+
+            glm::vec3 min = vertices[node_vertices[0]].pos;
+            glm::vec3 max = min;
+            for (uint32_t v : node_vertices) {
+                min = glm::min(min, vertices[v].pos);
+                max = glm::max(max, vertices[v].pos);
+            }
+
+            build.node.center = (min + max) * 0.5f;
+            for (uint32_t v : node_vertices)
+                build.node.radius = std::max(build.node.radius, glm::length(vertices[v].pos - build.node.center));
+
+            // Position of each node vertex in the current cluster.
+            std::vector<uint32_t> cluster_index(node_vertices.size(), UINT32_MAX);
+            std::vector<uint32_t> cluster_vertices = {};
+            std::vector<uint16_t> cluster_indices = {};
+
+            auto flush = [&]()
+            {
+                StreamedCluster cluster = {};
+                cluster.payload_offset = static_cast<uint32_t>(build.payload.size());
+                cluster.vertex_count   = static_cast<uint32_t>(cluster_vertices.size());
+                cluster.index_count    = static_cast<uint32_t>(cluster_indices.size());
+
+                std::vector<Vertex::PackedVertexData> cluster_packed = {};
+                cluster_packed.reserve(cluster_vertices.size());
+                for (uint32_t v : cluster_vertices) {
+                    cluster_packed.push_back(packed[node_vertices[v]]);
+                    cluster_index[v] = UINT32_MAX;
+                }
+
+                appendAligned(build.payload, cluster_packed.data(), cluster_packed.size() * sizeof(Vertex::PackedVertexData));
+                appendAligned(build.payload, cluster_indices.data(), cluster_indices.size() * sizeof(uint16_t));
+                build.clusters.push_back(cluster);
+
+                cluster_vertices.clear();
+                cluster_indices.clear();
+            };
+
+            for (size_t t = 0; t + 2 < local_indices.size(); t += 3)
+            {
+                uint32_t new_vertices = 0;
+                for (size_t k = 0; k < 3; ++k)
+                    new_vertices += cluster_index[local_indices[t + k]] == UINT32_MAX ? 1 : 0;
+
+                if (cluster_vertices.size() + new_vertices > StreamedMeshFile::CLUSTER_MAX_VERTICES ||
+                    cluster_indices.size() == StreamedMeshFile::CLUSTER_MAX_TRIANGLES * 3)
+                    flush();
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    uint32_t v = local_indices[t + k];
+                    if (cluster_index[v] == UINT32_MAX) {
+                        cluster_index[v] = static_cast<uint32_t>(cluster_vertices.size());
+                        cluster_vertices.push_back(v);
+                    }
+                    cluster_indices.push_back(static_cast<uint16_t>(cluster_index[v]));
+                }
+            }
+
+            if (!cluster_indices.empty())
+                flush();
+        }
+
+        bool isValid(const StreamedMesh& mesh, uint64_t file_size)
+        {
+            auto node_count = static_cast<uint32_t>(mesh.nodes.size());
+            auto cluster_count = static_cast<uint32_t>(mesh.clusters.size());
+
+            for (uint32_t i = 0; i < node_count; ++i)
+            {
+                const StreamedNode& node = mesh.nodes[i];
+
+                // Parents come first, so the tree has no cycle.
+                if ((i == 0) != (node.parent == UINT32_MAX) || (i > 0 && node.parent >= i))
+                    return false;
+                if (node.child_count > 0 && (node.first_child <= i || node.first_child + node.child_count > node_count))
+                    return false;
+                if (node.first_cluster + node.cluster_count > cluster_count || node.payload_offset + node.payload_size > file_size)
+                    return false;
+
+                for (uint32_t c = node.first_cluster; c < node.first_cluster + node.cluster_count; ++c)
+                {
+                    const StreamedCluster& cluster = mesh.clusters[c];
+                    size_t size = cluster.vertex_count * sizeof(Vertex::PackedVertexData) + alignUp(cluster.index_count * sizeof(uint16_t), 4);
+
+                    if (cluster.vertex_count > StreamedMeshFile::CLUSTER_MAX_VERTICES || cluster.index_count % 3 != 0 ||
+                        cluster.index_count > StreamedMeshFile::CLUSTER_MAX_TRIANGLES * 3 ||
+                        static_cast<uint64_t>(cluster.payload_offset) + size > node.payload_size)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        MeshBuild buildMesh(const Mesh& mesh)
+        {
+            MeshBuild build = {};
+            if (mesh.vertexData == nullptr || mesh.indexData == nullptr || mesh.indexData->size() < 3)
+                return build;
+
+            const auto& vertices = *mesh.vertexData;
+            const auto& indices = *mesh.indexData;
+            size_t triangle_count = indices.size() / 3;
+
+            Vertex::QuantizedMesh quantized = Vertex::VertexQuantizer::quantize(vertices, {});
+            build.quantization = quantized.params;
+            build.bounds = MeshOptimizer::computeBounds(vertices);
+
+            // Cubic cells, so the cells of a level nest in the cells of the level above.
+            glm::vec3 extent = build.bounds.max - build.bounds.min;
+            float size = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f));
+            Bounds cube = {};
+            cube.min = build.bounds.min;
+            cube.max = build.bounds.min + glm::vec3(size);
+
+            std::vector<glm::vec3> centroids(triangle_count);
+            for (size_t t = 0; t < triangle_count; ++t)
+                centroids[t] = (vertices[indices[t * 3]].pos + vertices[indices[t * 3 + 1]].pos + vertices[indices[t * 3 + 2]].pos) / 3.f;
+
+            BuildNode root = {};
+            root.triangles.resize(triangle_count);
+            for (size_t t = 0; t < triangle_count; ++t)
+                root.triangles[t] = static_cast<uint32_t>(t);
+            build.nodes.push_back(std::move(root));
+
+            auto isLeaf = [](const BuildNode& node)
+            {
+                return node.triangles.size() <= StreamedMeshFile::LEAF_MAX_TRIANGLES || node.depth + 1 >= StreamedMeshFile::MAX_DEPTH;
+            };
+
+            // One level at a time, nodes of a level are independent.
+            size_t level_begin = 0;
+            while (level_begin < build.nodes.size())
+            {
+                size_t level_end = build.nodes.size();
+                uint32_t depth = build.nodes[level_begin].depth;
+
+                std::vector<uint32_t> representative = {};
+                for (size_t i = level_begin; i < level_end && representative.empty(); ++i)
+                    if (!isLeaf(build.nodes[i]))
+                        representative = MeshOptimizer::clusterVertices(vertices, cube, StreamedMeshFile::NODE_GRID_SIZE << depth);
+
+                ThreadPool::getInstance()->parallelFor(level_end - level_begin, [&](size_t i)
+                {
+                    BuildNode& node = build.nodes[level_begin + i];
+
+                    std::vector<uint32_t> node_indices = {};
+                    node_indices.reserve(node.triangles.size() * 3);
+                    for (uint32_t t : node.triangles)
+                        node_indices.insert(node_indices.end(), {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]});
+
+                    if (!isLeaf(node)) {
+                        node_indices = MeshOptimizer::collapseTriangles(node_indices, representative);
+                        // Clustering moves a vertex at most one cell diagonal away.
+                        node.node.error = size * std::sqrt(3.f) / static_cast<float>(StreamedMeshFile::NODE_GRID_SIZE << depth);
+                    }
+
+                    buildClusters(node, node_indices, vertices, quantized.vertices);
+                });
+
+                // Children of inner nodes, one per non empty octant.
+                float child_cell_size = size / static_cast<float>(1u << (depth + 1));
+                for (size_t i = level_begin; i < level_end; ++i)
+                {
+                    if (isLeaf(build.nodes[i])) {
+                        build.nodes[i].triangles = {};
+                        continue;
+                    }
+
+                    std::vector<uint32_t> octants[8] = {};
+                    glm::uvec3 first_cell = build.nodes[i].cell * 2u;
+                    for (uint32_t t : build.nodes[i].triangles)
+                    {
+                        glm::uvec3 cell = glm::uvec3(glm::max((centroids[t] - cube.min) / child_cell_size, glm::vec3(0.f)));
+                        cell = glm::clamp(cell, first_cell, first_cell + 1u);
+                        octants[(cell.x & 1u) | ((cell.y & 1u) << 1u) | ((cell.z & 1u) << 2u)].push_back(t);
+                    }
+                    build.nodes[i].triangles = {};
+
+                    build.nodes[i].node.first_child = static_cast<uint32_t>(build.nodes.size());
+                    for (uint32_t octant = 0; octant < 8; ++octant)
+                    {
+                        if (octants[octant].empty())
+                            continue;
+
+                        BuildNode child = {};
+                        child.depth       = depth + 1;
+                        child.cell        = first_cell + glm::uvec3(octant & 1u, (octant >> 1u) & 1u, (octant >> 2u) & 1u);
+                        child.triangles   = std::move(octants[octant]);
+                        child.node.parent = static_cast<uint32_t>(i);
+                        build.nodes.push_back(std::move(child));
+                        build.nodes[i].node.child_count++;
+                    }
+                }
+
+                level_begin = level_end;
+            }
+
+            // Parents bound their children, so a coarser node is never farther than any of its descendants.
+            for (size_t i = build.nodes.size(); i-- > 0;)
+            {
+                StreamedNode& node = build.nodes[i].node;
+                for (uint32_t c = node.first_child; c < node.first_child + node.child_count; ++c)
+                {
+                    const StreamedNode& child = build.nodes[c].node;
+                    if (build.nodes[i].clusters.empty() && c == node.first_child) {
+                        node.center = child.center;
+                        node.radius = child.radius;
+                    } else {
+                        mergeSphere(node.center, node.radius, child.center, child.radius);
+                    }
+                }
+            }
+
+            return build;
+        }
+    }
+
+    bool StreamedMeshFile::write(const std::string& path, const Model& model)
+    {
+        const auto& meshes = *model.meshes;
+
+        std::vector<MeshBuild> builds(meshes.size());
+        ThreadPool::getInstance()->parallelFor(meshes.size(), [&meshes, &builds](size_t m)
+        {
+            builds[m] = buildMesh(*meshes[m]);
+        });
+
+        std::vector<std::string> texture_paths = {};
+        size_t table_size = sizeof(FileHeader);
+        for (size_t m = 0; m < meshes.size(); ++m)
+        {
+            texture_paths.push_back(meshes[m]->material != nullptr ? meshes[m]->material->texture_path : "");
+            table_size += sizeof(MeshHeader) + alignUp(texture_paths[m].size(), 4) + builds[m].nodes.size() * sizeof(NodeHeader);
+            for (const auto& node : builds[m].nodes)
+                table_size += node.clusters.size() * sizeof(ClusterHeader);
+        }
+
+        // Payloads after every table, each one on its own pages.
+        uint64_t payload_start = alignUp(table_size, PAGE_SIZE);
+        uint64_t payload_offset = payload_start;
+        for (auto& build : builds)
+            for (auto& node : build.nodes) {
+                node.node.payload_offset = payload_offset;
+                node.node.payload_size   = static_cast<uint32_t>(node.payload.size());
+                payload_offset += alignUp(node.payload.size(), PAGE_SIZE);
+            }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        FileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version    = VERSION;
+        header.mesh_count = static_cast<uint32_t>(meshes.size());
+        writeAligned(file, &header, sizeof(header));
+
+        for (size_t m = 0; m < meshes.size(); ++m)
+        {
+            const MeshBuild& build = builds[m];
+
+            MeshHeader mesh_header = {};
+            mesh_header.node_count          = static_cast<uint32_t>(build.nodes.size());
+            mesh_header.texture_path_length = static_cast<uint32_t>(texture_paths[m].size());
+            for (const auto& node : build.nodes)
+                mesh_header.cluster_count += static_cast<uint32_t>(node.clusters.size());
+            std::memcpy(mesh_header.bounds_min, &build.bounds.min, sizeof(mesh_header.bounds_min));
+            std::memcpy(mesh_header.bounds_max, &build.bounds.max, sizeof(mesh_header.bounds_max));
+            std::memcpy(mesh_header.center, &build.bounds.center, sizeof(mesh_header.center));
+            mesh_header.radius = build.bounds.radius;
+            std::memcpy(mesh_header.quantization_min, &build.quantization.bounds_min, sizeof(mesh_header.quantization_min));
+            std::memcpy(mesh_header.quantization_extent, &build.quantization.bounds_extent, sizeof(mesh_header.quantization_extent));
+
+            writeAligned(file, &mesh_header, sizeof(mesh_header));
+            writeAligned(file, texture_paths[m].data(), texture_paths[m].size());
+
+            std::vector<NodeHeader> node_headers = {};
+            std::vector<ClusterHeader> cluster_headers = {};
+            for (const auto& build_node : build.nodes)
+            {
+                const StreamedNode& node = build_node.node;
+
+                NodeHeader node_header = {};
+                std::memcpy(node_header.center, &node.center, sizeof(node_header.center));
+                node_header.radius          = node.radius;
+                node_header.error           = node.error;
+                node_header.parent          = node.parent;
+                node_header.first_child     = node.first_child;
+                node_header.child_count     = node.child_count;
+                node_header.first_cluster   = static_cast<uint32_t>(cluster_headers.size());
+                node_header.cluster_count   = static_cast<uint32_t>(build_node.clusters.size());
+                node_header.payload_size    = node.payload_size;
+                node_header.payload_offset  = node.payload_offset;
+                node_headers.push_back(node_header);
+
+                for (const auto& cluster : build_node.clusters)
+                    cluster_headers.push_back(ClusterHeader{cluster.payload_offset, cluster.vertex_count, cluster.index_count, 0});
+            }
+
+            writeAligned(file, node_headers.data(), node_headers.size() * sizeof(NodeHeader));
+            writeAligned(file, cluster_headers.data(), cluster_headers.size() * sizeof(ClusterHeader));
+        }
+
+        std::vector<char> table_padding(payload_start - table_size, 0);
+        file.write(table_padding.data(), static_cast<std::streamsize>(table_padding.size()));
+        for (const auto& build : builds)
+            for (const auto& node : build.nodes)
+                writeAligned(file, node.payload.data(), node.payload.size(), PAGE_SIZE);
+
+        return file.good();
+    }
+
+    std::vector<std::shared_ptr<StreamedMesh>> StreamedMeshFile::read(const std::string& path)
+    {
+        // Random access: only the tables are touched, payloads are read later without the mapping.
+        MappedFile file(path, false);
+        if (!file.isOpen())
+            return {};
+
+        size_t offset = 0;
+        auto take = [&file, &offset](size_t size) -> const uint8_t*
+        {
+            if (offset + size > file.size())
+                return nullptr;
+
+            const uint8_t* ptr = file.data() + offset;
+            offset = alignUp(offset + size, 4);
+            return ptr;
+        };
+
+        FileHeader header = {};
+        const uint8_t* header_data = take(sizeof(FileHeader));
+        if (header_data == nullptr)
+            return {};
+
+        std::memcpy(&header, header_data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+            return {};
+
+        std::vector<std::shared_ptr<StreamedMesh>> meshes = {};
+        for (uint32_t m = 0; m < header.mesh_count; ++m)
+        {
+            MeshHeader mesh_header = {};
+            const uint8_t* mesh_header_data = take(sizeof(MeshHeader));
+            if (mesh_header_data == nullptr)
+                return {};
+            std::memcpy(&mesh_header, mesh_header_data, sizeof(mesh_header));
+
+            const uint8_t* texture_path = take(mesh_header.texture_path_length);
+            const uint8_t* node_table = take(static_cast<size_t>(mesh_header.node_count) * sizeof(NodeHeader));
+            const uint8_t* cluster_table = take(static_cast<size_t>(mesh_header.cluster_count) * sizeof(ClusterHeader));
+            if (texture_path == nullptr || node_table == nullptr || cluster_table == nullptr)
+                return {};
+
+            auto mesh = std::make_shared<StreamedMesh>();
+            mesh->path = path;
+            mesh->texture_path.assign(reinterpret_cast<const char*>(texture_path), mesh_header.texture_path_length);
+
+            std::memcpy(&mesh->bounds.min, mesh_header.bounds_min, sizeof(mesh_header.bounds_min));
+            std::memcpy(&mesh->bounds.max, mesh_header.bounds_max, sizeof(mesh_header.bounds_max));
+            std::memcpy(&mesh->bounds.center, mesh_header.center, sizeof(mesh_header.center));
+            mesh->bounds.radius = mesh_header.radius;
+            std::memcpy(&mesh->quantization.bounds_min, mesh_header.quantization_min, sizeof(mesh_header.quantization_min));
+            std::memcpy(&mesh->quantization.bounds_extent, mesh_header.quantization_extent, sizeof(mesh_header.quantization_extent));
+
+            mesh->nodes.resize(mesh_header.node_count);
+            for (uint32_t i = 0; i < mesh_header.node_count; ++i)
+            {
+                NodeHeader node_header = {};
+                std::memcpy(&node_header, node_table + i * sizeof(NodeHeader), sizeof(NodeHeader));
+
+                StreamedNode& node = mesh->nodes[i];
+                std::memcpy(&node.center, node_header.center, sizeof(node_header.center));
+                node.radius         = node_header.radius;
+                node.error          = node_header.error;
+                node.parent         = node_header.parent;
+                node.first_child    = node_header.first_child;
+                node.child_count    = node_header.child_count;
+                node.first_cluster  = node_header.first_cluster;
+                node.cluster_count  = node_header.cluster_count;
+                node.payload_offset = node_header.payload_offset;
+                node.payload_size   = node_header.payload_size;
+            }
+
+            mesh->clusters.resize(mesh_header.cluster_count);
+            for (uint32_t i = 0; i < mesh_header.cluster_count; ++i)
+            {
+                ClusterHeader cluster_header = {};
+                std::memcpy(&cluster_header, cluster_table + i * sizeof(ClusterHeader), sizeof(ClusterHeader));
+                mesh->clusters[i] = StreamedCluster{cluster_header.payload_offset, cluster_header.vertex_count, cluster_header.index_count};
+            }
+
+            if (!isValid(*mesh, file.size()))
+                return {};
+
+            // Meshes without triangles have nothing to stream.
+            if (!mesh->nodes.empty())
+                meshes.push_back(std::move(mesh));
+        }
+
+        return meshes;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef GYMNURE_STREAMEDMESHFILE_H
+#define GYMNURE_STREAMEDMESHFILE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <Vertex/VertexQuantizer.h>
+#include "ModelData.hpp"
+
+namespace Engine::Util
+{
+    struct StreamedCluster
+    {
+        uint32_t payload_offset = 0;    // From the start of the node payload.
+        uint32_t vertex_count   = 0;
+        uint32_t index_count    = 0;
+    };
+
+    struct StreamedNode
+    {
+        glm::vec3   center          = glm::vec3(0.f);   // Bounding sphere of the node and all its descendants.
+        float       radius          = 0.f;
+        float       error           = 0.f;              // Object space distance vertices were moved by, 0 for leaves.
+        uint32_t    parent          = UINT32_MAX;
+        uint32_t    first_child     = 0;                // Children are contiguous.
+        uint32_t    child_count     = 0;
+        uint32_t    first_cluster   = 0;
+        uint32_t    cluster_count   = 0;
+        uint64_t    payload_offset  = 0;                // File offset of the node clusters, page aligned.
+        uint32_t    payload_size    = 0;
+    };
+
+    /**
+     * Everything about a streamed mesh but its geometry, which stays in 'path' until paged in.
+     * */
+    struct StreamedMesh
+    {
+        std::string                     path            = {};
+        std::string                     texture_path    = {};
+        Bounds                          bounds          = {};
+        Vertex::QuantizationParams      quantization    = {};
+        std::vector<StreamedNode>       nodes           = {};   // nodes[0] is the root.
+        std::vector<StreamedCluster>    clusters        = {};
+    };
+
+    /**
+     * Engine native streamed mesh file (.gstream) written by gymnure_cook for very large meshes.
+     *
+     * Each mesh is an octree over its bounds. Leaves hold the original triangles of their cell. Inner nodes hold
+     * the triangles of their cell, vertex clustered on a grid of NODE_GRID_SIZE cells per node side, so every
+     * level halves the error of the one above. A level is clustered on one grid over the whole mesh, so nodes
+     * of the same level share their borders.
+     *
+     * Node geometry is split in clusters of at most CLUSTER_MAX_VERTICES vertices (Vertex::PackedVertexData,
+     * quantized over the whole mesh) and CLUSTER_MAX_TRIANGLES triangles (16 bits indices local to the cluster).
+     * The clusters of a node are stored together, from a page boundary, so a node is a single aligned read.
+     *
+     * Header and node tables of every mesh come first, node payloads last. Values are little endian.
+     * */
+    class StreamedMeshFile
+    {
+    public:
+
+        static constexpr uint32_t VERSION               = 1;
+        static constexpr uint32_t NODE_GRID_SIZE        = 32;
+        static constexpr uint32_t LEAF_MAX_TRIANGLES    = 32768;
+        static constexpr uint32_t MAX_DEPTH             = 12;
+        static constexpr uint32_t CLUSTER_MAX_VERTICES  = 4096;
+        static constexpr uint32_t CLUSTER_MAX_TRIANGLES = 8192;
+        static constexpr size_t   PAGE_SIZE             = 4096;
+
+        StreamedMeshFile() = delete;
+
+        static bool write(const std::string& path, const Model& model);
+
+        /**
+         * Header and node tables of every mesh, geometry is left in the file.
+         * */
+        static std::vector<std::shared_ptr<StreamedMesh>> read(const std::string& path);
+    };
+}
+
+#endif //GYMNURE_STREAMEDMESHFILE_H
@@ -0,0 +1,326 @@
+#include <cmath>
+#include <algorithm>
+#include "ThreadPool.h"
+#include "TangentSpace.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GYMNURE_TANGENT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Engine::Util
+{
+    namespace
+    {
+        struct FaceTangent
+        {
+            glm::vec3   direction   = glm::vec3(0.0f);  // Object space direction of increasing u, unnormalized.
+            float       angles[3]   = {};               // Corner angles.
+            bool        mirrored    = false;            // UVs wound the other way round than positions.
+        };
+
+        /**
+         * Call fn(begin, end) over 'count' items split in batches of 'batch_size', on the ThreadPool.
+         * */
+        template <class F>
+        void parallelBatches(size_t count, size_t batch_size, F&& fn)
+        {
+            size_t batch_count = (count + batch_size - 1) / batch_size;
+            ThreadPool::getInstance()->parallelFor(batch_count, [&](size_t batch)
+            {
+                size_t begin = batch * batch_size;
+                fn(begin, std::min(begin + batch_size, count));
+            });
+        }
+
+        float cornerAngle(const glm::vec3& corner, const glm::vec3& next, const glm::vec3& previous)
+        {
+            glm::vec3 u = next - corner;
+            glm::vec3 w = previous - corner;
+            float lengths = glm::length(u) * glm::length(w);
+
+            return lengths > 0.0f ? std::acos(glm::clamp(glm::dot(u, w) / lengths, -1.0f, 1.0f)) : 0.0f;
+        }
+
+#ifdef GYMNURE_TANGENT_SSE2
+        /**
+         * Corners of triangles t to t + 3, transposed: x[k] holds the x coordinate of corner k of the four triangles.
+         * */
+        struct TriangleBatch
+        {
+            __m128 x[3], y[3], z[3];
+            __m128 u[3], v[3];
+        };
+
+        TriangleBatch loadTriangles(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices, size_t t, bool with_uvs)
+        {
+            TriangleBatch batch = {};
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const VertexData& a = vertices[indices[t * 3 + k]];
+                const VertexData& b = vertices[indices[t * 3 + 3 + k]];
+                const VertexData& c = vertices[indices[t * 3 + 6 + k]];
+                const VertexData& d = vertices[indices[t * 3 + 9 + k]];
+
+                batch.x[k] = _mm_setr_ps(a.pos.x, b.pos.x, c.pos.x, d.pos.x);
+                batch.y[k] = _mm_setr_ps(a.pos.y, b.pos.y, c.pos.y, d.pos.y);
+                batch.z[k] = _mm_setr_ps(a.pos.z, b.pos.z, c.pos.z, d.pos.z);
+
+                if (with_uvs) {
+                    batch.u[k] = _mm_setr_ps(a.uv.x, b.uv.x, c.uv.x, d.uv.x);
+                    batch.v[k] = _mm_setr_ps(a.uv.y, b.uv.y, c.uv.y, d.uv.y);
+                }
+            }
+
+            return batch;
+        }
+
+        __m128 dot3(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        }
+
+        /**
+         * dot / lengths clamped to [-1, 1], 1 (zero angle) where an edge is degenerate.
+         * */
+        __m128 safeCosine(__m128 dot, __m128 lengths)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            __m128 valid = _mm_cmpgt_ps(lengths, _mm_setzero_ps());
+            __m128 cosine = _mm_div_ps(dot, _mm_or_ps(_mm_and_ps(valid, lengths), _mm_andnot_ps(valid, one)));
+            cosine = _mm_max_ps(_mm_min_ps(cosine, one), _mm_set1_ps(-1.0f));
+
+            return _mm_or_ps(_mm_and_ps(valid, cosine), _mm_andnot_ps(valid, one));
+        }
+#endif
+    }
+
+    TangentSpace::Adjacency TangentSpace::buildAdjacency(const std::vector<uint32_t>& indices, size_t vertex_count)
+    {
+        Adjacency adjacency = {};
+        size_t corner_count = indices.size() / 3 * 3;
+
+        // Counting sort of the corners by vertex.
+        adjacency.offsets.assign(vertex_count + 1, 0);
+        for (size_t c = 0; c < corner_count; ++c)
+            if (indices[c] < vertex_count)
+                adjacency.offsets[indices[c] + 1]++;
+
+        for (size_t v = 0; v < vertex_count; ++v)
+            adjacency.offsets[v + 1] += adjacency.offsets[v];
+
+        std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        adjacency.corners.resize(adjacency.offsets.back());
+        for (size_t c = 0; c < corner_count; ++c)
+            if (indices[c] < vertex_count)
+                adjacency.corners[cursor[indices[c]]++] = static_cast<uint32_t>(c);
+
+        return adjacency;
+    }
+
+    std::vector<glm::vec3> TangentSpace::computeFaceNormals(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices)
+    {
+        size_t triangle_count = indices.size() / 3;
+        std::vector<glm::vec3> normals(triangle_count);
+
+        parallelBatches(triangle_count, BATCH_SIZE, [&](size_t begin, size_t end)
+        {
+            size_t t = begin;
+
+#ifdef GYMNURE_TANGENT_SSE2
+            // Four triangles per iteration, transposed to one register per coordinate.
+            for (; t + 4 <= end; t += 4)
+            {
+                TriangleBatch p = loadTriangles(vertices, indices, t, false);
+
+                __m128 e1x = _mm_sub_ps(p.x[1], p.x[0]), e1y = _mm_sub_ps(p.y[1], p.y[0]), e1z = _mm_sub_ps(p.z[1], p.z[0]);
+                __m128 e2x = _mm_sub_ps(p.x[2], p.x[0]), e2y = _mm_sub_ps(p.y[2], p.y[0]), e2z = _mm_sub_ps(p.z[2], p.z[0]);
+
+                alignas(16) float nx[4], ny[4], nz[4];
+                _mm_store_ps(nx, _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y)));
+                _mm_store_ps(ny, _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z)));
+                _mm_store_ps(nz, _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x)));
+
+                for (size_t i = 0; i < 4; ++i)
+                    normals[t + i] = glm::vec3(nx[i], ny[i], nz[i]);
+            }
+#endif
+
+            for (; t < end; ++t)
+            {
+                const glm::vec3& a = vertices[indices[t * 3]].pos;
+                normals[t] = glm::cross(vertices[indices[t * 3 + 1]].pos - a, vertices[indices[t * 3 + 2]].pos - a);
+            }
+        });
+
+        return normals;
+    }
+
+    void TangentSpace::generateNormals(Mesh& mesh)
+    {
+        auto& vertices = *mesh.vertexData;
+        const auto& indices = *mesh.indexData;
+
+        std::vector<glm::vec3> face_normals = computeFaceNormals(vertices, indices);
+        Adjacency adjacency = buildAdjacency(indices, vertices.size());
+
+        parallelBatches(vertices.size(), BATCH_SIZE, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                glm::vec3 normal = glm::vec3(0.0f);
+                for (uint32_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+                    normal += face_normals[adjacency.corners[i] / 3];
+
+                float length = glm::length(normal);
+                vertices[v].normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+        });
+    }
+
+    void TangentSpace::generateTangents(Mesh& mesh)
+    {
+        auto& vertices = *mesh.vertexData;
+        auto& indices = *mesh.indexData;
+
+        size_t triangle_count = indices.size() / 3;
+        std::vector<FaceTangent> faces(triangle_count);
+
+        parallelBatches(triangle_count, BATCH_SIZE, [&](size_t begin, size_t end)
+        {
+            size_t t = begin;
+
+#ifdef GYMNURE_TANGENT_SSE2
+            for (; t + 4 <= end; t += 4)
+            {
+                TriangleBatch p = loadTriangles(vertices, indices, t, true);
+
+                __m128 e1x = _mm_sub_ps(p.x[1], p.x[0]), e1y = _mm_sub_ps(p.y[1], p.y[0]), e1z = _mm_sub_ps(p.z[1], p.z[0]);
+                __m128 e2x = _mm_sub_ps(p.x[2], p.x[0]), e2y = _mm_sub_ps(p.y[2], p.y[0]), e2z = _mm_sub_ps(p.z[2], p.z[0]);
+                __m128 e3x = _mm_sub_ps(p.x[2], p.x[1]), e3y = _mm_sub_ps(p.y[2], p.y[1]), e3z = _mm_sub_ps(p.z[2], p.z[1]);
+
+                __m128 t1u = _mm_sub_ps(p.u[1], p.u[0]), t1v = _mm_sub_ps(p.v[1], p.v[0]);
+                __m128 t2u = _mm_sub_ps(p.u[2], p.u[0]), t2v = _mm_sub_ps(p.v[2], p.v[0]);
+
+                // Direction flipped by the sign bit of the UV area.
+                __m128 uv_area = _mm_sub_ps(_mm_mul_ps(t1u, t2v), _mm_mul_ps(t1v, t2u));
+                __m128 mirrored = _mm_cmplt_ps(uv_area, _mm_setzero_ps());
+                __m128 sign = _mm_and_ps(mirrored, _mm_set1_ps(-0.0f));
+
+                alignas(16) float dx[4], dy[4], dz[4], cosines[3][4];
+                _mm_store_ps(dx, _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e1x, t2v), _mm_mul_ps(e2x, t1v)), sign));
+                _mm_store_ps(dy, _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e1y, t2v), _mm_mul_ps(e2y, t1v)), sign));
+                _mm_store_ps(dz, _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e1z, t2v), _mm_mul_ps(e2z, t1v)), sign));
+
+                __m128 l1 = _mm_sqrt_ps(dot3(e1x, e1y, e1z, e1x, e1y, e1z));
+                __m128 l2 = _mm_sqrt_ps(dot3(e2x, e2y, e2z, e2x, e2y, e2z));
+                __m128 l3 = _mm_sqrt_ps(dot3(e3x, e3y, e3z, e3x, e3y, e3z));
+
+                // Corner 0 sits between e1 and e2, corner 1 between -e1 and e3, corner 2 between -e2 and -e3.
+                _mm_store_ps(cosines[0], safeCosine(dot3(e1x, e1y, e1z, e2x, e2y, e2z), _mm_mul_ps(l1, l2)));
+                _mm_store_ps(cosines[1], safeCosine(_mm_xor_ps(dot3(e1x, e1y, e1z, e3x, e3y, e3z), _mm_set1_ps(-0.0f)), _mm_mul_ps(l1, l3)));
+                _mm_store_ps(cosines[2], safeCosine(dot3(e2x, e2y, e2z, e3x, e3y, e3z), _mm_mul_ps(l2, l3)));
+
+                int mirrored_mask = _mm_movemask_ps(mirrored);
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    FaceTangent& face = faces[t + i];
+                    face.direction = glm::vec3(dx[i], dy[i], dz[i]);
+                    face.mirrored  = (mirrored_mask >> i) & 1;
+                    for (size_t k = 0; k < 3; ++k)
+                        face.angles[k] = std::acos(cosines[k][i]);
+                }
+            }
+#endif
+
+            for (; t < end; ++t)
+            {
+                const VertexData& a = vertices[indices[t * 3]];
+                const VertexData& b = vertices[indices[t * 3 + 1]];
+                const VertexData& c = vertices[indices[t * 3 + 2]];
+
+                glm::vec3 e1 = b.pos - a.pos, e2 = c.pos - a.pos;
+                glm::vec2 t1 = b.uv - a.uv,   t2 = c.uv - a.uv;
+
+                // Sign of the UV area flips the gradient of mirrored triangles, its magnitude is dropped by the projection.
+                float uv_area = t1.x * t2.y - t1.y * t2.x;
+                FaceTangent& face = faces[t];
+                face.mirrored  = uv_area < 0.0f;
+                face.direction = (e1 * t2.y - e2 * t1.y) * (face.mirrored ? -1.0f : 1.0f);
+                face.angles[0] = cornerAngle(a.pos, b.pos, c.pos);
+                face.angles[1] = cornerAngle(b.pos, c.pos, a.pos);
+                face.angles[2] = cornerAngle(c.pos, a.pos, b.pos);
+            }
+        });
+
+        Adjacency adjacency = buildAdjacency(indices, vertices.size());
+
+        // Tangent of the mirrored corners of vertices used both ways, w stays 0 for the others.
+        std::vector<glm::vec4> split_tangents(vertices.size(), glm::vec4(0.0f));
+
+        parallelBatches(vertices.size(), BATCH_SIZE, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                const glm::vec3 normal = vertices[v].normal;
+                glm::vec3 sums[2] = { glm::vec3(0.0f), glm::vec3(0.0f) };
+                bool used[2] = { false, false };
+
+                for (uint32_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+                {
+                    uint32_t corner = adjacency.corners[i];
+                    const FaceTangent& face = faces[corner / 3];
+
+                    glm::vec3 projected = face.direction - normal * glm::dot(normal, face.direction);
+                    float length = glm::length(projected);
+
+                    used[face.mirrored] = true;
+                    if (length > 0.0f)
+                        sums[face.mirrored] += projected * (face.angles[corner % 3] / length);
+                }
+
+                auto finish = [&normal](const glm::vec3& sum, float sign)
+                {
+                    float length = glm::length(sum);
+                    return glm::vec4(length > 0.0f ? sum / length : getOrthogonal(normal), sign);
+                };
+
+                if (used[0] || !used[1])
+                    vertices[v].tangent = finish(sums[0], 1.0f);
+                else
+                    vertices[v].tangent = finish(sums[1], -1.0f);
+
+                if (used[0] && used[1])
+                    split_tangents[v] = finish(sums[1], -1.0f);
+            }
+        });
+
+        // Mirrored corners of split vertices move to a copy carrying their tangent.
+        size_t vertex_count = vertices.size();
+        for (size_t v = 0; v < vertex_count; ++v)
+        {
+            if (split_tangents[v].w == 0.0f)
+                continue;
+
+            VertexData copy = vertices[v];
+            copy.tangent = split_tangents[v];
+
+            auto copy_index = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(copy);
+
+            for (uint32_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+                if (faces[adjacency.corners[i] / 3].mirrored)
+                    indices[adjacency.corners[i]] = copy_index;
+        }
+    }
+
+    glm::vec3 TangentSpace::getOrthogonal(const glm::vec3& normal)
+    {
+        // Duff et al., "Building an Orthonormal Basis, Revisited".
+        float sign = std::copysign(1.0f, normal.z);
+        float a = -1.0f / (sign + normal.z);
+        float b = normal.x * normal.y * a;
+
+        return glm::vec3(1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef GYMNURE_TANGENTSPACE_H
+#define GYMNURE_TANGENTSPACE_H
+
+#include <vector>
+#include <cstdint>
+#include "ModelData.hpp"
+
+namespace Engine::Util
+{
+    /**
+     * Vertex normals and tangents of indexed triangle meshes, run by the loaders (so by the cooker too).
+     *
+     * Both walk a vertex to triangle corner adjacency, so each vertex gathers its own sum and batches of
+     * vertices run on the ThreadPool without atomics. Face terms are computed four triangles at a time with SSE.
+     * */
+    class TangentSpace
+    {
+
+    private:
+
+        static constexpr size_t BATCH_SIZE = 16 * 1024;
+
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets = {};  // Corners of vertex v are corners[offsets[v]] to corners[offsets[v + 1]].
+            std::vector<uint32_t> corners = {};  // Position in the index list, triangle is corner / 3.
+        };
+
+        static Adjacency buildAdjacency(const std::vector<uint32_t>& indices, size_t vertex_count);
+
+        /**
+         * Unnormalized face normals (length is twice the triangle area).
+         * */
+        static std::vector<glm::vec3> computeFaceNormals(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices);
+
+    public:
+
+        TangentSpace() = delete;
+
+        /**
+         * Area weighted smooth normals.
+         * */
+        static void generateNormals(Mesh& mesh);
+
+        /**
+         * MikkTSpace style tangents: per corner UV gradient projected on the vertex normal plane, weighted by the corner angle.
+         * w is the bitangent sign (bitangent = w * cross(normal, tangent)). Vertices shared by mirrored and non mirrored
+         * UV triangles are split, so vertices may be appended and indexData remapped.
+         * */
+        static void generateTangents(Mesh& mesh);
+
+        /**
+         * Any unit tangent of 'normal', for meshes without UVs.
+         * */
+        static glm::vec3 getOrthogonal(const glm::vec3& normal);
+    };
+}
+
+#endif //GYMNURE_TANGENTSPACE_H
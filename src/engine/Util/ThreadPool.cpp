@@ -0,0 +1,70 @@
+#include "ThreadPool.h"
+
+namespace Engine::Util
+{
+    std::shared_ptr<ThreadPool> ThreadPool::instance = nullptr;
+
+    ThreadPool::ThreadPool(uint32_t thread_count)
+    {
+        for (uint32_t i = 0; i < thread_count; ++i)
+            workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    std::shared_ptr<ThreadPool> ThreadPool::getInstance()
+    {
+        static std::once_flag once;
+        std::call_once(once, []()
+        {
+            uint32_t hw_threads = std::thread::hardware_concurrency();
+            instance = std::make_shared<ThreadPool>(hw_threads > 1 ? hw_threads - 1 : 1);
+        });
+
+        return instance;
+    }
+
+    uint32_t ThreadPool::getThreadCount() const
+    {
+        return static_cast<uint32_t>(workers_.size());
+    }
+
+    void ThreadPool::enqueue(std::function<void()>&& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push(std::move(task));
+        }
+        condition_.notify_one();
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+
+                if (stop_ && tasks_.empty())
+                    return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+
+            task();
+        }
+    }
+}
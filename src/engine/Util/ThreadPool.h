@@ -0,0 +1,118 @@
+#ifndef GYMNURE_THREADPOOL_H
+#define GYMNURE_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Engine::Util
+{
+    class ThreadPool
+    {
+
+    private:
+
+        std::vector<std::thread>            workers_    = {};
+        std::queue<std::function<void()>>   tasks_      = {};
+        std::mutex                          mutex_      = {};
+        std::condition_variable             condition_  = {};
+        bool                                stop_       = false;
+
+        static std::shared_ptr<ThreadPool>  instance;
+
+        void enqueue(std::function<void()>&& task);
+        void workerLoop();
+
+    public:
+
+        explicit ThreadPool(uint32_t thread_count);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Engine-wide pool, with one worker per hardware thread (minus the calling one).
+         * */
+        static std::shared_ptr<ThreadPool> getInstance();
+
+        [[nodiscard]] uint32_t getThreadCount() const;
+
+        template <class F>
+        auto submit(F&& fn) -> std::future<std::invoke_result_t<F>>
+        {
+            using R = std::invoke_result_t<F>;
+
+            auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+            std::future<R> result = task->get_future();
+            enqueue([task]() { (*task)(); });
+
+            return result;
+        }
+
+        /**
+         * Call fn(i) for every i in [0, count) across workers and block until all are done.
+         * The calling thread takes part in the work, so it is safe to call it from inside a worker.
+         * */
+        template <class F>
+        void parallelFor(size_t count, F&& fn)
+        {
+            if (count == 0)
+                return;
+
+            struct State
+            {
+                std::atomic<size_t>     next = 0;
+                std::atomic<size_t>     done = 0;
+                std::mutex              mutex = {};
+                std::condition_variable condition = {};
+                std::exception_ptr      exception = nullptr;
+            };
+
+            auto state = std::make_shared<State>();
+            auto body  = std::make_shared<std::function<void(size_t)>>(std::forward<F>(fn));
+
+            auto run = [state, body, count]()
+            {
+                size_t i;
+                while ((i = state->next++) < count)
+                {
+                    try {
+                        (*body)(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (!state->exception) state->exception = std::current_exception();
+                    }
+
+                    if (++state->done == count) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->condition.notify_all();
+                    }
+                }
+            };
+
+            size_t helpers = std::min(count - 1, static_cast<size_t>(workers_.size()));
+            for (size_t i = 0; i < helpers; ++i)
+                enqueue(run);
+
+            run();
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->condition.wait(lock, [&state, count]() { return state->done == count; });
+
+            if (state->exception)
+                std::rethrow_exception(state->exception);
+        }
+    };
+}
+
+#endif //GYMNURE_THREADPOOL_H
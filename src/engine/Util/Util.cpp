@@ -1,5 +1,6 @@
 #include <vulkan/vulkan.hpp>
 #include <ApplicationData.hpp>
+#include "AsyncIO.h"
 #include "Util.h"
 
 namespace Engine
@@ -47,36 +48,17 @@ namespace Engine
 
         vk::ShaderModule Util::loadSPIRVShader(const std::string& filename)
         {
-            long shaderSize;
-            char* shaderCode = nullptr;
-
             std::string shader_file_path = "spirv/" + filename;
-            std::ifstream is(shader_file_path, std::ios::binary | std::ios::in | std::ios::ate);
-
-            if (is.is_open())
-            {
-                shaderSize = is.tellg();
-                assert(shaderSize > 0);
+            IOBuffer shader_code = AsyncIO::getInstance()->read(shader_file_path).get();
 
-                is.seekg(0, std::ios::beg);
-                // Copy file contents into a buffer
-                shaderCode = new char[shaderSize];
-                is.read(shaderCode, shaderSize);
-                is.close();
-            }
-            if (shaderCode)
+            if (shader_code && shader_code.size > 0)
             {
                 // Create a new shader module that will be used for pipeline creation
                 vk::ShaderModuleCreateInfo moduleCreateInfo{};
-                moduleCreateInfo.codeSize = static_cast<size_t>(shaderSize);
-                moduleCreateInfo.pCode = (uint32_t*)shaderCode;
-
-                vk::ShaderModule shaderModule;
-                shaderModule = ApplicationData::data->device.createShaderModule(moduleCreateInfo);
-
-                delete[] shaderCode;
+                moduleCreateInfo.codeSize = shader_code.size;
+                moduleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(shader_code.data.get());
 
-                return shaderModule;
+                return ApplicationData::data->device.createShaderModule(moduleCreateInfo);
             }
             else
             {
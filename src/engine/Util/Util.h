@@ -14,6 +14,9 @@
 #define ASSETS_FOLDER_PATH_STR "."
 #endif
 
+// Engine ready assets generated from ASSETS_FOLDER_PATH_STR sources.
+#define COOKED_FOLDER_PATH_STR ASSETS_FOLDER_PATH_STR "/cooked"
+
 #include <vector>
 #include <fstream>
 #include <cstring>
@@ -0,0 +1,54 @@
+#ifndef GYMNURE_LAYOUTS_HPP
+#define GYMNURE_LAYOUTS_HPP
+
+#include <imgui/imgui.h>
+#include <Util/ModelData.hpp>
+#include "VertexLayout.hpp"
+#include "VertexQuantizer.h"
+
+namespace Engine::Vertex
+{
+    // Position, UV, normal and tangent from interleaved VertexData (64 bytes per vertex).
+    using MeshLayout = VertexLayout<
+        Binding<INTERLEAVED, VertexData,
+            Attribute<vk::Format::eR32G32B32Sfloat,    offsetof(VertexData, pos)>,
+            Attribute<vk::Format::eR32G32Sfloat,       offsetof(VertexData, uv)>,
+            Attribute<vk::Format::eR32G32B32Sfloat,    offsetof(VertexData, normal)>,
+            Attribute<vk::Format::eR32G32B32A32Sfloat, offsetof(VertexData, tangent)>>>;
+
+    // Same attributes as MeshLayout, quantized (20 bytes per vertex). The tangent is decoded from pos.w.
+    using PackedMeshLayout = VertexLayout<
+        Binding<INTERLEAVED, PackedVertexData,
+            Attribute<vk::Format::eR16G16B16A16Unorm, offsetof(PackedVertexData, pos)>,
+            Attribute<vk::Format::eR16G16Sfloat,      offsetof(PackedVertexData, uv)>,
+            Attribute<vk::Format::eR16G16Snorm,       offsetof(PackedVertexData, normal)>>>;
+
+    // MeshLayout without the tangent, for shaders that do no normal mapping (the deferred G-buffer pass).
+    using UnmappedMeshLayout = VertexLayout<
+        Binding<INTERLEAVED, VertexData,
+            Attribute<vk::Format::eR32G32B32Sfloat, offsetof(VertexData, pos)>,
+            Attribute<vk::Format::eR32G32Sfloat,    offsetof(VertexData, uv)>,
+            Attribute<vk::Format::eR32G32B32Sfloat, offsetof(VertexData, normal)>>>;
+
+    // Position only stream (12 bytes per vertex), for depth/shadow passes.
+    using PositionLayout = VertexLayout<
+        Binding<POSITION, glm::vec3,
+            Attribute<vk::Format::eR32G32B32Sfloat, 0>>>;
+
+    // MeshLayout locations, with position fetched from the position only stream.
+    using SplitMeshLayout = VertexLayout<
+        Binding<POSITION, glm::vec3,
+            Attribute<vk::Format::eR32G32B32Sfloat, 0>>,
+        Binding<INTERLEAVED, VertexData,
+            Attribute<vk::Format::eR32G32Sfloat,       offsetof(VertexData, uv)>,
+            Attribute<vk::Format::eR32G32B32Sfloat,    offsetof(VertexData, normal)>,
+            Attribute<vk::Format::eR32G32B32A32Sfloat, offsetof(VertexData, tangent)>>>;
+
+    using UiLayout = VertexLayout<
+        Binding<INTERLEAVED, ImDrawVert,
+            Attribute<vk::Format::eR32G32Sfloat,  offsetof(ImDrawVert, pos)>,
+            Attribute<vk::Format::eR32G32Sfloat,  offsetof(ImDrawVert, uv)>,
+            Attribute<vk::Format::eR8G8B8A8Unorm, offsetof(ImDrawVert, col)>>>;
+}
+
+#endif //GYMNURE_LAYOUTS_HPP
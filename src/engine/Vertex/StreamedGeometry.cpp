@@ -0,0 +1,356 @@
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <RenderPass/Queue.h>
+#include "StreamedGeometry.h"
+
+namespace Engine::Vertex
+{
+    StreamedGeometry::StreamedGeometry(std::shared_ptr<const Util::StreamedMesh> mesh, size_t budget) : mesh_(std::move(mesh))
+    {
+        auto app_data = ApplicationData::data;
+        const std::vector<Util::StreamedNode>& nodes = mesh_->nodes;
+
+        // The root and any one node must fit together, or refining it could never make progress.
+        uint32_t max_node_clusters = 0;
+        uint32_t max_payload_size = 0;
+        for (size_t i = 1; i < nodes.size(); ++i) {
+            max_node_clusters = std::max(max_node_clusters, nodes[i].cluster_count);
+            max_payload_size = std::max(max_payload_size, nodes[i].payload_size);
+        }
+        max_payload_size = std::max(max_payload_size, nodes[0].payload_size);
+
+        slot_count_ = std::max(static_cast<uint32_t>(budget / SLOT_SIZE), nodes[0].cluster_count + max_node_clusters);
+
+        nodes_.resize(nodes.size());
+        for (uint32_t slot = slot_count_; slot > 0; --slot)
+            free_slots_.push_back(slot - 1);
+
+        struct BufferData buffer_data = {};
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+        buffer_data.usage      = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        buffer_data.count      = static_cast<size_t>(slot_count_) * SLOT_VERTICES;
+        vertex_buffer_ = std::make_unique<Memory::Buffer<PackedVertexData>>(buffer_data);
+
+        buffer_data.usage      = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        buffer_data.count      = static_cast<size_t>(slot_count_) * SLOT_INDICES;
+        index_buffer_ = std::make_unique<Memory::Buffer<uint16_t>>(buffer_data);
+
+        buffer_data.usage      = vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        buffer_data.count      = slot_count_;
+        draw_buffer_ = std::make_unique<Memory::Buffer<vk::DrawIndexedIndirectCommand>>(buffer_data);
+
+        // Draw commands first, then the node payloads uploaded in the frame.
+        buffer_data.usage      = vk::BufferUsageFlagBits::eTransferSrc;
+        buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        buffer_data.count      = std::max(STAGING_SIZE, draw_buffer_->getSize() + max_payload_size);
+        staging_buffer_ = std::make_unique<Memory::Buffer<uint8_t>>(buffer_data);
+        staging_ = static_cast<uint8_t*>(staging_buffer_->map());
+
+        vk::CommandBufferAllocateInfo cmd_buff_ai = {};
+        cmd_buff_ai.pNext               = nullptr;
+        cmd_buff_ai.commandPool         = app_data->graphic_command_pool;
+        cmd_buff_ai.level               = vk::CommandBufferLevel::ePrimary;
+        cmd_buff_ai.commandBufferCount  = 1;
+        command_buffer_ = app_data->device.allocateCommandBuffers(cmd_buff_ai)[0];
+
+        vk::FenceCreateInfo fence_info = {};
+        fence_info.flags = vk::FenceCreateFlagBits::eSignaled;
+        fence_ = app_data->device.createFence(fence_info);
+    }
+
+    StreamedGeometry::~StreamedGeometry()
+    {
+        auto app_data = ApplicationData::data;
+
+        app_data->device.waitForFences({fence_}, VK_TRUE, UINT64_MAX);
+        app_data->device.destroyFence(fence_);
+        app_data->device.freeCommandBuffers(app_data->graphic_command_pool, {command_buffer_});
+        staging_buffer_->unmap();
+    }
+
+    void StreamedGeometry::request(uint32_t node)
+    {
+        const Util::StreamedNode& streamed_node = mesh_->nodes[node];
+
+        nodes_[node].residency = Residency::LOADING;
+        nodes_[node].read = Util::AsyncIO::getInstance()->read(mesh_->path, streamed_node.payload_offset, streamed_node.payload_size);
+        pending_reads_++;
+    }
+
+    void StreamedGeometry::evict(uint32_t node)
+    {
+        free_slots_.insert(free_slots_.end(), nodes_[node].slots.begin(), nodes_[node].slots.end());
+        nodes_[node].slots.clear();
+        nodes_[node].residency = Residency::NONE;
+    }
+
+    bool StreamedGeometry::allocateSlots(uint32_t node)
+    {
+        uint32_t slot_count = mesh_->nodes[node].cluster_count;
+
+        if (free_slots_.size() < slot_count)
+        {
+            // Least recently visited first. Nodes visited this frame may be drawn, the root is the last fallback.
+            std::vector<uint32_t> candidates = {};
+            for (uint32_t i = 1; i < nodes_.size(); ++i)
+                if (nodes_[i].residency == Residency::RESIDENT && nodes_[i].last_used < frame_)
+                    candidates.push_back(i);
+
+            std::sort(candidates.begin(), candidates.end(),
+                      [this](uint32_t a, uint32_t b) { return nodes_[a].last_used < nodes_[b].last_used; });
+
+            for (size_t i = 0; i < candidates.size() && free_slots_.size() < slot_count; ++i)
+                evict(candidates[i]);
+        }
+
+        if (free_slots_.size() < slot_count)
+            return false;
+
+        nodes_[node].slots.assign(free_slots_.end() - slot_count, free_slots_.end());
+        free_slots_.resize(free_slots_.size() - slot_count);
+
+        return true;
+    }
+
+    std::vector<uint32_t> StreamedGeometry::selectNodes(const Descriptors::Camera& camera, std::vector<NodeRequest>& requests)
+    {
+        const std::vector<Util::StreamedNode>& nodes = mesh_->nodes;
+        std::vector<uint32_t> selected = {};
+
+        if (nodes_[0].residency != Residency::RESIDENT)
+        {
+            if (nodes_[0].residency == Residency::NONE)
+                requests.push_back({0, std::numeric_limits<float>::max()});
+            return selected;
+        }
+
+        // Model matrices are identity, so the mesh is already in world space.
+        std::array<glm::vec4, 6> planes = camera.getFrustumPlanes();
+        glm::vec3 eye = camera.getEyePosition();
+        float pixels_per_unit = camera.getPixelsPerUnit();
+
+        auto isVisible = [&planes](const Util::StreamedNode& node) {
+            return Descriptors::Camera::isSphereVisible(planes, node.center, node.radius);
+        };
+
+        // Node error in pixels at the closest point of its sphere, always refined from inside it.
+        auto projectedError = [&eye, pixels_per_unit](const Util::StreamedNode& node) {
+            float distance = glm::length(node.center - eye) - node.radius;
+            if (distance <= 0.f)
+                return std::numeric_limits<float>::max();
+            return node.error * pixels_per_unit / distance;
+        };
+
+        std::vector<uint32_t> stack = {0};
+        while (!stack.empty())
+        {
+            uint32_t index = stack.back();
+            stack.pop_back();
+
+            const Util::StreamedNode& node = nodes[index];
+            if (!isVisible(node))
+                continue;
+
+            nodes_[index].last_used = frame_;
+
+            float error = projectedError(node);
+            if (node.child_count == 0 || error <= MAX_PIXEL_ERROR) {
+                selected.push_back(index);
+                continue;
+            }
+
+            // Children replace the node all at once, so it stays drawn until every visible one is resident.
+            bool children_resident = true;
+            for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+            {
+                if (!isVisible(nodes[child]))
+                    continue;
+
+                if (nodes_[child].residency == Residency::RESIDENT) {
+                    nodes_[child].last_used = frame_;
+                    continue;
+                }
+
+                children_resident = false;
+                if (nodes_[child].residency == Residency::NONE)
+                    requests.push_back({child, error});
+            }
+
+            if (!children_resident) {
+                selected.push_back(index);
+                continue;
+            }
+
+            for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+                stack.push_back(child);
+        }
+
+        return selected;
+    }
+
+    void StreamedGeometry::update(const Descriptors::Camera& camera)
+    {
+        auto device = ApplicationData::data->device;
+
+        // Staging memory and slots written by the last copies are still in use.
+        if (device.getFenceStatus(fence_) != vk::Result::eSuccess)
+            return;
+
+        frame_++;
+
+        std::vector<NodeRequest> requests = {};
+        std::vector<uint32_t> selected = selectNodes(camera, requests);
+
+        // Finished reads go to the staging buffer, one copy per cluster vertices and indices.
+        std::vector<vk::BufferCopy> vertex_copies = {};
+        std::vector<vk::BufferCopy> index_copies = {};
+        size_t draws_size = draw_buffer_->getSize();
+        size_t staging_offset = draws_size;
+
+        for (uint32_t i = 0; i < nodes_.size(); ++i)
+        {
+            NodeState& state = nodes_[i];
+            const Util::StreamedNode& node = mesh_->nodes[i];
+
+            if (state.residency != Residency::LOADING || state.read.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+
+            // Left for the next frame.
+            if (staging_offset + node.payload_size > staging_buffer_->getSize())
+                break;
+
+            Util::IOBuffer buffer = state.read.get();
+            pending_reads_--;
+
+            if (!buffer || buffer.size < node.payload_size) {
+                Debug::logErrorAndDie("Failed to read streamed geometry from " + mesh_->path + "!");
+                state.residency = Residency::NONE;
+                continue;
+            }
+
+            // Slots are adjacent, an index past its cluster would read another one.
+            bool corrupted = false;
+            for (uint32_t c = 0; c < node.cluster_count && !corrupted; ++c)
+            {
+                const Util::StreamedCluster& cluster = mesh_->clusters[node.first_cluster + c];
+                const auto* indices = reinterpret_cast<const uint16_t*>(buffer.data.get() + cluster.payload_offset +
+                                                                         cluster.vertex_count * sizeof(PackedVertexData));
+                corrupted = std::any_of(indices, indices + cluster.index_count,
+                                        [&cluster](uint16_t index) { return index >= cluster.vertex_count; });
+            }
+
+            if (corrupted) {
+                Debug::logErrorAndDie("Corrupted streamed geometry in " + mesh_->path + "!");
+                state.residency = Residency::NONE;
+                continue;
+            }
+
+            // Out of budget with everything in view: requested again when some node gets out of it.
+            if (!allocateSlots(i)) {
+                state.residency = Residency::NONE;
+                continue;
+            }
+
+            uint8_t* payload = staging_ + staging_offset;
+            memcpy(payload, buffer.data.get(), node.payload_size);
+
+            for (uint32_t c = 0; c < node.cluster_count; ++c)
+            {
+                const Util::StreamedCluster& cluster = mesh_->clusters[node.first_cluster + c];
+                uint32_t slot = state.slots[c];
+                size_t vertices_size = cluster.vertex_count * sizeof(PackedVertexData);
+
+                vertex_copies.emplace_back(staging_offset + cluster.payload_offset,
+                                           static_cast<vk::DeviceSize>(slot) * SLOT_VERTICES * sizeof(PackedVertexData), vertices_size);
+                index_copies.emplace_back(staging_offset + cluster.payload_offset + vertices_size,
+                                          static_cast<vk::DeviceSize>(slot) * SLOT_INDICES * sizeof(uint16_t),
+                                          cluster.index_count * sizeof(uint16_t));
+            }
+
+            staging_offset += node.payload_size;
+            state.residency = Residency::RESIDENT;
+            // Not evicted by the next uploads of this frame.
+            state.last_used = frame_;
+        }
+
+        // Most visible first.
+        std::sort(requests.begin(), requests.end(), [](const NodeRequest& a, const NodeRequest& b) { return a.priority > b.priority; });
+        for (size_t i = 0; i < requests.size() && pending_reads_ < MAX_PENDING_READS; ++i)
+            request(requests[i].node);
+
+        std::vector<vk::DrawIndexedIndirectCommand> draws(slot_count_, vk::DrawIndexedIndirectCommand{0, 1, 0, 0, 0});
+        for (uint32_t index : selected)
+        {
+            const Util::StreamedNode& node = mesh_->nodes[index];
+            for (uint32_t c = 0; c < node.cluster_count; ++c)
+            {
+                uint32_t slot = nodes_[index].slots[c];
+                draws[slot].indexCount   = mesh_->clusters[node.first_cluster + c].index_count;
+                draws[slot].firstIndex   = slot * SLOT_INDICES;
+                draws[slot].vertexOffset = static_cast<int32_t>(slot * SLOT_VERTICES);
+            }
+        }
+
+        // Empty until the first upload.
+        if (vertex_copies.empty() && draws == draws_)
+            return;
+
+        draws_ = std::move(draws);
+        memcpy(staging_, draws_.data(), draws_size);
+
+        vk::CommandBufferBeginInfo cmd_buf_info = {};
+        cmd_buf_info.pNext              = nullptr;
+        cmd_buf_info.flags              = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        cmd_buf_info.pInheritanceInfo   = nullptr;
+        command_buffer_.begin(cmd_buf_info);
+
+        // Frames in flight may still draw from slots and commands written here.
+        command_buffer_.pipelineBarrier(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput,
+                                        vk::PipelineStageFlagBits::eTransfer, {}, 0, nullptr, 0, nullptr, 0, nullptr);
+
+        if (!vertex_copies.empty()) {
+            command_buffer_.copyBuffer(staging_buffer_->getBuffer(), vertex_buffer_->getBuffer(), vertex_copies);
+            command_buffer_.copyBuffer(staging_buffer_->getBuffer(), index_buffer_->getBuffer(), index_copies);
+        }
+        command_buffer_.copyBuffer(staging_buffer_->getBuffer(), draw_buffer_->getBuffer(), {vk::BufferCopy{0, 0, draws_size}});
+
+        vk::MemoryBarrier barrier = {};
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead |
+                                vk::AccessFlagBits::eIndexRead;
+        command_buffer_.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                        vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput,
+                                        {}, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        command_buffer_.end();
+
+        vk::SubmitInfo submit_info = {};
+        submit_info.pNext               = nullptr;
+        submit_info.commandBufferCount  = 1;
+        submit_info.pCommandBuffers     = &command_buffer_;
+
+        device.resetFences({fence_});
+        RenderPass::Queue::GetGraphicQueue().submit({submit_info}, fence_);
+    }
+
+    void StreamedGeometry::recordDraw(vk::CommandBuffer command_buffer) const
+    {
+        command_buffer.bindVertexBuffers(0, {vertex_buffer_->getBuffer()}, {vk::DeviceSize(0)});
+        command_buffer.bindIndexBuffer(index_buffer_->getBuffer(), 0, vk::IndexType::eUint16);
+
+        constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+        if (ApplicationData::data->multi_draw_indirect) {
+            command_buffer.drawIndexedIndirect(draw_buffer_->getBuffer(), 0, slot_count_, stride);
+        } else {
+            for (uint32_t slot = 0; slot < slot_count_; ++slot)
+                command_buffer.drawIndexedIndirect(draw_buffer_->getBuffer(), slot * stride, 1, stride);
+        }
+    }
+
+    const Vertex::QuantizationParams& StreamedGeometry::getQuantization() const
+    {
+        return mesh_->quantization;
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef GYMNURE_STREAMEDGEOMETRY_H
+#define GYMNURE_STREAMEDGEOMETRY_H
+
+#include <memory>
+#include <future>
+#include <vector>
+#include <Memory/Buffer.h>
+#include <Descriptors/Camera.h>
+#include <Util/AsyncIO.h>
+#include <Util/StreamedMeshFile.h>
+#include "VertexQuantizer.h"
+
+namespace Engine::Vertex
+{
+    /**
+     * GPU side of a streamed mesh (see Util::StreamedMeshFile): a fixed pool of device local slots, one cluster each,
+     * paged from the file as the camera moves.
+     *
+     * Every frame update() walks the node tree from the root, skipping nodes outside the frustum, and stops at the
+     * first node whose error projects under MAX_PIXEL_ERROR, or whose visible children are not all resident yet
+     * (they are requested, largest error on screen first). Completed reads are copied into free slots, evicting the nodes
+     * least recently visited when the pool is full. The root is loaded first and never evicted.
+     *
+     * Slots are drawn indirectly, one command per slot, so the pre-recorded command buffers need no re-recording.
+     * */
+    class StreamedGeometry
+    {
+    public:
+
+        static constexpr uint32_t SLOT_VERTICES  = Util::StreamedMeshFile::CLUSTER_MAX_VERTICES;
+        static constexpr uint32_t SLOT_INDICES   = Util::StreamedMeshFile::CLUSTER_MAX_TRIANGLES * 3;
+        static constexpr size_t   SLOT_SIZE      = SLOT_VERTICES * sizeof(PackedVertexData) + SLOT_INDICES * sizeof(uint16_t);
+        static constexpr size_t   DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+    private:
+
+        static constexpr uint32_t MAX_PENDING_READS = 8;
+        static constexpr size_t   STAGING_SIZE      = 16 * 1024 * 1024;
+        static constexpr float    MAX_PIXEL_ERROR   = 1.f;
+
+        enum class Residency
+        {
+            NONE,
+            LOADING,
+            RESIDENT
+        };
+
+        struct NodeState
+        {
+            Residency                       residency   = Residency::NONE;
+            std::vector<uint32_t>           slots       = {};   // One per node cluster.
+            uint64_t                        last_used   = 0;    // Last frame the node was visited.
+            std::future<Util::IOBuffer>     read        = {};
+        };
+
+        struct NodeRequest
+        {
+            uint32_t    node        = 0;
+            float       priority    = 0.f;
+        };
+
+        std::shared_ptr<const Util::StreamedMesh>   mesh_           = nullptr;
+        std::vector<NodeState>                      nodes_          = {};
+        std::vector<uint32_t>                       free_slots_     = {};
+        std::vector<vk::DrawIndexedIndirectCommand> draws_          = {};   // Last uploaded, one per slot.
+        uint32_t                                    slot_count_     = 0;
+        uint32_t                                    pending_reads_  = 0;
+        uint64_t                                    frame_          = 1;
+
+        std::unique_ptr<Memory::Buffer<PackedVertexData>>               vertex_buffer_  = nullptr;
+        std::unique_ptr<Memory::Buffer<uint16_t>>                       index_buffer_   = nullptr;
+        std::unique_ptr<Memory::Buffer<vk::DrawIndexedIndirectCommand>> draw_buffer_    = nullptr;
+        std::unique_ptr<Memory::Buffer<uint8_t>>                        staging_buffer_ = nullptr;
+        uint8_t*                                                        staging_        = nullptr;
+
+        vk::CommandBuffer   command_buffer_ = {};
+        vk::Fence           fence_          = {};
+
+        bool allocateSlots(uint32_t node);
+        void evict(uint32_t node);
+        void request(uint32_t node);
+        std::vector<uint32_t> selectNodes(const Descriptors::Camera& camera, std::vector<NodeRequest>& requests);
+
+    public:
+
+        explicit StreamedGeometry(std::shared_ptr<const Util::StreamedMesh> mesh, size_t budget = DEFAULT_BUDGET);
+        ~StreamedGeometry();
+
+        StreamedGeometry(const StreamedGeometry&) = delete;
+        StreamedGeometry& operator=(const StreamedGeometry&) = delete;
+
+        /**
+         * Select the nodes drawn this frame, issue reads and upload finished ones. Submits its own copies on the
+         * graphics queue, so it must run before the frame is submitted. Skipped while the last copies are in flight.
+         * */
+        void update(const Descriptors::Camera& camera);
+
+        /**
+         * Inside a render pass, with a program taking Vertex::PackedVertexData.
+         * */
+        void recordDraw(vk::CommandBuffer command_buffer) const;
+
+        [[nodiscard]] const Vertex::QuantizationParams& getQuantization() const;
+    };
+}
+
+#endif //GYMNURE_STREAMEDGEOMETRY_H
@@ -9,11 +9,56 @@
 #include "Memory/Buffer.h"
 #include <Descriptors/Camera.h>
 #include <Util/ModelDataLoader.h>
+#include "VertexLayout.hpp"
 
 namespace Engine::Vertex
 {
+    /**
+     * Type-erased view over a VertexBuffer, so objects with different vertex/index formats can be drawn alike.
+     * */
+    class VertexBufferBase
+    {
+
+    private:
+
+        // Optional position-only copy of vertices positions (see VertexStream::POSITION).
+        std::shared_ptr<Memory::Buffer<glm::vec3>> position_buffer_ = nullptr;
+
+    public:
+
+        virtual ~VertexBufferBase() = default;
+
+        [[nodiscard]] virtual uint32_t getVertexCount() const = 0;
+        [[nodiscard]] virtual vk::Buffer getVertexBuffer() const = 0;
+        [[nodiscard]] virtual uint32_t getIndexCount() const = 0;
+        [[nodiscard]] virtual vk::Buffer getIndexBuffer() const = 0;
+        [[nodiscard]] virtual vk::IndexType getIndexType() const = 0;
+
+        void initPositionStream(const std::vector<glm::vec3>& positions)
+        {
+            struct BufferData buffer_data = {};
+            buffer_data.properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+            buffer_data.usage      = vk::BufferUsageFlagBits::eVertexBuffer;
+            buffer_data.count      = positions.size();
+
+            position_buffer_ = std::make_shared<Memory::Buffer<glm::vec3>>(buffer_data);
+            position_buffer_->updateBuffer(positions);
+        }
+
+        [[nodiscard]] vk::Buffer getStreamBuffer(VertexStream stream) const
+        {
+            if (stream == VertexStream::POSITION) {
+                if (position_buffer_ == nullptr)
+                    Debug::logErrorAndDie("Vertex buffer has no position stream!");
+                return position_buffer_->getBuffer();
+            }
+
+            return getVertexBuffer();
+        }
+    };
+
     template <class T, class U>
-    class VertexBuffer
+    class VertexBuffer : public VertexBufferBase
     {
 
     private:
@@ -27,28 +72,34 @@ namespace Engine::Vertex
     public:
 
         VertexBuffer() = default;
-        ~VertexBuffer() = default;
+        ~VertexBuffer() override = default;
 
-        [[nodiscard]] uint32_t getVertexCount() const
+        [[nodiscard]] uint32_t getVertexCount() const override
         {
             return vertex_count_;
         }
 
-        [[nodiscard]] vk::Buffer getVertexBuffer() const
+        [[nodiscard]] vk::Buffer getVertexBuffer() const override
         {
             return vertex_buffer_->getBuffer();
         }
 
-        [[nodiscard]] uint32_t getIndexCount() const
+        [[nodiscard]] uint32_t getIndexCount() const override
         {
             return index_count_;
         }
 
-        [[nodiscard]] vk::Buffer getIndexBuffer() const
+        [[nodiscard]] vk::Buffer getIndexBuffer() const override
         {
             return index_buffer_->getBuffer();
         }
 
+        [[nodiscard]] vk::IndexType getIndexType() const override
+        {
+            static_assert(sizeof(U) == 2 || sizeof(U) == 4, "Index type must have 16 or 32 bits!");
+            return sizeof(U) == 2 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+        }
+
         void initBuffers(const std::vector<T>& vertexData = {}, const std::vector<U>& indexBuffer = {})
         {
             vertex_count_ = static_cast<uint32_t>(vertexData.size());
@@ -65,47 +116,20 @@ namespace Engine::Vertex
 
                 index_count_ = static_cast<uint32_t>(indexBuffer.size());
 
-                buffer_data.usage = vk::BufferUsageFlagBits::eIndexBuffer;
-                buffer_data.count = indexBuffer.size();
+                // Also read by compute passes (see GraphicsPipeline::MeshletCulling), in whole 32 bits words.
+                buffer_data.usage = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+                buffer_data.count = (indexBuffer.size() * sizeof(U) + 3) / 4 * 4 / sizeof(U);
 
                 index_buffer_ = std::make_unique<Memory::Buffer<U>>(buffer_data);
-                index_buffer_->updateBuffer(indexBuffer);
+                if (buffer_data.count == indexBuffer.size()) {
+                    index_buffer_->updateBuffer(indexBuffer);
+                } else {
+                    std::vector<U> padded = indexBuffer;
+                    padded.resize(buffer_data.count, 0);
+                    index_buffer_->updateBuffer(padded);
+                }
             }
         }
-
-        void createPrimitiveTriangle()
-        {
-            std::vector<VertexData> vertexBuffer =
-            {
-                //     POSITION              UV              NORMAL
-                { { 1.0f,  1.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 0.0f, -1.0f} },
-                { {-1.0f,  1.0f, 0.0f}, {0.0f, 0.0f}, {0.0f, 0.0f, -1.0f} },
-                { { 0.0f, -1.0f, 0.0f}, {0.5f, 1.0f}, {0.0f, 0.0f, -1.0f} }
-            };
-
-            // Setup indices
-            std::vector<uint32_t> indexBuffer = { 0, 1, 2 };
-
-            this->initBuffers(vertexBuffer, indexBuffer);
-        }
-
-        void createPrimitiveQuad()
-        {
-            std::vector<VertexData> vertexBuffer =
-            {
-                //     POSITION              UV              NORMAL
-                { { 10.0f, 0.0f,  10.0f}, {1.0f, 1.0f}, {0.0f, 1.0f, 0.0f} },
-                { { 10.0f, 0.0f, -10.0f}, {1.0f, 0.0f}, {0.0f, 1.0f, 0.0f} },
-                { {-10.0f, 0.0f, -10.0f}, {0.0f, 0.0f}, {0.0f, 1.0f, 0.0f} },
-                { {-10.0f, 0.0f,  10.0f}, {0.0f, 1.0f}, {0.0f, 1.0f, 0.0f} },
-            };
-
-            // Setup indices
-            std::vector<uint32_t> indexBuffer = { 0, 1, 2, 0, 2, 3 };
-
-            this->initBuffers(vertexBuffer, indexBuffer);
-        }
-
     };
 }
 #endif // GYMNURE_VERTEX_BUFFER
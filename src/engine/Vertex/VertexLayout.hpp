@@ -0,0 +1,125 @@
+#ifndef GYMNURE_VERTEXLAYOUT_HPP
+#define GYMNURE_VERTEXLAYOUT_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <vulkan/vulkan.hpp>
+
+namespace Engine::Vertex
+{
+    /**
+     * Which object buffer feeds a binding.
+     * INTERLEAVED is the object vertex buffer itself, POSITION is its optional position-only (vec3) stream.
+     * */
+    enum VertexStream
+    {
+        INTERLEAVED,
+        POSITION,
+    };
+
+    constexpr uint32_t formatSize(vk::Format format)
+    {
+        switch (format)
+        {
+            case vk::Format::eR8G8B8A8Unorm:        return 4;
+            case vk::Format::eR16G16Sfloat:         return 4;
+            case vk::Format::eR16G16Snorm:          return 4;
+            case vk::Format::eR16G16Unorm:          return 4;
+            case vk::Format::eR16G16B16A16Unorm:    return 8;
+            case vk::Format::eR16G16B16A16Snorm:    return 8;
+            case vk::Format::eR32G32Sfloat:         return 8;
+            case vk::Format::eR32G32B32Sfloat:      return 12;
+            case vk::Format::eR32G32B32A32Sfloat:   return 16;
+            default:                                return 0;
+        }
+    }
+
+    template <vk::Format Format, size_t Offset>
+    struct Attribute
+    {
+        static constexpr vk::Format format = Format;
+        static constexpr uint32_t   offset = static_cast<uint32_t>(Offset);
+        static constexpr uint32_t   size   = formatSize(Format);
+
+        static_assert(size > 0, "Unsupported vertex attribute format, add it to formatSize()!");
+    };
+
+    template <VertexStream Stream, class T, class... Attributes>
+    struct Binding
+    {
+        static constexpr VertexStream stream          = Stream;
+        static constexpr uint32_t     stride          = sizeof(T);
+        static constexpr uint32_t     attribute_count = sizeof...(Attributes);
+
+        static_assert(((Attributes::offset + Attributes::size <= sizeof(T)) && ...), "Vertex attribute out of vertex bounds!");
+
+        // Attributes take consecutive shader locations, starting at 'first_location'.
+        static constexpr void fillAttributes(vk::VertexInputAttributeDescription* out, uint32_t binding, uint32_t first_location)
+        {
+            [[maybe_unused]] uint32_t i = 0;
+            ((out[i] = vk::VertexInputAttributeDescription(first_location + i, binding, Attributes::format, Attributes::offset), i++), ...);
+        }
+    };
+
+    /**
+     * Runtime form of a VertexLayout, consumed by GraphicsPipeline and CommandBuffer.
+     * */
+    struct VertexInputDescription
+    {
+        std::vector<vk::VertexInputBindingDescription>      bindings   = {};
+        std::vector<vk::VertexInputAttributeDescription>    attributes = {};
+        std::vector<VertexStream>                           streams    = {}; // Stream feeding each binding.
+
+        [[nodiscard]] bool usesStream(VertexStream stream) const
+        {
+            return std::find(streams.begin(), streams.end(), stream) != streams.end();
+        }
+    };
+
+    /**
+     * Compile-time vertex layout: one Binding per vertex buffer bound by the program.
+     * Attribute locations are assigned in declaration order across bindings.
+     * */
+    template <class... Bindings>
+    struct VertexLayout
+    {
+        static constexpr uint32_t binding_count   = sizeof...(Bindings);
+        static constexpr uint32_t attribute_count = (0 + ... + Bindings::attribute_count);
+
+        static constexpr std::array<vk::VertexInputBindingDescription, binding_count> bindings()
+        {
+            std::array<vk::VertexInputBindingDescription, binding_count> out = {};
+            [[maybe_unused]] uint32_t binding = 0;
+            ((out[binding] = vk::VertexInputBindingDescription(binding, Bindings::stride, vk::VertexInputRate::eVertex), binding++), ...);
+            return out;
+        }
+
+        static constexpr std::array<vk::VertexInputAttributeDescription, attribute_count> attributes()
+        {
+            std::array<vk::VertexInputAttributeDescription, attribute_count> out = {};
+            [[maybe_unused]] uint32_t binding = 0;
+            [[maybe_unused]] uint32_t location = 0;
+            ((Bindings::fillAttributes(out.data() + location, binding++, location), location += Bindings::attribute_count), ...);
+            return out;
+        }
+
+        static VertexInputDescription describe()
+        {
+            auto b = bindings();
+            auto a = attributes();
+
+            VertexInputDescription description = {};
+            description.bindings   = std::vector<vk::VertexInputBindingDescription>(b.begin(), b.end());
+            description.attributes = std::vector<vk::VertexInputAttributeDescription>(a.begin(), a.end());
+            description.streams    = { Bindings::stream... };
+
+            return description;
+        }
+    };
+
+    using EmptyLayout = VertexLayout<>;
+}
+
+#endif //GYMNURE_VERTEXLAYOUT_HPP
@@ -0,0 +1,157 @@
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+#include "VertexQuantizer.h"
+
+namespace Engine::Vertex
+{
+    namespace
+    {
+        constexpr float TWO_PI = 6.28318530718f;
+
+        // Duff et al., "Building an Orthonormal Basis, Revisited": frame every normal maps to without branches on its sign.
+        void tangentFrame(const glm::vec3& normal, glm::vec3& b1, glm::vec3& b2)
+        {
+            float sign = normal.z >= 0.f ? 1.f : -1.f;
+            float a = -1.f / (sign + normal.z);
+            float b = normal.x * normal.y * a;
+
+            b1 = glm::vec3(1.f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+            b2 = glm::vec3(b, sign + normal.y * normal.y * a, -normal.y);
+        }
+    }
+
+    QuantizedMesh VertexQuantizer::quantize(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices)
+    {
+        QuantizedMesh mesh = {};
+        mesh.params = computeParams(vertices);
+
+        mesh.vertices.reserve(vertices.size());
+        for (const auto& vertex : vertices)
+            mesh.vertices.push_back(packVertex(vertex, mesh.params));
+
+        if (vertices.size() <= UINT16_MAX + 1) {
+            mesh.indices16.reserve(indices.size());
+            for (uint32_t index : indices)
+                mesh.indices16.push_back(static_cast<uint16_t>(index));
+        } else {
+            mesh.indices32 = indices;
+        }
+
+        return mesh;
+    }
+
+    QuantizationParams VertexQuantizer::computeParams(const std::vector<VertexData>& vertices)
+    {
+        QuantizationParams params = {};
+        if (vertices.empty())
+            return params;
+
+        glm::vec3 min = vertices[0].pos;
+        glm::vec3 max = vertices[0].pos;
+        for (const auto& vertex : vertices) {
+            min = glm::min(min, vertex.pos);
+            max = glm::max(max, vertex.pos);
+        }
+
+        glm::vec3 extent = max - min;
+        // Flat axis: any extent works, avoid division by zero.
+        for (int i = 0; i < 3; ++i)
+            if (extent[i] <= 0.f) extent[i] = 1.f;
+
+        params.bounds_min    = glm::vec4(min, 0.f);
+        params.bounds_extent = glm::vec4(extent, 0.f);
+
+        return params;
+    }
+
+    PackedVertexData VertexQuantizer::packVertex(const VertexData& vertex, const QuantizationParams& params)
+    {
+        PackedVertexData packed = {};
+
+        glm::vec3 rel_pos = (vertex.pos - glm::vec3(params.bounds_min)) / glm::vec3(params.bounds_extent);
+        for (int i = 0; i < 3; ++i)
+            packed.pos[i] = static_cast<uint16_t>(glm::round(glm::clamp(rel_pos[i], 0.f, 1.f) * 65535.f));
+
+        glm::vec2 oct = octEncode(vertex.normal);
+        for (int i = 0; i < 2; ++i)
+            packed.normal[i] = static_cast<uint16_t>(static_cast<int16_t>(glm::round(glm::clamp(oct[i], -1.f, 1.f) * 32767.f)));
+
+        glm::vec2 packed_oct = glm::vec2(static_cast<int16_t>(packed.normal[0]), static_cast<int16_t>(packed.normal[1])) / 32767.f;
+        packed.pos[3] = encodeTangent(octDecode(glm::clamp(packed_oct, -1.f, 1.f)), vertex.tangent);
+
+        packed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+        packed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+        for (int i = 0; i < 4; ++i)
+            packed.color[i] = static_cast<uint8_t>(glm::round(glm::clamp(vertex.color[i], 0.f, 1.f) * 255.f));
+
+        return packed;
+    }
+
+    VertexData VertexQuantizer::unpackVertex(const PackedVertexData& packed, const QuantizationParams& params)
+    {
+        VertexData vertex = {};
+
+        glm::vec3 rel_pos = glm::vec3(packed.pos[0], packed.pos[1], packed.pos[2]) / 65535.f;
+        vertex.pos = glm::vec3(params.bounds_min) + rel_pos * glm::vec3(params.bounds_extent);
+
+        glm::vec2 oct = glm::vec2(static_cast<int16_t>(packed.normal[0]), static_cast<int16_t>(packed.normal[1])) / 32767.f;
+        vertex.normal = octDecode(glm::clamp(oct, -1.f, 1.f));
+        vertex.tangent = decodeTangent(vertex.normal, packed.pos[3]);
+
+        vertex.uv = glm::vec2(glm::unpackHalf1x16(packed.uv[0]), glm::unpackHalf1x16(packed.uv[1]));
+        vertex.color = glm::vec4(packed.color[0], packed.color[1], packed.color[2], packed.color[3]) / 255.f;
+
+        return vertex;
+    }
+
+    glm::vec2 VertexQuantizer::octEncode(const glm::vec3& normal)
+    {
+        float l1_norm = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+        if (l1_norm <= 0.f)
+            return glm::vec2(0.f);
+
+        glm::vec3 n = normal / l1_norm;
+        glm::vec2 encoded = glm::vec2(n.x, n.y);
+
+        // Fold lower hemisphere over the diagonals.
+        if (n.z < 0.f) {
+            glm::vec2 sign_not_zero = glm::vec2(encoded.x >= 0.f ? 1.f : -1.f, encoded.y >= 0.f ? 1.f : -1.f);
+            encoded = (1.f - glm::abs(glm::vec2(encoded.y, encoded.x))) * sign_not_zero;
+        }
+
+        return encoded;
+    }
+
+    glm::vec3 VertexQuantizer::octDecode(const glm::vec2& encoded)
+    {
+        glm::vec3 n = glm::vec3(encoded.x, encoded.y, 1.f - glm::abs(encoded.x) - glm::abs(encoded.y));
+        float t = glm::max(-n.z, 0.f);
+        n.x += n.x >= 0.f ? -t : t;
+        n.y += n.y >= 0.f ? -t : t;
+
+        return glm::normalize(n);
+    }
+
+    uint16_t VertexQuantizer::encodeTangent(const glm::vec3& normal, const glm::vec4& tangent)
+    {
+        glm::vec3 b1, b2;
+        tangentFrame(normal, b1, b2);
+
+        float angle = std::atan2(glm::dot(glm::vec3(tangent), b2), glm::dot(glm::vec3(tangent), b1));
+        auto quantized = static_cast<uint16_t>(glm::round((angle / TWO_PI + 0.5f) * 32767.f));
+
+        return static_cast<uint16_t>((quantized << 1u) | (tangent.w < 0.f ? 1u : 0u));
+    }
+
+    glm::vec4 VertexQuantizer::decodeTangent(const glm::vec3& normal, uint16_t encoded)
+    {
+        glm::vec3 b1, b2;
+        tangentFrame(normal, b1, b2);
+
+        float angle = (static_cast<float>(encoded >> 1u) / 32767.f - 0.5f) * TWO_PI;
+        glm::vec3 tangent = b1 * std::cos(angle) + b2 * std::sin(angle);
+
+        return glm::vec4(tangent, (encoded & 1u) != 0 ? -1.f : 1.f);
+    }
+}
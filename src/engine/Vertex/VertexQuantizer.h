@@ -0,0 +1,65 @@
+#ifndef GYMNURE_VERTEXQUANTIZER_H
+#define GYMNURE_VERTEXQUANTIZER_H
+
+#include <cstdint>
+#include <vector>
+#include <Util/ModelData.hpp>
+
+namespace Engine::Vertex
+{
+    /**
+     * Compact vertex layout (20 bytes instead of the 64 bytes of VertexData).
+     * Dequantization is done in the vertex shader (see phong_packed_vs.glsl).
+     * */
+    struct PackedVertexData
+    {
+        uint16_t pos[4];    // UNORM16, relative to mesh bounds. 'w' is the tangent (see encodeTangent).
+        uint16_t normal[2]; // SNORM16, octahedral encoded.
+        uint16_t uv[2];     // Half float.
+        uint8_t  color[4];  // UNORM8.
+    };
+
+    static_assert(sizeof(PackedVertexData) == 20, "PackedVertexData must be tightly packed!");
+
+    /**
+     * Pushed as vertex push constant, so 'pos = bounds_min + inPos * bounds_extent'.
+     * */
+    struct QuantizationParams
+    {
+        glm::vec4 bounds_min    = glm::vec4(0.f);
+        glm::vec4 bounds_extent = glm::vec4(1.f);
+    };
+
+    struct QuantizedMesh
+    {
+        std::vector<PackedVertexData> vertices  = {};
+        // Only one of them is filled, 16 bits indices are used when mesh has fewer than 65536 vertices.
+        std::vector<uint16_t>         indices16 = {};
+        std::vector<uint32_t>         indices32 = {};
+        QuantizationParams            params    = {};
+    };
+
+    class VertexQuantizer
+    {
+    public:
+
+        VertexQuantizer() = delete;
+
+        static QuantizedMesh quantize(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices);
+        static QuantizationParams computeParams(const std::vector<VertexData>& vertices);
+        static PackedVertexData packVertex(const VertexData& vertex, const QuantizationParams& params);
+        static VertexData unpackVertex(const PackedVertexData& packed, const QuantizationParams& params);
+
+        static glm::vec2 octEncode(const glm::vec3& normal);
+        static glm::vec3 octDecode(const glm::vec2& encoded);
+
+        /**
+         * Tangent as its angle around 'normal' (15 bits) and the bitangent sign (low bit).
+         * 'normal' must be the decoded one so both sides build the same reference frame.
+         * */
+        static uint16_t encodeTangent(const glm::vec3& normal, const glm::vec4& tangent);
+        static glm::vec4 decodeTangent(const glm::vec3& normal, uint16_t encoded);
+    };
+}
+
+#endif //GYMNURE_VERTEXQUANTIZER_H
@@ -38,7 +38,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         {
             auto black_dragon = GymnureObjData{};
             black_dragon.obj_path = "BlackDragon/Dragon 2.5_fbx.fbx";
-            gymnure->addFbxData(phong_id, std::move(black_dragon));
+            // Shows up once loaded, without blocking the first frames.
+            gymnure->addFbxDataAsync(phong_id, std::move(black_dragon));
         }
 
         //{